@@ -1,12 +1,11 @@
 #version 450
 
+/* mode is a specialization constant, so each pipeline only contains the path it uses */
+layout (constant_id = 0) const int mode = 0;
+
 layout (location = 0) in vec2 TexCoord;
 layout (location = 0) out vec4 FragColor;
 layout (set = 2, binding = 0, rgba8) uniform readonly image2D Texture;
-layout (set = 3, binding = 0) uniform UBO
-{
-    int mode;
-};
 
 void main()
 {
@@ -0,0 +1,17 @@
+#version 450
+
+/* GradientTexture.comp as a full-screen pass, so it can write the swapchain directly */
+
+layout (location = 0) in vec2 TexCoord;
+layout (location = 0) out vec4 FragColor;
+layout (set = 3, binding = 0) uniform UBO
+{
+	float time;
+} ubo;
+
+void main()
+{
+    vec3 col = 0.5 + 0.5*cos(ubo.time + TexCoord.xyx + vec3(0, 2, 4));
+
+    FragColor = vec4(col, 1.0);
+}
@@ -2,15 +2,16 @@
 
 layout (location = 0) in vec3 Position;
 layout (location = 1) in vec4 Color;
+layout (location = 2) in vec2 InstanceOffset;
+layout (location = 3) in float InstanceScale;
+layout (location = 4) in vec4 InstanceColor;
 
 layout (location = 0) out vec4 outColor;
 
 void main()
 {
-	outColor = Color;
+	outColor = Color * InstanceColor;
 
-	vec3 pos = (Position * 0.25) - vec3(0.75, 0.75, 0);
-	pos.x += (gl_InstanceIndex % 4) * 0.5;
-	pos.y += floor(gl_InstanceIndex / 4) * 0.5;
+	vec3 pos = (Position * InstanceScale) + vec3(InstanceOffset, 0);
 	gl_Position = vec4(pos, 1);
-}
\ No newline at end of file
+}
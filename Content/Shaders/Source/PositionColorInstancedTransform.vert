@@ -0,0 +1,17 @@
+#version 450
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec4 Color;
+
+layout (location = 0) out vec4 outColor;
+
+layout (std430, set = 0, binding = 0) readonly buffer TransformBuffer
+{
+	mat4x4 Transforms[];
+};
+
+void main()
+{
+	outColor = Color;
+	gl_Position = Transforms[gl_InstanceIndex] * vec4(Position, 1);
+}
@@ -0,0 +1,19 @@
+#version 450
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec4 ObjectPositionRadius;
+layout (location = 2) in vec4 ObjectColor;
+
+layout (location = 0) out vec4 outColor;
+
+layout (set = 1, binding = 0) uniform UniformBlock
+{
+	mat4x4 ViewProjection;
+};
+
+void main()
+{
+	outColor = ObjectColor;
+	vec2 worldPosition = (Position.xy * ObjectPositionRadius.z) + ObjectPositionRadius.xy;
+	gl_Position = ViewProjection * vec4(worldPosition, 0, 1);
+}
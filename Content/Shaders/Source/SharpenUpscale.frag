@@ -0,0 +1,36 @@
+#version 450
+
+/* SharpenUpscale.comp as a full-screen pass, so it can write the swapchain directly */
+
+layout (location = 0) in vec2 TexCoord;
+layout (location = 0) out vec4 FragColor;
+layout (set = 2, binding = 0) uniform sampler2D inImage;
+layout (set = 3, binding = 0) uniform UBO
+{
+	vec2 sourceSize; // The rendered region of inImage, in texels
+	vec2 texelSize; // 1 / the full size of inImage
+	vec2 outputSize;
+	float sharpness;
+} ubo;
+
+void main()
+{
+	// Stay half a texel inside the rendered region, the rest of inImage is stale
+	vec2 position = gl_FragCoord.xy * ubo.sourceSize / ubo.outputSize;
+	position = clamp(position, vec2(1.5), ubo.sourceSize - 1.5);
+	vec2 uv = position * ubo.texelSize;
+
+	vec3 center = textureLod(inImage, uv, 0).rgb;
+	vec3 north = textureLod(inImage, uv - vec2(0, ubo.texelSize.y), 0).rgb;
+	vec3 south = textureLod(inImage, uv + vec2(0, ubo.texelSize.y), 0).rgb;
+	vec3 west = textureLod(inImage, uv - vec2(ubo.texelSize.x, 0), 0).rgb;
+	vec3 east = textureLod(inImage, uv + vec2(ubo.texelSize.x, 0), 0).rgb;
+
+	// Unsharp mask, clamped to the neighbourhood so edges don't ring
+	vec3 blurred = (north + south + west + east) * 0.25;
+	vec3 low = min(center, min(min(north, south), min(west, east)));
+	vec3 high = max(center, max(max(north, south), max(west, east)));
+	vec3 sharpened = clamp(center + (center - blurred) * ubo.sharpness, low, high);
+
+	FragColor = vec4(sharpened, 1.0);
+}
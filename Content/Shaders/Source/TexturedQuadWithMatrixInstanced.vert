@@ -0,0 +1,24 @@
+#version 450
+
+layout (location = 0) in vec3 Position;
+layout (location = 1) in vec2 TexCoord;
+
+layout (location = 0) out vec2 outTexCoord;
+layout (location = 1) out vec4 outColor;
+
+layout (std430, set = 0, binding = 0) readonly buffer TransformBuffer
+{
+	mat4x4 Transforms[];
+};
+
+layout (std430, set = 0, binding = 1) readonly buffer ColorBuffer
+{
+	vec4 MultiplyColors[];
+};
+
+void main()
+{
+	outTexCoord = TexCoord;
+	outColor = MultiplyColors[gl_InstanceIndex];
+	gl_Position = Transforms[gl_InstanceIndex] * vec4(Position, 1);
+}
@@ -0,0 +1,157 @@
+#version 450
+
+/* ToneMap.comp and the transfer passes after it, as one full-screen pass that writes the
+ * swapchain directly. Both choices are specialization constants, as in ToneMap.comp.
+ * Operator 0: Reinhard, 1: Extended Reinhard (luminance), 2: Hable, 3: ACES
+ * Transfer 0: none, the swapchain is linear; 1: LinearToSRGB.comp; 2: LinearToST2084.comp
+ */
+
+layout (constant_id = 0) const int Operator = 0;
+layout (constant_id = 1) const int Transfer = 0;
+
+layout (location = 0) in vec2 TexCoord;
+layout (location = 0) out vec4 FragColor;
+layout (set = 2, binding = 0) uniform sampler2D inImage;
+
+vec3 reinhard(vec3 v)
+{
+    return v / (1.0f + v);
+}
+
+float luminance(vec3 v)
+{
+    return dot(v, vec3(0.2126f, 0.7152f, 0.0722f));
+}
+
+vec3 change_luminance(vec3 c_in, float l_out)
+{
+    float l_in = luminance(c_in);
+    return c_in * (l_out / l_in);
+}
+
+vec3 reinhard_extended_luminance(vec3 v, float max_white_l)
+{
+    float l_old = luminance(v);
+    float numerator = l_old * (1.0f + (l_old / (max_white_l * max_white_l)));
+    float l_new = numerator / (1.0f + l_old);
+    return change_luminance(v, l_new);
+}
+
+vec3 hable_tonemap_partial(vec3 x)
+{
+    float A = 0.15f;
+    float B = 0.50f;
+    float C = 0.10f;
+    float D = 0.20f;
+    float E = 0.02f;
+    float F = 0.30f;
+    return ((x*(A*x+C*B)+D*E)/(x*(A*x+B)+D*F))-E/F;
+}
+
+vec3 hable_filmic(vec3 v)
+{
+    float exposure_bias = 2.0f;
+    vec3 curr = hable_tonemap_partial(v * exposure_bias);
+
+    vec3 W = vec3(11.2f);
+    vec3 white_scale = vec3(1.0f) / hable_tonemap_partial(W);
+    return curr * white_scale;
+}
+
+const mat3x3 aces_input_matrix = mat3x3
+(
+	vec3(0.59719f, 0.35458f, 0.04823f),
+    vec3(0.07600f, 0.90834f, 0.01566f),
+    vec3(0.02840f, 0.13383f, 0.83777f)
+);
+
+const mat3x3 aces_output_matrix = mat3x3
+(
+    vec3( 1.60475f, -0.53108f, -0.07367f),
+    vec3(-0.10208f,  1.10813f, -0.00605f),
+    vec3(-0.00327f, -0.07276f,  1.07602f)
+);
+
+vec3 rtt_and_odt_fit(vec3 v)
+{
+    vec3 a = v * (v + 0.0245786f) - 0.000090537f;
+    vec3 b = v * (0.983729f * v + 0.4329510f) + 0.238081f;
+    return a / b;
+}
+
+vec3 aces_fitted(vec3 v)
+{
+    v = v * aces_input_matrix;
+    v = rtt_and_odt_fit(v);
+    return v * aces_output_matrix;
+}
+
+const float g_MaxNitsFor2084 = 10000.0f;
+
+// Color rotation matrix to rotate Rec.709 color primaries into Rec.2020
+const mat3x3 from709to2020 =
+{
+    { 0.6274040f, 0.3292820f, 0.0433136f },
+    { 0.0690970f, 0.9195400f, 0.0113612f },
+    { 0.0163916f, 0.0880132f, 0.8955950f }
+};
+
+vec3 LinearToST2084(vec3 normalizedLinearValue)
+{
+    return pow(
+		(0.8359375f + 18.8515625f * pow(
+			abs(normalizedLinearValue),
+			vec3(0.1593017578f)
+		)) / (1.0f + 18.6875f * pow(
+			abs(normalizedLinearValue),
+			vec3(0.1593017578f)
+		)),
+		vec3(78.84375f)
+	);
+}
+
+vec3 NormalizeHDRSceneValue(vec3 hdrSceneValue, float paperWhiteNits)
+{
+    vec3 normalizedLinearValue = hdrSceneValue * paperWhiteNits / g_MaxNitsFor2084;
+    return normalizedLinearValue;       // Don't clamp between [0..1], so we can still perform operations on scene values higher than 10,000 nits
+}
+
+float CalcHDRSceneValue(float nits, float paperWhiteNits)
+{
+    return nits / paperWhiteNits;
+}
+
+vec4 ConvertToHDR10(vec4 hdrSceneValue, float paperWhiteNits)
+{
+    vec3 rec2020 = hdrSceneValue.rgb * from709to2020;                             // Rotate Rec.709 color primaries into Rec.2020 color primaries
+    vec3 normalizedLinearValue = NormalizeHDRSceneValue(rec2020, paperWhiteNits);     // Normalize using paper white nits to prepare for ST.2084
+    vec3 HDR10 = LinearToST2084(normalizedLinearValue);                               // Apply ST.2084 curve
+
+    return vec4(HDR10.rgb, hdrSceneValue.a);
+}
+
+vec3 LinearToSRGB(vec3 color)
+{
+    return pow(abs(color), vec3(1.0f/2.2f));
+}
+
+void main()
+{
+	vec4 inPixel = texelFetch(inImage, ivec2(gl_FragCoord.xy), 0);
+
+	vec3 outColor;
+	switch (Operator)
+	{
+		case 0: outColor = reinhard(inPixel.rgb); break;
+		case 1: outColor = reinhard_extended_luminance(inPixel.rgb, 662); break; /* hardcode white point to scene radiance */
+		case 2: outColor = hable_filmic(inPixel.rgb); break;
+		default: outColor = aces_fitted(inPixel.rgb); break;
+	}
+
+	switch (Transfer)
+	{
+		case 0: FragColor = vec4(outColor, 1.0); break;
+		case 1: FragColor = vec4(LinearToSRGB(outColor), 1.0); break;
+		default: FragColor = ConvertToHDR10(vec4(outColor, 1.0), 200.0); break;
+	}
+}
@@ -0,0 +1,21 @@
+#version 450
+
+/* SolidColor.frag for an HDR color, tonemapped (Reinhard) and gamma encoded in the shader.
+ * Under MSAA every sample is display-referred before the hardware resolve averages them,
+ * so edges against a bright background stay antialiased.
+ */
+
+layout (location = 0) in vec4 Color;
+layout (location = 0) out vec4 FragColor;
+
+vec3 LinearToSRGB(vec3 color)
+{
+	return pow(abs(color), vec3(1.0f/2.2f));
+}
+
+void main()
+{
+	vec3 color = Color.rgb / (1.0 + Color.rgb);
+
+	FragColor = vec4(LinearToSRGB(color), Color.a);
+}
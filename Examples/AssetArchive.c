@@ -0,0 +1,206 @@
+#include "Common.h"
+
+#ifdef SDL_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* Runtime side of Content.pak, see Tools/AssetPacker.c for the writer.
+ *
+ * The whole file is mapped read-only, so opening it costs a handful of syscalls no matter
+ * how many assets it holds, and FindAsset hands out pointers straight into the mapping.
+ * If the file can't be mapped it is read into one heap block instead.
+ * The name table is the last thing in the file, so a valid archive always ends in a zero byte.
+ */
+
+static const Uint8* ArchiveData;
+static size_t ArchiveSize;
+static bool ArchiveMapped;
+static const AssetArchiveHeader* ArchiveHeader;
+static const AssetArchiveEntry* ArchiveEntries;
+static const Uint32* ArchiveSlots;
+static const char* ArchiveNames;
+
+/* FNV-1a */
+Uint32 HashAssetName(const char* name)
+{
+	Uint32 hash = 2166136261u;
+	for (const char* c = name; *c != '\0'; c += 1)
+	{
+		hash ^= (Uint8) *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static bool MapArchiveFile(const char* path)
+{
+#ifdef SDL_PLATFORM_WINDOWS
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	HANDLE mapping = NULL;
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+	{
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	}
+	CloseHandle(file);
+	if (mapping == NULL)
+	{
+		return false;
+	}
+
+	ArchiveData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	ArchiveSize = (size_t) size.QuadPart;
+#else
+	int file = open(path, O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat info;
+	void* mapping = MAP_FAILED;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		mapping = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	close(file);
+	if (mapping == MAP_FAILED)
+	{
+		return false;
+	}
+
+	ArchiveData = mapping;
+	ArchiveSize = (size_t) info.st_size;
+#endif
+
+	ArchiveMapped = ArchiveData != NULL;
+	return ArchiveMapped;
+}
+
+static void UnmapArchiveFile()
+{
+#ifdef SDL_PLATFORM_WINDOWS
+	UnmapViewOfFile(ArchiveData);
+#else
+	munmap((void*) ArchiveData, ArchiveSize);
+#endif
+}
+
+bool OpenAssetArchive(const char* path)
+{
+	CloseAssetArchive();
+
+	if (!MapArchiveFile(path))
+	{
+		ArchiveData = SDL_LoadFile(path, &ArchiveSize);
+		if (ArchiveData == NULL)
+		{
+			return false;
+		}
+	}
+
+	const AssetArchiveHeader* header = (const AssetArchiveHeader*) ArchiveData;
+	bool valid =
+		ArchiveSize >= sizeof(AssetArchiveHeader) &&
+		header->Magic == ASSET_ARCHIVE_MAGIC &&
+		header->Version == ASSET_ARCHIVE_VERSION &&
+		header->SlotCount > 0 &&
+		(header->SlotCount & (header->SlotCount - 1)) == 0 &&
+		header->SlotCount >= header->EntryCount &&
+		header->EntriesOffset <= ArchiveSize &&
+		(Uint64) header->EntryCount * sizeof(AssetArchiveEntry) <= ArchiveSize - header->EntriesOffset &&
+		header->SlotsOffset <= ArchiveSize &&
+		(Uint64) header->SlotCount * sizeof(Uint32) <= ArchiveSize - header->SlotsOffset &&
+		header->NamesOffset < ArchiveSize &&
+		ArchiveData[ArchiveSize - 1] == '\0';
+
+	if (!valid)
+	{
+		SDL_Log("Asset archive %s is corrupt or from a different version, ignoring it", path);
+		CloseAssetArchive();
+		return false;
+	}
+
+	ArchiveHeader = header;
+	ArchiveEntries = (const AssetArchiveEntry*) (ArchiveData + header->EntriesOffset);
+	ArchiveSlots = (const Uint32*) (ArchiveData + header->SlotsOffset);
+	ArchiveNames = (const char*) (ArchiveData + header->NamesOffset);
+
+	SDL_Log("Loaded %u assets from %s (%s)", header->EntryCount, path, ArchiveMapped ? "mapped" : "read");
+	return true;
+}
+
+void CloseAssetArchive()
+{
+	if (ArchiveMapped)
+	{
+		UnmapArchiveFile();
+	}
+	else
+	{
+		SDL_free((void*) ArchiveData);
+	}
+
+	ArchiveData = NULL;
+	ArchiveSize = 0;
+	ArchiveMapped = false;
+	ArchiveHeader = NULL;
+	ArchiveEntries = NULL;
+	ArchiveSlots = NULL;
+	ArchiveNames = NULL;
+}
+
+bool FindAsset(const char* name, Asset* asset)
+{
+	if (ArchiveHeader == NULL)
+	{
+		return false;
+	}
+
+	Uint32 hash = HashAssetName(name);
+	Uint32 mask = ArchiveHeader->SlotCount - 1;
+
+	for (Uint32 probe = 0; probe <= mask; probe += 1)
+	{
+		Uint32 index = ArchiveSlots[(hash + probe) & mask];
+		if (index == ASSET_ARCHIVE_EMPTY_SLOT || index >= ArchiveHeader->EntryCount)
+		{
+			return false;
+		}
+
+		const AssetArchiveEntry* entry = &ArchiveEntries[index];
+		if (entry->NameHash != hash ||
+			entry->NameOffset >= ArchiveSize - ArchiveHeader->NamesOffset ||
+			SDL_strcmp(ArchiveNames + entry->NameOffset, name) != 0)
+		{
+			continue;
+		}
+
+		/* Written so that a corrupt offset can't wrap around */
+		if (entry->DataOffset > ArchiveSize || entry->DataSize > ArchiveSize - entry->DataOffset)
+		{
+			return false;
+		}
+
+		asset->Data = ArchiveData + entry->DataOffset;
+		asset->Size = (size_t) entry->DataSize;
+		asset->Type = (AssetType) entry->Type;
+		asset->Width = (int) entry->Width;
+		asset->Height = (int) entry->Height;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,422 @@
+#include "Common.h"
+
+static SDL_GPUGraphicsPipeline* PerDrawPipeline;
+static SDL_GPUGraphicsPipeline* InstancedPipeline;
+static SDL_GPUBuffer* VertexBuffer;
+static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUBuffer* TransformBuffer;
+static SDL_GPUTransferBuffer* TransformTransferBuffer;
+
+static TransformBatch Transforms;
+
+static const Uint32 ObjectCounts[] = { 1000, 10000, 100000 };
+static Sint32 ObjectCountIndex = 0;
+static bool UseBatchedPath = true;
+
+static Uint64 AccumulatedCPUTicks = 0;
+static float AccumulatedFrameTime = 0;
+static Uint32 AccumulatedFrames = 0;
+
+static void ResetObjects(void)
+{
+	Uint32 count = ObjectCounts[ObjectCountIndex];
+	Uint32 perRow = (Uint32) SDL_ceilf(SDL_sqrtf((float) count));
+	float spacing = 640.0f / perRow;
+
+	Transforms.Count = 0;
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		TransformBatch_Add(
+			&Transforms,
+			(i % perRow) * spacing + (spacing * 0.5f),
+			(i / perRow) * spacing * 0.75f + (spacing * 0.5f),
+			0,
+			(float) i * 0.01f,
+			spacing * 0.4f
+		);
+	}
+
+	AccumulatedCPUTicks = 0;
+	AccumulatedFrameTime = 0;
+	AccumulatedFrames = 0;
+
+	SDL_Log(
+		"%s path, %u objects",
+		UseBatchedPath ? "Batched SoA + instanced" : "Per-draw uniform push",
+		count
+	);
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Create the shaders
+	SDL_GPUShader* perDrawVertexShader = LoadShader(context->Device, "PositionColorTransform.vert", 0, 1, 0, 0);
+	if (perDrawVertexShader == NULL)
+	{
+		SDL_Log("Failed to create per-draw vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* instancedVertexShader = LoadShader(context->Device, "PositionColorInstancedTransform.vert", 0, 0, 1, 0);
+	if (instancedVertexShader == NULL)
+	{
+		SDL_Log("Failed to create instanced vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	// Create the pipelines
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.vertex_input_state = (SDL_GPUVertexInputState){
+			.num_vertex_buffers = 1,
+			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+				.slot = 0,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+				.instance_step_rate = 0,
+				.pitch = sizeof(PositionColorVertex)
+			}},
+			.num_vertex_attributes = 2,
+			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+				.location = 0,
+				.offset = 0
+			}, {
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+				.location = 1,
+				.offset = sizeof(float) * 3
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = perDrawVertexShader,
+		.fragment_shader = fragmentShader
+	};
+
+	PerDrawPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (PerDrawPipeline == NULL)
+	{
+		SDL_Log("Failed to create per-draw pipeline!");
+		return -1;
+	}
+
+	pipelineCreateInfo.vertex_shader = instancedVertexShader;
+	InstancedPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (InstancedPipeline == NULL)
+	{
+		SDL_Log("Failed to create instanced pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, perDrawVertexShader);
+	SDL_ReleaseGPUShader(context->Device, instancedVertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	// Create the GPU resources
+	Uint32 maxObjects = ObjectCounts[SDL_arraysize(ObjectCounts) - 1];
+
+	VertexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = sizeof(PositionColorVertex) * 4
+		}
+	);
+
+	IndexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = sizeof(Uint16) * 6
+		}
+	);
+
+	TransformBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			.size = sizeof(Matrix4x4) * maxObjects
+		}
+	);
+
+	TransformTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = sizeof(Matrix4x4) * maxObjects
+		}
+	);
+
+	if (!TransformBatch_Init(&Transforms, maxObjects))
+	{
+		return -1;
+	}
+
+	// Set up the quad geometry
+	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = (sizeof(PositionColorVertex) * 4) + (sizeof(Uint16) * 6)
+		}
+	);
+
+	PositionColorVertex* transferData = SDL_MapGPUTransferBuffer(
+		context->Device,
+		transferBuffer,
+		false
+	);
+
+	transferData[0] = (PositionColorVertex) { -1, -1, 0, 255,   0,   0, 255 };
+	transferData[1] = (PositionColorVertex) {  1, -1, 0,   0, 255,   0, 255 };
+	transferData[2] = (PositionColorVertex) {  1,  1, 0,   0,   0, 255, 255 };
+	transferData[3] = (PositionColorVertex) { -1,  1, 0, 255, 255, 255, 255 };
+
+	Uint16* indexData = (Uint16*) &transferData[4];
+	indexData[0] = 0;
+	indexData[1] = 1;
+	indexData[2] = 2;
+	indexData[3] = 0;
+	indexData[4] = 2;
+	indexData[5] = 3;
+
+	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = transferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = VertexBuffer,
+			.offset = 0,
+			.size = sizeof(PositionColorVertex) * 4
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = transferBuffer,
+			.offset = sizeof(PositionColorVertex) * 4
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = IndexBuffer,
+			.offset = 0,
+			.size = sizeof(Uint16) * 6
+		},
+		false
+	);
+
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+
+	// Print the instructions
+	SDL_Log("Press Left/Right to switch between per-draw and batched transforms");
+	SDL_Log("Press Up/Down to change the object count");
+
+	ResetObjects();
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	bool changed = false;
+
+	if (context->LeftPressed || context->RightPressed)
+	{
+		UseBatchedPath = !UseBatchedPath;
+		changed = true;
+	}
+
+	if (context->UpPressed)
+	{
+		ObjectCountIndex = (ObjectCountIndex + 1) % SDL_arraysize(ObjectCounts);
+		changed = true;
+	}
+	else if (context->DownPressed)
+	{
+		ObjectCountIndex -= 1;
+		if (ObjectCountIndex < 0)
+		{
+			ObjectCountIndex = SDL_arraysize(ObjectCounts) - 1;
+		}
+		changed = true;
+	}
+
+	if (changed)
+	{
+		ResetObjects();
+	}
+
+	for (Uint32 i = 0; i < Transforms.Count; i += 1)
+	{
+		Transforms.RotationZ[i] += context->DeltaTime;
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	Uint64 cpuStart = SDL_GetPerformanceCounter();
+
+	Matrix4x4 viewProjection = Matrix4x4_CreateOrthographicOffCenter(
+		0,
+		640,
+		480,
+		0,
+		0,
+		-1
+	);
+
+    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+    if (cmdbuf == NULL)
+    {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GPUTexture* swapchainTexture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        return -1;
+    }
+
+	if (swapchainTexture != NULL)
+	{
+		if (UseBatchedPath)
+		{
+			// Compute every WVP matrix in one pass, straight into the mapped transfer buffer
+			Matrix4x4* mapped = SDL_MapGPUTransferBuffer(
+				context->Device,
+				TransformTransferBuffer,
+				true
+			);
+			TransformBatch_Compute(&Transforms, &viewProjection, NULL, mapped);
+			SDL_UnmapGPUTransferBuffer(context->Device, TransformTransferBuffer);
+
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) {
+					.transfer_buffer = TransformTransferBuffer,
+					.offset = 0
+				},
+				&(SDL_GPUBufferRegion) {
+					.buffer = TransformBuffer,
+					.offset = 0,
+					.size = sizeof(Matrix4x4) * Transforms.Count
+				},
+				true
+			);
+			SDL_EndGPUCopyPass(copyPass);
+		}
+
+		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+		colorTargetInfo.texture = swapchainTexture;
+		colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
+		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+
+		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ .buffer = VertexBuffer, .offset = 0 }, 1);
+		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer, .offset = 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+
+		if (UseBatchedPath)
+		{
+			SDL_BindGPUGraphicsPipeline(renderPass, InstancedPipeline);
+			SDL_BindGPUVertexStorageBuffers(renderPass, 0, &TransformBuffer, 1);
+			SDL_DrawGPUIndexedPrimitives(renderPass, 6, Transforms.Count, 0, 0, 0);
+		}
+		else
+		{
+			SDL_BindGPUGraphicsPipeline(renderPass, PerDrawPipeline);
+			for (Uint32 i = 0; i < Transforms.Count; i += 1)
+			{
+				Matrix4x4 matrixUniform = Matrix4x4_Multiply(
+					Matrix4x4_Multiply(
+						Matrix4x4_Multiply(
+							Matrix4x4_CreateScale(Transforms.ScaleX[i], Transforms.ScaleY[i], Transforms.ScaleZ[i]),
+							Matrix4x4_CreateRotationZ(Transforms.RotationZ[i])
+						),
+						Matrix4x4_CreateTranslation(Transforms.PositionX[i], Transforms.PositionY[i], Transforms.PositionZ[i])
+					),
+					viewProjection
+				);
+				SDL_PushGPUVertexUniformData(cmdbuf, 0, &matrixUniform, sizeof(matrixUniform));
+				SDL_DrawGPUIndexedPrimitives(renderPass, 6, 1, 0, 0, 0);
+			}
+		}
+
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	// Report averaged timings once per second
+	AccumulatedCPUTicks += SDL_GetPerformanceCounter() - cpuStart;
+	AccumulatedFrameTime += context->DeltaTime;
+	AccumulatedFrames += 1;
+	if (AccumulatedFrameTime >= 1.0f)
+	{
+		double cpuMs = (double) AccumulatedCPUTicks * 1000.0 / SDL_GetPerformanceFrequency() / AccumulatedFrames;
+		SDL_Log(
+			"%s, %u objects: CPU %.3f ms/frame, frame %.3f ms",
+			UseBatchedPath ? "Batched" : "Per-draw",
+			Transforms.Count,
+			cpuMs,
+			AccumulatedFrameTime * 1000.0f / AccumulatedFrames
+		);
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, PerDrawPipeline);
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, InstancedPipeline);
+	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, TransformBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, TransformTransferBuffer);
+
+	TransformBatch_Destroy(&Transforms);
+
+	ObjectCountIndex = 0;
+	UseBatchedPath = true;
+
+	CommonQuit(context);
+}
+
+Example BatchedTransforms_Example = { "BatchedTransforms", Init, Update, Draw, Quit };
@@ -83,15 +83,18 @@ static int Init(Context* context)
 		}
 	);
 
-	SourceTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
-		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
-		.type = SDL_GPU_TEXTURETYPE_CUBE,
-		.width = 32,
-		.height = 32,
-		.layer_count_or_depth = 6,
-		.num_levels = 1,
-		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
-	});
+	// Load all six faces in parallel and upload them in one pass
+	const char* imageNames[] = {
+		"cube0.bmp", "cube1.bmp", "cube2.bmp",
+		"cube3.bmp", "cube4.bmp", "cube5.bmp",
+	};
+
+	SourceTexture = LoadCubemap(context->Device, imageNames, 1, 0, NULL);
+	if (SourceTexture == NULL)
+	{
+		SDL_Log("Could not load image data!");
+		return -1;
+	}
 
 	DestinationTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
 		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
@@ -170,38 +173,6 @@ static int Init(Context* context)
 
 	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
 
-	// Set up texture data
-	const Uint32 bytesPerImage = 32 * 32 * 4;
-	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
-		context->Device,
-		&(SDL_GPUTransferBufferCreateInfo) {
-			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = bytesPerImage * 6
-		}
-	);
-	Uint8* textureTransferData = SDL_MapGPUTransferBuffer(
-		context->Device,
-		textureTransferBuffer,
-		false
-	);
-
-	const char* imageNames[] = {
-		"cube0.bmp", "cube1.bmp", "cube2.bmp",
-		"cube3.bmp", "cube4.bmp", "cube5.bmp",
-	};
-
-	for (int i = 0; i < SDL_arraysize(imageNames); i += 1) {
-		SDL_Surface* imageData = LoadImage(imageNames[i], 4);
-		if (imageData == NULL)
-		{
-			SDL_Log("Could not load image data!");
-			return -1;
-		}
-		SDL_memcpy(textureTransferData + (bytesPerImage * i), imageData->pixels, bytesPerImage);
-		SDL_DestroySurface(imageData);
-	}
-	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
-
 	// Upload the transfer data to the GPU buffers
 	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
 	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
@@ -234,24 +205,6 @@ static int Init(Context* context)
 		false
 	);
 
-	for (int i = 0; i < 6; i += 1) {
-		SDL_UploadToGPUTexture(
-			copyPass,
-			&(SDL_GPUTextureTransferInfo) {
-				.transfer_buffer = textureTransferBuffer,
-				.offset = bytesPerImage * i
-			},
-			&(SDL_GPUTextureRegion) {
-				.texture = SourceTexture,
-				.layer = i,
-				.w = 32,
-				.h = 32,
-				.d = 1,
-			},
-			false
-		);
-	}
-
 	SDL_EndGPUCopyPass(copyPass);
 
 	// Blit to destination texture.
@@ -275,7 +228,6 @@ static int Init(Context* context)
 	}
 
 	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
-	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
 
 	SDL_SubmitGPUCommandBuffer(cmdbuf);
 
@@ -0,0 +1,172 @@
+#include "Common.h"
+
+#if CPU_PROFILER_ENABLED
+
+/* Claiming a ring is a compare-and-swap, and after that a thread finds its own through TLS.
+ * Recording a zone takes no locks: only the owner writes a ring, and it publishes each event
+ * by bumping Count.
+ */
+static CPUProfilerThread Threads[CPU_PROFILER_MAX_THREADS];
+static SDL_TLSID ThreadSlot;
+
+static void ReleaseThread(void* value)
+{
+	CPUProfilerThread* thread = value;
+	SDL_SetAtomicInt(&thread->InUse, 0);
+}
+
+static CPUProfilerThread* GetThread(void)
+{
+	CPUProfilerThread* thread = SDL_GetTLS(&ThreadSlot);
+	if (thread != NULL)
+	{
+		return thread;
+	}
+
+	for (Uint32 i = 0; i < CPU_PROFILER_MAX_THREADS; i += 1)
+	{
+		thread = &Threads[i];
+		if (!SDL_CompareAndSwapAtomicInt(&thread->InUse, 0, 1))
+		{
+			continue;
+		}
+
+		/* Rings outlive their threads, so an exited thread's zones are written out until another thread claims its slot */
+		if (thread->Events == NULL)
+		{
+			thread->Events = SDL_malloc(CPU_PROFILER_RING_SIZE * sizeof(CPUProfilerEvent));
+			if (thread->Events == NULL)
+			{
+				SDL_SetAtomicInt(&thread->InUse, 0);
+				return NULL;
+			}
+		}
+
+		SDL_SetAtomicU32(&thread->Count, 0);
+		thread->ThreadID = SDL_GetCurrentThreadID();
+		thread->Name = NULL;
+		SDL_SetTLS(&ThreadSlot, thread, ReleaseThread);
+		return thread;
+	}
+
+	/* Every ring is taken, so this thread's zones are dropped */
+	return NULL;
+}
+
+CPUZone CPUProfiler_BeginZone(const char* name, const char* detail)
+{
+	return (CPUZone){ name, detail, SDL_GetTicksNS() };
+}
+
+void CPUProfiler_EndZone(const CPUZone* zone)
+{
+	Uint64 endNS = SDL_GetTicksNS();
+	CPUProfilerThread* thread = GetThread();
+	if (thread == NULL)
+	{
+		return;
+	}
+
+	Uint32 count = SDL_GetAtomicU32(&thread->Count);
+	CPUProfilerEvent* event = &thread->Events[count & (CPU_PROFILER_RING_SIZE - 1)];
+	event->Name = zone->Name;
+	SDL_strlcpy(event->Detail, zone->Detail != NULL ? zone->Detail : "", sizeof(event->Detail));
+	event->StartNS = zone->StartNS;
+	event->DurationNS = endNS - zone->StartNS;
+	SDL_SetAtomicU32(&thread->Count, count + 1);
+}
+
+void CPUProfiler_NameThread(const char* name)
+{
+	CPUProfilerThread* thread = GetThread();
+	if (thread != NULL)
+	{
+		thread->Name = name;
+	}
+}
+
+bool CPUProfiler_WriteTrace(const char* filename)
+{
+	char path[1024];
+	char* prefPath = SDL_GetPrefPath("SDL", "SDL_gpu_examples");
+	SDL_snprintf(path, sizeof(path), "%s%s", prefPath ? prefPath : "", filename);
+	SDL_free(prefPath);
+
+	SDL_IOStream* stream = SDL_IOFromFile(path, "w");
+	if (stream == NULL)
+	{
+		SDL_Log("Couldn't open %s: %s", path, SDL_GetError());
+		return false;
+	}
+
+	/* Timestamps are in microseconds since SDL started, the same on every thread */
+	Uint32 eventCount = 0;
+	SDL_IOprintf(stream, "{\"traceEvents\":[\n");
+	SDL_IOprintf(stream, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"SDL_gpu_examples\"}}");
+
+	for (Uint32 i = 0; i < CPU_PROFILER_MAX_THREADS; i += 1)
+	{
+		CPUProfilerThread* thread = &Threads[i];
+		Uint32 count = SDL_GetAtomicU32(&thread->Count);
+		if (count == 0)
+		{
+			continue;
+		}
+
+		char threadName[64];
+		if (thread->Name != NULL)
+		{
+			SDL_strlcpy(threadName, thread->Name, sizeof(threadName));
+		}
+		else
+		{
+			SDL_snprintf(threadName, sizeof(threadName), "Thread %llu", (unsigned long long) thread->ThreadID);
+		}
+		SDL_IOprintf(stream, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", i + 1);
+		WriteJSONString(stream, threadName);
+		SDL_IOprintf(stream, "}}");
+
+		Uint32 kept = SDL_min(count, CPU_PROFILER_RING_SIZE);
+		for (Uint32 j = count - kept; j != count; j += 1)
+		{
+			const CPUProfilerEvent* event = &thread->Events[j & (CPU_PROFILER_RING_SIZE - 1)];
+			SDL_IOprintf(stream, ",\n{\"name\":");
+			WriteJSONString(stream, event->Name);
+			SDL_IOprintf(
+				stream,
+				",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+				i + 1,
+				event->StartNS / 1e3,
+				event->DurationNS / 1e3
+			);
+			if (event->Detail[0] != '\0')
+			{
+				SDL_IOprintf(stream, ",\"args\":{\"detail\":");
+				WriteJSONString(stream, event->Detail);
+				SDL_IOprintf(stream, "}");
+			}
+			SDL_IOprintf(stream, "}");
+		}
+		eventCount += kept;
+	}
+
+	SDL_IOprintf(stream, "\n]}\n");
+	SDL_CloseIO(stream);
+
+	SDL_Log("Wrote %u CPU zones to %s", eventCount, path);
+	return true;
+}
+
+#else
+
+void CPUProfiler_NameThread(const char* name)
+{
+}
+
+bool CPUProfiler_WriteTrace(const char* filename)
+{
+	SDL_Log("Built with CPU_PROFILER_ENABLED=0, so there are no CPU zones to write");
+	return false;
+}
+
+#endif
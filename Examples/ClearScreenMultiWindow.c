@@ -1,6 +1,109 @@
 #include "Common.h"
 
-static SDL_Window* SecondWindow = NULL;
+/* Each window draws a GRID_SIZE x GRID_SIZE grid of triangles, one draw each,
+ * to give its worker thread some recording to do.
+ */
+#define GRID_SIZE 16
+#define INITIAL_WINDOW_COUNT 2
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static MultiWindowPresenter Presenter;
+static SDL_Window* Windows[MULTI_WINDOW_MAX_WINDOWS];
+
+/* Window queries belong on the main thread, so Update fills these in for the workers */
+static SDL_Point WindowSizes[MULTI_WINDOW_MAX_WINDOWS];
+
+static const SDL_FColor ClearColors[MULTI_WINDOW_MAX_WINDOWS] =
+{
+	{ 0.3f, 0.4f, 0.5f, 1.0f },
+	{ 1.0f, 0.5f, 0.6f, 1.0f },
+	{ 0.4f, 0.7f, 0.3f, 1.0f },
+	{ 0.9f, 0.8f, 0.3f, 1.0f },
+	{ 0.5f, 0.3f, 0.8f, 1.0f },
+	{ 0.2f, 0.7f, 0.7f, 1.0f },
+	{ 0.8f, 0.4f, 0.2f, 1.0f },
+	{ 0.6f, 0.6f, 0.6f, 1.0f }
+};
+
+/* Called on the window's worker thread */
+static void RecordWindow(SDL_GPUCommandBuffer* cmdbuf, SDL_GPUTexture* target, Uint32 windowIndex, void* userdata)
+{
+	SDL_Point size = WindowSizes[windowIndex];
+
+	SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+	colorTargetInfo.texture = target;
+	colorTargetInfo.clear_color = ClearColors[windowIndex];
+	colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+	colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+	SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+
+	float cellWidth = (float) size.x / GRID_SIZE;
+	float cellHeight = (float) size.y / GRID_SIZE;
+	for (int y = 0; y < GRID_SIZE; y += 1)
+	{
+		for (int x = 0; x < GRID_SIZE; x += 1)
+		{
+			SDL_SetGPUViewport(renderPass, &(SDL_GPUViewport){ x * cellWidth, y * cellHeight, cellWidth, cellHeight, 0, 1 });
+			SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+		}
+	}
+
+	SDL_EndGPURenderPass(renderPass);
+}
+
+static bool AddWindow(Context* context)
+{
+	Uint32 index = Presenter.WindowCount;
+	SDL_Window* window = context->Window;
+
+	if (index > 0)
+	{
+		char title[64];
+		SDL_snprintf(title, sizeof(title), "ClearScreenMultiWindow (%u)", index + 1);
+		window = SDL_CreateWindow(title, 640, 480, 0);
+		if (window == NULL)
+		{
+			SDL_Log("CreateWindow failed: %s", SDL_GetError());
+			return false;
+		}
+
+		if (!SDL_ClaimWindowForGPUDevice(context->Device, window))
+		{
+			SDL_Log("GPUClaimWindow failed");
+			SDL_DestroyWindow(window);
+			return false;
+		}
+	}
+
+	Windows[index] = window;
+	if (!MultiWindowPresenter_AddWindow(&Presenter, window))
+	{
+		if (index > 0)
+		{
+			SDL_ReleaseWindowFromGPUDevice(context->Device, window);
+			SDL_DestroyWindow(window);
+		}
+		Windows[index] = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+static void RemoveWindow(Context* context)
+{
+	SDL_Window* window = MultiWindowPresenter_RemoveWindow(&Presenter);
+	Windows[Presenter.WindowCount] = NULL;
+
+	// The main window belongs to CommonQuit
+	if (window != NULL && window != context->Window)
+	{
+		SDL_ReleaseWindowFromGPUDevice(context->Device, window);
+		SDL_DestroyWindow(window);
+	}
+}
 
 static int Init(Context* context)
 {
@@ -10,81 +113,101 @@ static int Init(Context* context)
 		return result;
 	}
 
-	SecondWindow = SDL_CreateWindow("ClearScreenMultiWindow (2)", 640, 480, 0);
-	if (SecondWindow == NULL)
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
 	{
-		SDL_Log("CreateWindow failed: %s", SDL_GetError());
+		SDL_Log("Failed to create vertex shader!");
 		return -1;
 	}
 
-	if (!SDL_ClaimWindowForGPUDevice(context->Device, SecondWindow))
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
 	{
-		SDL_Log("GPUClaimWindow failed");
+		SDL_Log("Failed to create fragment shader!");
 		return -1;
 	}
 
-	return 0;
-}
+	// Every window gets the device's default swapchain format, which the presenter's targets match
+	Pipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+	if (Pipeline == NULL)
+	{
+		SDL_Log("Failed to create pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	if (!MultiWindowPresenter_Init(&Presenter, context->Device, RecordWindow, NULL))
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < INITIAL_WINDOW_COUNT; i += 1)
+	{
+		if (!AddWindow(context))
+		{
+			return -1;
+		}
+	}
+
+	SDL_Log("Press Up/Down to add/remove a window, up to %d", MULTI_WINDOW_MAX_WINDOWS);
 
-static int Update(Context* context)
-{
 	return 0;
 }
 
-static int Draw(Context* context)
+static int Update(Context* context)
 {
-    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
-    if (cmdbuf == NULL)
-    {
-        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
-        return -1;
-    }
-
-    SDL_GPUTexture* swapchainTexture;
-    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
-        SDL_Log("AcquireGpuSwapchainTexture failed: %s", SDL_GetError());
-        return -1;
-    }
-
-	if (swapchainTexture != NULL)
+	if (context->UpPressed && Presenter.WindowCount < MULTI_WINDOW_MAX_WINDOWS)
 	{
-		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
-		colorTargetInfo.texture = swapchainTexture;
-		colorTargetInfo.clear_color = (SDL_FColor){ 0.3f, 0.4f, 0.5f, 1.0f };
-		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
-
-		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
-		SDL_EndGPURenderPass(renderPass);
+		if (AddWindow(context))
+		{
+			SDL_Log("%u windows", Presenter.WindowCount);
+		}
 	}
 
-	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, SecondWindow, &swapchainTexture)) {
-		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
-		return -1;
+	if (context->DownPressed && Presenter.WindowCount > 1)
+	{
+		RemoveWindow(context);
+		SDL_Log("%u windows", Presenter.WindowCount);
 	}
 
-	if (swapchainTexture != NULL)
+	for (Uint32 i = 0; i < Presenter.WindowCount; i += 1)
 	{
-		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
-		colorTargetInfo.texture = swapchainTexture;
-		colorTargetInfo.clear_color = (SDL_FColor){ 1.0f, 0.5f, 0.6f, 1.0f };
-		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
-
-		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
-		SDL_EndGPURenderPass(renderPass);
+		SDL_GetWindowSizeInPixels(Windows[i], &WindowSizes[i].x, &WindowSizes[i].y);
 	}
 
-	SDL_SubmitGPUCommandBuffer(cmdbuf);
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	if (!MultiWindowPresenter_Present(&Presenter))
+	{
+		return -1;
+	}
 
 	return 0;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseWindowFromGPUDevice(context->Device, SecondWindow);
-	SDL_DestroyWindow(SecondWindow);
-	SecondWindow = NULL;
+	// The pipeline belongs to the state cache, which CommonQuit releases
+	while (Presenter.WindowCount > 0)
+	{
+		RemoveWindow(context);
+	}
+	MultiWindowPresenter_Destroy(&Presenter);
 
 	CommonQuit(context);
 }
@@ -12,7 +12,9 @@
 
 int CommonInit(Context* context, SDL_WindowFlags windowFlags)
 {
+	CPU_ZONE_BEGIN(zone, "CreateGPUDevice", NULL);
 	context->Device = SDL_CreateGPUDevice(SDL_ShaderCross_GetSPIRVShaderFormats(), true, NULL);
+	CPU_ZONE_END(zone);
 	if (context->Device == NULL)
 	{
 		SDL_Log("GPUCreateDevice failed");
@@ -32,11 +34,15 @@ int CommonInit(Context* context, SDL_WindowFlags windowFlags)
 		return -1;
 	}
 
+	InitializeStateCache(context->Device, context->ExampleName);
+
 	return 0;
 }
 
 void CommonQuit(Context* context)
 {
+	ReleaseRenderTargetPool(context->Device);
+	ReleaseStateCache(context->Device);
 	SDL_ReleaseWindowFromGPUDevice(context->Device, context->Window);
 	SDL_DestroyWindow(context->Window);
 	SDL_DestroyGPUDevice(context->Device);
@@ -46,9 +52,90 @@ static const char* BasePath = NULL;
 void InitializeAssetLoader()
 {
 	BasePath = SDL_GetBasePath();
+
+	/* Prefer the packed archive, loose files under Content/ are still used for anything it lacks */
+	char archivePath[256];
+	SDL_PathInfo info;
+	SDL_snprintf(archivePath, sizeof(archivePath), "%sContent.pak", BasePath);
+	if (SDL_GetPathInfo(archivePath, &info))
+	{
+		OpenAssetArchive(archivePath);
+	}
 }
 
-SDL_GPUShader* LoadShader(
+/* Returns the contents of Content/<name>, either pointing into the asset archive or
+ * read from disk into *pAllocation, which the caller must SDL_free (NULL is fine).
+ */
+static const void* LoadContentFile(const char* name, size_t* pSize, void** pAllocation)
+{
+	Asset asset;
+	if (FindAsset(name, &asset) && asset.Type == ASSETTYPE_RAW)
+	{
+		*pAllocation = NULL;
+		*pSize = asset.Size;
+		return asset.Data;
+	}
+
+	char fullPath[256];
+	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/%s", BasePath, name);
+	*pAllocation = SDL_LoadFile(fullPath, pSize);
+	return *pAllocation;
+}
+
+static ShaderFlavor CurrentShaderFlavor = SHADERFLAVOR_OPTIMIZED;
+void SetShaderFlavor(ShaderFlavor flavor)
+{
+	CurrentShaderFlavor = flavor;
+}
+
+/* Loads Shaders/<flavor>/<file>.spv for a shader or variant name, see ParseShaderVariantName.
+ * Variants are specialized in a private copy, so *pAllocation is never NULL for them.
+ */
+static const void* LoadShaderCode(const char* shaderFilename, size_t* pSize, void** pAllocation)
+{
+	char filename[128];
+	SpecializationConstant constants[MAX_SPECIALIZATION_CONSTANTS];
+	Uint32 constantCount;
+	if (!ParseShaderVariantName(shaderFilename, filename, sizeof(filename), constants, &constantCount))
+	{
+		return NULL;
+	}
+
+	/* The optimized flavor only exists when the build found spirv-opt */
+	char name[256];
+	const void* code = NULL;
+	if (CurrentShaderFlavor == SHADERFLAVOR_OPTIMIZED)
+	{
+		SDL_snprintf(name, sizeof(name), "Shaders/Optimized/%s.spv", filename);
+		code = LoadContentFile(name, pSize, pAllocation);
+	}
+	if (code == NULL)
+	{
+		SDL_snprintf(name, sizeof(name), "Shaders/Compiled/%s.spv", filename);
+		code = LoadContentFile(name, pSize, pAllocation);
+	}
+	if (code == NULL || constantCount == 0)
+	{
+		return code;
+	}
+
+	/* Archived code is read-only */
+	if (*pAllocation == NULL)
+	{
+		*pAllocation = SDL_malloc(*pSize);
+		SDL_memcpy(*pAllocation, code, *pSize);
+	}
+
+	if (!SpecializeShader(shaderFilename, *pAllocation, *pSize, constants, constantCount))
+	{
+		SDL_free(*pAllocation);
+		*pAllocation = NULL;
+		return NULL;
+	}
+	return *pAllocation;
+}
+
+static SDL_GPUShader* CreateShaderFromFile(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
 	Uint32 samplerCount,
@@ -72,17 +159,32 @@ SDL_GPUShader* LoadShader(
 		return NULL;
 	}
 
-	char fullPath[256];
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/%s.spv", BasePath, shaderFilename);
-
 	size_t codeSize;
-	void* code = SDL_LoadFile(fullPath, &codeSize);
+	void* allocation;
+	const void* code = LoadShaderCode(shaderFilename, &codeSize, &allocation);
 	if (code == NULL)
 	{
-		SDL_Log("Failed to load shader from disk! %s", fullPath);
+		SDL_Log("Failed to load shader from disk! %s", shaderFilename);
 		return NULL;
 	}
 
+	/* Fill in or check the counts against what the shader declares */
+	ShaderReflection reflection;
+	Uint64 hash;
+	if (GetShaderReflection(shaderFilename, code, codeSize, &reflection))
+	{
+		if (reflection.IsCompute || reflection.Stage != stage)
+		{
+			SDL_Log("%s's entry point doesn't match the stage in its name!", shaderFilename);
+		}
+		ApplyShaderReflection(shaderFilename, &reflection, &samplerCount, &uniformBufferCount, &storageBufferCount, &storageTextureCount);
+		hash = reflection.CodeHash;
+	}
+	else
+	{
+		hash = HashBytes(STATE_CACHE_HASH_SEED, code, codeSize);
+	}
+
 	SDL_GPUShaderCreateInfo shaderInfo = {
 		.code = code,
 		.code_size = codeSize,
@@ -94,93 +196,523 @@ SDL_GPUShader* LoadShader(
 		.num_storage_buffers = storageBufferCount,
 		.num_storage_textures = storageTextureCount
 	};
+	CPU_ZONE_BEGIN(compileZone, "CompileFromSPIRV", shaderFilename);
 	SDL_GPUShader* shader = SDL_ShaderCross_CompileFromSPIRV(device, &shaderInfo, false);
+	CPU_ZONE_END(compileZone);
 	if (shader == NULL)
 	{
 		SDL_Log("Failed to create shader!");
-		SDL_free(code);
+		SDL_free(allocation);
 		return NULL;
 	}
 
-	SDL_free(code);
+	/* Lets the pipeline cache recognize this shader by content, reusing the reflection's hash of the code */
+	hash = HashBytes(hash, &stage, sizeof(stage));
+	hash = HashBytes(hash, &samplerCount, sizeof(samplerCount));
+	hash = HashBytes(hash, &uniformBufferCount, sizeof(uniformBufferCount));
+	hash = HashBytes(hash, &storageBufferCount, sizeof(storageBufferCount));
+	hash = HashBytes(hash, &storageTextureCount, sizeof(storageTextureCount));
+	RegisterShaderIdentity(shader, hash, shaderFilename, samplerCount, uniformBufferCount, storageBufferCount, storageTextureCount);
+
+	SDL_free(allocation);
 	return shader;
 }
 
-SDL_GPUComputePipeline* CreateComputePipelineFromShader(
+SDL_GPUShader* LoadShader(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
-	SDL_GPUComputePipelineCreateInfo *createInfo
+	Uint32 samplerCount,
+	Uint32 uniformBufferCount,
+	Uint32 storageBufferCount,
+	Uint32 storageTextureCount
 ) {
-	char fullPath[256];
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Shaders/Compiled/%s.spv", BasePath, shaderFilename);
+	CPU_ZONE_BEGIN(zone, "LoadShader", shaderFilename);
+	SDL_GPUShader* shader = CreateShaderFromFile(
+		device,
+		shaderFilename,
+		samplerCount,
+		uniformBufferCount,
+		storageBufferCount,
+		storageTextureCount
+	);
+	CPU_ZONE_END(zone);
+	return shader;
+}
 
+static SDL_GPUComputePipeline* CreateComputePipelineFromFile(
+	SDL_GPUDevice* device,
+	const char* shaderFilename,
+	SDL_GPUComputePipelineCreateInfo *createInfo
+) {
 	size_t codeSize;
-	void* code = SDL_LoadFile(fullPath, &codeSize);
+	void* allocation;
+	const void* code = LoadShaderCode(shaderFilename, &codeSize, &allocation);
 	if (code == NULL)
 	{
-		SDL_Log("Failed to load compute shader from disk! %s", fullPath);
+		SDL_Log("Failed to load compute shader from disk! %s", shaderFilename);
 		return NULL;
 	}
 
 	// Make a copy of the create data, then overwrite the parts we need
 	SDL_GPUComputePipelineCreateInfo newCreateInfo = *createInfo;
+	ShaderReflection reflection;
+	if (GetShaderReflection(shaderFilename, code, codeSize, &reflection))
+	{
+		if (!reflection.IsCompute)
+		{
+			SDL_Log("%s is not a compute shader!", shaderFilename);
+		}
+		ApplyComputeShaderReflection(shaderFilename, &reflection, &newCreateInfo);
+	}
 	newCreateInfo.code = code;
 	newCreateInfo.code_size = codeSize;
 	newCreateInfo.entrypoint = "main";
 	newCreateInfo.format = SDL_GPU_SHADERFORMAT_SPIRV;
 
+	CPU_ZONE_BEGIN(compileZone, "CompileFromSPIRV", shaderFilename);
 	SDL_GPUComputePipeline* pipeline = SDL_ShaderCross_CompileFromSPIRV(device, &newCreateInfo, true);
+	CPU_ZONE_END(compileZone);
 	if (pipeline == NULL)
 	{
 		SDL_Log("Failed to create compute pipeline!");
-		SDL_free(code);
+		SDL_free(allocation);
 		return NULL;
 	}
 
-	SDL_free(code);
+	SDL_free(allocation);
+	return pipeline;
+}
+
+SDL_GPUComputePipeline* CreateComputePipelineFromShader(
+	SDL_GPUDevice* device,
+	const char* shaderFilename,
+	SDL_GPUComputePipelineCreateInfo *createInfo
+) {
+	CPU_ZONE_BEGIN(zone, "CreateComputePipelineFromShader", shaderFilename);
+	SDL_GPUComputePipeline* pipeline = CreateComputePipelineFromFile(device, shaderFilename, createInfo);
+	CPU_ZONE_END(zone);
 	return pipeline;
 }
 
 SDL_Surface* LoadImage(const char* imageFilename, int desiredChannels)
 {
-	char fullPath[256];
+	ImageFile image;
 	SDL_Surface *result;
-	SDL_PixelFormat format;
-
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
 
-	result = SDL_LoadBMP(fullPath);
-	if (result == NULL)
+	if (desiredChannels != 4)
 	{
-		SDL_Log("Failed to load BMP: %s", SDL_GetError());
+		SDL_assert(!"Unexpected desiredChannels");
 		return NULL;
 	}
 
-	if (desiredChannels == 4)
-	{
-		format = SDL_PIXELFORMAT_ABGR8888;
-	}
-	else
+	CPU_ZONE_BEGIN(zone, "LoadImage", imageFilename);
+	if (!OpenImage(imageFilename, &image))
 	{
-		SDL_assert(!"Unexpected desiredChannels");
-		SDL_DestroySurface(result);
+		CPU_ZONE_END(zone);
 		return NULL;
 	}
-	if (result->format != format)
+
+	result = SDL_CreateSurface(image.Width, image.Height, SDL_PIXELFORMAT_ABGR8888);
+	if (result != NULL && !DecodeImage(&image, result->pixels, result->pitch))
 	{
-		SDL_Surface *next = SDL_ConvertSurface(result, format);
 		SDL_DestroySurface(result);
-		result = next;
+		result = NULL;
 	}
 
+	CloseImage(&image);
+	CPU_ZONE_END(zone);
 	return result;
 }
 
+// Image Decoding
+
+static Uint32 ReadLE32(const Uint8* data)
+{
+	return (Uint32) data[0] | ((Uint32) data[1] << 8) | ((Uint32) data[2] << 16) | ((Uint32) data[3] << 24);
+}
+
+/* Byte offset of an 8-bit channel mask within a pixel, or -1 if the mask isn't one whole byte */
+static int GetMaskByteOffset(Uint32 mask)
+{
+	for (int i = 0; i < 4; i += 1)
+	{
+		if (mask == (0xFFu << (i * 8)))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+bool OpenImage(const char* imageFilename, ImageFile* image)
+{
+	char name[256];
+	SDL_zerop(image);
+
+	SDL_snprintf(name, sizeof(name), "Images/%s", imageFilename);
+
+	/* Archived BMPs are already top-down RGBA8, so decoding is a plain row copy */
+	Asset asset;
+	if (FindAsset(name, &asset) && asset.Type == ASSETTYPE_IMAGE_RGBA8)
+	{
+		if (asset.Width <= 0 || asset.Height <= 0 || (Uint64) asset.Width * (Uint64) asset.Height * 4 > asset.Size)
+		{
+			SDL_Log("Archived image %s is %dx%d but holds only %zu bytes", name, asset.Width, asset.Height, asset.Size);
+			return false;
+		}
+
+		image->Width = asset.Width;
+		image->Height = asset.Height;
+		image->FileData = asset.Data;
+		image->FileSize = asset.Size;
+		image->SourcePitch = asset.Width * 4;
+		image->BytesPerPixel = 4;
+		image->ChannelOffsets[0] = 0;
+		image->ChannelOffsets[1] = 1;
+		image->ChannelOffsets[2] = 2;
+		image->ChannelOffsets[3] = 3;
+		return true;
+	}
+
+	image->FileData = LoadContentFile(name, &image->FileSize, &image->Allocation);
+	if (image->FileData == NULL)
+	{
+		SDL_Log("Failed to load BMP: %s", SDL_GetError());
+		return false;
+	}
+
+	const Uint8* data = image->FileData;
+	if (image->FileSize < 54 || data[0] != 'B' || data[1] != 'M')
+	{
+		SDL_Log("Failed to load BMP: %s is not a BMP file", name);
+		CloseImage(image);
+		return false;
+	}
+
+	/* Everything below reads BITMAPINFOHEADER fields, older OS/2 core headers lay them out differently */
+	Uint32 headerSize = ReadLE32(&data[14]);
+	if (headerSize < 40 || 14 + (Uint64) headerSize > image->FileSize)
+	{
+		SDL_Log("Failed to load BMP: %s has an unsupported %u-byte header", name, headerSize);
+		CloseImage(image);
+		return false;
+	}
+
+	Sint32 width = (Sint32) ReadLE32(&data[18]);
+	Sint32 height = (Sint32) ReadLE32(&data[22]);
+	Uint32 bitsPerPixel = data[28] | (data[29] << 8);
+	Uint32 compression = ReadLE32(&data[30]);
+
+	if (width <= 0 || height == 0 || height == SDL_MIN_SINT32)
+	{
+		SDL_Log("Failed to load BMP: %s has invalid dimensions %dx%d", name, width, height);
+		CloseImage(image);
+		return false;
+	}
+
+	image->Width = width;
+	image->Height = height < 0 ? -height : height;
+	image->BottomUp = height > 0;
+	image->PixelOffset = ReadLE32(&data[10]);
+	image->BytesPerPixel = bitsPerPixel / 8;
+	image->SourcePitch = ((image->Width * bitsPerPixel + 31) / 32) * 4;
+
+	/* 24-bit is always BGR. BI_RGB 32-bit is BGRX: the fourth byte is unused, so alpha decodes as opaque
+	 * unless bitfields say otherwise. */
+	Uint32 masks[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0 };
+	bool hasBitfields = compression == 3 || compression == 6;
+	if (hasBitfields && image->FileSize >= 14 + 40 + 16)
+	{
+		/* Masks follow a 40-byte header, and are part of larger headers at the same offset */
+		masks[0] = ReadLE32(&data[54]);
+		masks[1] = ReadLE32(&data[58]);
+		masks[2] = ReadLE32(&data[62]);
+		masks[3] = (compression == 6 || headerSize >= 56) ? ReadLE32(&data[66]) : 0;
+	}
+
+	bool supported = (bitsPerPixel == 24 && compression == 0) || (bitsPerPixel == 32 && (compression == 0 || hasBitfields));
+	for (int c = 0; c < 4 && supported; c += 1)
+	{
+		image->ChannelOffsets[c] = GetMaskByteOffset(masks[c]);
+		/* Only alpha may be missing, it then decodes as opaque */
+		supported = image->ChannelOffsets[c] >= 0 || (c == 3 && masks[c] == 0);
+	}
+
+	if (supported && (Uint64) image->PixelOffset + ((Uint64) image->SourcePitch * image->Height) > image->FileSize)
+	{
+		SDL_Log("Failed to load BMP: %s is truncated", name);
+		CloseImage(image);
+		return false;
+	}
+
+	/* Palettized, RLE and 16-bit files go through SDL's decoder instead */
+	image->UseSurfaceFallback = !supported;
+
+	return true;
+}
+
+static int SwizzleRowScalar(const Uint8* src, Uint8* dst, int start, int width, int bytesPerPixel, const int offsets[4])
+{
+	for (int x = start; x < width; x += 1)
+	{
+		const Uint8* pixel = &src[x * bytesPerPixel];
+		Uint8* out = &dst[x * 4];
+		out[0] = pixel[offsets[0]];
+		out[1] = pixel[offsets[1]];
+		out[2] = pixel[offsets[2]];
+		out[3] = offsets[3] >= 0 ? pixel[offsets[3]] : 255;
+	}
+	return width;
+}
+
+#ifdef SDL_SSE4_1_INTRINSICS
+/* Any byte-aligned 24/32-bit layout, four pixels per shuffle. Returns the number of pixels written. */
+static int SDL_TARGETING("sse4.1") SwizzleRowSSE41(const Uint8* src, Uint8* dst, int width, int bytesPerPixel, Uint32 sourcePitch, const int offsets[4])
+{
+	SDL_ALIGNED(16) Uint8 shuffle[16];
+	for (int p = 0; p < 4; p += 1)
+	{
+		for (int c = 0; c < 4; c += 1)
+		{
+			shuffle[(p * 4) + c] = offsets[c] >= 0 ? (Uint8) ((p * bytesPerPixel) + offsets[c]) : 0x80;
+		}
+	}
+
+	__m128i mask = _mm_load_si128((const __m128i*) shuffle);
+	__m128i alpha = offsets[3] >= 0 ? _mm_setzero_si128() : _mm_set1_epi32((int) 0xFF000000);
+	int x = 0;
+
+	/* Each load reads 16 bytes, stop before it would cross the end of the stored row */
+	for (; x + 4 <= width && (Uint32) ((x * bytesPerPixel) + 16) <= sourcePitch; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((const __m128i*) &src[x * bytesPerPixel]);
+		_mm_storeu_si128((__m128i*) &dst[x * 4], _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha));
+	}
+
+	return x;
+}
+#endif
+
+#ifdef SDL_SSE2_INTRINSICS
+/* BGRA/BGRX to RGBA by swapping the red and blue bytes of each 32-bit pixel */
+static int SwizzleRowBGRASSE2(const Uint8* src, Uint8* dst, int width, bool opaque)
+{
+	__m128i greenAlphaMask = _mm_set1_epi32((int) 0xFF00FF00);
+	__m128i redBlueMask = _mm_set1_epi32(0x00FF00FF);
+	__m128i alpha = opaque ? _mm_set1_epi32((int) 0xFF000000) : _mm_setzero_si128();
+	int x = 0;
+
+	for (; x + 4 <= width; x += 4)
+	{
+		__m128i pixels = _mm_loadu_si128((const __m128i*) &src[x * 4]);
+		__m128i greenAlpha = _mm_and_si128(pixels, greenAlphaMask);
+		__m128i redBlue = _mm_and_si128(pixels, redBlueMask);
+		redBlue = _mm_or_si128(_mm_slli_epi32(redBlue, 16), _mm_srli_epi32(redBlue, 16));
+		_mm_storeu_si128((__m128i*) &dst[x * 4], _mm_or_si128(_mm_or_si128(greenAlpha, redBlue), alpha));
+	}
+
+	return x;
+}
+#endif
+
+static bool DecodeImageFallback(const ImageFile* image, Uint8* destination, Uint32 destinationPitch)
+{
+	SDL_Surface* surface = SDL_LoadBMP_IO(SDL_IOFromConstMem(image->FileData, image->FileSize), true);
+	if (surface == NULL)
+	{
+		SDL_Log("Failed to load BMP: %s", SDL_GetError());
+		return false;
+	}
+
+	if (surface->format != SDL_PIXELFORMAT_ABGR8888)
+	{
+		SDL_Surface *next = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
+		SDL_DestroySurface(surface);
+		surface = next;
+		if (surface == NULL)
+		{
+			SDL_Log("Failed to convert BMP: %s", SDL_GetError());
+			return false;
+		}
+	}
+
+	for (int y = 0; y < surface->h; y += 1)
+	{
+		SDL_memcpy(destination + (y * destinationPitch), (Uint8*) surface->pixels + (y * surface->pitch), surface->w * 4);
+	}
+
+	SDL_DestroySurface(surface);
+	return true;
+}
+
+bool DecodeImage(const ImageFile* image, void* destination, Uint32 destinationPitch)
+{
+	Uint8* dst = destination;
+
+	if (image->UseSurfaceFallback)
+	{
+		return DecodeImageFallback(image, dst, destinationPitch);
+	}
+
+	const int* offsets = image->ChannelOffsets;
+	bool isRGBA = image->BytesPerPixel == 4 && offsets[0] == 0 && offsets[1] == 1 && offsets[2] == 2 && offsets[3] == 3;
+#ifdef SDL_SSE2_INTRINSICS
+	bool isBGRA = image->BytesPerPixel == 4 && offsets[0] == 2 && offsets[1] == 1 && offsets[2] == 0 && offsets[3] != 1;
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+	bool hasSSE41 = SDL_HasSSE41();
+#endif
+
+	for (int y = 0; y < image->Height; y += 1)
+	{
+		int sourceRow = image->BottomUp ? (image->Height - 1 - y) : y;
+		const Uint8* src = image->FileData + image->PixelOffset + (sourceRow * image->SourcePitch);
+		Uint8* row = dst + (y * destinationPitch);
+		int x = 0;
+
+		if (isRGBA)
+		{
+			SDL_memcpy(row, src, image->Width * 4);
+			continue;
+		}
+
+#ifdef SDL_SSE4_1_INTRINSICS
+		if (hasSSE41)
+		{
+			x = SwizzleRowSSE41(src, row, image->Width, image->BytesPerPixel, image->SourcePitch, offsets);
+		}
+		else
+#endif
+#ifdef SDL_SSE2_INTRINSICS
+		if (isBGRA)
+		{
+			x = SwizzleRowBGRASSE2(src, row, image->Width, offsets[3] < 0);
+		}
+#endif
+
+		SwizzleRowScalar(src, row, x, image->Width, image->BytesPerPixel, offsets);
+	}
+
+	return true;
+}
+
+void CloseImage(ImageFile* image)
+{
+	SDL_free(image->Allocation);
+	SDL_zerop(image);
+}
+
+bool ImageExists(const char* imageFilename)
+{
+	char name[256];
+	SDL_snprintf(name, sizeof(name), "Images/%s", imageFilename);
+
+	Asset asset;
+	if (FindAsset(name, &asset))
+	{
+		return true;
+	}
+
+	char fullPath[256];
+	SDL_PathInfo info;
+	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/%s", BasePath, name);
+	return SDL_GetPathInfo(fullPath, &info) && info.type == SDL_PATHTYPE_FILE;
+}
+
 float* LoadHDRImage(const char* imageFilename, int* pWidth, int* pHeight, int* pChannels, int desiredChannels)
 {
+	char name[256];
+	SDL_snprintf(name, sizeof(name), "Images/%s", imageFilename);
+
+	size_t size;
+	void* allocation;
+	const void* data = LoadContentFile(name, &size, &allocation);
+	if (data == NULL)
+	{
+		return NULL;
+	}
+
+	float* result = stbi_loadf_from_memory(data, (int) size, pWidth, pHeight, pChannels, desiredChannels);
+	SDL_free(allocation);
+	return result;
+}
+
+static const char* CompressedFormatExtensions[] = { "bc1", "bc3", "bc7", "astc" };
+
+SDL_GPUTexture* LoadCompressedTexture(SDL_GPUDevice* device, const char* imageName, CompressedImage* pInfo)
+{
+	/* Best quality first */
+	static const CompressedFormat preference[] = {
+		COMPRESSEDFORMAT_BC7,
+		COMPRESSEDFORMAT_ASTC_4x4,
+		COMPRESSEDFORMAT_BC3,
+		COMPRESSEDFORMAT_BC1
+	};
+
 	char fullPath[256];
-	SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s", BasePath, imageFilename);
-	return stbi_loadf(fullPath, pWidth, pHeight, pChannels, desiredChannels);
+	CompressedImage image = { 0 };
+	bool loaded = false;
+	int bestSupported = -1;
+
+	for (int i = 0; i < SDL_arraysize(preference) && !loaded; i += 1)
+	{
+		SDL_GPUTextureFormat format = GetCompressedFormatGPUFormat(preference[i], false);
+		if (!SDL_GPUTextureSupportsFormat(device, format, SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+		{
+			continue;
+		}
+
+		if (bestSupported < 0)
+		{
+			bestSupported = i;
+		}
+
+		SDL_snprintf(fullPath, sizeof(fullPath), "%sContent/Images/%s.%s.ktx2", BasePath, imageName, CompressedFormatExtensions[preference[i]]);
+		loaded = LoadKTX2(fullPath, &image);
+	}
+
+	SDL_GPUTexture* texture = NULL;
+	if (!loaded)
+	{
+		SDL_snprintf(fullPath, sizeof(fullPath), "%s.bmp", imageName);
+		SDL_Surface* surface = LoadImage(fullPath, 4);
+		if (surface == NULL)
+		{
+			return NULL;
+		}
+
+		if (bestSupported >= 0)
+		{
+			loaded = EncodeCompressedImage(surface->pixels, surface->w, surface->h, preference[bestSupported], false, true, &image);
+		}
+
+		if (!loaded)
+		{
+			/* No block format available, upload as plain RGBA8 */
+			image.Format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
+			image.BlockFormat = COMPRESSEDFORMAT_COUNT;
+			image.Width = surface->w;
+			image.Height = surface->h;
+			image.LevelCount = 1;
+			image.LevelSizes[0] = surface->w * surface->h * 4;
+			image.DataSize = image.LevelSizes[0];
+			image.Data = SDL_malloc(image.DataSize);
+			SDL_memcpy(image.Data, surface->pixels, image.DataSize);
+		}
+
+		SDL_DestroySurface(surface);
+	}
+
+	texture = CreateTextureFromCompressedImage(device, &image);
+
+	if (pInfo != NULL)
+	{
+		*pInfo = image;
+		pInfo->Data = NULL;
+	}
+	FreeCompressedImage(&image);
+
+	return texture;
 }
 
 // Matrix Math
@@ -309,6 +841,16 @@ Matrix4x4 Matrix4x4_CreateTranslation(float x, float y, float z)
 	};
 }
 
+Matrix4x4 Matrix4x4_CreateScale(float x, float y, float z)
+{
+	return (Matrix4x4) {
+		x, 0, 0, 0,
+		0, y, 0, 0,
+		0, 0, z, 0,
+		0, 0, 0, 1
+	};
+}
+
 Matrix4x4 Matrix4x4_CreateOrthographicOffCenter(
 	float left,
 	float right,
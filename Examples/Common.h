@@ -13,6 +13,8 @@ typedef struct Context
 	bool RightPressed;
 	bool DownPressed;
 	bool UpPressed;
+	/* When the first key or button of this frame was pressed, 0 if none was */
+	Uint64 InputTimestampNS;
 	float DeltaTime;
 } Context;
 
@@ -23,6 +25,41 @@ void InitializeAssetLoader();
 SDL_Surface* LoadImage(const char* imageFilename, int desiredChannels);
 float* LoadHDRImage(const char* imageFilename, int* pWidth, int* pHeight, int* pChannels, int desiredChannels);
 
+/* Two-step image loading that decodes straight into caller memory:
+ * OpenImage reads the header so the caller can size and map a transfer buffer,
+ * then DecodeImage writes R8G8B8A8 rows destinationPitch bytes apart.
+ */
+typedef struct ImageFile
+{
+	int Width;
+	int Height;
+	const Uint8* FileData;
+	size_t FileSize;
+	void* Allocation;
+	Uint32 PixelOffset;
+	Uint32 SourcePitch;
+	int BytesPerPixel;
+	int ChannelOffsets[4];
+	bool BottomUp;
+	bool UseSurfaceFallback;
+} ImageFile;
+
+bool OpenImage(const char* imageFilename, ImageFile* image);
+bool DecodeImage(const ImageFile* image, void* destination, Uint32 destinationPitch);
+void CloseImage(ImageFile* image);
+/* Whether Images/<imageFilename> is in the asset archive or on disk, without loading it */
+bool ImageExists(const char* imageFilename);
+
+typedef enum ShaderFlavor
+{
+	SHADERFLAVOR_OPTIMIZED, /* Content/Shaders/Optimized when present, otherwise Compiled */
+	SHADERFLAVOR_DEBUG /* Content/Shaders/Compiled, straight from glslangValidator */
+} ShaderFlavor;
+
+void SetShaderFlavor(ShaderFlavor flavor);
+/* Resource counts and compute fields left at 0 are filled in from the shader's SPIR-V,
+ * and non-zero ones that disagree with it are logged and corrected.
+ */
 SDL_GPUShader* LoadShader(
 	SDL_GPUDevice* device,
 	const char* shaderFilename,
@@ -72,6 +109,7 @@ typedef struct Vector3
 Matrix4x4 Matrix4x4_Multiply(Matrix4x4 matrix1, Matrix4x4 matrix2);
 Matrix4x4 Matrix4x4_CreateRotationZ(float radians);
 Matrix4x4 Matrix4x4_CreateTranslation(float x, float y, float z);
+Matrix4x4 Matrix4x4_CreateScale(float x, float y, float z);
 Matrix4x4 Matrix4x4_CreateOrthographicOffCenter(float left, float right, float bottom, float top, float zNearPlane, float zFarPlane);
 Matrix4x4 Matrix4x4_CreatePerspectiveFieldOfView(float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance);
 Matrix4x4 Matrix4x4_CreateLookAt(Vector3 cameraPosition, Vector3 cameraTarget, Vector3 cameraUpVector);
@@ -79,6 +117,988 @@ Vector3 Vector3_Normalize(Vector3 vec);
 float Vector3_Dot(Vector3 vecA, Vector3 vecB);
 Vector3 Vector3_Cross(Vector3 vecA, Vector3 vecB);
 
+// Transform Batching
+typedef struct TransformBatch
+{
+	Uint32 Count;
+	Uint32 Capacity;
+	float* PositionX;
+	float* PositionY;
+	float* PositionZ;
+	float* RotationZ;
+	float* ScaleX;
+	float* ScaleY;
+	float* ScaleZ;
+} TransformBatch;
+
+bool TransformBatch_Init(TransformBatch* batch, Uint32 capacity);
+void TransformBatch_Destroy(TransformBatch* batch);
+Uint32 TransformBatch_Add(TransformBatch* batch, float x, float y, float z, float rotationZ, float scale);
+/* Computes World and World * viewProjection for every object in one pass.
+ * Either output may be NULL, and viewProjection is only read when wvpOut is set.
+ * The outputs can point straight into a mapped transfer buffer.
+ */
+void TransformBatch_Compute(
+	const TransformBatch* batch,
+	const Matrix4x4* viewProjection,
+	Matrix4x4* worldOut,
+	Matrix4x4* wvpOut
+);
+
+// Texture Compression
+#define COMPRESSED_IMAGE_MAX_LEVELS 16
+
+typedef enum CompressedFormat
+{
+	COMPRESSEDFORMAT_BC1,
+	COMPRESSEDFORMAT_BC3,
+	COMPRESSEDFORMAT_BC7,
+	COMPRESSEDFORMAT_ASTC_4x4,
+	COMPRESSEDFORMAT_COUNT
+} CompressedFormat;
+
+typedef struct CompressedImage
+{
+	SDL_GPUTextureFormat Format;
+	CompressedFormat BlockFormat;
+	bool SRGB;
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 LevelCount;
+	Uint32 LevelOffsets[COMPRESSED_IMAGE_MAX_LEVELS];
+	Uint32 LevelSizes[COMPRESSED_IMAGE_MAX_LEVELS];
+	Uint8* Data;
+	Uint32 DataSize;
+} CompressedImage;
+
+const char* GetCompressedFormatName(CompressedFormat format);
+SDL_GPUTextureFormat GetCompressedFormatGPUFormat(CompressedFormat format, bool srgb);
+/* Encodes tightly packed RGBA8 pixels, optionally with a box-filtered mip chain down to 1x1 */
+bool EncodeCompressedImage(
+	const Uint8* pixels,
+	Uint32 width,
+	Uint32 height,
+	CompressedFormat format,
+	bool srgb,
+	bool generateMipmaps,
+	CompressedImage* image
+);
+bool LoadKTX2(const char* path, CompressedImage* image);
+bool SaveKTX2(const char* path, const CompressedImage* image);
+void FreeCompressedImage(CompressedImage* image);
+SDL_GPUTexture* CreateTextureFromCompressedImage(SDL_GPUDevice* device, const CompressedImage* image);
+/* Loads Content/Images/<imageName>.<format>.ktx2 for the best format the device can sample,
+ * encoding <imageName>.bmp at runtime if no prebuilt file exists, and falling back to
+ * uncompressed R8G8B8A8 when no block format is supported. pInfo may be NULL; its Data is not kept.
+ */
+SDL_GPUTexture* LoadCompressedTexture(SDL_GPUDevice* device, const char* imageName, CompressedImage* pInfo);
+
+// State Caching
+#define STATE_CACHE_HASH_SEED 14695981039346656037ull
+
+typedef struct StateCacheStats
+{
+	Uint32 SamplerCount;
+	Uint32 SamplerHits;
+	Uint32 SamplerMisses;
+	Uint64 SamplerCreationNS;
+	Uint32 PipelineCount;
+	Uint32 PipelineHits;
+	Uint32 PipelineMisses;
+	Uint64 PipelineCreationNS;
+	Uint32 PrewarmedCount;
+	Uint32 WaitCount;
+	Uint64 WaitNS;
+} StateCacheStats;
+
+/* FNV-1a, seeded with STATE_CACHE_HASH_SEED or a previous result to hash several ranges */
+Uint64 HashBytes(Uint64 hash, const void* data, size_t size);
+/* Return a shared object for an identical create info, creating it on first use.
+ * The cache owns what it returns: don't release it, CommonQuit does. A failed creation
+ * returns NULL and isn't cached, so the next call for that create info tries again.
+ * Pipelines must use shaders from LoadShader, since shaders are matched by content.
+ */
+SDL_GPUSampler* GetCachedSampler(SDL_GPUDevice* device, const SDL_GPUSamplerCreateInfo* createInfo);
+SDL_GPUGraphicsPipeline* GetCachedGraphicsPipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* createInfo);
+/* Compute pipelines are keyed by shader filename, see CreateComputePipelineFromShader */
+SDL_GPUComputePipeline* GetCachedComputePipeline(SDL_GPUDevice* device, const char* shaderFilename, const SDL_GPUComputePipelineCreateInfo* createInfo);
+void RegisterShaderIdentity(
+	SDL_GPUShader* shader,
+	Uint64 hash,
+	const char* filename,
+	Uint32 samplerCount,
+	Uint32 uniformBufferCount,
+	Uint32 storageBufferCount,
+	Uint32 storageTextureCount
+);
+/* Starts a thread that creates the pipelines exampleName used on earlier runs,
+ * as recorded in PipelineManifest.txt in the pref path. Lookups for a pipeline
+ * the thread is still creating wait for it. ReleaseStateCache stops the thread.
+ */
+void InitializeStateCache(SDL_GPUDevice* device, const char* exampleName);
+void GetStateCacheStats(StateCacheStats* stats);
+void ReleaseStateCache(SDL_GPUDevice* device);
+
+// Shader Reflection
+typedef struct ShaderReflection
+{
+	Uint64 CodeHash;
+	bool IsCompute;
+	SDL_GPUShaderStage Stage;
+	Uint32 SamplerCount;
+	Uint32 UniformBufferCount;
+	/* For compute shaders these two count only the read-only resources */
+	Uint32 StorageBufferCount;
+	Uint32 StorageTextureCount;
+	Uint32 ReadWriteStorageBufferCount;
+	Uint32 ReadWriteStorageTextureCount;
+	Uint32 ThreadCount[3];
+} ShaderReflection;
+
+/* Parses a SPIR-V module and checks its bindings use the descriptor sets SDL_gpu expects */
+bool ReflectShader(const char* name, const void* code, size_t codeSize, ShaderReflection* reflection);
+/* Same as ReflectShader, but cached by filename so each shader is only parsed once */
+bool GetShaderReflection(const char* shaderFilename, const void* code, size_t codeSize, ShaderReflection* reflection);
+void ApplyShaderReflection(
+	const char* shaderFilename,
+	const ShaderReflection* reflection,
+	Uint32* pSamplerCount,
+	Uint32* pUniformBufferCount,
+	Uint32* pStorageBufferCount,
+	Uint32* pStorageTextureCount
+);
+void ApplyComputeShaderReflection(const char* shaderFilename, const ShaderReflection* reflection, SDL_GPUComputePipelineCreateInfo* createInfo);
+
+// Shader Variants
+#define MAX_SPECIALIZATION_CONSTANTS 8
+
+typedef struct SpecializationConstant
+{
+	Uint32 ID;
+	Uint32 Value;
+} SpecializationConstant;
+
+/* Splits a variant name like "ToneMap.comp:0=2,1=1" into the file name and constant values.
+ * LoadShader and CreateComputePipelineFromShader accept these names anywhere a file name goes.
+ */
+bool ParseShaderVariantName(
+	const char* variantName,
+	char* filename,
+	size_t filenameSize,
+	SpecializationConstant* constants,
+	Uint32* pConstantCount
+);
+/* Overwrites the defaults of the matching constant_id constants, ints and bools only */
+bool SpecializeShader(const char* name, void* code, size_t codeSize, const SpecializationConstant* constants, Uint32 constantCount);
+
+// Render Target Pool
+#define RENDER_TARGET_POOL_CAPACITY 64
+#define RENDER_TARGET_POOL_IDLE_FRAMES 4
+
+typedef struct RenderTargetDescription
+{
+	SDL_GPUTextureFormat Format;
+	Uint32 Width;
+	Uint32 Height;
+	SDL_GPUSampleCount SampleCount;
+	SDL_GPUTextureUsageFlags Usage;
+} RenderTargetDescription;
+
+typedef struct RenderTargetPoolStats
+{
+	Uint32 TargetCount;
+	Uint32 PeakTargetCount;
+	Uint64 Bytes;
+	Uint64 PeakBytes;
+	Uint64 PeakUnpooledBytes;
+	Uint32 AcquireCount;
+	Uint32 CreateCount;
+	Uint32 EvictCount;
+} RenderTargetPoolStats;
+
+/* Hands out a 2D single-level texture matching description exactly, reusing one that was
+ * released earlier in the frame or in a previous frame. Its contents are undefined, so clear
+ * or overwrite it, and bind it with cycle = false or SDL_gpu allocates a second copy behind it.
+ * Everything acquired is released at the end of the frame, and targets nobody acquired for
+ * RENDER_TARGET_POOL_IDLE_FRAMES frames, such as those of an old window size, are destroyed.
+ * PeakUnpooledBytes is what the busiest frame would have needed with a texture per acquire.
+ */
+SDL_GPUTexture* AcquireRenderTarget(SDL_GPUDevice* device, const RenderTargetDescription* description);
+void ReleaseRenderTarget(SDL_GPUTexture* texture);
+/* Called by the example loop after every Draw */
+void EndRenderTargetFrame(void);
+void GetRenderTargetPoolStats(RenderTargetPoolStats* stats);
+void ReleaseRenderTargetPool(SDL_GPUDevice* device);
+
+// GPU Profiling
+#define GPU_PROFILER_MAX_PENDING 128
+#define GPU_PROFILER_MAX_PASSES 32
+#define GPU_PROFILER_MAX_EVENTS 4096
+
+/* How the profiler tells time and waits for fences. The default uses SDL_GetTicksNS and the
+ * device's fences; a mock clock with made-up fences runs the profiler without a GPU.
+ */
+typedef struct GPUProfilerClock
+{
+	Uint64 (*Now)(void* userdata);
+	void (*Wait)(void* userdata, SDL_GPUFence* fence);
+	void (*Release)(void* userdata, SDL_GPUFence* fence);
+	void* Userdata;
+} GPUProfilerClock;
+
+typedef struct GPUPassRecord GPUPassRecord;
+/* Called on the watcher thread as each tracked pass completes, in submission order */
+typedef void (*GPUPassCallback)(void* userdata, const GPUPassRecord* record);
+
+struct GPUPassRecord
+{
+	const char* Name;
+	Uint64 Frame;
+	SDL_GPUFence* Fence;
+	Uint64 SubmitNS;
+	/* The later of SubmitNS and the previous pass's completion, when the GPU got to this one */
+	Uint64 StartNS;
+	Uint64 CompleteNS;
+	GPUPassCallback Callback;
+	void* Userdata;
+};
+
+typedef struct GPUPassStats
+{
+	const char* Name;
+	Uint32 Count;
+	Uint64 TotalNS;
+	Uint64 MinNS;
+	Uint64 MaxNS;
+	/* Since Init, for the summary Destroy logs */
+	Uint32 LifetimeCount;
+	Uint64 LifetimeNS;
+} GPUPassStats;
+
+typedef struct GPUTraceEvent
+{
+	const char* Name;
+	Uint64 Frame;
+	Uint64 StartNS;
+	Uint64 DurationNS;
+} GPUTraceEvent;
+
+typedef struct GPUProfiler
+{
+	SDL_GPUDevice* Device;
+	GPUProfilerClock Clock;
+	Uint64 Frame;
+	SDL_GPUCommandBuffer* OpenCommandBuffer;
+	const char* OpenName;
+
+	/* Submitted passes, in submission order. A watcher thread waits on each fence in turn
+	 * and stamps its completion; BeginFrame collects the stamped ones.
+	 */
+	SDL_Thread* Watcher;
+	SDL_Mutex* Lock;
+	SDL_Condition* Signal;
+	bool Quit;
+	GPUPassRecord Pending[GPU_PROFILER_MAX_PENDING];
+	Uint32 PendingRead;
+	Uint32 PendingCompleted;
+	Uint32 PendingCount;
+	/* Only the watcher touches it */
+	Uint64 LastCompleteNS;
+
+	GPUPassStats Passes[GPU_PROFILER_MAX_PASSES];
+	Uint32 PassCount;
+	GPUTraceEvent Events[GPU_PROFILER_MAX_EVENTS];
+	Uint32 EventWrite;
+	Uint32 EventCount;
+
+	Uint32 ReportFrames;
+	Uint64 LastReportNS;
+} GPUProfiler;
+
+/* SDL_gpu has no timestamp queries, so each timed pass is a command buffer of its own,
+ * submitted with a fence. The GPU runs command buffers in order, so a pass starts when it
+ * is submitted or when the one before it finishes, whichever is later, and ends when its
+ * fence signals. Per-pass averages are logged every two seconds, and the most recent
+ * GPU_PROFILER_MAX_EVENTS passes can be written out as a Chrome trace.
+ * clock may be NULL for the real one.
+ */
+bool GPUProfiler_Init(GPUProfiler* profiler, SDL_GPUDevice* device, const GPUProfilerClock* clock);
+/* Collects the passes that finished since the last call, and starts numbering a new frame */
+void GPUProfiler_BeginFrame(GPUProfiler* profiler);
+/* Acquires a command buffer for the pass and opens a debug group named after it. One pass
+ * is open at a time, and the name must stay valid until the profiler is destroyed.
+ */
+SDL_GPUCommandBuffer* GPUProfiler_BeginPass(GPUProfiler* profiler, const char* name);
+/* Closes the debug group and submits the command buffer, in place of SDL_SubmitGPUCommandBuffer */
+bool GPUProfiler_EndPass(GPUProfiler* profiler, SDL_GPUCommandBuffer* commandBuffer);
+/* Times a command buffer submitted elsewhere with SDL_SubmitGPUCommandBufferAndAcquireFence.
+ * The profiler takes over the fence. callback, if not NULL, gets the pass as soon as it
+ * completes, for code that acts on GPU time without waiting for the next BeginFrame.
+ */
+void GPUProfiler_TrackFence(
+	GPUProfiler* profiler,
+	const char* name,
+	SDL_GPUFence* fence,
+	GPUPassCallback callback,
+	void* userdata
+);
+/* Waits for every pass submitted so far and collects them */
+void GPUProfiler_Flush(GPUProfiler* profiler);
+/* Writes the collected passes to filename in the pref path as Chrome trace JSON, which
+ * chrome://tracing and ui.perfetto.dev open
+ */
+bool GPUProfiler_WriteTrace(GPUProfiler* profiler, const char* filename, const char* processName);
+void GPUProfiler_Destroy(GPUProfiler* profiler);
+
+// Compute Presentation
+typedef enum ComputePresentPath
+{
+	COMPUTEPRESENTPATH_DRAW, /* A full-screen fragment pass writes the swapchain as a color target */
+	COMPUTEPRESENTPATH_BLIT, /* A compute pass writes a pooled storage texture, which is blitted to the swapchain */
+	COMPUTEPRESENTPATH_COUNT
+} ComputePresentPath;
+
+typedef struct ComputePresentStats
+{
+	Uint32 FrameCount;
+	Uint64 FrameNS;
+} ComputePresentStats;
+
+typedef struct ComputePresenter
+{
+	SDL_GPUDevice* Device;
+	SDL_Window* Window;
+	/* Takes the blit path even when a draw pipeline is available, to compare the two */
+	bool ForceBlit;
+
+	/* The frame being recorded */
+	ComputePresentPath Path;
+	bool Presented;
+	SDL_GPURenderPass* RenderPass;
+	SDL_GPUTexture* Intermediate;
+	Uint32 Width;
+	Uint32 Height;
+
+	/* GPU time per path comes from the profiler's watcher thread, frame time from the submits */
+	GPUProfiler Profiler;
+	Uint64 LastSubmitNS;
+	Uint64 LastReportNS;
+	ComputePresentStats Stats[COMPUTEPRESENTPATH_COUNT];
+	ComputePresentStats Totals[COMPUTEPRESENTPATH_COUNT];
+} ComputePresenter;
+
+/* Gets the last stage of a compute example onto the swapchain. Swapchain textures are only
+ * ever color targets, so they can't be a compute pass's storage output. The draw path runs
+ * that stage as a full-screen fragment pass (Fullscreen.vert) that writes the swapchain
+ * itself. The blit path keeps the compute pass: it writes a pooled storage texture that
+ * End blits to the swapchain. Frame time and GPU time are logged per path every two seconds.
+ */
+bool ComputePresenter_Init(ComputePresenter* presenter, SDL_GPUDevice* device, SDL_Window* window);
+/* Whether this frame can take the draw path: drawPipeline is the example's full-screen
+ * pipeline for the swapchain format, or NULL if it couldn't be created
+ */
+bool ComputePresenter_CanDraw(const ComputePresenter* presenter, SDL_GPUGraphicsPipeline* drawPipeline);
+/* Begins a render pass on the swapchain. Bind the draw pipeline and draw 3 vertices, then call End. */
+SDL_GPURenderPass* ComputePresenter_BeginDraw(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture);
+/* Returns the binding to pass to SDL_BeginGPUComputePass for a width x height output.
+ * Its texture is NULL when the pool can't provide one: skip the compute pass and End.
+ */
+SDL_GPUStorageTextureReadWriteBinding ComputePresenter_BeginCompute(
+	ComputePresenter* presenter,
+	SDL_GPUTextureFormat storageFormat,
+	Uint32 width,
+	Uint32 height
+);
+/* Ends the draw path's render pass, or blits the blit path's texture to the swapchain and returns it to the pool */
+void ComputePresenter_End(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture, SDL_GPUFilter filter);
+/* Submits in place of SDL_SubmitGPUCommandBuffer, with a fence the profiler waits on when a frame was presented */
+bool ComputePresenter_Submit(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer);
+/* Waits for the outstanding frames and logs the totals */
+void ComputePresenter_Destroy(ComputePresenter* presenter);
+
+// Dynamic Resolution
+typedef struct DynamicResolution
+{
+	SDL_GPUDevice* Device;
+	SDL_Window* Window;
+	SDL_GPUTextureFormat Format;
+	SDL_GPUTexture* Target;
+	Uint32 TargetWidth;
+	Uint32 TargetHeight;
+	Uint32 Width;
+	Uint32 Height;
+
+	/* Controller settings, all of them can be changed between frames */
+	bool Enabled;
+	float TargetMilliseconds;
+	float MinScale;
+	float MaxScale;
+	float Kp;
+	float Ki;
+	float Kd;
+	bool Sharpen;
+	float Sharpness;
+
+	float Scale;
+	float SmoothedMilliseconds;
+	float Errors[2];
+
+	/* Scene times, added up by the profiler's watcher thread as each scene finishes */
+	GPUProfiler Profiler;
+	SDL_Mutex* Lock;
+	Uint64 SampleNS;
+	Uint32 SampleCount;
+
+	SDL_GPUComputePipeline* SharpenPipeline;
+	SDL_GPUGraphicsPipeline* SharpenDrawPipeline;
+	SDL_GPUSampler* Sampler;
+	ComputePresenter Presenter;
+	Uint64 LastReportNS;
+	Uint32 ReportFrames;
+	double ReportMilliseconds;
+} DynamicResolution;
+
+/* Renders the scene into a scaled offscreen target of the given format and upscales it to the
+ * swapchain. The scene's GPU time is taken from the completion of its own command buffer, and
+ * an incremental PID controller moves Scale so it settles on targetMilliseconds.
+ */
+bool DynamicResolution_Init(
+	DynamicResolution* resolution,
+	SDL_GPUDevice* device,
+	SDL_Window* window,
+	SDL_GPUTextureFormat format,
+	float targetMilliseconds
+);
+/* Runs the controller on the frames that finished since the last call and returns the target
+ * to render into, a pooled render target that Upscale releases. Only the top-left
+ * *pWidth x *pHeight of it is shown, so set the viewport.
+ */
+SDL_GPUTexture* DynamicResolution_BeginFrame(DynamicResolution* resolution, Uint32* pWidth, Uint32* pHeight);
+/* Submits a command buffer holding only the scene, so its fence times nothing else */
+bool DynamicResolution_SubmitScene(DynamicResolution* resolution, SDL_GPUCommandBuffer* commandBuffer);
+/* Stretches the rendered region over the swapchain with a linear blit, or sharpens it on the way if Sharpen is set */
+void DynamicResolution_Upscale(DynamicResolution* resolution, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture);
+void DynamicResolution_Destroy(DynamicResolution* resolution);
+
+// Multi-Window Presentation
+#define MULTI_WINDOW_MAX_WINDOWS 8
+
+typedef void (*RecordWindowFunction)(SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* target, Uint32 windowIndex, void* userdata);
+
+typedef struct WindowTimings
+{
+	Uint32 FrameCount;
+	Uint64 AcquireNS;
+	Uint64 RecordNS;
+	Uint64 SubmitNS;
+} WindowTimings;
+
+typedef struct WindowWorker
+{
+	struct MultiWindowPresenter* Presenter;
+	Uint32 Index;
+	SDL_Window* Window;
+	SDL_Thread* Thread;
+	SDL_Semaphore* Start;
+	bool Quit;
+	bool Failed;
+	SDL_GPUTexture* SwapchainTexture;
+	SDL_GPUTexture* Target;
+	Uint32 Width;
+	Uint32 Height;
+	WindowTimings Timings;
+} WindowWorker;
+
+typedef struct MultiWindowPresenter
+{
+	SDL_GPUDevice* Device;
+	RecordWindowFunction Record;
+	void* Userdata;
+	WindowWorker Workers[MULTI_WINDOW_MAX_WINDOWS];
+	Uint32 WindowCount;
+
+	/* The submission queue: the index of the window whose worker may submit next.
+	 * It reaches WindowCount once every worker has submitted or skipped its turn.
+	 */
+	SDL_Mutex* Lock;
+	SDL_Condition* Changed;
+	Uint32 SubmitTurn;
+
+	Uint32 FrameCount;
+	Uint64 FrameNS;
+	Uint64 PresentSubmitNS;
+	Uint64 LastReportNS;
+} MultiWindowPresenter;
+
+/* Renders every window on a worker thread of its own. Each worker acquires, records and
+ * submits its own command buffer into a pooled target the size and format of its window's
+ * swapchain, and the workers submit in window order, each waiting for its turn.
+ * Swapchain textures are acquired on the calling thread, since SDL requires that of the
+ * window's thread, and a command buffer of the calling thread blits the targets to them once
+ * every worker has submitted. Per-window acquire, record and submit times are logged every
+ * two seconds.
+ */
+bool MultiWindowPresenter_Init(MultiWindowPresenter* presenter, SDL_GPUDevice* device, RecordWindowFunction record, void* userdata);
+/* The window must already be claimed for the device */
+bool MultiWindowPresenter_AddWindow(MultiWindowPresenter* presenter, SDL_Window* window);
+/* Stops the worker of the most recently added window and returns that window */
+SDL_Window* MultiWindowPresenter_RemoveWindow(MultiWindowPresenter* presenter);
+bool MultiWindowPresenter_Present(MultiWindowPresenter* presenter);
+void MultiWindowPresenter_Destroy(MultiWindowPresenter* presenter);
+
+// Frame Job Graph
+#define FRAME_JOB_GRAPH_MAX_JOBS 32
+#define FRAME_JOB_GRAPH_MAX_WORKERS 16
+
+/* swapchainTexture is only set for jobs with a Window, and may be NULL when it is minimized */
+typedef void (*FrameJobFunction)(SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture, void* userdata);
+
+typedef struct FrameJobDescription
+{
+	const char* Name;
+	FrameJobFunction Record;
+	void* Userdata;
+	/* Bit i set: submitted after job i, as numbered by AddJob */
+	Uint32 Dependencies;
+	/* Set for the job that presents the window. It is recorded on the calling thread. */
+	SDL_Window* Window;
+} FrameJobDescription;
+
+typedef struct FrameJob
+{
+	FrameJobDescription Description;
+	SDL_GPUCommandBuffer* CommandBuffer;
+	SDL_GPUTexture* SwapchainTexture;
+	bool Failed;
+	Uint64 RecordNS;
+	Uint64 SubmitNS;
+} FrameJob;
+
+typedef struct FrameJobGraph
+{
+	SDL_GPUDevice* Device;
+	SDL_Thread* Workers[FRAME_JOB_GRAPH_MAX_WORKERS];
+	Uint32 WorkerCount;
+	FrameJob Jobs[FRAME_JOB_GRAPH_MAX_JOBS];
+	Uint32 JobCount;
+	bool Validated;
+	/* Optional, set after Init to time each job's command buffer on the GPU */
+	struct GPUProfiler* Profiler;
+
+	/* Jobs waiting for a thread to record them, jobs a thread has taken on, and jobs that
+	 * are submitted. Changed is broadcast whenever a job is claimed or submitted.
+	 */
+	SDL_Mutex* Lock;
+	SDL_Condition* Changed;
+	Uint32 PendingMask;
+	Uint32 ClaimedMask;
+	Uint32 SubmittedMask;
+	bool Quit;
+
+	Uint32 FrameCount;
+	Uint64 FrameNS;
+	Uint64 LastReportNS;
+} FrameJobGraph;
+
+/* Records each job into a command buffer of its own on a pool of workerCount threads,
+ * with the calling thread helping out. The thread that records a job also submits it, as
+ * SDL requires, once everything the job depends on has been submitted. Dependencies only
+ * order submission, so jobs that share a resource must not cycle it. Per-job record and
+ * submit times are logged every two seconds. workerCount may be 0 to record everything
+ * on the calling thread.
+ */
+bool FrameJobGraph_Init(FrameJobGraph* graph, SDL_GPUDevice* device, Uint32 workerCount);
+/* Returns the job's index for the Dependencies of later jobs, or -1 */
+int FrameJobGraph_AddJob(FrameJobGraph* graph, const FrameJobDescription* description);
+bool FrameJobGraph_Execute(FrameJobGraph* graph);
+void FrameJobGraph_Destroy(FrameJobGraph* graph);
+
+// Render Graph
+#define RENDER_GRAPH_MAX_PASSES 32
+#define RENDER_GRAPH_MAX_RESOURCES 32
+#define RENDER_GRAPH_MAX_ACCESSES 8
+#define RENDER_GRAPH_MAX_COLOR_TARGETS 4
+#define RENDER_GRAPH_INVALID 0xFFFFFFFF
+
+typedef enum RenderGraphPassType
+{
+	RENDERGRAPH_PASS_RENDER, /* Writes are color targets */
+	RENDERGRAPH_PASS_COMPUTE, /* Writes are read-write storage textures, bound in the order they were declared */
+	RENDERGRAPH_PASS_BLIT /* Without a function, blits its one read over the whole of its one write */
+} RenderGraphPassType;
+
+typedef struct RenderGraphAccess
+{
+	Uint32 Resource;
+	SDL_GPUTextureUsageFlags Usage;
+	bool Write;
+	bool Clear;
+	SDL_FColor ClearColor;
+	/* Set for the destination of a resolve, to the color target it resolves */
+	Uint32 ResolveFrom;
+
+	/* Decided by RenderGraph_Compile for color targets */
+	SDL_GPULoadOp LoadOp;
+	SDL_GPUStoreOp StoreOp;
+} RenderGraphAccess;
+
+typedef struct RenderGraphPassContext
+{
+	const struct RenderGraph* Graph;
+	SDL_GPUCommandBuffer* CommandBuffer;
+	/* Begun by the graph for render and compute passes. Bind everything but the writes. */
+	SDL_GPURenderPass* RenderPass;
+	SDL_GPUComputePass* ComputePass;
+} RenderGraphPassContext;
+
+typedef void (*RenderGraphPassFunction)(const RenderGraphPassContext* context, void* userdata);
+
+typedef struct RenderGraphPass
+{
+	const char* Name;
+	RenderGraphPassType Type;
+	RenderGraphPassFunction Function;
+	void* Userdata;
+	RenderGraphAccess Accesses[RENDER_GRAPH_MAX_ACCESSES];
+	Uint32 AccessCount;
+
+	/* Compile results. Producers are the passes whose output this one keeps. */
+	Uint32 Dependencies;
+	Uint32 Producers;
+	bool Culled;
+	bool MergedWithPrevious;
+} RenderGraphPass;
+
+typedef struct RenderGraphResource
+{
+	const char* Name;
+	/* Usage is added to by every access */
+	RenderTargetDescription Description;
+	bool Imported;
+	SDL_GPUTexture* Texture;
+
+	/* Compile results, as positions in Order */
+	Uint32 FirstUse;
+	Uint32 LastUse;
+	Uint32 PhysicalIndex;
+} RenderGraphResource;
+
+typedef struct RenderGraphPhysicalTexture
+{
+	RenderTargetDescription Description;
+	Uint32 LastUse;
+	SDL_GPUTexture* Texture;
+} RenderGraphPhysicalTexture;
+
+typedef struct RenderGraph
+{
+	RenderGraphPass Passes[RENDER_GRAPH_MAX_PASSES];
+	Uint32 PassCount;
+	RenderGraphResource Resources[RENDER_GRAPH_MAX_RESOURCES];
+	Uint32 ResourceCount;
+	bool Invalid;
+
+	bool Compiled;
+	Uint32 Order[RENDER_GRAPH_MAX_PASSES];
+	Uint32 OrderCount;
+	Uint32 SDLPassCount;
+	RenderGraphPhysicalTexture Physical[RENDER_GRAPH_MAX_RESOURCES];
+	Uint32 PhysicalCount;
+} RenderGraph;
+
+/* Passes declare what they read and write, and the order they are added in gives those
+ * accesses their meaning. RenderGraph_Compile, which touches no GPU state, then:
+ * - culls passes that contribute nothing to an imported resource,
+ * - orders the rest so render passes with the same color targets run back to back, and
+ *   merges those into one SDL render pass,
+ * - picks load and store ops,
+ * - and lets transient textures with the same description and disjoint lifetimes share
+ *   one texture from the render target pool.
+ * Execute then begins and ends the SDL passes, calling each pass function inside its own.
+ */
+void RenderGraph_Reset(RenderGraph* graph);
+Uint32 RenderGraph_CreateTexture(RenderGraph* graph, const char* name, const RenderTargetDescription* description);
+/* The texture is supplied with SetTexture before each Execute, e.g. the swapchain texture */
+Uint32 RenderGraph_ImportTexture(RenderGraph* graph, const char* name, const RenderTargetDescription* description);
+void RenderGraph_SetTexture(RenderGraph* graph, Uint32 resource, SDL_GPUTexture* texture);
+Uint32 RenderGraph_AddPass(RenderGraph* graph, const char* name, RenderGraphPassType type, RenderGraphPassFunction function, void* userdata);
+/* usage is SAMPLER or COMPUTE_STORAGE_READ, 0 for SAMPLER */
+void RenderGraph_Read(RenderGraph* graph, Uint32 pass, Uint32 resource, SDL_GPUTextureUsageFlags usage);
+void RenderGraph_Write(RenderGraph* graph, Uint32 pass, Uint32 resource);
+void RenderGraph_Clear(RenderGraph* graph, Uint32 pass, Uint32 resource, SDL_FColor color);
+/* source must be a multisampled color target the render pass writes */
+void RenderGraph_Resolve(RenderGraph* graph, Uint32 pass, Uint32 source, Uint32 destination);
+bool RenderGraph_Compile(RenderGraph* graph);
+void RenderGraph_LogSchedule(const RenderGraph* graph);
+/* Only valid inside Execute for transient textures */
+SDL_GPUTexture* RenderGraph_GetTexture(const RenderGraph* graph, Uint32 resource);
+bool RenderGraph_Execute(RenderGraph* graph, SDL_GPUDevice* device, SDL_GPUCommandBuffer* commandBuffer);
+
+// Presentation
+#define FRAME_PRESENTER_MAX_FRAMES_IN_FLIGHT 3
+
+typedef enum PresentPolicy
+{
+	PRESENTPOLICY_LOWEST_LATENCY, /* IMMEDIATE, else MAILBOX, else VSYNC, with one frame in flight */
+	PRESENTPOLICY_LOWEST_POWER, /* VSYNC, with two frames in flight */
+	PRESENTPOLICY_TEAR_FREE, /* MAILBOX, else VSYNC, with three frames in flight */
+	PRESENTPOLICY_COUNT
+} PresentPolicy;
+
+const char* GetPresentPolicyName(PresentPolicy policy);
+const char* GetPresentModeName(SDL_GPUPresentMode presentMode);
+/* Switches the window to the first present mode of the policy that it supports, and returns it */
+SDL_GPUPresentMode ApplyPresentPolicy(SDL_GPUDevice* device, SDL_Window* window, PresentPolicy policy);
+
+typedef struct PresentedFrame
+{
+	Uint64 Index;
+	PresentPolicy Policy;
+	SDL_GPUPresentMode PresentMode;
+	Uint32 FramesInFlight;
+
+	/* Timestamps from SDL_GetTicksNS. InputNS is 0 for frames without input. */
+	Uint64 InputNS;
+	Uint64 AcquireNS;
+	Uint64 SubmitNS;
+	Uint64 CompleteNS;
+
+	/* Durations: since the previous frame's Acquire, waiting for a frame in flight to
+	 * finish before this one started, and waiting for the swapchain texture
+	 */
+	Uint64 FrameNS;
+	Uint64 ThrottleNS;
+	Uint64 AcquireWaitNS;
+} PresentedFrame;
+
+typedef struct PresentStats
+{
+	Uint32 FrameCount;
+	Uint64 FrameNS;
+	Uint64 ThrottleNS;
+	Uint64 AcquireWaitNS;
+	Uint64 GPUNS;
+	Uint32 InputCount;
+	Uint64 LatencyNS;
+	Uint64 MaxLatencyNS;
+} PresentStats;
+
+typedef struct FramePresenter
+{
+	SDL_GPUDevice* Device;
+	SDL_Window* Window;
+	char Title[64];
+	PresentPolicy Policy;
+	SDL_GPUPresentMode PresentMode;
+	Uint32 FramesInFlight;
+
+	PresentedFrame Current;
+	Uint64 FrameIndex;
+	Uint64 LastAcquireNS;
+	Uint64 LastThrottleNS;
+
+	/* Submitted frames, retired by the profiler's watcher thread as their fences signal */
+	GPUProfiler Profiler;
+	SDL_Mutex* Lock;
+	SDL_Condition* Signal;
+	PresentedFrame InFlight[FRAME_PRESENTER_MAX_FRAMES_IN_FLIGHT];
+	Uint32 InFlightRead;
+	Uint32 InFlightCount;
+	PresentStats Stats;
+
+	SDL_IOStream* CSV;
+	Uint64 LastReportNS;
+} FramePresenter;
+
+/* Acquires, submits and paces a window's frames according to a PresentPolicy, and measures
+ * each one: the time from its first input event until its commands finish on the GPU, how
+ * long it waited for a frame in flight, and how long it waited for the swapchain texture.
+ * SDL has no present timestamps, so the commands finishing stands in for the present; with
+ * VSYNC the image is shown up to a refresh later. Averages go to the window title and the
+ * log every second, and every frame goes to csvFilename in the pref path if it isn't NULL.
+ */
+bool FramePresenter_Init(
+	FramePresenter* presenter,
+	SDL_GPUDevice* device,
+	SDL_Window* window,
+	PresentPolicy policy,
+	const char* csvFilename
+);
+void FramePresenter_SetPolicy(FramePresenter* presenter, PresentPolicy policy);
+/* inputTimestampNS is Context.InputTimestampNS. Returns NULL on failure, otherwise a
+ * command buffer that must go to Submit, even if *pSwapchainTexture is NULL.
+ */
+SDL_GPUCommandBuffer* FramePresenter_Acquire(FramePresenter* presenter, Uint64 inputTimestampNS, SDL_GPUTexture** pSwapchainTexture);
+/* Submits, then waits until another frame may be in flight, so the main loop polls input after the wait */
+bool FramePresenter_Submit(FramePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer);
+void FramePresenter_Destroy(FramePresenter* presenter);
+
+// JSON Writing
+/* Writes text as a quoted, escaped JSON string, for the GPU and CPU trace writers */
+void WriteJSONString(SDL_IOStream* stream, const char* text);
+
+// CPU Profiling
+/* Build with CPU_PROFILER_ENABLED=0 (the CPU_PROFILER CMake option) to compile every zone out */
+#ifndef CPU_PROFILER_ENABLED
+#define CPU_PROFILER_ENABLED 1
+#endif
+
+#define CPU_PROFILER_MAX_THREADS 64
+#define CPU_PROFILER_RING_SIZE 8192 /* Events per thread, a power of two */
+#define CPU_PROFILER_DETAIL_LENGTH 40
+
+typedef struct CPUZone
+{
+	const char* Name;
+	const char* Detail;
+	Uint64 StartNS;
+} CPUZone;
+
+typedef struct CPUProfilerEvent
+{
+	const char* Name;
+	char Detail[CPU_PROFILER_DETAIL_LENGTH];
+	Uint64 StartNS;
+	Uint64 DurationNS;
+} CPUProfilerEvent;
+
+/* Each thread that ends a zone claims one of these and is the only one to write it. Count is
+ * how many events it has written; the trace writer reads the most recent of them.
+ */
+typedef struct CPUProfilerThread
+{
+	SDL_AtomicInt InUse;
+	SDL_AtomicU32 Count;
+	SDL_ThreadID ThreadID;
+	const char* Name;
+	CPUProfilerEvent* Events;
+} CPUProfilerThread;
+
+/* Zones nest, and are recorded when they end. name must be a string literal, while detail,
+ * which may be NULL, is copied. A thread that exits hands its ring to the next new thread.
+ */
+#if CPU_PROFILER_ENABLED
+#define CPU_ZONE_BEGIN(zone, name, detail) CPUZone zone = CPUProfiler_BeginZone(name, detail)
+#define CPU_ZONE_END(zone) CPUProfiler_EndZone(&zone)
+#else
+#define CPU_ZONE_BEGIN(zone, name, detail)
+#define CPU_ZONE_END(zone)
+#endif
+
+CPUZone CPUProfiler_BeginZone(const char* name, const char* detail);
+void CPUProfiler_EndZone(const CPUZone* zone);
+/* Labels the calling thread in the trace. name must be a string literal. */
+void CPUProfiler_NameThread(const char* name);
+/* Writes every thread's most recent zones to filename in the pref path as Chrome trace JSON.
+ * A thread that is recording meanwhile may have its oldest zone torn.
+ */
+bool CPUProfiler_WriteTrace(const char* filename);
+
+// Cubemap Loading
+typedef struct CubemapInfo
+{
+	Uint32 Size;
+	Uint32 LevelCount;
+	/* Levels read from files rather than filtered at load time, the fewest of any face */
+	Uint32 AuthoredLevelCount;
+	Uint32 StagingSize;
+	float DecodeMilliseconds;
+	float UploadMilliseconds;
+} CubemapInfo;
+
+/* Decodes the faces (+X, -X, +Y, -Y, +Z, -Z) on one thread each into a single transfer buffer,
+ * with a mip chain of levelCount levels (0 for a full chain), and uploads every face and level
+ * in one copy pass. Levels authored as <face>.mip<level>.<extension> files are loaded as is, and
+ * only the levels below the last one found are box-filtered, on the same threads.
+ * extraUsage is added to SAMPLER usage. pInfo may be NULL.
+ */
+SDL_GPUTexture* LoadCubemap(
+	SDL_GPUDevice* device,
+	const char* const faceFilenames[6],
+	Uint32 levelCount,
+	SDL_GPUTextureUsageFlags extraUsage,
+	CubemapInfo* pInfo
+);
+
+typedef struct SpecularPrefilter
+{
+	SDL_GPUComputePipeline* Pipeline;
+	SDL_GPUSampler* Sampler;
+} SpecularPrefilter;
+
+bool SpecularPrefilter_Init(SpecularPrefilter* prefilter, SDL_GPUDevice* device);
+void SpecularPrefilter_Destroy(SpecularPrefilter* prefilter, SDL_GPUDevice* device);
+/* Fills every level of destination, a cube with COMPUTE_STORAGE_WRITE usage, with GGX-prefiltered
+ * radiance from source. Roughness goes from 0 at level 0 to 1 at the last level.
+ * source should have a full mip chain so wide lobes can read from small levels.
+ */
+void SpecularPrefilter_Run(
+	const SpecularPrefilter* prefilter,
+	SDL_GPUCommandBuffer* commandBuffer,
+	SDL_GPUTexture* source,
+	Uint32 sourceSize,
+	SDL_GPUTexture* destination,
+	Uint32 destinationSize,
+	Uint32 levelCount,
+	Uint32 sampleCount
+);
+
+// Asset Archive
+/* Content.pak packs Content/Images and Content/Shaders/Compiled into a single file that is
+ * memory-mapped at startup. Entries are named by their path relative to Content/, for example
+ * "Shaders/Compiled/TexturedQuad.vert.spv", and found through an open-addressed hash table.
+ * BMP images are stored already decoded as top-down R8G8B8A8 rows.
+ * All fields are little-endian.
+ */
+#define ASSET_ARCHIVE_MAGIC SDL_FOURCC('S', 'G', 'P', 'K')
+#define ASSET_ARCHIVE_VERSION 1
+#define ASSET_ARCHIVE_ALIGNMENT 64
+#define ASSET_ARCHIVE_EMPTY_SLOT 0xFFFFFFFF
+
+typedef enum AssetType
+{
+	ASSETTYPE_RAW,
+	ASSETTYPE_IMAGE_RGBA8
+} AssetType;
+
+typedef struct AssetArchiveHeader
+{
+	Uint32 Magic;
+	Uint32 Version;
+	Uint32 EntryCount;
+	Uint32 SlotCount;		/* Power of two, each slot holds an entry index or ASSET_ARCHIVE_EMPTY_SLOT */
+	Uint64 EntriesOffset;
+	Uint64 SlotsOffset;
+	Uint64 NamesOffset;
+} AssetArchiveHeader;
+
+typedef struct AssetArchiveEntry
+{
+	Uint32 NameHash;
+	Uint32 NameOffset;		/* Relative to NamesOffset, null-terminated */
+	Uint32 Type;
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 Padding;
+	Uint64 DataOffset;		/* Aligned to ASSET_ARCHIVE_ALIGNMENT */
+	Uint64 DataSize;
+} AssetArchiveEntry;
+
+typedef struct Asset
+{
+	const void* Data;
+	size_t Size;
+	AssetType Type;
+	int Width;
+	int Height;
+} Asset;
+
+Uint32 HashAssetName(const char* name);
+bool OpenAssetArchive(const char* path);
+void CloseAssetArchive();
+/* Data points into the mapped archive and stays valid until CloseAssetArchive */
+bool FindAsset(const char* name, Asset* asset);
+
 // Examples
 typedef struct Example
 {
@@ -97,7 +1117,9 @@ extern Example CullMode_Example;
 extern Example BasicStencil_Example;
 extern Example InstancedIndexed_Example;
 extern Example TexturedQuad_Example;
+extern Example CompressedTexturedQuad_Example;
 extern Example TexturedAnimatedQuad_Example;
+extern Example TexturedAnimatedQuadInstanced_Example;
 extern Example Clear3DSlice_Example;
 extern Example BasicCompute_Example;
 extern Example ComputeUniforms_Example;
@@ -111,10 +1133,19 @@ extern Example CopyConsistency_Example;
 extern Example Texture2DArray_Example;
 extern Example TriangleMSAA_Example;
 extern Example Cubemap_Example;
+extern Example PrefilteredCubemap_Example;
 extern Example WindowResize_Example;
 extern Example Blit2DArray_Example;
 extern Example BlitCube_Example;
 extern Example BlitMirror_Example;
 extern Example GenerateMipmaps_Example;
+extern Example GenerateMipmapsCompute_Example;
+extern Example BatchedTransforms_Example;
+extern Example ComputeDrawIndirect_Example;
+extern Example ResolutionScaling_Example;
+extern Example JobGraphStress_Example;
+extern Example RenderGraphPost_Example;
+extern Example PresentLatency_Example;
+extern Example GPUPassTiming_Example;
 
 #endif
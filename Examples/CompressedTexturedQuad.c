@@ -0,0 +1,336 @@
+#include "Common.h"
+
+#define MAX_VARIANTS (COMPRESSEDFORMAT_COUNT + 2)
+
+typedef struct TextureVariant
+{
+	char Name[64];
+	SDL_GPUTexture* Texture;
+	Uint32 Size;
+} TextureVariant;
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static SDL_GPUBuffer* VertexBuffer;
+static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUSampler* Sampler;
+
+static TextureVariant Variants[MAX_VARIANTS];
+static int VariantCount;
+static int CurrentVariantIndex;
+static Uint32 UncompressedSize;
+
+static void LogVariant(const TextureVariant* variant)
+{
+	SDL_Log(
+		"Showing %s: %u bytes of VRAM and upload, %.1fx smaller than R8G8B8A8",
+		variant->Name,
+		variant->Size,
+		(double) UncompressedSize / variant->Size
+	);
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Create the shaders
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "TexturedQuad.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "TexturedQuad.frag", 1, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	// Create the pipeline
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.vertex_input_state = (SDL_GPUVertexInputState){
+			.num_vertex_buffers = 1,
+			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+				.slot = 0,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+				.instance_step_rate = 0,
+				.pitch = sizeof(PositionTextureVertex)
+			}},
+			.num_vertex_attributes = 2,
+			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+				.location = 0,
+				.offset = 0
+			}, {
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+				.location = 1,
+				.offset = sizeof(float) * 3
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	};
+
+	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (Pipeline == NULL)
+	{
+		SDL_Log("Failed to create pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	Sampler = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+		.min_filter = SDL_GPU_FILTER_LINEAR,
+		.mag_filter = SDL_GPU_FILTER_NEAREST,
+		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
+		.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
+		.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
+		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
+	});
+
+	// The texture the loader would pick for this device
+	CompressedImage info;
+	TextureVariant* variant = &Variants[VariantCount];
+	variant->Texture = LoadCompressedTexture(context->Device, "ravioli", &info);
+	if (variant->Texture == NULL)
+	{
+		SDL_Log("Could not load compressed texture!");
+		return -1;
+	}
+	variant->Size = info.DataSize;
+	SDL_snprintf(variant->Name, sizeof(variant->Name), "LoadCompressedTexture (%s)", GetCompressedFormatName(info.BlockFormat));
+	VariantCount += 1;
+
+	// Runtime-encode every supported format from the same source for comparison
+	SDL_Surface* imageData = LoadImage("ravioli.bmp", 4);
+	if (imageData == NULL)
+	{
+		SDL_Log("Could not load image data!");
+		return -1;
+	}
+
+	// Baseline is a full R8G8B8A8 mip chain
+	UncompressedSize = 0;
+	for (Uint32 level = 0; (SDL_max(imageData->w, imageData->h) >> level) > 0; level += 1)
+	{
+		UncompressedSize += SDL_max(imageData->w >> level, 1) * SDL_max(imageData->h >> level, 1) * 4;
+	}
+
+	for (int format = 0; format < COMPRESSEDFORMAT_COUNT; format += 1)
+	{
+		SDL_GPUTextureFormat gpuFormat = GetCompressedFormatGPUFormat(format, false);
+		if (!SDL_GPUTextureSupportsFormat(context->Device, gpuFormat, SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_SAMPLER))
+		{
+			SDL_Log("%s is not supported on this device", GetCompressedFormatName(format));
+			continue;
+		}
+
+		CompressedImage image;
+		Uint64 start = SDL_GetPerformanceCounter();
+		if (!EncodeCompressedImage(imageData->pixels, imageData->w, imageData->h, format, false, true, &image))
+		{
+			continue;
+		}
+		double encodeMs = (double) (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+		variant = &Variants[VariantCount];
+		variant->Texture = CreateTextureFromCompressedImage(context->Device, &image);
+		variant->Size = image.DataSize;
+		SDL_snprintf(variant->Name, sizeof(variant->Name), "%s (runtime encoded in %.2f ms)", GetCompressedFormatName(format), encodeMs);
+		FreeCompressedImage(&image);
+
+		if (variant->Texture != NULL)
+		{
+			VariantCount += 1;
+		}
+	}
+
+	SDL_DestroySurface(imageData);
+
+	// Create the GPU resources
+	VertexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = sizeof(PositionTextureVertex) * 4
+		}
+	);
+
+	IndexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = sizeof(Uint16) * 6
+		}
+	);
+
+	// Set up buffer data
+	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6)
+		}
+	);
+
+	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
+		context->Device,
+		bufferTransferBuffer,
+		false
+	);
+
+	transferData[0] = (PositionTextureVertex) { -1,  1, 0, 0, 0 };
+	transferData[1] = (PositionTextureVertex) {  1,  1, 0, 4, 0 };
+	transferData[2] = (PositionTextureVertex) {  1, -1, 0, 4, 4 };
+	transferData[3] = (PositionTextureVertex) { -1, -1, 0, 0, 4 };
+
+	Uint16* indexData = (Uint16*) &transferData[4];
+	indexData[0] = 0;
+	indexData[1] = 1;
+	indexData[2] = 2;
+	indexData[3] = 0;
+	indexData[4] = 2;
+	indexData[5] = 3;
+
+	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+
+	// Upload the transfer data to the GPU resources
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = VertexBuffer,
+			.offset = 0,
+			.size = sizeof(PositionTextureVertex) * 4
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = sizeof(PositionTextureVertex) * 4
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = IndexBuffer,
+			.offset = 0,
+			.size = sizeof(Uint16) * 6
+		},
+		false
+	);
+
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+
+	// Finally, print instructions!
+	SDL_Log("Press Left/Right to switch between texture formats");
+	LogVariant(&Variants[0]);
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	if (context->LeftPressed)
+	{
+		CurrentVariantIndex -= 1;
+		if (CurrentVariantIndex < 0)
+		{
+			CurrentVariantIndex = VariantCount - 1;
+		}
+		LogVariant(&Variants[CurrentVariantIndex]);
+	}
+
+	if (context->RightPressed)
+	{
+		CurrentVariantIndex = (CurrentVariantIndex + 1) % VariantCount;
+		LogVariant(&Variants[CurrentVariantIndex]);
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	if (cmdbuf == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	SDL_GPUTexture* swapchainTexture;
+	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	if (swapchainTexture != NULL)
+	{
+		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+		colorTargetInfo.texture = swapchainTexture;
+		colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
+		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+
+		SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ .buffer = VertexBuffer, .offset = 0 }, 1);
+		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer, .offset = 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+		SDL_BindGPUFragmentSamplers(renderPass, 0, &(SDL_GPUTextureSamplerBinding){ .texture = Variants[CurrentVariantIndex].Texture, .sampler = Sampler }, 1);
+		SDL_DrawGPUIndexedPrimitives(renderPass, 6, 1, 0, 0, 0);
+
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUSampler(context->Device, Sampler);
+
+	for (int i = 0; i < VariantCount; i += 1)
+	{
+		SDL_ReleaseGPUTexture(context->Device, Variants[i].Texture);
+	}
+	SDL_zeroa(Variants);
+
+	VariantCount = 0;
+	CurrentVariantIndex = 0;
+
+	CommonQuit(context);
+}
+
+Example CompressedTexturedQuad_Example = { "CompressedTexturedQuad", Init, Update, Draw, Quit };
@@ -0,0 +1,649 @@
+#include "Common.h"
+
+static SDL_GPUGraphicsPipeline* RenderPipeline;
+static SDL_GPUComputePipeline* GenerateDrawsPipeline;
+static SDL_GPUBuffer* VertexBuffer;
+static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUBuffer* ObjectBuffer;
+static SDL_GPUBuffer* DrawBuffer;
+static SDL_GPUTransferBuffer* DrawTransferBuffer;
+
+typedef struct ObjectData
+{
+	float x, y, radius, padding;
+	float r, g, b, a;
+} ObjectData;
+
+typedef struct LodRange
+{
+	Uint32 FirstIndex;
+	Uint32 IndexCount;
+	Sint32 VertexOffset;
+	Uint32 Padding;
+} LodRange;
+
+/* Matches the std140 layout of the UniformBlock in GenerateDrawCommands.comp */
+typedef struct CullUniforms
+{
+	float ViewRect[4];
+	float CameraX, CameraY;
+	float Lod1DistanceSquared;
+	float Lod2DistanceSquared;
+	Uint32 ObjectCount;
+	Uint32 Padding[3];
+	LodRange Lods[3];
+} CullUniforms;
+
+#define GRID_SIZE 128
+#define OBJECT_COUNT (GRID_SIZE * GRID_SIZE)
+
+static const Uint32 LodSegments[3] = { 48, 12, 5 };
+static LodRange Lods[3];
+
+static ObjectData* Objects;
+static SDL_GPUIndexedIndirectDrawCommand* ReferenceCommands;
+
+static bool UseGPUGeneration = true;
+static bool ValidateNextFrame = true;
+
+static float t = 0;
+
+static Uint64 AccumulatedCPUTicks = 0;
+static float AccumulatedFrameTime = 0;
+static Uint32 AccumulatedFrames = 0;
+
+static CullUniforms BuildCullUniforms(void)
+{
+	const float viewWidth = 32.0f;
+	const float viewHeight = 24.0f;
+	float cameraX = (GRID_SIZE * 0.5f) + SDL_cosf(t * 0.2f) * 40.0f;
+	float cameraY = (GRID_SIZE * 0.5f) + SDL_sinf(t * 0.2f) * 40.0f;
+
+	CullUniforms uniforms = {
+		.ViewRect = {
+			cameraX - viewWidth * 0.5f,
+			cameraY - viewHeight * 0.5f,
+			cameraX + viewWidth * 0.5f,
+			cameraY + viewHeight * 0.5f
+		},
+		.CameraX = cameraX,
+		.CameraY = cameraY,
+		.Lod1DistanceSquared = 6.0f * 6.0f,
+		.Lod2DistanceSquared = 12.0f * 12.0f,
+		.ObjectCount = OBJECT_COUNT
+	};
+	SDL_memcpy(uniforms.Lods, Lods, sizeof(Lods));
+
+	return uniforms;
+}
+
+/* CPU reference for GenerateDrawCommands.comp. Returns the number of visible objects. */
+static Uint32 GenerateDrawCommandsCPU(
+	const CullUniforms* uniforms,
+	const ObjectData* objects,
+	SDL_GPUIndexedIndirectDrawCommand* commands
+) {
+	Uint32 visibleCount = 0;
+
+	for (Uint32 i = 0; i < uniforms->ObjectCount; i += 1)
+	{
+		const ObjectData* object = &objects[i];
+
+		bool visible =
+			object->x + object->radius >= uniforms->ViewRect[0] &&
+			object->y + object->radius >= uniforms->ViewRect[1] &&
+			object->x - object->radius <= uniforms->ViewRect[2] &&
+			object->y - object->radius <= uniforms->ViewRect[3];
+
+		float dx = object->x - uniforms->CameraX;
+		float dy = object->y - uniforms->CameraY;
+		float distanceSquared = (dx * dx) + (dy * dy);
+
+		Uint32 lod = 2;
+		if (distanceSquared < uniforms->Lod1DistanceSquared)
+		{
+			lod = 0;
+		}
+		else if (distanceSquared < uniforms->Lod2DistanceSquared)
+		{
+			lod = 1;
+		}
+
+		// Culled objects keep their slot but draw zero instances
+		commands[i] = (SDL_GPUIndexedIndirectDrawCommand) {
+			uniforms->Lods[lod].IndexCount,
+			visible ? 1 : 0,
+			uniforms->Lods[lod].FirstIndex,
+			uniforms->Lods[lod].VertexOffset,
+			i
+		};
+
+		visibleCount += visible ? 1 : 0;
+	}
+
+	return visibleCount;
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Create the shaders
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "PositionInstancedObject.vert", 0, 1, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	// Create the pipelines
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		// Object data is read per instance, and first_instance selects the object
+		.vertex_input_state = (SDL_GPUVertexInputState){
+			.num_vertex_buffers = 2,
+			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+				.slot = 0,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+				.instance_step_rate = 0,
+				.pitch = sizeof(PositionVertex)
+			}, {
+				.slot = 1,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+				.instance_step_rate = 0,
+				.pitch = sizeof(ObjectData)
+			}},
+			.num_vertex_attributes = 3,
+			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+				.location = 0,
+				.offset = 0
+			}, {
+				.buffer_slot = 1,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+				.location = 1,
+				.offset = 0
+			}, {
+				.buffer_slot = 1,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+				.location = 2,
+				.offset = sizeof(float) * 4
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	};
+
+	RenderPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (RenderPipeline == NULL)
+	{
+		SDL_Log("Failed to create render pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	GenerateDrawsPipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"GenerateDrawCommands.comp",
+		&(SDL_GPUComputePipelineCreateInfo) {
+			.num_readonly_storage_buffers = 1,
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 64,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+	if (GenerateDrawsPipeline == NULL)
+	{
+		SDL_Log("Failed to create draw generation pipeline!");
+		return -1;
+	}
+
+	// Lay out every LOD of the circle mesh back to back in one vertex/index buffer
+	Uint32 vertexCount = 0;
+	Uint32 indexCount = 0;
+	for (Uint32 lod = 0; lod < SDL_arraysize(LodSegments); lod += 1)
+	{
+		Lods[lod].FirstIndex = indexCount;
+		Lods[lod].IndexCount = LodSegments[lod] * 3;
+		Lods[lod].VertexOffset = vertexCount;
+		vertexCount += LodSegments[lod] + 1;
+		indexCount += LodSegments[lod] * 3;
+	}
+
+	const Uint32 vertexBufferSize = sizeof(PositionVertex) * vertexCount;
+	const Uint32 indexBufferSize = sizeof(Uint16) * indexCount;
+	const Uint32 objectBufferSize = sizeof(ObjectData) * OBJECT_COUNT;
+	const Uint32 drawBufferSize = sizeof(SDL_GPUIndexedIndirectDrawCommand) * OBJECT_COUNT;
+
+	VertexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = vertexBufferSize
+		}
+	);
+
+	IndexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = indexBufferSize
+		}
+	);
+
+	ObjectBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ,
+			.size = objectBufferSize
+		}
+	);
+
+	DrawBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = drawBufferSize
+		}
+	);
+
+	// Used by the CPU generation path to stream commands every frame
+	DrawTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = drawBufferSize
+		}
+	);
+
+	Objects = SDL_malloc(objectBufferSize);
+	ReferenceCommands = SDL_malloc(drawBufferSize);
+	if (Objects == NULL || ReferenceCommands == NULL)
+	{
+		SDL_Log("Failed to allocate object data!");
+		return -1;
+	}
+
+	for (Uint32 i = 0; i < OBJECT_COUNT; i += 1)
+	{
+		Uint32 x = i % GRID_SIZE;
+		Uint32 y = i / GRID_SIZE;
+		Objects[i] = (ObjectData) {
+			x + 0.5f, y + 0.5f, 0.4f, 0,
+			(float) x / GRID_SIZE, (float) y / GRID_SIZE, 1.0f, 1.0f
+		};
+	}
+
+	// Set the buffer data
+	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = vertexBufferSize + indexBufferSize + objectBufferSize
+		}
+	);
+
+	PositionVertex* transferData = SDL_MapGPUTransferBuffer(
+		context->Device,
+		transferBuffer,
+		false
+	);
+
+	Uint16* indexData = (Uint16*) &transferData[vertexCount];
+	for (Uint32 lod = 0; lod < SDL_arraysize(LodSegments); lod += 1)
+	{
+		Uint32 segments = LodSegments[lod];
+		PositionVertex* vertices = &transferData[Lods[lod].VertexOffset];
+		Uint16* indices = &indexData[Lods[lod].FirstIndex];
+
+		// Triangle fan around a center vertex, indices are relative to VertexOffset
+		vertices[0] = (PositionVertex) { 0, 0, 0 };
+		for (Uint32 i = 0; i < segments; i += 1)
+		{
+			float angle = (2.0f * SDL_PI_F * i) / segments;
+			vertices[i + 1] = (PositionVertex) { SDL_cosf(angle), SDL_sinf(angle), 0 };
+
+			indices[i * 3] = 0;
+			indices[i * 3 + 1] = (Uint16) (i + 1);
+			indices[i * 3 + 2] = (Uint16) (((i + 1) % segments) + 1);
+		}
+	}
+
+	SDL_memcpy((Uint8*) transferData + vertexBufferSize + indexBufferSize, Objects, objectBufferSize);
+
+	SDL_UnmapGPUTransferBuffer(context->Device, transferBuffer);
+
+	// Upload the transfer data to the GPU buffers
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = transferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = VertexBuffer,
+			.offset = 0,
+			.size = vertexBufferSize
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = transferBuffer,
+			.offset = vertexBufferSize
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = IndexBuffer,
+			.offset = 0,
+			.size = indexBufferSize
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = transferBuffer,
+			.offset = vertexBufferSize + indexBufferSize
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = ObjectBuffer,
+			.offset = 0,
+			.size = objectBufferSize
+		},
+		false
+	);
+
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
+
+	// Print the instructions
+	SDL_Log("Press Left/Right to switch between GPU and CPU draw generation");
+	SDL_Log("Press Up to compare the GPU commands against the CPU reference");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	if (context->LeftPressed || context->RightPressed)
+	{
+		UseGPUGeneration = !UseGPUGeneration;
+		SDL_Log("Generating draws on the %s", UseGPUGeneration ? "GPU" : "CPU");
+
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	if (context->UpPressed)
+	{
+		ValidateNextFrame = true;
+	}
+
+	t += context->DeltaTime;
+
+	return 0;
+}
+
+/* Runs the compute pass on its own, reads DrawBuffer back and diffs it against the CPU reference */
+static void ValidateDrawCommands(Context* context, const CullUniforms* uniforms)
+{
+	const Uint32 drawBufferSize = sizeof(SDL_GPUIndexedIndirectDrawCommand) * OBJECT_COUNT;
+
+	SDL_GPUTransferBuffer* downloadTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
+			.size = drawBufferSize
+		}
+	);
+
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		cmdbuf,
+		NULL,
+		0,
+		&(SDL_GPUStorageBufferReadWriteBinding){
+			.buffer = DrawBuffer,
+			.cycle = true
+		},
+		1
+	);
+	SDL_BindGPUComputePipeline(computePass, GenerateDrawsPipeline);
+	SDL_BindGPUComputeStorageBuffers(computePass, 0, &ObjectBuffer, 1);
+	SDL_PushGPUComputeUniformData(cmdbuf, 0, uniforms, sizeof(CullUniforms));
+	SDL_DispatchGPUCompute(computePass, (OBJECT_COUNT + 63) / 64, 1, 1);
+	SDL_EndGPUComputePass(computePass);
+
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+	SDL_DownloadFromGPUBuffer(
+		copyPass,
+		&(SDL_GPUBufferRegion) {
+			.buffer = DrawBuffer,
+			.offset = 0,
+			.size = drawBufferSize
+		},
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = downloadTransferBuffer,
+			.offset = 0
+		}
+	);
+	SDL_EndGPUCopyPass(copyPass);
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
+	SDL_WaitForGPUFences(context->Device, true, &fence, 1);
+	SDL_ReleaseGPUFence(context->Device, fence);
+
+	Uint32 visibleCount = GenerateDrawCommandsCPU(uniforms, Objects, ReferenceCommands);
+
+	SDL_GPUIndexedIndirectDrawCommand* gpuCommands = SDL_MapGPUTransferBuffer(
+		context->Device,
+		downloadTransferBuffer,
+		false
+	);
+
+	Uint32 mismatches = 0;
+	for (Uint32 i = 0; i < OBJECT_COUNT; i += 1)
+	{
+		if (SDL_memcmp(&gpuCommands[i], &ReferenceCommands[i], sizeof(SDL_GPUIndexedIndirectDrawCommand)) != 0)
+		{
+			mismatches += 1;
+		}
+	}
+
+	SDL_UnmapGPUTransferBuffer(context->Device, downloadTransferBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, downloadTransferBuffer);
+
+	if (mismatches == 0)
+	{
+		SDL_Log("SUCCESS! All %u GPU draw commands match the CPU reference (%u visible)", OBJECT_COUNT, visibleCount);
+	}
+	else
+	{
+		SDL_Log("FAILURE! %u of %u GPU draw commands differ from the CPU reference", mismatches, OBJECT_COUNT);
+	}
+}
+
+static int Draw(Context* context)
+{
+	CullUniforms cullUniforms = BuildCullUniforms();
+
+	if (ValidateNextFrame)
+	{
+		ValidateDrawCommands(context, &cullUniforms);
+		ValidateNextFrame = false;
+	}
+
+	Uint64 cpuStart = SDL_GetPerformanceCounter();
+
+    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+    if (cmdbuf == NULL)
+    {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GPUTexture* swapchainTexture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        return -1;
+    }
+
+	if (swapchainTexture != NULL)
+	{
+		if (UseGPUGeneration)
+		{
+			SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+				cmdbuf,
+				NULL,
+				0,
+				&(SDL_GPUStorageBufferReadWriteBinding){
+					.buffer = DrawBuffer,
+					.cycle = true
+				},
+				1
+			);
+			SDL_BindGPUComputePipeline(computePass, GenerateDrawsPipeline);
+			SDL_BindGPUComputeStorageBuffers(computePass, 0, &ObjectBuffer, 1);
+			SDL_PushGPUComputeUniformData(cmdbuf, 0, &cullUniforms, sizeof(CullUniforms));
+			SDL_DispatchGPUCompute(computePass, (OBJECT_COUNT + 63) / 64, 1, 1);
+			SDL_EndGPUComputePass(computePass);
+		}
+		else
+		{
+			SDL_GPUIndexedIndirectDrawCommand* commands = SDL_MapGPUTransferBuffer(
+				context->Device,
+				DrawTransferBuffer,
+				true
+			);
+			GenerateDrawCommandsCPU(&cullUniforms, Objects, commands);
+			SDL_UnmapGPUTransferBuffer(context->Device, DrawTransferBuffer);
+
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) {
+					.transfer_buffer = DrawTransferBuffer,
+					.offset = 0
+				},
+				&(SDL_GPUBufferRegion) {
+					.buffer = DrawBuffer,
+					.offset = 0,
+					.size = sizeof(SDL_GPUIndexedIndirectDrawCommand) * OBJECT_COUNT
+				},
+				true
+			);
+			SDL_EndGPUCopyPass(copyPass);
+		}
+
+		Matrix4x4 viewProjection = Matrix4x4_CreateOrthographicOffCenter(
+			cullUniforms.ViewRect[0],
+			cullUniforms.ViewRect[2],
+			cullUniforms.ViewRect[1],
+			cullUniforms.ViewRect[3],
+			0,
+			-1
+		);
+
+		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+		colorTargetInfo.texture = swapchainTexture;
+		colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
+		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+
+		SDL_BindGPUGraphicsPipeline(renderPass, RenderPipeline);
+		SDL_BindGPUVertexBuffers(
+			renderPass,
+			0,
+			(SDL_GPUBufferBinding[]){
+				{ .buffer = VertexBuffer, .offset = 0 },
+				{ .buffer = ObjectBuffer, .offset = 0 }
+			},
+			2
+		);
+		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+		SDL_PushGPUVertexUniformData(cmdbuf, 0, &viewProjection, sizeof(viewProjection));
+		SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, DrawBuffer, 0, OBJECT_COUNT);
+
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	// Report averaged timings once per second
+	AccumulatedCPUTicks += SDL_GetPerformanceCounter() - cpuStart;
+	AccumulatedFrameTime += context->DeltaTime;
+	AccumulatedFrames += 1;
+	if (AccumulatedFrameTime >= 1.0f)
+	{
+		double cpuMs = (double) AccumulatedCPUTicks * 1000.0 / SDL_GetPerformanceFrequency() / AccumulatedFrames;
+		SDL_Log(
+			"%s generation, %u draws: CPU %.3f ms/frame, frame %.3f ms",
+			UseGPUGeneration ? "GPU" : "CPU",
+			OBJECT_COUNT,
+			cpuMs,
+			AccumulatedFrameTime * 1000.0f / AccumulatedFrames
+		);
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, RenderPipeline);
+	SDL_ReleaseGPUComputePipeline(context->Device, GenerateDrawsPipeline);
+	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, ObjectBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, DrawBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, DrawTransferBuffer);
+
+	SDL_free(Objects);
+	SDL_free(ReferenceCommands);
+	Objects = NULL;
+	ReferenceCommands = NULL;
+
+	UseGPUGeneration = true;
+	ValidateNextFrame = true;
+	t = 0;
+
+	CommonQuit(context);
+}
+
+Example ComputeDrawIndirect_Example = { "ComputeDrawIndirect", Init, Update, Draw, Quit };
@@ -0,0 +1,199 @@
+#include "Common.h"
+
+#define COMPUTE_PRESENT_REPORT_INTERVAL_NS (2 * SDL_NS_PER_SECOND)
+
+/* Also the profiler's pass names, so its GPU times line up with the frame times below */
+static const char* PathNames[COMPUTEPRESENTPATH_COUNT] =
+{
+	"Fragment pass",
+	"Compute + blit"
+};
+
+bool ComputePresenter_Init(ComputePresenter* presenter, SDL_GPUDevice* device, SDL_Window* window)
+{
+	SDL_zerop(presenter);
+	presenter->Device = device;
+	presenter->Window = window;
+	presenter->LastReportNS = SDL_GetTicksNS();
+
+	return GPUProfiler_Init(&presenter->Profiler, device, NULL);
+}
+
+bool ComputePresenter_CanDraw(const ComputePresenter* presenter, SDL_GPUGraphicsPipeline* drawPipeline)
+{
+	return drawPipeline != NULL && !presenter->ForceBlit;
+}
+
+SDL_GPURenderPass* ComputePresenter_BeginDraw(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture)
+{
+	/* The full-screen triangle covers every pixel, so the old contents are never loaded */
+	presenter->RenderPass = SDL_BeginGPURenderPass(
+		commandBuffer,
+		&(SDL_GPUColorTargetInfo){
+			.texture = swapchainTexture,
+			.load_op = SDL_GPU_LOADOP_DONT_CARE,
+			.store_op = SDL_GPU_STOREOP_STORE
+		},
+		1,
+		NULL
+	);
+
+	presenter->Path = COMPUTEPRESENTPATH_DRAW;
+	presenter->Presented = presenter->RenderPass != NULL;
+	return presenter->RenderPass;
+}
+
+SDL_GPUStorageTextureReadWriteBinding ComputePresenter_BeginCompute(
+	ComputePresenter* presenter,
+	SDL_GPUTextureFormat storageFormat,
+	Uint32 width,
+	Uint32 height
+) {
+	presenter->Width = width;
+	presenter->Height = height;
+	presenter->Intermediate = AcquireRenderTarget(presenter->Device, &(RenderTargetDescription){
+		.Format = storageFormat,
+		.Width = width,
+		.Height = height,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+		.Usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
+	});
+	if (presenter->Intermediate == NULL)
+	{
+		SDL_Log("Failed to acquire a %ux%u compute output, skipping the frame", width, height);
+	}
+
+	presenter->Path = COMPUTEPRESENTPATH_BLIT;
+	presenter->Presented = presenter->Intermediate != NULL;
+	return (SDL_GPUStorageTextureReadWriteBinding){
+		.texture = presenter->Intermediate,
+		.cycle = false
+	};
+}
+
+void ComputePresenter_End(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture, SDL_GPUFilter filter)
+{
+	if (presenter->RenderPass != NULL)
+	{
+		SDL_EndGPURenderPass(presenter->RenderPass);
+		presenter->RenderPass = NULL;
+		return;
+	}
+
+	if (presenter->Intermediate == NULL)
+	{
+		return;
+	}
+
+	int windowWidth, windowHeight;
+	SDL_GetWindowSizeInPixels(presenter->Window, &windowWidth, &windowHeight);
+
+	SDL_BlitGPUTexture(
+		commandBuffer,
+		&(SDL_GPUBlitInfo){
+			.source.texture = presenter->Intermediate,
+			.source.w = presenter->Width,
+			.source.h = presenter->Height,
+			.destination.texture = swapchainTexture,
+			.destination.w = windowWidth,
+			.destination.h = windowHeight,
+			.load_op = SDL_GPU_LOADOP_DONT_CARE,
+			.filter = filter
+		}
+	);
+
+	ReleaseRenderTarget(presenter->Intermediate);
+	presenter->Intermediate = NULL;
+}
+
+static void LogStats(const ComputePresentStats* stats, const char* heading)
+{
+	for (int i = 0; i < COMPUTEPRESENTPATH_COUNT; i += 1)
+	{
+		if (stats[i].FrameCount == 0)
+		{
+			continue;
+		}
+
+		SDL_Log(
+			"%s %s: %u frames, %.3f ms/frame",
+			heading,
+			PathNames[i],
+			stats[i].FrameCount,
+			stats[i].FrameNS / (double) stats[i].FrameCount / SDL_NS_PER_MS
+		);
+	}
+}
+
+static void FoldStats(ComputePresenter* presenter)
+{
+	for (int i = 0; i < COMPUTEPRESENTPATH_COUNT; i += 1)
+	{
+		presenter->Totals[i].FrameCount += presenter->Stats[i].FrameCount;
+		presenter->Totals[i].FrameNS += presenter->Stats[i].FrameNS;
+	}
+	SDL_zeroa(presenter->Stats);
+}
+
+bool ComputePresenter_Submit(ComputePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer)
+{
+	/* Collects the frames that finished, and logs their GPU time per path every two seconds */
+	GPUProfiler_BeginFrame(&presenter->Profiler);
+
+	if (!presenter->Presented)
+	{
+		/* Nothing reached the swapchain, so there is no frame to time */
+		presenter->LastSubmitNS = 0;
+		if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+		{
+			SDL_Log("SubmitGPUCommandBuffer failed: %s", SDL_GetError());
+			return false;
+		}
+		return true;
+	}
+	presenter->Presented = false;
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (fence == NULL)
+	{
+		SDL_Log("SubmitGPUCommandBufferAndAcquireFence failed: %s", SDL_GetError());
+		return false;
+	}
+
+	/* The profiler's watcher thread waits on the fence, so the frame never does */
+	GPUProfiler_TrackFence(&presenter->Profiler, PathNames[presenter->Path], fence, NULL, NULL);
+
+	Uint64 now = SDL_GetTicksNS();
+	if (presenter->LastSubmitNS != 0)
+	{
+		ComputePresentStats* stats = &presenter->Stats[presenter->Path];
+		stats->FrameCount += 1;
+		stats->FrameNS += now - presenter->LastSubmitNS;
+	}
+	presenter->LastSubmitNS = now;
+
+	if (now - presenter->LastReportNS >= COMPUTE_PRESENT_REPORT_INTERVAL_NS)
+	{
+		LogStats(presenter->Stats, "Last 2s");
+		FoldStats(presenter);
+		presenter->LastReportNS = now;
+	}
+
+	return true;
+}
+
+void ComputePresenter_Destroy(ComputePresenter* presenter)
+{
+	if (presenter->Device == NULL)
+	{
+		return;
+	}
+
+	/* Logs each path's GPU time since Init once the outstanding frames finish */
+	GPUProfiler_Destroy(&presenter->Profiler);
+
+	FoldStats(presenter);
+	LogStats(presenter->Totals, "Total");
+
+	SDL_zerop(presenter);
+}
@@ -72,7 +72,7 @@ static int Init(Context* context)
     );
 
    	// PointClamp
-	Samplers[0] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[0] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_NEAREST,
 		.mag_filter = SDL_GPU_FILTER_NEAREST,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
@@ -81,7 +81,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
 	});
 	// PointWrap
-	Samplers[1] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[1] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_NEAREST,
 		.mag_filter = SDL_GPU_FILTER_NEAREST,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
@@ -90,7 +90,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
 	});
 	// LinearClamp
-	Samplers[2] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[2] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -99,7 +99,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
 	});
 	// LinearWrap
-	Samplers[3] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[3] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -108,7 +108,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
 	});
 	// AnisotropicClamp
-	Samplers[4] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[4] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -119,7 +119,7 @@ static int Init(Context* context)
 		.max_anisotropy = 4
 	});
 	// AnisotropicWrap
-	Samplers[5] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[5] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -273,11 +273,7 @@ static void Quit(Context* context)
 	SDL_ReleaseGPUTexture(context->Device, Texture);
     SDL_ReleaseGPUTexture(context->Device, WriteTexture);
 
-	for (int i = 0; i < SDL_arraysize(Samplers); i += 1)
-	{
-		SDL_ReleaseGPUSampler(context->Device, Samplers[i]);
-	}
-
+	// The samplers belong to the state cache, which CommonQuit releases
 	CurrentSamplerIndex = 0;
 
 	CommonQuit(context);
@@ -7,9 +7,19 @@ static SDL_GPUSampler* Sampler;
 static SDL_GPUTexture* Texture;
 static SDL_GPUTransferBuffer* SpriteComputeTransferBuffer;
 static SDL_GPUBuffer* SpriteComputeBuffer;
-static SDL_GPUBuffer* SpriteVertexBuffer;
 static SDL_GPUBuffer* SpriteIndexBuffer;
 
+/* The sprite job writes this frame's vertices while the render job is recorded on another
+ * thread. Cycling the buffer during recording would race with the render job binding it,
+ * so the frames take turns with a ring of buffers instead.
+ */
+#define SPRITE_VERTEX_BUFFER_COUNT 3
+static SDL_GPUBuffer* SpriteVertexBuffers[SPRITE_VERTEX_BUFFER_COUNT];
+static SDL_GPUBuffer* SpriteVertexBuffer;
+static Uint32 FrameIndex;
+
+static FrameJobGraph Graph;
+
 typedef struct PositionTextureColorVertex
 {
 	float x, y, z, w;
@@ -27,6 +37,178 @@ typedef struct ComputeSpriteInstance
 
 const Uint32 SPRITE_COUNT = 8192;
 
+/* Runs on a worker thread while the main thread records the render job */
+static void RecordSprites(SDL_GPUCommandBuffer* cmdBuf, SDL_GPUTexture* swapchainTexture, void* userdata)
+{
+	Context* context = userdata;
+
+	// Build sprite instance transfer
+	ComputeSpriteInstance* dataPtr = SDL_MapGPUTransferBuffer(
+		context->Device,
+		SpriteComputeTransferBuffer,
+		true
+	);
+
+	for (Uint32 i = 0; i < SPRITE_COUNT; i += 1)
+	{
+		dataPtr[i].x = (float)(rand() % 640);
+		dataPtr[i].y = (float)(rand() % 480);
+		dataPtr[i].z = 0;
+		dataPtr[i].w = 1;
+		dataPtr[i].rotation = ((float)rand())/(RAND_MAX/(SDL_PI_F * 2));
+		dataPtr[i].w = 32;
+		dataPtr[i].h = 32;
+		dataPtr[i].r = 1.0f;
+		dataPtr[i].g = 1.0f;
+		dataPtr[i].b = 1.0f;
+		dataPtr[i].a = 1.0f;
+	}
+
+	SDL_UnmapGPUTransferBuffer(context->Device, SpriteComputeTransferBuffer);
+
+	// Upload instance data
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = SpriteComputeTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = SpriteComputeBuffer,
+			.offset = 0,
+			.size = SPRITE_COUNT * sizeof(ComputeSpriteInstance)
+		},
+		true
+	);
+	SDL_EndGPUCopyPass(copyPass);
+
+	// Set up compute pass to build vertex buffer
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		cmdBuf,
+		NULL,
+		0,
+		&(SDL_GPUStorageBufferReadWriteBinding){
+			.buffer = SpriteVertexBuffer,
+			.cycle = false
+		},
+		1
+	);
+
+	SDL_BindGPUComputePipeline(computePass, ComputePipeline);
+	SDL_BindGPUComputeStorageBuffers(
+		computePass,
+		0,
+		&(SDL_GPUBuffer*){
+			SpriteComputeBuffer,
+		},
+		1
+	);
+	SDL_DispatchGPUCompute(computePass, SPRITE_COUNT / 64, 1, 1);
+
+	SDL_EndGPUComputePass(computePass);
+}
+
+static void RecordRender(SDL_GPUCommandBuffer* cmdBuf, SDL_GPUTexture* swapchainTexture, void* userdata)
+{
+	if (swapchainTexture == NULL)
+	{
+		return;
+	}
+
+	Matrix4x4 cameraMatrix = Matrix4x4_CreateOrthographicOffCenter(
+		0,
+		640,
+		480,
+		0,
+		0,
+		-1
+	);
+
+	// Render sprites
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
+		cmdBuf,
+		&(SDL_GPUColorTargetInfo){
+			.texture = swapchainTexture,
+			.cycle = false,
+			.load_op = SDL_GPU_LOADOP_CLEAR,
+			.store_op = SDL_GPU_STOREOP_STORE,
+			.clear_color = { 0, 0, 0, 1 }
+		},
+		1,
+		NULL
+	);
+
+	SDL_BindGPUGraphicsPipeline(renderPass, RenderPipeline);
+	SDL_BindGPUVertexBuffers(
+		renderPass,
+		0,
+		&(SDL_GPUBufferBinding){
+			.buffer = SpriteVertexBuffer
+		},
+		1
+	);
+	SDL_BindGPUIndexBuffer(
+		renderPass,
+		&(SDL_GPUBufferBinding){
+			.buffer = SpriteIndexBuffer
+		},
+		SDL_GPU_INDEXELEMENTSIZE_32BIT
+	);
+	SDL_BindGPUFragmentSamplers(
+		renderPass,
+		0,
+		&(SDL_GPUTextureSamplerBinding){
+			.texture = Texture,
+			.sampler = Sampler
+		},
+		1
+	);
+	SDL_PushGPUVertexUniformData(
+		cmdBuf,
+		0,
+		&cameraMatrix,
+		sizeof(Matrix4x4)
+	);
+	SDL_DrawGPUIndexedPrimitives(
+		renderPass,
+		SPRITE_COUNT * 6,
+		1,
+		0,
+		0,
+		0
+	);
+
+	SDL_EndGPURenderPass(renderPass);
+}
+
+static bool BuildGraph(Context* context)
+{
+	int coreCount = SDL_GetNumLogicalCPUCores();
+	if (!FrameJobGraph_Init(&Graph, context->Device, coreCount > 1 ? 1 : 0))
+	{
+		return false;
+	}
+
+	int spriteJob = FrameJobGraph_AddJob(&Graph, &(FrameJobDescription){
+		.Name = "Sprites",
+		.Record = RecordSprites,
+		.Userdata = context
+	});
+	if (spriteJob < 0)
+	{
+		return false;
+	}
+
+	int renderJob = FrameJobGraph_AddJob(&Graph, &(FrameJobDescription){
+		.Name = "Render",
+		.Record = RecordRender,
+		.Dependencies = 1u << spriteJob,
+		.Window = context->Window
+	});
+	return renderJob >= 0;
+}
+
 static int Init(Context* context)
 {
 	int result = CommonInit(context, 0);
@@ -35,28 +217,7 @@ static int Init(Context* context)
 		return result;
 	}
 
-	SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
-	if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_IMMEDIATE
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
-	}
-	else if (SDL_WindowSupportsGPUPresentMode(
-		context->Device,
-		context->Window,
-		SDL_GPU_PRESENTMODE_MAILBOX
-	)) {
-		presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
-	}
-
-	SDL_SetGPUSwapchainParameters(
-		context->Device,
-		context->Window,
-		SDL_GPU_SWAPCHAINCOMPOSITION_SDR,
-		presentMode
-	);
+	ApplyPresentPolicy(context->Device, context->Window, PRESENTPOLICY_LOWEST_LATENCY);
 
 	srand(0);
 
@@ -80,7 +241,7 @@ static int Init(Context* context)
 	);
 
 	// Create the sprite render pipeline
-	RenderPipeline = SDL_CreateGPUGraphicsPipeline(
+	RenderPipeline = GetCachedGraphicsPipeline(
 		context->Device,
 		&(SDL_GPUGraphicsPipelineCreateInfo){
 			.target_info = (SDL_GPUGraphicsPipelineTargetInfo){
@@ -125,7 +286,7 @@ static int Init(Context* context)
 	SDL_ReleaseGPUShader(context->Device, fragShader);
 
 	// Create the sprite batch compute pipeline
-	ComputePipeline = CreateComputePipelineFromShader(
+	ComputePipeline = GetCachedComputePipeline(
 		context->Device,
 		"SpriteBatch.comp",
 		&(SDL_GPUComputePipelineCreateInfo){
@@ -203,13 +364,16 @@ static int Init(Context* context)
 		}
 	);
 
-	SpriteVertexBuffer = SDL_CreateGPUBuffer(
-		context->Device,
-		&(SDL_GPUBufferCreateInfo) {
-			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_BUFFERUSAGE_VERTEX,
-			.size = SPRITE_COUNT * 4 * sizeof(PositionTextureColorVertex)
-		}
-	);
+	for (Uint32 i = 0; i < SPRITE_VERTEX_BUFFER_COUNT; i += 1)
+	{
+		SpriteVertexBuffers[i] = SDL_CreateGPUBuffer(
+			context->Device,
+			&(SDL_GPUBufferCreateInfo) {
+				.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_BUFFERUSAGE_VERTEX,
+				.size = SPRITE_COUNT * 4 * sizeof(PositionTextureColorVertex)
+			}
+		);
+	}
 
 	SpriteIndexBuffer = SDL_CreateGPUBuffer(
 		context->Device,
@@ -287,7 +451,7 @@ static int Init(Context* context)
 	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
 	SDL_ReleaseGPUTransferBuffer(context->Device, indexBufferTransferBuffer);
 
-	return 0;
+	return BuildGraph(context) ? 0 : -1;
 }
 
 static int Update(Context* context)
@@ -297,168 +461,27 @@ static int Update(Context* context)
 
 static int Draw(Context* context)
 {
-	Matrix4x4 cameraMatrix = Matrix4x4_CreateOrthographicOffCenter(
-		0,
-		640,
-		480,
-		0,
-		0,
-		-1
-	);
-
-    SDL_GPUCommandBuffer* cmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
-    if (cmdBuf == NULL)
-    {
-        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
-        return -1;
-    }
+	SpriteVertexBuffer = SpriteVertexBuffers[FrameIndex];
+	FrameIndex = (FrameIndex + 1) % SPRITE_VERTEX_BUFFER_COUNT;
 
-    SDL_GPUTexture* swapchainTexture;
-    if (!SDL_AcquireGPUSwapchainTexture(cmdBuf, context->Window, &swapchainTexture)) {
-        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
-        return -1;
-    }
-
-	if (swapchainTexture != NULL)
-	{
-		// Build sprite instance transfer
-		ComputeSpriteInstance* dataPtr = SDL_MapGPUTransferBuffer(
-			context->Device,
-			SpriteComputeTransferBuffer,
-			true
-		);
-
-		for (Uint32 i = 0; i < SPRITE_COUNT; i += 1)
-		{
-			dataPtr[i].x = (float)(rand() % 640);
-			dataPtr[i].y = (float)(rand() % 480);
-			dataPtr[i].z = 0;
-			dataPtr[i].w = 1;
-			dataPtr[i].rotation = ((float)rand())/(RAND_MAX/(SDL_PI_F * 2));
-			dataPtr[i].w = 32;
-			dataPtr[i].h = 32;
-			dataPtr[i].r = 1.0f;
-			dataPtr[i].g = 1.0f;
-			dataPtr[i].b = 1.0f;
-			dataPtr[i].a = 1.0f;
-		}
-
-		SDL_UnmapGPUTransferBuffer(context->Device, SpriteComputeTransferBuffer);
-
-		// Upload instance data
-		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdBuf);
-		SDL_UploadToGPUBuffer(
-			copyPass,
-			&(SDL_GPUTransferBufferLocation) {
-				.transfer_buffer = SpriteComputeTransferBuffer,
-				.offset = 0
-			},
-			&(SDL_GPUBufferRegion) {
-				.buffer = SpriteComputeBuffer,
-				.offset = 0,
-				.size = SPRITE_COUNT * sizeof(ComputeSpriteInstance)
-			},
-			true
-		);
-		SDL_EndGPUCopyPass(copyPass);
-
-		// Set up compute pass to build vertex buffer
-		SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
-			cmdBuf,
-			NULL,
-			0,
-			&(SDL_GPUStorageBufferReadWriteBinding){
-				.buffer = SpriteVertexBuffer,
-				.cycle = true
-			},
-			1
-		);
-
-		SDL_BindGPUComputePipeline(computePass, ComputePipeline);
-		SDL_BindGPUComputeStorageBuffers(
-			computePass,
-			0,
-			&(SDL_GPUBuffer*){
-				SpriteComputeBuffer,
-			},
-			1
-		);
-		SDL_DispatchGPUCompute(computePass, SPRITE_COUNT / 64, 1, 1);
-
-		SDL_EndGPUComputePass(computePass);
-
-		// Render sprites
-		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
-			cmdBuf,
-			&(SDL_GPUColorTargetInfo){
-				.texture = swapchainTexture,
-				.cycle = false,
-				.load_op = SDL_GPU_LOADOP_CLEAR,
-				.store_op = SDL_GPU_STOREOP_STORE,
-				.clear_color = { 0, 0, 0, 1 }
-			},
-			1,
-			NULL
-		);
-
-		SDL_BindGPUGraphicsPipeline(renderPass, RenderPipeline);
-		SDL_BindGPUVertexBuffers(
-			renderPass,
-			0,
-			&(SDL_GPUBufferBinding){
-				.buffer = SpriteVertexBuffer
-			},
-			1
-		);
-		SDL_BindGPUIndexBuffer(
-			renderPass,
-			&(SDL_GPUBufferBinding){
-				.buffer = SpriteIndexBuffer
-			},
-			SDL_GPU_INDEXELEMENTSIZE_32BIT
-		);
-		SDL_BindGPUFragmentSamplers(
-			renderPass,
-			0,
-			&(SDL_GPUTextureSamplerBinding){
-				.texture = Texture,
-				.sampler = Sampler
-			},
-			1
-		);
-		SDL_PushGPUVertexUniformData(
-			cmdBuf,
-			0,
-			&cameraMatrix,
-			sizeof(Matrix4x4)
-		);
-		SDL_DrawGPUIndexedPrimitives(
-			renderPass,
-			SPRITE_COUNT * 6,
-			1,
-			0,
-			0,
-			0
-		);
-
-		SDL_EndGPURenderPass(renderPass);
-	}
-
-	SDL_SubmitGPUCommandBuffer(cmdBuf);
-
-	return 0;
+	return FrameJobGraph_Execute(&Graph) ? 0 : -1;
 }
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUComputePipeline(context->Device, ComputePipeline);
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, RenderPipeline);
+	// The pipelines belong to the state cache, which CommonQuit releases
+	FrameJobGraph_Destroy(&Graph);
 	SDL_ReleaseGPUSampler(context->Device, Sampler);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
 	SDL_ReleaseGPUTransferBuffer(context->Device, SpriteComputeTransferBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, SpriteComputeBuffer);
-	SDL_ReleaseGPUBuffer(context->Device, SpriteVertexBuffer);
+	for (Uint32 i = 0; i < SPRITE_VERTEX_BUFFER_COUNT; i += 1)
+	{
+		SDL_ReleaseGPUBuffer(context->Device, SpriteVertexBuffers[i]);
+	}
 	SDL_ReleaseGPUBuffer(context->Device, SpriteIndexBuffer);
+	SpriteVertexBuffer = NULL;
+	FrameIndex = 0;
 
 	CommonQuit(context);
 }
@@ -1,7 +1,8 @@
 #include "Common.h"
 
 static SDL_GPUComputePipeline* GradientPipeline;
-static SDL_GPUTexture* GradientRenderTexture;
+static SDL_GPUGraphicsPipeline* DrawPipeline;
+static ComputePresenter Presenter;
 
 typedef struct GradientUniforms
 {
@@ -30,21 +31,46 @@ static int Init(Context* context)
         }
     );
 
-    int w, h;
-    SDL_GetWindowSizeInPixels(context->Window, &w, &h);
+    // The same gradient as a full-screen pass, which writes the swapchain without a blit
+    SDL_GPUShader* vertexShader = LoadShader(context->Device, "Fullscreen.vert", 0, 0, 0, 0);
+    SDL_GPUShader* fragmentShader = LoadShader(context->Device, "GradientTexture.frag", 0, 0, 0, 0);
+    if (vertexShader != NULL && fragmentShader != NULL)
+    {
+        DrawPipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+            .target_info = {
+                .num_color_targets = 1,
+                .color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+                    .format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+                }},
+            },
+            .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+            .vertex_shader = vertexShader,
+            .fragment_shader = fragmentShader
+        });
+    }
+    if (vertexShader != NULL)
+    {
+        SDL_ReleaseGPUShader(context->Device, vertexShader);
+    }
+    if (fragmentShader != NULL)
+    {
+        SDL_ReleaseGPUShader(context->Device, fragmentShader);
+    }
+    if (DrawPipeline == NULL)
+    {
+        SDL_Log("Failed to create the fragment pipeline, presenting through compute + blit");
+    }
 
-    GradientRenderTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
-        .format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
-        .type = SDL_GPU_TEXTURETYPE_2D,
-        .width = w,
-        .height = h,
-        .layer_count_or_depth = 1,
-        .num_levels = 1,
-        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
-    });
+    // The presenter owns the intermediate texture the blit path writes the gradient to
+    if (!ComputePresenter_Init(&Presenter, context->Device, context->Window))
+    {
+        return -1;
+    }
 
     GradientUniformValues.time = 0;
 
+    SDL_Log("Press Left/Right to toggle forcing the compute + blit path");
+
     return 0;
 }
 
@@ -52,6 +78,12 @@ static int Update(Context* context)
 {
     GradientUniformValues.time += 0.01f;
 
+    if (context->LeftPressed || context->RightPressed)
+    {
+        Presenter.ForceBlit = !Presenter.ForceBlit;
+        SDL_Log("Force blit: %s", Presenter.ForceBlit ? "on" : "off");
+    }
+
     return 0;
 }
 
@@ -75,47 +107,59 @@ static int Draw(Context* context)
         int w, h;
         SDL_GetWindowSizeInPixels(context->Window, &w, &h);
 
-        SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
-            cmdbuf,
-            (SDL_GPUStorageTextureReadWriteBinding[]){{
-                .texture = GradientRenderTexture,
-                .cycle = true
-            }},
-            1,
-            NULL,
-            0
-        );
-
-        SDL_BindGPUComputePipeline(computePass, GradientPipeline);
-        SDL_PushGPUComputeUniformData(cmdbuf, 0, &GradientUniformValues, sizeof(GradientUniforms));
-        SDL_DispatchGPUCompute(computePass, w / 8 , h / 8 , 1);
-
-        SDL_EndGPUComputePass(computePass);
-
-        SDL_BlitGPUTexture(
-            cmdbuf,
-            &(SDL_GPUBlitInfo){
-                .source.texture = GradientRenderTexture,
-                .source.w = w,
-                .source.h = h,
-                .destination.texture = swapchainTexture,
-                .destination.w = w,
-                .destination.h = h,
-                .load_op = SDL_GPU_LOADOP_DONT_CARE,
-                .filter = SDL_GPU_FILTER_LINEAR
+        if (ComputePresenter_CanDraw(&Presenter, DrawPipeline))
+        {
+            SDL_GPURenderPass* renderPass = ComputePresenter_BeginDraw(&Presenter, cmdbuf, swapchainTexture);
+            SDL_BindGPUGraphicsPipeline(renderPass, DrawPipeline);
+            SDL_PushGPUFragmentUniformData(cmdbuf, 0, &GradientUniformValues, sizeof(GradientUniforms));
+            SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+            ComputePresenter_End(&Presenter, cmdbuf, swapchainTexture, SDL_GPU_FILTER_LINEAR);
+        }
+        else
+        {
+            // GradientTexture.comp writes an rgba8 image
+            SDL_GPUStorageTextureReadWriteBinding outputBinding = ComputePresenter_BeginCompute(
+                &Presenter,
+                SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+                w,
+                h
+            );
+
+            if (outputBinding.texture != NULL)
+            {
+                SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+                    cmdbuf,
+                    &outputBinding,
+                    1,
+                    NULL,
+                    0
+                );
+
+                SDL_BindGPUComputePipeline(computePass, GradientPipeline);
+                SDL_PushGPUComputeUniformData(cmdbuf, 0, &GradientUniformValues, sizeof(GradientUniforms));
+                SDL_DispatchGPUCompute(computePass, w / 8 , h / 8 , 1);
+
+                SDL_EndGPUComputePass(computePass);
+
+                ComputePresenter_End(&Presenter, cmdbuf, swapchainTexture, SDL_GPU_FILTER_LINEAR);
             }
-        );
+        }
     }
 
-    SDL_SubmitGPUCommandBuffer(cmdbuf);
+    if (!ComputePresenter_Submit(&Presenter, cmdbuf))
+    {
+        return -1;
+    }
 
     return 0;
 }
 
 static void Quit(Context* context)
 {
+    // The draw pipeline belongs to the state cache, which CommonQuit releases
     SDL_ReleaseGPUComputePipeline(context->Device, GradientPipeline);
-    SDL_ReleaseGPUTexture(context->Device, GradientRenderTexture);
+    DrawPipeline = NULL;
+    ComputePresenter_Destroy(&Presenter);
 
     CommonQuit(context);
 }
@@ -0,0 +1,473 @@
+#include "Common.h"
+
+/* Cubemap loading: all six faces are opened and decoded concurrently, one thread per face,
+ * straight into a single transfer buffer that is then uploaded in one copy pass.
+ *
+ * Each thread first opens its file and reports back, so the transfer buffer can be sized
+ * and mapped once every face's dimensions are known, then decodes into its own slice of it.
+ *
+ * Authored mip levels sit next to the face as <name>.mip<level>.<extension>, e.g. cube0.mip1.bmp.
+ * A face's levels are read up to the first one missing, and only the levels below that are
+ * box-filtered at load time.
+ */
+
+#define CUBEMAP_FACE_COUNT 6
+#define CUBEMAP_MAX_LEVELS 16
+
+typedef struct CubemapLoad CubemapLoad;
+
+typedef struct CubemapFaceJob
+{
+	CubemapLoad* Load;
+	const char* Filename;
+	SDL_Thread* Thread;
+	ImageFile Levels[CUBEMAP_MAX_LEVELS];
+	Uint32 AuthoredLevelCount;
+	bool Opened;
+	Uint8* Staging;
+	bool Decoded;
+} CubemapFaceJob;
+
+struct CubemapLoad
+{
+	CubemapFaceJob Faces[CUBEMAP_FACE_COUNT];
+	SDL_Semaphore* OpenedSemaphore;
+	SDL_Semaphore* StagingSemaphore;
+	Uint32 Size;
+	Uint32 LevelCount;
+};
+
+/* Matches the std140 layout of the UniformBlock in PrefilterSpecular.comp */
+typedef struct PrefilterUniforms
+{
+	Uint32 Face;
+	Uint32 Size;
+	float Roughness;
+	Uint32 SampleCount;
+	float SourceSize;
+	Uint32 Padding[3];
+} PrefilterUniforms;
+
+static Uint32 GetMipChainSize(Uint32 size, Uint32 levelCount)
+{
+	Uint32 total = 0;
+	for (Uint32 level = 0; level < levelCount; level += 1)
+	{
+		Uint32 levelSize = SDL_max(size >> level, 1);
+		total += levelSize * levelSize * 4;
+	}
+	return total;
+}
+
+static void DownsampleBox(const Uint8* source, Uint32 sourceSize, Uint8* destination)
+{
+	Uint32 destinationSize = SDL_max(sourceSize / 2, 1);
+	Uint32 step = sourceSize > 1 ? 1 : 0;
+
+	for (Uint32 y = 0; y < destinationSize; y += 1)
+	{
+		const Uint8* row0 = &source[(y * 2) * sourceSize * 4];
+		const Uint8* row1 = &source[((y * 2) + step) * sourceSize * 4];
+		for (Uint32 x = 0; x < destinationSize; x += 1)
+		{
+			Uint32 x0 = (x * 2) * 4;
+			Uint32 x1 = ((x * 2) + step) * 4;
+			for (Uint32 c = 0; c < 4; c += 1)
+			{
+				destination[(((y * destinationSize) + x) * 4) + c] = (Uint8) ((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+			}
+		}
+	}
+}
+
+/* cube0.bmp becomes cube0.mip1.bmp for level 1 */
+static void GetLevelFilename(const char* faceFilename, Uint32 level, char* levelFilename, size_t maxLength)
+{
+	const char* extension = SDL_strrchr(faceFilename, '.');
+	if (extension == NULL)
+	{
+		SDL_snprintf(levelFilename, maxLength, "%s.mip%u", faceFilename, level);
+		return;
+	}
+
+	SDL_snprintf(levelFilename, maxLength, "%.*s.mip%u%s", (int) (extension - faceFilename), faceFilename, level, extension);
+}
+
+static void OpenFace(CubemapFaceJob* job)
+{
+	job->Opened = OpenImage(job->Filename, &job->Levels[0]);
+	job->AuthoredLevelCount = job->Opened ? 1 : 0;
+
+	/* The sizes are checked once every face is open */
+	char levelFilename[256];
+	for (Uint32 level = 1; job->Opened && level < CUBEMAP_MAX_LEVELS; level += 1)
+	{
+		GetLevelFilename(job->Filename, level, levelFilename, sizeof(levelFilename));
+		if (!ImageExists(levelFilename))
+		{
+			break;
+		}
+
+		job->Opened = OpenImage(levelFilename, &job->Levels[level]);
+		job->AuthoredLevelCount += 1;
+	}
+}
+
+static void CloseFace(CubemapFaceJob* job)
+{
+	for (Uint32 level = 0; level < job->AuthoredLevelCount; level += 1)
+	{
+		CloseImage(&job->Levels[level]);
+	}
+}
+
+static bool DecodeFace(CubemapFaceJob* job)
+{
+	Uint32 size = job->Load->Size;
+	Uint32 levelCount = job->Load->LevelCount;
+	Uint32 authoredLevelCount = SDL_min(job->AuthoredLevelCount, levelCount);
+
+	/* Every level comes from a file, so each decodes straight into its slice of the transfer buffer */
+	Uint8* destination = job->Staging;
+	if (authoredLevelCount < levelCount)
+	{
+		/* Transfer memory may be write-combined, so build the chain in cached memory and copy it once */
+		destination = SDL_malloc(GetMipChainSize(size, levelCount));
+		if (destination == NULL)
+		{
+			return false;
+		}
+	}
+
+	bool decoded = true;
+	Uint8* level = destination;
+	for (Uint32 i = 0; i < levelCount && decoded; i += 1)
+	{
+		Uint32 levelSize = SDL_max(size >> i, 1);
+		if (i < authoredLevelCount)
+		{
+			decoded = DecodeImage(&job->Levels[i], level, levelSize * 4);
+		}
+		else
+		{
+			Uint32 previousSize = SDL_max(size >> (i - 1), 1);
+			DownsampleBox(level - (previousSize * previousSize * 4), previousSize, level);
+		}
+		level += levelSize * levelSize * 4;
+	}
+
+	if (destination != job->Staging)
+	{
+		if (decoded)
+		{
+			SDL_memcpy(job->Staging, destination, GetMipChainSize(size, levelCount));
+		}
+		SDL_free(destination);
+	}
+	return decoded;
+}
+
+static int CubemapFaceThread(void* data)
+{
+	CubemapFaceJob* job = data;
+
+	OpenFace(job);
+	SDL_SignalSemaphore(job->Load->OpenedSemaphore);
+
+	SDL_WaitSemaphore(job->Load->StagingSemaphore);
+	if (job->Opened && job->Staging != NULL)
+	{
+		job->Decoded = DecodeFace(job);
+	}
+
+	CloseFace(job);
+	return 0;
+}
+
+SDL_GPUTexture* LoadCubemap(
+	SDL_GPUDevice* device,
+	const char* const faceFilenames[6],
+	Uint32 levelCount,
+	SDL_GPUTextureUsageFlags extraUsage,
+	CubemapInfo* pInfo
+) {
+	Uint64 start = SDL_GetPerformanceCounter();
+
+	CubemapLoad load = { 0 };
+	load.OpenedSemaphore = SDL_CreateSemaphore(0);
+	load.StagingSemaphore = SDL_CreateSemaphore(0);
+
+	for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+	{
+		CubemapFaceJob* job = &load.Faces[i];
+		job->Load = &load;
+		job->Filename = faceFilenames[i];
+		job->Thread = SDL_CreateThread(CubemapFaceThread, "CubemapFace", job);
+		if (job->Thread == NULL)
+		{
+			/* Finish this face on the calling thread instead */
+			OpenFace(job);
+			SDL_SignalSemaphore(load.OpenedSemaphore);
+		}
+	}
+
+	for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+	{
+		SDL_WaitSemaphore(load.OpenedSemaphore);
+	}
+
+	bool valid = true;
+	for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+	{
+		const ImageFile* image = &load.Faces[i].Levels[0];
+		if (!load.Faces[i].Opened)
+		{
+			valid = false;
+		}
+		else if (image->Width != image->Height || image->Width != load.Faces[0].Levels[0].Width)
+		{
+			SDL_Log("Cubemap face %s is %dx%d, faces must be square and the same size!", faceFilenames[i], image->Width, image->Height);
+			valid = false;
+		}
+	}
+
+	SDL_GPUTransferBuffer* transferBuffer = NULL;
+	Uint32 faceSize = 0;
+	Uint32 authoredLevelCount = 0;
+	if (valid)
+	{
+		Uint32 maxLevelCount = 1;
+		load.Size = load.Faces[0].Levels[0].Width;
+		while ((load.Size >> maxLevelCount) > 0 && maxLevelCount < CUBEMAP_MAX_LEVELS)
+		{
+			maxLevelCount += 1;
+		}
+		load.LevelCount = (levelCount == 0) ? maxLevelCount : SDL_min(levelCount, maxLevelCount);
+		faceSize = GetMipChainSize(load.Size, load.LevelCount);
+
+		authoredLevelCount = load.LevelCount;
+		for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+		{
+			const CubemapFaceJob* job = &load.Faces[i];
+			for (Uint32 level = 1; level < SDL_min(job->AuthoredLevelCount, load.LevelCount); level += 1)
+			{
+				const ImageFile* image = &job->Levels[level];
+				int levelSize = SDL_max(load.Size >> level, 1);
+				if (image->Width != levelSize || image->Height != levelSize)
+				{
+					SDL_Log("Cubemap face %s has a %dx%d level %u, it should be %dx%d!", faceFilenames[i], image->Width, image->Height, level, levelSize, levelSize);
+					valid = false;
+				}
+			}
+			authoredLevelCount = SDL_min(authoredLevelCount, job->AuthoredLevelCount);
+		}
+	}
+
+	if (valid)
+	{
+
+		transferBuffer = SDL_CreateGPUTransferBuffer(
+			device,
+			&(SDL_GPUTransferBufferCreateInfo) {
+				.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+				.size = faceSize * CUBEMAP_FACE_COUNT
+			}
+		);
+
+		Uint8* staging = transferBuffer ? SDL_MapGPUTransferBuffer(device, transferBuffer, false) : NULL;
+		for (int i = 0; i < CUBEMAP_FACE_COUNT && staging != NULL; i += 1)
+		{
+			load.Faces[i].Staging = staging + (faceSize * i);
+		}
+	}
+
+	for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+	{
+		SDL_SignalSemaphore(load.StagingSemaphore);
+	}
+
+	bool decoded = load.Faces[0].Staging != NULL;
+	for (int i = 0; i < CUBEMAP_FACE_COUNT; i += 1)
+	{
+		CubemapFaceJob* job = &load.Faces[i];
+		if (job->Thread != NULL)
+		{
+			SDL_WaitThread(job->Thread, NULL);
+		}
+		else
+		{
+			if (job->Opened && job->Staging != NULL)
+			{
+				job->Decoded = DecodeFace(job);
+			}
+			CloseFace(job);
+		}
+		decoded = decoded && job->Decoded;
+	}
+
+	SDL_DestroySemaphore(load.OpenedSemaphore);
+	SDL_DestroySemaphore(load.StagingSemaphore);
+
+	if (load.Faces[0].Staging != NULL)
+	{
+		SDL_UnmapGPUTransferBuffer(device, transferBuffer);
+	}
+
+	Uint64 decodeEnd = SDL_GetPerformanceCounter();
+
+	SDL_GPUTexture* texture = NULL;
+	if (decoded)
+	{
+		texture = SDL_CreateGPUTexture(device, &(SDL_GPUTextureCreateInfo){
+			.type = SDL_GPU_TEXTURETYPE_CUBE,
+			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.width = load.Size,
+			.height = load.Size,
+			.layer_count_or_depth = CUBEMAP_FACE_COUNT,
+			.num_levels = load.LevelCount,
+			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | extraUsage
+		});
+	}
+	else if (valid)
+	{
+		SDL_Log("Failed to decode cubemap faces!");
+	}
+
+	if (texture != NULL)
+	{
+		SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(device);
+		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+
+		for (Uint32 face = 0; face < CUBEMAP_FACE_COUNT; face += 1)
+		{
+			Uint32 offset = faceSize * face;
+			for (Uint32 level = 0; level < load.LevelCount; level += 1)
+			{
+				Uint32 levelSize = SDL_max(load.Size >> level, 1);
+				SDL_UploadToGPUTexture(
+					copyPass,
+					&(SDL_GPUTextureTransferInfo) {
+						.transfer_buffer = transferBuffer,
+						.offset = offset
+					},
+					&(SDL_GPUTextureRegion) {
+						.texture = texture,
+						.mip_level = level,
+						.layer = face,
+						.w = levelSize,
+						.h = levelSize,
+						.d = 1
+					},
+					false
+				);
+				offset += levelSize * levelSize * 4;
+			}
+		}
+
+		SDL_EndGPUCopyPass(copyPass);
+		SDL_SubmitGPUCommandBuffer(cmdbuf);
+	}
+
+	if (transferBuffer != NULL)
+	{
+		SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+	}
+
+	Uint64 end = SDL_GetPerformanceCounter();
+
+	if (pInfo != NULL)
+	{
+		pInfo->Size = load.Size;
+		pInfo->LevelCount = load.LevelCount;
+		pInfo->AuthoredLevelCount = authoredLevelCount;
+		pInfo->StagingSize = faceSize * CUBEMAP_FACE_COUNT;
+		pInfo->DecodeMilliseconds = (float) ((double) (decodeEnd - start) * 1000.0 / SDL_GetPerformanceFrequency());
+		pInfo->UploadMilliseconds = (float) ((double) (end - decodeEnd) * 1000.0 / SDL_GetPerformanceFrequency());
+	}
+
+	return texture;
+}
+
+bool SpecularPrefilter_Init(SpecularPrefilter* prefilter, SDL_GPUDevice* device)
+{
+	prefilter->Pipeline = CreateComputePipelineFromShader(
+		device,
+		"PrefilterSpecular.comp",
+		/* Everything but the shader is filled in by reflection */
+		&(SDL_GPUComputePipelineCreateInfo) { 0 }
+	);
+	if (prefilter->Pipeline == NULL)
+	{
+		return false;
+	}
+
+	prefilter->Sampler = SDL_CreateGPUSampler(device, &(SDL_GPUSamplerCreateInfo){
+		.min_filter = SDL_GPU_FILTER_LINEAR,
+		.mag_filter = SDL_GPU_FILTER_LINEAR,
+		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
+		.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.max_lod = 1000.0f
+	});
+
+	return prefilter->Sampler != NULL;
+}
+
+void SpecularPrefilter_Destroy(SpecularPrefilter* prefilter, SDL_GPUDevice* device)
+{
+	SDL_ReleaseGPUComputePipeline(device, prefilter->Pipeline);
+	SDL_ReleaseGPUSampler(device, prefilter->Sampler);
+	prefilter->Pipeline = NULL;
+	prefilter->Sampler = NULL;
+}
+
+void SpecularPrefilter_Run(
+	const SpecularPrefilter* prefilter,
+	SDL_GPUCommandBuffer* commandBuffer,
+	SDL_GPUTexture* source,
+	Uint32 sourceSize,
+	SDL_GPUTexture* destination,
+	Uint32 destinationSize,
+	Uint32 levelCount,
+	Uint32 sampleCount
+) {
+	for (Uint32 level = 0; level < levelCount; level += 1)
+	{
+		PrefilterUniforms uniforms = {
+			.Size = SDL_max(destinationSize >> level, 1),
+			.Roughness = levelCount > 1 ? (float) level / (levelCount - 1) : 0.0f,
+			.SampleCount = sampleCount,
+			.SourceSize = (float) sourceSize
+		};
+
+		/* Storage bindings are per pass, and each face is a separate layer */
+		for (Uint32 face = 0; face < CUBEMAP_FACE_COUNT; face += 1)
+		{
+			uniforms.Face = face;
+
+			SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+				commandBuffer,
+				&(SDL_GPUStorageTextureReadWriteBinding){
+					.texture = destination,
+					.mip_level = level,
+					.layer = face
+				},
+				1,
+				NULL,
+				0
+			);
+
+			SDL_BindGPUComputePipeline(computePass, prefilter->Pipeline);
+			SDL_BindGPUComputeSamplers(
+				computePass,
+				0,
+				&(SDL_GPUTextureSamplerBinding){ .texture = source, .sampler = prefilter->Sampler },
+				1
+			);
+			SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+			SDL_DispatchGPUCompute(computePass, (uniforms.Size + 7) / 8, (uniforms.Size + 7) / 8, 1);
+			SDL_EndGPUComputePass(computePass);
+		}
+	}
+}
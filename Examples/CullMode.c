@@ -80,7 +80,7 @@ static int Init(Context* context)
 			SDL_GPU_FRONTFACE_CLOCKWISE :
 			SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE;
 
-		Pipelines[i] = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		Pipelines[i] = GetCachedGraphicsPipeline(context->Device, &pipelineCreateInfo);
 		if (Pipelines[i] == NULL)
 		{
 			SDL_Log("Failed to create pipeline!");
@@ -237,11 +237,7 @@ static int Draw(Context* context)
 
 static void Quit(Context* context)
 {
-	for (int i = 0; i < SDL_arraysize(Pipelines); i += 1)
-	{
-		SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[i]);
-	}
-
+	// The pipelines belong to the state cache, which CommonQuit releases
 	SDL_ReleaseGPUBuffer(context->Device, VertexBufferCW);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBufferCCW);
 
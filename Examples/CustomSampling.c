@@ -1,6 +1,6 @@
 #include "Common.h"
 
-static SDL_GPUGraphicsPipeline* Pipeline;
+static SDL_GPUGraphicsPipeline* Pipelines[2];
 static SDL_GPUBuffer* VertexBuffer;
 static SDL_GPUBuffer* IndexBuffer;
 static SDL_GPUTexture* Texture;
@@ -23,11 +23,18 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "CustomSampling.frag", 0, 1, 0, 1);
-	if (fragmentShader == NULL)
+	// Each sampler mode is its own variant of the fragment shader, specialized on constant 0
+	SDL_GPUShader* fragmentShaders[2];
+	for (int i = 0; i < 2; i += 1)
 	{
-		SDL_Log("Failed to create fragment shader!");
-		return -1;
+		char variantName[64];
+		SDL_snprintf(variantName, sizeof(variantName), "CustomSampling.frag:0=%d", i);
+		fragmentShaders[i] = LoadShader(context->Device, variantName, 0, 0, 0, 1);
+		if (fragmentShaders[i] == NULL)
+		{
+			SDL_Log("Failed to create fragment shader!");
+			return -1;
+		}
 	}
 
 	// Load the image
@@ -68,19 +75,22 @@ static int Init(Context* context)
 			}}
 		},
 		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
-		.vertex_shader = vertexShader,
-		.fragment_shader = fragmentShader
+		.vertex_shader = vertexShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
-	if (Pipeline == NULL)
+	for (int i = 0; i < 2; i += 1)
 	{
-		SDL_Log("Failed to create pipeline!");
-		return -1;
+		pipelineCreateInfo.fragment_shader = fragmentShaders[i];
+		Pipelines[i] = GetCachedGraphicsPipeline(context->Device, &pipelineCreateInfo);
+		if (Pipelines[i] == NULL)
+		{
+			SDL_Log("Failed to create pipeline!");
+			return -1;
+		}
+		SDL_ReleaseGPUShader(context->Device, fragmentShaders[i]);
 	}
 
 	SDL_ReleaseGPUShader(context->Device, vertexShader);
-	SDL_ReleaseGPUShader(context->Device, fragmentShader);
 
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -251,11 +261,10 @@ static int Draw(Context* context)
 
 		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
 
-		SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+		SDL_BindGPUGraphicsPipeline(renderPass, Pipelines[SamplerMode]);
 		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ .buffer = VertexBuffer, .offset = 0 }, 1);
 		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer, .offset = 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
 		SDL_BindGPUFragmentStorageTextures(renderPass, 0, &Texture, 1);
-		SDL_PushGPUFragmentUniformData(cmdbuf, 0, &SamplerMode, sizeof(SamplerMode));
 		SDL_DrawGPUIndexedPrimitives(renderPass, 6, 1, 0, 0, 0);
 
 		SDL_EndGPURenderPass(renderPass);
@@ -268,7 +277,7 @@ static int Draw(Context* context)
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	// The pipelines belong to the state cache, which CommonQuit releases
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
@@ -0,0 +1,341 @@
+#include "Common.h"
+
+#define DYNAMIC_RESOLUTION_REPORT_INTERVAL_NS SDL_NS_PER_SECOND
+
+typedef struct SharpenUniforms
+{
+	float SourceWidth;
+	float SourceHeight;
+	float TexelWidth;
+	float TexelHeight;
+	float OutputWidth;
+	float OutputHeight;
+	float Sharpness;
+	float Padding;
+} SharpenUniforms;
+
+/* Runs on the profiler's watcher thread as each scene finishes */
+static void OnSceneComplete(void* userdata, const GPUPassRecord* record)
+{
+	DynamicResolution* resolution = userdata;
+
+	SDL_LockMutex(resolution->Lock);
+	resolution->SampleNS += record->CompleteNS - record->StartNS;
+	resolution->SampleCount += 1;
+	SDL_UnlockMutex(resolution->Lock);
+}
+
+bool DynamicResolution_Init(
+	DynamicResolution* resolution,
+	SDL_GPUDevice* device,
+	SDL_Window* window,
+	SDL_GPUTextureFormat format,
+	float targetMilliseconds
+) {
+	SDL_zerop(resolution);
+	resolution->Device = device;
+	resolution->Window = window;
+	resolution->Format = format;
+
+	resolution->Enabled = true;
+	resolution->TargetMilliseconds = targetMilliseconds;
+	resolution->MinScale = 0.5f;
+	resolution->MaxScale = 1.0f;
+	resolution->Kp = 0.2f;
+	resolution->Ki = 0.05f;
+	resolution->Kd = 0.05f;
+	resolution->Sharpness = 0.5f;
+	resolution->Scale = 1.0f;
+
+	// Bindings and group size are reflected from the SPIR-V
+	resolution->SharpenPipeline = GetCachedComputePipeline(
+		device,
+		"SharpenUpscale.comp",
+		&(SDL_GPUComputePipelineCreateInfo){ 0 }
+	);
+	if (resolution->SharpenPipeline == NULL)
+	{
+		SDL_Log("Failed to create the sharpen pipeline, upscaling will always blit");
+	}
+
+	/* The same filter as a full-screen pass, which writes the swapchain without the extra blit */
+	SDL_GPUShader* vertexShader = LoadShader(device, "Fullscreen.vert", 0, 0, 0, 0);
+	SDL_GPUShader* fragmentShader = LoadShader(device, "SharpenUpscale.frag", 0, 0, 0, 0);
+	if (vertexShader != NULL && fragmentShader != NULL)
+	{
+		resolution->SharpenDrawPipeline = GetCachedGraphicsPipeline(device, &(SDL_GPUGraphicsPipelineCreateInfo){
+			.target_info = {
+				.num_color_targets = 1,
+				.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+					.format = SDL_GetGPUSwapchainTextureFormat(device, window)
+				}},
+			},
+			.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+			.vertex_shader = vertexShader,
+			.fragment_shader = fragmentShader
+		});
+	}
+	if (vertexShader != NULL)
+	{
+		SDL_ReleaseGPUShader(device, vertexShader);
+	}
+	if (fragmentShader != NULL)
+	{
+		SDL_ReleaseGPUShader(device, fragmentShader);
+	}
+
+	resolution->Sampler = GetCachedSampler(device, &(SDL_GPUSamplerCreateInfo){
+		.min_filter = SDL_GPU_FILTER_LINEAR,
+		.mag_filter = SDL_GPU_FILTER_LINEAR,
+		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+		.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE
+	});
+
+	if (!ComputePresenter_Init(&resolution->Presenter, device, window))
+	{
+		return false;
+	}
+
+	resolution->Lock = SDL_CreateMutex();
+	if (resolution->Lock == NULL)
+	{
+		SDL_Log("CreateMutex failed: %s", SDL_GetError());
+		return false;
+	}
+
+	if (!GPUProfiler_Init(&resolution->Profiler, device, NULL))
+	{
+		return false;
+	}
+
+	resolution->LastReportNS = SDL_GetTicksNS();
+	return true;
+}
+
+/* Incremental PID form: it outputs a change of scale, so clamping the scale is all the
+ * anti-windup it needs. The error is relative to the target, positive when there is headroom.
+ */
+static void UpdateController(DynamicResolution* resolution, float milliseconds)
+{
+	if (resolution->SmoothedMilliseconds == 0.0f)
+	{
+		resolution->SmoothedMilliseconds = milliseconds;
+	}
+	resolution->SmoothedMilliseconds += (milliseconds - resolution->SmoothedMilliseconds) * 0.25f;
+
+	float error = (resolution->TargetMilliseconds - resolution->SmoothedMilliseconds) / resolution->TargetMilliseconds;
+	error = SDL_clamp(error, -1.0f, 1.0f);
+
+	float change =
+		resolution->Kp * (error - resolution->Errors[0]) +
+		resolution->Ki * error +
+		resolution->Kd * (error - 2.0f * resolution->Errors[0] + resolution->Errors[1]);
+
+	resolution->Errors[1] = resolution->Errors[0];
+	resolution->Errors[0] = error;
+
+	if (resolution->Enabled)
+	{
+		resolution->Scale = SDL_clamp(resolution->Scale + change, resolution->MinScale, resolution->MaxScale);
+	}
+}
+
+static Uint32 ScaleDimension(Uint32 size, float scale)
+{
+	/* Multiples of 8 keep the size from changing on every small correction */
+	Uint32 scaled = (Uint32) (size * scale / 8.0f + 0.5f) * 8;
+	return SDL_clamp(scaled, SDL_min(size, 8), size);
+}
+
+SDL_GPUTexture* DynamicResolution_BeginFrame(DynamicResolution* resolution, Uint32* pWidth, Uint32* pHeight)
+{
+	SDL_LockMutex(resolution->Lock);
+	Uint64 sampleNS = resolution->SampleNS;
+	Uint32 sampleCount = resolution->SampleCount;
+	resolution->SampleNS = 0;
+	resolution->SampleCount = 0;
+	SDL_UnlockMutex(resolution->Lock);
+
+	if (sampleCount > 0)
+	{
+		float milliseconds = (float) ((double) sampleNS / sampleCount / SDL_NS_PER_MS);
+		UpdateController(resolution, milliseconds);
+		resolution->ReportFrames += sampleCount;
+		resolution->ReportMilliseconds += (double) sampleNS / SDL_NS_PER_MS;
+	}
+	if (!resolution->Enabled)
+	{
+		resolution->Scale = resolution->MaxScale;
+	}
+
+	int windowWidth, windowHeight;
+	SDL_GetWindowSizeInPixels(resolution->Window, &windowWidth, &windowHeight);
+
+	/* Sized for the largest scale, smaller scales render into the top-left of it.
+	 * Taking it from the pool each frame means an old window size's target is dropped on its own.
+	 */
+	Uint32 targetWidth = ScaleDimension(windowWidth, resolution->MaxScale);
+	Uint32 targetHeight = ScaleDimension(windowHeight, resolution->MaxScale);
+	resolution->Target = AcquireRenderTarget(resolution->Device, &(RenderTargetDescription){
+		.Format = resolution->Format,
+		.Width = targetWidth,
+		.Height = targetHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+		.Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+	});
+	resolution->TargetWidth = targetWidth;
+	resolution->TargetHeight = targetHeight;
+
+	resolution->Width = SDL_min(ScaleDimension(windowWidth, resolution->Scale), targetWidth);
+	resolution->Height = SDL_min(ScaleDimension(windowHeight, resolution->Scale), targetHeight);
+
+	Uint64 now = SDL_GetTicksNS();
+	if (now - resolution->LastReportNS >= DYNAMIC_RESOLUTION_REPORT_INTERVAL_NS && resolution->ReportFrames > 0)
+	{
+		SDL_Log(
+			"Scene GPU time %.2f ms (target %.2f ms), scale %.2f, rendering %ux%u of %dx%d",
+			resolution->ReportMilliseconds / resolution->ReportFrames,
+			resolution->TargetMilliseconds,
+			resolution->Scale,
+			resolution->Width,
+			resolution->Height,
+			windowWidth,
+			windowHeight
+		);
+		resolution->ReportFrames = 0;
+		resolution->ReportMilliseconds = 0.0;
+		resolution->LastReportNS = now;
+	}
+
+	*pWidth = resolution->Width;
+	*pHeight = resolution->Height;
+	return resolution->Target;
+}
+
+bool DynamicResolution_SubmitScene(DynamicResolution* resolution, SDL_GPUCommandBuffer* commandBuffer)
+{
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (fence == NULL)
+	{
+		SDL_Log("SubmitGPUCommandBufferAndAcquireFence failed: %s", SDL_GetError());
+		return false;
+	}
+
+	GPUProfiler_TrackFence(&resolution->Profiler, "Scene", fence, OnSceneComplete, resolution);
+	return true;
+}
+
+/* Returns false if nothing was drawn, when the compute output couldn't be acquired */
+static bool SharpenUpscale(
+	DynamicResolution* resolution,
+	SDL_GPUCommandBuffer* commandBuffer,
+	SDL_GPUTexture* swapchainTexture,
+	int windowWidth,
+	int windowHeight
+) {
+	SharpenUniforms uniforms = {
+		.SourceWidth = (float) resolution->Width,
+		.SourceHeight = (float) resolution->Height,
+		.TexelWidth = 1.0f / resolution->TargetWidth,
+		.TexelHeight = 1.0f / resolution->TargetHeight,
+		.OutputWidth = (float) windowWidth,
+		.OutputHeight = (float) windowHeight,
+		.Sharpness = resolution->Sharpness
+	};
+	SDL_GPUTextureSamplerBinding samplerBinding = { .texture = resolution->Target, .sampler = resolution->Sampler };
+
+	if (ComputePresenter_CanDraw(&resolution->Presenter, resolution->SharpenDrawPipeline))
+	{
+		SDL_GPURenderPass* renderPass = ComputePresenter_BeginDraw(&resolution->Presenter, commandBuffer, swapchainTexture);
+		SDL_BindGPUGraphicsPipeline(renderPass, resolution->SharpenDrawPipeline);
+		SDL_BindGPUFragmentSamplers(renderPass, 0, &samplerBinding, 1);
+		SDL_PushGPUFragmentUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+		SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+		ComputePresenter_End(&resolution->Presenter, commandBuffer, swapchainTexture, SDL_GPU_FILTER_NEAREST);
+		return true;
+	}
+
+	if (resolution->SharpenPipeline == NULL)
+	{
+		return false;
+	}
+
+	/* SharpenUpscale.comp writes an rgba8 image */
+	SDL_GPUStorageTextureReadWriteBinding outputBinding = ComputePresenter_BeginCompute(
+		&resolution->Presenter,
+		SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		windowWidth,
+		windowHeight
+	);
+	if (outputBinding.texture == NULL)
+	{
+		return false;
+	}
+
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(commandBuffer, &outputBinding, 1, NULL, 0);
+	SDL_BindGPUComputePipeline(computePass, resolution->SharpenPipeline);
+	SDL_BindGPUComputeSamplers(computePass, 0, &samplerBinding, 1);
+	SDL_PushGPUComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+	SDL_DispatchGPUCompute(computePass, (windowWidth + 7) / 8, (windowHeight + 7) / 8, 1);
+	SDL_EndGPUComputePass(computePass);
+
+	ComputePresenter_End(&resolution->Presenter, commandBuffer, swapchainTexture, SDL_GPU_FILTER_NEAREST);
+	return true;
+}
+
+void DynamicResolution_Upscale(DynamicResolution* resolution, SDL_GPUCommandBuffer* commandBuffer, SDL_GPUTexture* swapchainTexture)
+{
+	if (resolution->Target == NULL)
+	{
+		return;
+	}
+
+	int windowWidth, windowHeight;
+	SDL_GetWindowSizeInPixels(resolution->Window, &windowWidth, &windowHeight);
+
+	/* Without sharpening, or if the sharpen pass couldn't run this frame, stretch with a blit */
+	bool sharpened = resolution->Sharpen && (resolution->SharpenPipeline != NULL || resolution->SharpenDrawPipeline != NULL);
+	if (sharpened)
+	{
+		sharpened = SharpenUpscale(resolution, commandBuffer, swapchainTexture, windowWidth, windowHeight);
+	}
+
+	if (!sharpened)
+	{
+		SDL_BlitGPUTexture(
+			commandBuffer,
+			&(SDL_GPUBlitInfo){
+				.source.texture = resolution->Target,
+				.source.w = resolution->Width,
+				.source.h = resolution->Height,
+				.destination.texture = swapchainTexture,
+				.destination.w = windowWidth,
+				.destination.h = windowHeight,
+				.load_op = SDL_GPU_LOADOP_DONT_CARE,
+				.filter = SDL_GPU_FILTER_LINEAR
+			}
+		);
+	}
+
+	ReleaseRenderTarget(resolution->Target);
+	resolution->Target = NULL;
+}
+
+void DynamicResolution_Destroy(DynamicResolution* resolution)
+{
+	if (resolution->Device == NULL)
+	{
+		return;
+	}
+
+	/* The profiler's watcher drains the remaining scenes, through OnSceneComplete, before it exits */
+	GPUProfiler_Destroy(&resolution->Profiler);
+	SDL_DestroyMutex(resolution->Lock);
+
+	// The sharpen pipelines and sampler belong to the state cache, the target to the render target pool
+	ComputePresenter_Destroy(&resolution->Presenter);
+
+	SDL_zerop(resolution);
+}
@@ -0,0 +1,407 @@
+#include "Common.h"
+
+#define FRAME_JOB_GRAPH_REPORT_INTERVAL_NS (2 * SDL_NS_PER_SECOND)
+
+/* Called with the lock held. Only jobs whose dependencies are all claimed are handed out,
+ * so a thread waiting to submit only ever waits for jobs that are already being recorded.
+ */
+static bool ClaimJob(FrameJobGraph* graph, Uint32* pIndex)
+{
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		Uint32 bit = 1u << i;
+		if ((graph->PendingMask & bit) && !(graph->Jobs[i].Description.Dependencies & ~graph->ClaimedMask))
+		{
+			graph->PendingMask &= ~bit;
+			graph->ClaimedMask |= bit;
+			*pIndex = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Called with the lock held */
+static bool DependenciesSubmitted(FrameJobGraph* graph, Uint32 index)
+{
+	return !(graph->Jobs[index].Description.Dependencies & ~graph->SubmittedMask);
+}
+
+static void RecordJob(FrameJobGraph* graph, Uint32 index)
+{
+	FrameJob* job = &graph->Jobs[index];
+	Uint64 start = SDL_GetTicksNS();
+
+	/* Command buffers belong to the thread that acquires them, which also has to submit them */
+	job->CommandBuffer = SDL_AcquireGPUCommandBuffer(graph->Device);
+	if (job->CommandBuffer == NULL)
+	{
+		SDL_Log("%s: AcquireGPUCommandBuffer failed: %s", job->Description.Name, SDL_GetError());
+	}
+	else
+	{
+		job->Description.Record(job->CommandBuffer, NULL, job->Description.Userdata);
+	}
+
+	job->RecordNS += SDL_GetTicksNS() - start;
+}
+
+/* Called on the thread that recorded the job, once everything it depends on is submitted */
+static void SubmitJob(FrameJobGraph* graph, Uint32 index)
+{
+	FrameJob* job = &graph->Jobs[index];
+	if (job->CommandBuffer == NULL)
+	{
+		job->Failed = true;
+		return;
+	}
+
+	Uint64 start = SDL_GetTicksNS();
+	if (graph->Profiler != NULL)
+	{
+		SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(job->CommandBuffer);
+		if (fence == NULL)
+		{
+			SDL_Log("%s: SubmitGPUCommandBufferAndAcquireFence failed: %s", job->Description.Name, SDL_GetError());
+			job->Failed = true;
+		}
+		else
+		{
+			GPUProfiler_TrackFence(graph->Profiler, job->Description.Name, fence, NULL, NULL);
+		}
+	}
+	else if (!SDL_SubmitGPUCommandBuffer(job->CommandBuffer))
+	{
+		SDL_Log("%s: SubmitGPUCommandBuffer failed: %s", job->Description.Name, SDL_GetError());
+		job->Failed = true;
+	}
+	job->SubmitNS += SDL_GetTicksNS() - start;
+	job->CommandBuffer = NULL;
+}
+
+/* Called with the lock held */
+static void MarkSubmitted(FrameJobGraph* graph, Uint32 index)
+{
+	graph->SubmittedMask |= 1u << index;
+	SDL_BroadcastCondition(graph->Changed);
+}
+
+static int FrameJobWorkerThread(void* data)
+{
+	FrameJobGraph* graph = data;
+	Uint32 index = 0;
+
+	SDL_LockMutex(graph->Lock);
+	while (true)
+	{
+		while (!graph->Quit && !ClaimJob(graph, &index))
+		{
+			SDL_WaitCondition(graph->Changed, graph->Lock);
+		}
+		if (graph->Quit)
+		{
+			break;
+		}
+
+		/* The claim may have made jobs that depend on this one claimable */
+		SDL_BroadcastCondition(graph->Changed);
+		SDL_UnlockMutex(graph->Lock);
+
+		RecordJob(graph, index);
+
+		SDL_LockMutex(graph->Lock);
+		while (!DependenciesSubmitted(graph, index))
+		{
+			SDL_WaitCondition(graph->Changed, graph->Lock);
+		}
+		SDL_UnlockMutex(graph->Lock);
+
+		SubmitJob(graph, index);
+
+		SDL_LockMutex(graph->Lock);
+		MarkSubmitted(graph, index);
+	}
+	SDL_UnlockMutex(graph->Lock);
+
+	return 0;
+}
+
+bool FrameJobGraph_Init(FrameJobGraph* graph, SDL_GPUDevice* device, Uint32 workerCount)
+{
+	SDL_zerop(graph);
+	graph->Device = device;
+	graph->Lock = SDL_CreateMutex();
+	graph->Changed = SDL_CreateCondition();
+	graph->LastReportNS = SDL_GetTicksNS();
+
+	if (graph->Lock == NULL || graph->Changed == NULL)
+	{
+		SDL_Log("Failed to create the job queue: %s", SDL_GetError());
+		return false;
+	}
+
+	workerCount = SDL_min(workerCount, FRAME_JOB_GRAPH_MAX_WORKERS);
+	for (Uint32 i = 0; i < workerCount; i += 1)
+	{
+		char threadName[32];
+		SDL_snprintf(threadName, sizeof(threadName), "FrameJobWorker%u", i);
+		graph->Workers[i] = SDL_CreateThread(FrameJobWorkerThread, threadName, graph);
+		if (graph->Workers[i] == NULL)
+		{
+			SDL_Log("CreateThread failed: %s", SDL_GetError());
+			return false;
+		}
+		graph->WorkerCount += 1;
+	}
+
+	return true;
+}
+
+int FrameJobGraph_AddJob(FrameJobGraph* graph, const FrameJobDescription* description)
+{
+	if (graph->JobCount == FRAME_JOB_GRAPH_MAX_JOBS)
+	{
+		SDL_Log("FrameJobGraph: at most %d jobs are supported", FRAME_JOB_GRAPH_MAX_JOBS);
+		return -1;
+	}
+	if (description->Record == NULL)
+	{
+		SDL_Log("FrameJobGraph: %s has no Record function", description->Name);
+		return -1;
+	}
+
+	FrameJob* job = &graph->Jobs[graph->JobCount];
+	SDL_zerop(job);
+	job->Description = *description;
+	if (job->Description.Name == NULL)
+	{
+		job->Description.Name = "Unnamed";
+	}
+
+	graph->Validated = false;
+	graph->JobCount += 1;
+	return graph->JobCount - 1;
+}
+
+/* Dependencies may point forward, so check the graph for cycles once after it changes */
+static bool ValidateGraph(FrameJobGraph* graph)
+{
+	Uint32 allMask = graph->JobCount == 32 ? ~0u : (1u << graph->JobCount) - 1;
+	Uint32 orderedMask = 0;
+	bool progress = true;
+
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		if (graph->Jobs[i].Description.Dependencies & ~allMask)
+		{
+			SDL_Log("FrameJobGraph: %s depends on a job that doesn't exist", graph->Jobs[i].Description.Name);
+			return false;
+		}
+	}
+
+	while (orderedMask != allMask && progress)
+	{
+		progress = false;
+		for (Uint32 i = 0; i < graph->JobCount; i += 1)
+		{
+			Uint32 bit = 1u << i;
+			if (!(orderedMask & bit) && !(graph->Jobs[i].Description.Dependencies & ~orderedMask))
+			{
+				orderedMask |= bit;
+				progress = true;
+			}
+		}
+	}
+
+	if (orderedMask != allMask)
+	{
+		for (Uint32 i = 0; i < graph->JobCount; i += 1)
+		{
+			if (!(orderedMask & (1u << i)))
+			{
+				SDL_Log("FrameJobGraph: %s is part of a dependency cycle", graph->Jobs[i].Description.Name);
+			}
+		}
+		return false;
+	}
+
+	graph->Validated = true;
+	return true;
+}
+
+static void ReportTimings(FrameJobGraph* graph)
+{
+	Uint64 recordNS = 0;
+	Uint64 submitNS = 0;
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		FrameJob* job = &graph->Jobs[i];
+		SDL_Log(
+			"%s: record %.3f ms, submit %.3f ms",
+			job->Description.Name,
+			job->RecordNS / 1e6 / graph->FrameCount,
+			job->SubmitNS / 1e6 / graph->FrameCount
+		);
+		recordNS += job->RecordNS;
+		submitNS += job->SubmitNS;
+		job->RecordNS = 0;
+		job->SubmitNS = 0;
+	}
+
+	double frameMs = graph->FrameNS / 1e6 / graph->FrameCount;
+	double recordMs = recordNS / 1e6 / graph->FrameCount;
+	SDL_Log(
+		"%u jobs on %u workers and the calling thread: %.3f ms per frame, %.3f ms of submitting, %.3f ms of recording (%.2fx)",
+		graph->JobCount,
+		graph->WorkerCount,
+		frameMs,
+		submitNS / 1e6 / graph->FrameCount,
+		recordMs,
+		frameMs > 0 ? recordMs / frameMs : 0.0
+	);
+
+	graph->FrameCount = 0;
+	graph->FrameNS = 0;
+}
+
+bool FrameJobGraph_Execute(FrameJobGraph* graph)
+{
+	if (!graph->Validated && !ValidateGraph(graph))
+	{
+		return false;
+	}
+
+	Uint64 frameStart = SDL_GetTicksNS();
+	Uint32 allMask = graph->JobCount == 32 ? ~0u : (1u << graph->JobCount) - 1;
+	Uint32 windowMask = 0;
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		graph->Jobs[i].CommandBuffer = NULL;
+		graph->Jobs[i].SwapchainTexture = NULL;
+		graph->Jobs[i].Failed = false;
+		if (graph->Jobs[i].Description.Window != NULL)
+		{
+			windowMask |= 1u << i;
+		}
+	}
+
+	SDL_LockMutex(graph->Lock);
+	graph->PendingMask = allMask & ~windowMask;
+	graph->ClaimedMask = windowMask;
+	graph->SubmittedMask = 0;
+	SDL_BroadcastCondition(graph->Changed);
+	SDL_UnlockMutex(graph->Lock);
+
+	/* Swapchain textures have to be acquired on the window's thread, so the jobs that
+	 * present are recorded here while the workers get going on the rest
+	 */
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		FrameJob* job = &graph->Jobs[i];
+		if (job->Description.Window == NULL)
+		{
+			continue;
+		}
+
+		Uint64 start = SDL_GetTicksNS();
+		job->CommandBuffer = SDL_AcquireGPUCommandBuffer(graph->Device);
+		if (job->CommandBuffer == NULL)
+		{
+			SDL_Log("%s: AcquireGPUCommandBuffer failed: %s", job->Description.Name, SDL_GetError());
+		}
+		else if (!SDL_AcquireGPUSwapchainTexture(job->CommandBuffer, job->Description.Window, &job->SwapchainTexture))
+		{
+			SDL_Log("%s: AcquireGPUSwapchainTexture failed: %s", job->Description.Name, SDL_GetError());
+			SDL_CancelGPUCommandBuffer(job->CommandBuffer);
+			job->CommandBuffer = NULL;
+		}
+		else
+		{
+			job->Description.Record(job->CommandBuffer, job->SwapchainTexture, job->Description.Userdata);
+		}
+		job->RecordNS += SDL_GetTicksNS() - start;
+	}
+
+	/* Submit the jobs recorded here once their dependencies are, and lend a hand with the
+	 * recording when none of them can go yet. Jobs claimed here are submitted here too.
+	 */
+	Uint32 ownedMask = windowMask;
+	Uint32 index = 0;
+	SDL_LockMutex(graph->Lock);
+	while (graph->SubmittedMask != allMask)
+	{
+		bool submitted = false;
+		for (Uint32 i = 0; i < graph->JobCount && !submitted; i += 1)
+		{
+			if ((ownedMask & (1u << i)) && DependenciesSubmitted(graph, i))
+			{
+				SDL_UnlockMutex(graph->Lock);
+				SubmitJob(graph, i);
+				SDL_LockMutex(graph->Lock);
+
+				ownedMask &= ~(1u << i);
+				MarkSubmitted(graph, i);
+				submitted = true;
+			}
+		}
+
+		if (submitted)
+		{
+			continue;
+		}
+
+		if (ClaimJob(graph, &index))
+		{
+			SDL_BroadcastCondition(graph->Changed);
+			SDL_UnlockMutex(graph->Lock);
+
+			RecordJob(graph, index);
+
+			SDL_LockMutex(graph->Lock);
+			ownedMask |= 1u << index;
+		}
+		else
+		{
+			SDL_WaitCondition(graph->Changed, graph->Lock);
+		}
+	}
+	SDL_UnlockMutex(graph->Lock);
+
+	bool success = true;
+	for (Uint32 i = 0; i < graph->JobCount; i += 1)
+	{
+		success = success && !graph->Jobs[i].Failed;
+	}
+
+	Uint64 now = SDL_GetTicksNS();
+	graph->FrameCount += 1;
+	graph->FrameNS += now - frameStart;
+	if (now - graph->LastReportNS >= FRAME_JOB_GRAPH_REPORT_INTERVAL_NS)
+	{
+		ReportTimings(graph);
+		graph->LastReportNS = now;
+	}
+
+	return success;
+}
+
+void FrameJobGraph_Destroy(FrameJobGraph* graph)
+{
+	if (graph->Lock != NULL)
+	{
+		SDL_LockMutex(graph->Lock);
+		graph->Quit = true;
+		SDL_BroadcastCondition(graph->Changed);
+		SDL_UnlockMutex(graph->Lock);
+	}
+
+	for (Uint32 i = 0; i < graph->WorkerCount; i += 1)
+	{
+		SDL_WaitThread(graph->Workers[i], NULL);
+	}
+
+	SDL_DestroyCondition(graph->Changed);
+	SDL_DestroyMutex(graph->Lock);
+	SDL_zerop(graph);
+}
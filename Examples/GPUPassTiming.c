@@ -0,0 +1,207 @@
+#include "Common.h"
+
+/* Three passes, each in a command buffer of its own so the profiler can time it:
+ *   Gradient (compute) fills a pooled target,
+ *   Overdraw (render) stacks full-size triangles on top of it,
+ *   Present (blit) copies it to the swapchain.
+ * The profiler's bookkeeping is checked headlessly against a mock clock by Tools/ExampleChecks.c.
+ */
+#define MAX_LAYER_COUNT 1024
+
+static SDL_GPUComputePipeline* GradientPipeline;
+static SDL_GPUGraphicsPipeline* OverdrawPipeline;
+static GPUProfiler Profiler;
+static Uint32 LayerCount = 16;
+static float Time;
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	OverdrawPipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	// Bindings and group size are reflected from the SPIR-V
+	GradientPipeline = GetCachedComputePipeline(context->Device, "GradientTexture.comp", &(SDL_GPUComputePipelineCreateInfo){ 0 });
+	if (OverdrawPipeline == NULL || GradientPipeline == NULL)
+	{
+		SDL_Log("Failed to create pipelines!");
+		return -1;
+	}
+
+	if (!GPUProfiler_Init(&Profiler, context->Device, NULL))
+	{
+		return -1;
+	}
+
+	SDL_Log("Press Left/Right to halve/double the overdraw");
+	SDL_Log("Press Down to write the GPU time of each pass as a Chrome trace");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	Time += context->DeltaTime;
+
+	if (context->LeftPressed && LayerCount > 1)
+	{
+		LayerCount /= 2;
+		SDL_Log("%u layers of overdraw", LayerCount);
+	}
+
+	if (context->RightPressed && LayerCount < MAX_LAYER_COUNT)
+	{
+		LayerCount *= 2;
+		SDL_Log("%u layers of overdraw", LayerCount);
+	}
+
+	if (context->DownPressed)
+	{
+		char filename[64];
+		SDL_snprintf(filename, sizeof(filename), "%s.gpu.json", context->ExampleName);
+		GPUProfiler_WriteTrace(&Profiler, filename, context->ExampleName);
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	int w, h;
+	SDL_GetWindowSizeInPixels(context->Window, &w, &h);
+
+	GPUProfiler_BeginFrame(&Profiler);
+
+	SDL_GPUTexture* target = AcquireRenderTarget(context->Device, &(RenderTargetDescription){
+		.Format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.Width = w,
+		.Height = h,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+		.Usage = SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+	});
+	if (target == NULL)
+	{
+		return -1;
+	}
+
+	SDL_GPUCommandBuffer* cmdbuf = GPUProfiler_BeginPass(&Profiler, "Gradient");
+	if (cmdbuf == NULL)
+	{
+		return -1;
+	}
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		cmdbuf,
+		&(SDL_GPUStorageTextureReadWriteBinding){
+			.texture = target
+		},
+		1,
+		NULL,
+		0
+	);
+	SDL_BindGPUComputePipeline(computePass, GradientPipeline);
+	SDL_PushGPUComputeUniformData(cmdbuf, 0, &Time, sizeof(Time));
+	SDL_DispatchGPUCompute(computePass, (w + 7) / 8, (h + 7) / 8, 1);
+	SDL_EndGPUComputePass(computePass);
+	if (!GPUProfiler_EndPass(&Profiler, cmdbuf))
+	{
+		return -1;
+	}
+
+	cmdbuf = GPUProfiler_BeginPass(&Profiler, "Overdraw");
+	if (cmdbuf == NULL)
+	{
+		return -1;
+	}
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
+		cmdbuf,
+		&(SDL_GPUColorTargetInfo){
+			.texture = target,
+			.load_op = SDL_GPU_LOADOP_LOAD,
+			.store_op = SDL_GPU_STOREOP_STORE
+		},
+		1,
+		NULL
+	);
+	SDL_BindGPUGraphicsPipeline(renderPass, OverdrawPipeline);
+	/* Only the left half, so the gradient still shows on the right */
+	SDL_SetGPUViewport(renderPass, &(SDL_GPUViewport){ 0, 0, w / 2.0f, (float) h, 0, 1 });
+	SDL_DrawGPUPrimitives(renderPass, 3, LayerCount, 0, 0);
+	SDL_EndGPURenderPass(renderPass);
+	if (!GPUProfiler_EndPass(&Profiler, cmdbuf))
+	{
+		return -1;
+	}
+
+	cmdbuf = GPUProfiler_BeginPass(&Profiler, "Present");
+	if (cmdbuf == NULL)
+	{
+		return -1;
+	}
+	SDL_GPUTexture* swapchainTexture;
+	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture))
+	{
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		SDL_CancelGPUCommandBuffer(cmdbuf);
+		return -1;
+	}
+	if (swapchainTexture != NULL)
+	{
+		SDL_BlitGPUTexture(cmdbuf, &(SDL_GPUBlitInfo){
+			.source.texture = target,
+			.source.w = w,
+			.source.h = h,
+			.destination.texture = swapchainTexture,
+			.destination.w = w,
+			.destination.h = h,
+			.load_op = SDL_GPU_LOADOP_DONT_CARE,
+			.filter = SDL_GPU_FILTER_NEAREST
+		});
+	}
+	bool success = GPUProfiler_EndPass(&Profiler, cmdbuf);
+
+	ReleaseRenderTarget(target);
+	return success ? 0 : -1;
+}
+
+static void Quit(Context* context)
+{
+	// The pipelines belong to the state cache, which CommonQuit releases
+	GPUProfiler_Destroy(&Profiler);
+	LayerCount = 16;
+	Time = 0;
+
+	CommonQuit(context);
+}
+
+Example GPUPassTiming_Example = { "GPUPassTiming", Init, Update, Draw, Quit };
@@ -0,0 +1,370 @@
+#include "Common.h"
+
+#define GPU_PROFILER_REPORT_INTERVAL_NS (2 * SDL_NS_PER_SECOND)
+
+static Uint64 GetTicks(void* userdata)
+{
+	return SDL_GetTicksNS();
+}
+
+static void WaitForFence(void* userdata, SDL_GPUFence* fence)
+{
+	SDL_WaitForGPUFences(userdata, true, &fence, 1);
+}
+
+static void ReleaseFence(void* userdata, SDL_GPUFence* fence)
+{
+	SDL_ReleaseGPUFence(userdata, fence);
+}
+
+/* Waits on the fences in submission order, so completions are stamped in the order the GPU ran them.
+ * The GPU runs command buffers in order, so a pass starts when it is submitted or when the one
+ * before it finishes, whichever is later.
+ */
+static int GPUProfilerWatcherThread(void* data)
+{
+	GPUProfiler* profiler = data;
+	GPUProfilerClock* clock = &profiler->Clock;
+
+	SDL_LockMutex(profiler->Lock);
+	while (true)
+	{
+		while (profiler->PendingCompleted == profiler->PendingCount && !profiler->Quit)
+		{
+			SDL_WaitCondition(profiler->Signal, profiler->Lock);
+		}
+		if (profiler->PendingCompleted == profiler->PendingCount)
+		{
+			break;
+		}
+
+		/* Only this thread touches the records past PendingCompleted, until it counts them */
+		Uint32 index = (profiler->PendingRead + profiler->PendingCompleted) % GPU_PROFILER_MAX_PENDING;
+		GPUPassRecord* record = &profiler->Pending[index];
+		SDL_UnlockMutex(profiler->Lock);
+
+		clock->Wait(clock->Userdata, record->Fence);
+		record->CompleteNS = clock->Now(clock->Userdata);
+		clock->Release(clock->Userdata, record->Fence);
+		record->Fence = NULL;
+
+		record->StartNS = SDL_max(record->SubmitNS, profiler->LastCompleteNS);
+		record->CompleteNS = SDL_max(record->CompleteNS, record->StartNS);
+		profiler->LastCompleteNS = record->CompleteNS;
+		if (record->Callback != NULL)
+		{
+			record->Callback(record->Userdata, record);
+		}
+
+		SDL_LockMutex(profiler->Lock);
+		profiler->PendingCompleted += 1;
+		SDL_BroadcastCondition(profiler->Signal);
+	}
+	SDL_UnlockMutex(profiler->Lock);
+
+	return 0;
+}
+
+static GPUPassStats* FindPass(GPUProfiler* profiler, const char* name)
+{
+	for (Uint32 i = 0; i < profiler->PassCount; i += 1)
+	{
+		if (profiler->Passes[i].Name == name || SDL_strcmp(profiler->Passes[i].Name, name) == 0)
+		{
+			return &profiler->Passes[i];
+		}
+	}
+
+	if (profiler->PassCount == GPU_PROFILER_MAX_PASSES)
+	{
+		return NULL;
+	}
+
+	GPUPassStats* stats = &profiler->Passes[profiler->PassCount];
+	SDL_zerop(stats);
+	stats->Name = name;
+	profiler->PassCount += 1;
+	return stats;
+}
+
+static void AddTiming(GPUProfiler* profiler, const GPUPassRecord* record)
+{
+	Uint64 durationNS = record->CompleteNS - record->StartNS;
+
+	GPUPassStats* stats = FindPass(profiler, record->Name);
+	if (stats != NULL)
+	{
+		stats->MinNS = stats->Count == 0 ? durationNS : SDL_min(stats->MinNS, durationNS);
+		stats->MaxNS = SDL_max(stats->MaxNS, durationNS);
+		stats->Count += 1;
+		stats->TotalNS += durationNS;
+		stats->LifetimeCount += 1;
+		stats->LifetimeNS += durationNS;
+	}
+
+	GPUTraceEvent* event = &profiler->Events[profiler->EventWrite];
+	event->Name = record->Name;
+	event->Frame = record->Frame;
+	event->StartNS = record->StartNS;
+	event->DurationNS = durationNS;
+	profiler->EventWrite = (profiler->EventWrite + 1) % GPU_PROFILER_MAX_EVENTS;
+	profiler->EventCount = SDL_min(profiler->EventCount + 1, GPU_PROFILER_MAX_EVENTS);
+}
+
+/* Called with the lock held */
+static void CollectPasses(GPUProfiler* profiler)
+{
+	while (profiler->PendingCompleted > 0)
+	{
+		AddTiming(profiler, &profiler->Pending[profiler->PendingRead]);
+		profiler->PendingRead = (profiler->PendingRead + 1) % GPU_PROFILER_MAX_PENDING;
+		profiler->PendingCompleted -= 1;
+		profiler->PendingCount -= 1;
+	}
+}
+
+static void EnqueuePass(
+	GPUProfiler* profiler,
+	const char* name,
+	SDL_GPUFence* fence,
+	Uint64 submitNS,
+	GPUPassCallback callback,
+	void* userdata
+) {
+	SDL_LockMutex(profiler->Lock);
+	while (profiler->PendingCount == GPU_PROFILER_MAX_PENDING)
+	{
+		CollectPasses(profiler);
+		if (profiler->PendingCount == GPU_PROFILER_MAX_PENDING)
+		{
+			SDL_WaitCondition(profiler->Signal, profiler->Lock);
+		}
+	}
+
+	Uint32 index = (profiler->PendingRead + profiler->PendingCount) % GPU_PROFILER_MAX_PENDING;
+	profiler->Pending[index] = (GPUPassRecord){
+		.Name = name,
+		.Frame = profiler->Frame,
+		.Fence = fence,
+		.SubmitNS = submitNS,
+		.Callback = callback,
+		.Userdata = userdata
+	};
+	profiler->PendingCount += 1;
+	SDL_BroadcastCondition(profiler->Signal);
+	SDL_UnlockMutex(profiler->Lock);
+}
+
+bool GPUProfiler_Init(GPUProfiler* profiler, SDL_GPUDevice* device, const GPUProfilerClock* clock)
+{
+	SDL_zerop(profiler);
+	profiler->Device = device;
+	if (clock != NULL)
+	{
+		profiler->Clock = *clock;
+	}
+	else
+	{
+		profiler->Clock = (GPUProfilerClock){ GetTicks, WaitForFence, ReleaseFence, device };
+	}
+	profiler->LastReportNS = profiler->Clock.Now(profiler->Clock.Userdata);
+
+	profiler->Lock = SDL_CreateMutex();
+	profiler->Signal = SDL_CreateCondition();
+	if (profiler->Lock == NULL || profiler->Signal == NULL)
+	{
+		SDL_Log("Failed to create the pass queue: %s", SDL_GetError());
+		return false;
+	}
+
+	profiler->Watcher = SDL_CreateThread(GPUProfilerWatcherThread, "GPUProfilerWatcher", profiler);
+	if (profiler->Watcher == NULL)
+	{
+		SDL_Log("CreateThread failed: %s", SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
+
+static void ReportTimings(GPUProfiler* profiler)
+{
+	Uint64 frameNS = 0;
+	for (Uint32 i = 0; i < profiler->PassCount; i += 1)
+	{
+		GPUPassStats* stats = &profiler->Passes[i];
+		if (stats->Count == 0)
+		{
+			continue;
+		}
+
+		SDL_Log(
+			"GPU %s: %.3f ms avg, %.3f ms min, %.3f ms max",
+			stats->Name,
+			stats->TotalNS / 1e6 / stats->Count,
+			stats->MinNS / 1e6,
+			stats->MaxNS / 1e6
+		);
+		frameNS += stats->TotalNS;
+		stats->Count = 0;
+		stats->TotalNS = 0;
+		stats->MinNS = 0;
+		stats->MaxNS = 0;
+	}
+
+	SDL_Log("GPU: %.3f ms per frame over %u frames", frameNS / 1e6 / profiler->ReportFrames, profiler->ReportFrames);
+	profiler->ReportFrames = 0;
+}
+
+void GPUProfiler_BeginFrame(GPUProfiler* profiler)
+{
+	SDL_LockMutex(profiler->Lock);
+	CollectPasses(profiler);
+	SDL_UnlockMutex(profiler->Lock);
+
+	Uint64 now = profiler->Clock.Now(profiler->Clock.Userdata);
+	if (profiler->ReportFrames > 0 && now - profiler->LastReportNS >= GPU_PROFILER_REPORT_INTERVAL_NS)
+	{
+		ReportTimings(profiler);
+		profiler->LastReportNS = now;
+	}
+
+	profiler->Frame += 1;
+	profiler->ReportFrames += 1;
+}
+
+SDL_GPUCommandBuffer* GPUProfiler_BeginPass(GPUProfiler* profiler, const char* name)
+{
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(profiler->Device);
+	if (commandBuffer == NULL)
+	{
+		SDL_Log("%s: AcquireGPUCommandBuffer failed: %s", name, SDL_GetError());
+		return NULL;
+	}
+
+	/* The group also names the pass in captures from external tools */
+	SDL_PushGPUDebugGroup(commandBuffer, name);
+	profiler->OpenCommandBuffer = commandBuffer;
+	profiler->OpenName = name;
+	return commandBuffer;
+}
+
+bool GPUProfiler_EndPass(GPUProfiler* profiler, SDL_GPUCommandBuffer* commandBuffer)
+{
+	if (commandBuffer != profiler->OpenCommandBuffer)
+	{
+		SDL_Log("GPUProfiler: EndPass was given a command buffer that isn't from the last BeginPass");
+		return false;
+	}
+	profiler->OpenCommandBuffer = NULL;
+
+	SDL_PopGPUDebugGroup(commandBuffer);
+	Uint64 submitNS = profiler->Clock.Now(profiler->Clock.Userdata);
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (fence == NULL)
+	{
+		SDL_Log("%s: SubmitGPUCommandBufferAndAcquireFence failed: %s", profiler->OpenName, SDL_GetError());
+		return false;
+	}
+
+	EnqueuePass(profiler, profiler->OpenName, fence, submitNS, NULL, NULL);
+	return true;
+}
+
+void GPUProfiler_TrackFence(
+	GPUProfiler* profiler,
+	const char* name,
+	SDL_GPUFence* fence,
+	GPUPassCallback callback,
+	void* userdata
+) {
+	EnqueuePass(profiler, name, fence, profiler->Clock.Now(profiler->Clock.Userdata), callback, userdata);
+}
+
+void GPUProfiler_Flush(GPUProfiler* profiler)
+{
+	SDL_LockMutex(profiler->Lock);
+	while (profiler->PendingCompleted < profiler->PendingCount)
+	{
+		SDL_WaitCondition(profiler->Signal, profiler->Lock);
+	}
+	CollectPasses(profiler);
+	SDL_UnlockMutex(profiler->Lock);
+}
+
+bool GPUProfiler_WriteTrace(GPUProfiler* profiler, const char* filename, const char* processName)
+{
+	char path[1024];
+	char* prefPath = SDL_GetPrefPath("SDL", "SDL_gpu_examples");
+	SDL_snprintf(path, sizeof(path), "%s%s", prefPath ? prefPath : "", filename);
+	SDL_free(prefPath);
+
+	SDL_IOStream* stream = SDL_IOFromFile(path, "w");
+	if (stream == NULL)
+	{
+		SDL_Log("Couldn't open %s: %s", path, SDL_GetError());
+		return false;
+	}
+
+	/* Timestamps are in microseconds, relative to the oldest pass kept */
+	Uint32 first = (profiler->EventWrite + GPU_PROFILER_MAX_EVENTS - profiler->EventCount) % GPU_PROFILER_MAX_EVENTS;
+	Uint64 originNS = profiler->EventCount > 0 ? profiler->Events[first].StartNS : 0;
+
+	SDL_IOprintf(stream, "{\"traceEvents\":[\n");
+	SDL_IOprintf(stream, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":");
+	WriteJSONString(stream, processName);
+	SDL_IOprintf(stream, "}},\n");
+	SDL_IOprintf(stream, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"GPU\"}}");
+
+	for (Uint32 i = 0; i < profiler->EventCount; i += 1)
+	{
+		const GPUTraceEvent* event = &profiler->Events[(first + i) % GPU_PROFILER_MAX_EVENTS];
+		SDL_IOprintf(stream, ",\n{\"name\":");
+		WriteJSONString(stream, event->Name);
+		SDL_IOprintf(
+			stream,
+			",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+			(event->StartNS - originNS) / 1e3,
+			event->DurationNS / 1e3,
+			(unsigned long long) event->Frame
+		);
+	}
+
+	SDL_IOprintf(stream, "\n]}\n");
+	SDL_CloseIO(stream);
+
+	SDL_Log("Wrote %u GPU passes to %s", profiler->EventCount, path);
+	return true;
+}
+
+void GPUProfiler_Destroy(GPUProfiler* profiler)
+{
+	if (profiler->Lock != NULL)
+	{
+		/* The watcher finishes the outstanding fences before it sees Quit */
+		SDL_LockMutex(profiler->Lock);
+		profiler->Quit = true;
+		SDL_BroadcastCondition(profiler->Signal);
+		SDL_UnlockMutex(profiler->Lock);
+	}
+	SDL_WaitThread(profiler->Watcher, NULL);
+
+	if (profiler->Lock != NULL)
+	{
+		CollectPasses(profiler);
+		for (Uint32 i = 0; i < profiler->PassCount; i += 1)
+		{
+			GPUPassStats* stats = &profiler->Passes[i];
+			SDL_Log(
+				"GPU %s: %.3f ms avg over %u passes",
+				stats->Name,
+				stats->LifetimeCount > 0 ? stats->LifetimeNS / 1e6 / stats->LifetimeCount : 0.0,
+				stats->LifetimeCount
+			);
+		}
+	}
+
+	SDL_DestroyCondition(profiler->Signal);
+	SDL_DestroyMutex(profiler->Lock);
+	SDL_zerop(profiler);
+}
@@ -0,0 +1,782 @@
+#include "Common.h"
+
+/* Regenerates the mip chain of a runtime-generated texture every frame,
+ * either with SDL_GenerateMipmapsForGPUTexture (one blit pass per level)
+ * or with a single compute dispatch that builds every level at once.
+ */
+
+#define TEXTURE_WIDTH 320
+#define TEXTURE_HEIGHT 180
+/* SDL binds at most eight read-write storage textures, one per level below mip 0 */
+#define MAX_MIP_COUNT 9
+#define MAX_TEXTURE_SIZE ((1 << MAX_MIP_COUNT) - 1)
+
+/* A texture whose mips the downsampler builds, and the scratch buffer it needs: the
+ * workgroup counter, followed by mip 3 at full precision for the last workgroup
+ */
+typedef struct DownsampleTarget
+{
+	Uint32 Width;
+	Uint32 Height;
+	Uint32 MipCount;
+	SDL_GPUTexture* Source;
+	SDL_GPUTexture* Mips;
+	SDL_GPUBuffer* Scratch;
+} DownsampleTarget;
+
+/* Square and not, powers of two and not, and one too small to need the last workgroup */
+static const Uint32 ValidationSizes[][2] = {
+	{ 256, 256 },
+	{ TEXTURE_WIDTH, TEXTURE_HEIGHT },
+	{ 511, 97 },
+	{ 100, 300 },
+	{ 37, 5 },
+	{ 12, 7 }
+};
+
+static SDL_GPUComputePipeline* GradientPipeline;
+static SDL_GPUComputePipeline* DownsamplePipeline;
+static DownsampleTarget Target;
+static SDL_GPUTexture* UnusedMipTexture;
+static SDL_GPUSampler* PointSampler;
+
+typedef enum DownsampleFilter
+{
+	FILTER_BOX,
+	FILTER_KAISER,
+	FILTER_COUNT
+} DownsampleFilter;
+
+static const char* FilterNames[] = { "Box", "Kaiser" };
+
+/* Matches the std140 layout of the UniformBlock in SinglePassDownsample.comp */
+typedef struct DownsampleUniforms
+{
+	float Weights[4];
+	Uint32 SourceSize[2];
+	Uint32 MipCount;
+	Uint32 SRGB;
+	Uint32 GroupCount;
+	Uint32 Padding[3];
+} DownsampleUniforms;
+
+static bool UseComputeDownsample = true;
+static DownsampleFilter Filter = FILTER_BOX;
+static bool SRGBCorrect = true;
+static float Time = 0;
+
+static Uint64 AccumulatedCPUTicks = 0;
+static float AccumulatedFrameTime = 0;
+static Uint32 AccumulatedFrames = 0;
+
+static double BesselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+	for (int k = 1; k < 20; k += 1)
+	{
+		term *= (x * 0.5) / k;
+		sum += term * term;
+	}
+	return sum;
+}
+
+/* Taps sit at -1.5, -0.5, +0.5, +1.5 source texels from the destination texel center.
+ * Each is a half-band sinc windowed by a Kaiser window spanning the 4 tap footprint.
+ */
+static void GetFilterWeights(DownsampleFilter filter, float weights[4])
+{
+	if (filter == FILTER_BOX)
+	{
+		weights[0] = 0.0f;
+		weights[1] = 0.5f;
+		weights[2] = 0.5f;
+		weights[3] = 0.0f;
+		return;
+	}
+
+	const double beta = 4.0;
+	const double halfWidth = 2.0;
+	double total = 0.0;
+	double raw[4];
+	for (int i = 0; i < 4; i += 1)
+	{
+		double x = i - 1.5;
+		double s = (x * 0.5) * SDL_PI_D;
+		double sinc = SDL_sin(s) / s;
+		double r = x / halfWidth;
+		double window = BesselI0(beta * SDL_sqrt(1.0 - (r * r))) / BesselI0(beta);
+		raw[i] = sinc * window;
+		total += raw[i];
+	}
+
+	for (int i = 0; i < 4; i += 1)
+	{
+		weights[i] = (float) (raw[i] / total);
+	}
+}
+
+static Uint32 GetMipSize(Uint32 size, Uint32 level)
+{
+	return SDL_max(size >> level, 1);
+}
+
+static Uint32 GetGroupCount(Uint32 size)
+{
+	return (size + 63) / 64;
+}
+
+static void ReleaseDownsampleTarget(SDL_GPUDevice* device, DownsampleTarget* target)
+{
+	SDL_ReleaseGPUTexture(device, target->Source);
+	SDL_ReleaseGPUTexture(device, target->Mips);
+	SDL_ReleaseGPUBuffer(device, target->Scratch);
+	SDL_zerop(target);
+}
+
+static bool CreateDownsampleTarget(SDL_GPUDevice* device, Uint32 width, Uint32 height, DownsampleTarget* target)
+{
+	SDL_zerop(target);
+	if (width == 0 || height == 0 || width > MAX_TEXTURE_SIZE || height > MAX_TEXTURE_SIZE)
+	{
+		SDL_Log("The downsampler handles textures of 1x1 up to %dx%d, not %ux%u", MAX_TEXTURE_SIZE, MAX_TEXTURE_SIZE, width, height);
+		return false;
+	}
+
+	target->Width = width;
+	target->Height = height;
+	target->MipCount = 1;
+	while ((SDL_max(width, height) >> target->MipCount) > 0)
+	{
+		target->MipCount += 1;
+	}
+
+	target->Source = SDL_CreateGPUTexture(
+		device,
+		&(SDL_GPUTextureCreateInfo){
+			.type = SDL_GPU_TEXTURETYPE_2D,
+			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE,
+			.width = width,
+			.height = height,
+			.layer_count_or_depth = 1,
+			.num_levels = 1
+		}
+	);
+
+	target->Mips = SDL_CreateGPUTexture(
+		device,
+		&(SDL_GPUTextureCreateInfo){
+			.type = SDL_GPU_TEXTURETYPE_2D,
+			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE,
+			.width = width,
+			.height = height,
+			.layer_count_or_depth = 1,
+			.num_levels = target->MipCount
+		}
+	);
+
+	/* The counter takes the first 16 bytes, so the vec4 texels after it stay aligned */
+	Uint32 mip3TexelCount = GetMipSize(width, 3) * GetMipSize(height, 3);
+	target->Scratch = SDL_CreateGPUBuffer(
+		device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+			.size = 16 + (mip3TexelCount * 16)
+		}
+	);
+
+	if (target->Source == NULL || target->Mips == NULL || target->Scratch == NULL)
+	{
+		SDL_Log("Failed to create a %ux%u downsample target: %s", width, height, SDL_GetError());
+		ReleaseDownsampleTarget(device, target);
+		return false;
+	}
+
+	// The workgroup counter has to start at zero, the last workgroup resets it after each dispatch
+	SDL_GPUTransferBuffer* counterTransferBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = sizeof(Uint32)
+		}
+	);
+	Uint32* counterData = SDL_MapGPUTransferBuffer(device, counterTransferBuffer, false);
+	*counterData = 0;
+	SDL_UnmapGPUTransferBuffer(device, counterTransferBuffer);
+
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = counterTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = target->Scratch,
+			.offset = 0,
+			.size = sizeof(Uint32)
+		},
+		false
+	);
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(device, counterTransferBuffer);
+
+	return true;
+}
+
+static DownsampleUniforms GetDownsampleUniforms(const DownsampleTarget* target, DownsampleFilter filter, bool srgb)
+{
+	DownsampleUniforms uniforms = {
+		.SourceSize = { target->Width, target->Height },
+		.MipCount = target->MipCount,
+		.SRGB = srgb ? 1 : 0,
+		.GroupCount = GetGroupCount(target->Width) * GetGroupCount(target->Height)
+	};
+	GetFilterWeights(filter, uniforms.Weights);
+	return uniforms;
+}
+
+static void Downsample(SDL_GPUCommandBuffer* cmdbuf, const DownsampleTarget* target, const DownsampleUniforms* uniforms)
+{
+	if (target->MipCount < 2)
+	{
+		return;
+	}
+
+	// Mip 0 stays untouched, so the target must not be cycled.
+	// Outputs past the last level get a layer of their own in a dummy texture.
+	SDL_GPUStorageTextureReadWriteBinding mipBindings[MAX_MIP_COUNT - 1];
+	for (Uint32 i = 0; i < MAX_MIP_COUNT - 1; i += 1)
+	{
+		bool used = i + 1 < target->MipCount;
+		mipBindings[i] = (SDL_GPUStorageTextureReadWriteBinding) {
+			.texture = used ? target->Mips : UnusedMipTexture,
+			.mip_level = used ? i + 1 : 0,
+			.layer = used ? 0 : i,
+			.cycle = false
+		};
+	}
+
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		cmdbuf,
+		mipBindings,
+		MAX_MIP_COUNT - 1,
+		&(SDL_GPUStorageBufferReadWriteBinding){
+			.buffer = target->Scratch,
+			.cycle = false
+		},
+		1
+	);
+
+	SDL_BindGPUComputePipeline(computePass, DownsamplePipeline);
+	SDL_BindGPUComputeSamplers(
+		computePass,
+		0,
+		&(SDL_GPUTextureSamplerBinding){
+			.texture = target->Source,
+			.sampler = PointSampler
+		},
+		1
+	);
+	SDL_PushGPUComputeUniformData(cmdbuf, 0, uniforms, sizeof(DownsampleUniforms));
+	SDL_DispatchGPUCompute(computePass, GetGroupCount(target->Width), GetGroupCount(target->Height), 1);
+	SDL_EndGPUComputePass(computePass);
+}
+
+// CPU reference
+
+static float ToLinear(float value, bool srgb)
+{
+	if (!srgb)
+	{
+		return value;
+	}
+	return value <= 0.04045f ? value / 12.92f : SDL_powf((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static Uint8 Quantize(float value, int channel, bool srgb)
+{
+	if (srgb && channel < 3)
+	{
+		value = value <= 0.0031308f ? value * 12.92f : 1.055f * SDL_powf(value, 1.0f / 2.4f) - 0.055f;
+	}
+	value = SDL_clamp(value, 0.0f, 1.0f);
+	return (Uint8) ((value * 255.0f) + 0.5f);
+}
+
+/* Applies the separable 4-tap kernel with taps at base + 0..3, clamped to the image edges */
+static void FilterTexel(
+	const float* src,
+	int srcWidth,
+	int srcHeight,
+	int baseX,
+	int baseY,
+	const float weights[4],
+	float out[4]
+) {
+	float sum[4] = { 0 };
+	for (int ty = 0; ty < 4; ty += 1)
+	{
+		int sy = SDL_clamp(baseY + ty, 0, srcHeight - 1);
+		float row[4] = { 0 };
+		for (int tx = 0; tx < 4; tx += 1)
+		{
+			int sx = SDL_clamp(baseX + tx, 0, srcWidth - 1);
+			const float* texel = &src[((sy * srcWidth) + sx) * 4];
+			for (int c = 0; c < 4; c += 1)
+			{
+				row[c] += weights[tx] * texel[c];
+			}
+		}
+		for (int c = 0; c < 4; c += 1)
+		{
+			sum[c] += weights[ty] * row[c];
+		}
+	}
+	SDL_memcpy(out, sum, sizeof(sum));
+}
+
+/* Mips 1 to MipCount - 1 are laid out back to back */
+static Uint32 GetLevelOffset(Uint32 width, Uint32 height, Uint32 level)
+{
+	Uint32 offset = 0;
+	for (Uint32 i = 1; i < level; i += 1)
+	{
+		offset += GetMipSize(width, i) * GetMipSize(height, i) * 4;
+	}
+	return offset;
+}
+
+/* Filters each level from the full-precision level above it, over the whole image at once,
+ * so any seam the shader's tiling introduced shows up as a mismatch. Only the stored texels
+ * are quantized.
+ */
+static void BuildMipsCPU(
+	const Uint8* source,
+	Uint32 width,
+	Uint32 height,
+	const DownsampleUniforms* uniforms,
+	Uint8* levels
+) {
+	bool srgb = uniforms->SRGB != 0;
+	float* src = SDL_malloc(sizeof(float) * width * height * 4);
+	float* dst = SDL_malloc(sizeof(float) * GetMipSize(width, 1) * GetMipSize(height, 1) * 4);
+
+	for (Uint32 i = 0; i < width * height * 4; i += 1)
+	{
+		src[i] = ToLinear(source[i] / 255.0f, srgb && (i % 4) < 3);
+	}
+
+	for (Uint32 level = 1; level < uniforms->MipCount; level += 1)
+	{
+		int srcWidth = GetMipSize(width, level - 1);
+		int srcHeight = GetMipSize(height, level - 1);
+		int dstWidth = GetMipSize(width, level);
+		int dstHeight = GetMipSize(height, level);
+		Uint8* stored = &levels[GetLevelOffset(width, height, level)];
+		for (int y = 0; y < dstHeight; y += 1)
+		{
+			for (int x = 0; x < dstWidth; x += 1)
+			{
+				int index = ((y * dstWidth) + x) * 4;
+				FilterTexel(src, srcWidth, srcHeight, (x * 2) - 1, (y * 2) - 1, uniforms->Weights, &dst[index]);
+				for (int c = 0; c < 4; c += 1)
+				{
+					stored[index + c] = Quantize(dst[index + c], c, srgb);
+				}
+			}
+		}
+
+		float* swap = src;
+		src = dst;
+		dst = swap;
+	}
+
+	SDL_free(src);
+	SDL_free(dst);
+}
+
+static bool ValidateDownsample(Context* context, Uint32 width, Uint32 height, DownsampleFilter filter, bool srgb)
+{
+	DownsampleTarget target;
+	if (!CreateDownsampleTarget(context->Device, width, height, &target))
+	{
+		return false;
+	}
+
+	const Uint32 sourceSize = width * height * 4;
+	const Uint32 levelsSize = GetLevelOffset(width, height, target.MipCount);
+	DownsampleUniforms uniforms = GetDownsampleUniforms(&target, filter, srgb);
+
+	SDL_GPUTransferBuffer* uploadTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = sourceSize
+		}
+	);
+
+	SDL_GPUTransferBuffer* downloadTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
+			.size = levelsSize
+		}
+	);
+
+	// High frequency noise so that every tap of the kernel matters
+	Uint8* sourceData = SDL_MapGPUTransferBuffer(context->Device, uploadTransferBuffer, false);
+	Uint32 state = 0x12345678;
+	for (Uint32 i = 0; i < sourceSize; i += 1)
+	{
+		state = (state * 1664525u) + 1013904223u;
+		sourceData[i] = (Uint8) (state >> 24);
+	}
+
+	Uint8* expected = SDL_malloc(levelsSize);
+	BuildMipsCPU(sourceData, width, height, &uniforms, expected);
+	SDL_UnmapGPUTransferBuffer(context->Device, uploadTransferBuffer);
+
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+	SDL_UploadToGPUTexture(
+		copyPass,
+		&(SDL_GPUTextureTransferInfo) {
+			.transfer_buffer = uploadTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUTextureRegion){
+			.texture = target.Source,
+			.w = width,
+			.h = height,
+			.d = 1
+		},
+		false
+	);
+	SDL_EndGPUCopyPass(copyPass);
+
+	Downsample(cmdbuf, &target, &uniforms);
+
+	copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+	for (Uint32 level = 1; level < target.MipCount; level += 1)
+	{
+		SDL_DownloadFromGPUTexture(
+			copyPass,
+			&(SDL_GPUTextureRegion){
+				.texture = target.Mips,
+				.mip_level = level,
+				.w = GetMipSize(width, level),
+				.h = GetMipSize(height, level),
+				.d = 1
+			},
+			&(SDL_GPUTextureTransferInfo) {
+				.transfer_buffer = downloadTransferBuffer,
+				.offset = GetLevelOffset(width, height, level)
+			}
+		);
+	}
+	SDL_EndGPUCopyPass(copyPass);
+
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
+	SDL_WaitForGPUFences(context->Device, true, &fence, 1);
+	SDL_ReleaseGPUFence(context->Device, fence);
+
+	// Allow rounding differences between GPU and CPU pow and float accumulation, and the
+	// half precision the shader keeps its intermediate levels in
+	const int tolerance = 2;
+	Uint8* downloadedData = SDL_MapGPUTransferBuffer(context->Device, downloadTransferBuffer, false);
+	int maxError = 0;
+	Uint32 mismatches = 0;
+	for (Uint32 i = 0; i < levelsSize; i += 1)
+	{
+		int error = SDL_abs((int) downloadedData[i] - (int) expected[i]);
+		maxError = SDL_max(maxError, error);
+		if (error > tolerance)
+		{
+			mismatches += 1;
+		}
+	}
+	SDL_UnmapGPUTransferBuffer(context->Device, downloadTransferBuffer);
+
+	if (mismatches == 0)
+	{
+		SDL_Log("SUCCESS! %ux%u %s %s mips match the CPU reference (max error %d)", width, height, FilterNames[filter], srgb ? "sRGB" : "linear", maxError);
+	}
+	else
+	{
+		SDL_Log("FAILURE! %ux%u %s %s mips differ from the CPU reference in %u channels (max error %d)", width, height, FilterNames[filter], srgb ? "sRGB" : "linear", mismatches, maxError);
+	}
+
+	SDL_free(expected);
+	SDL_ReleaseGPUTransferBuffer(context->Device, uploadTransferBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, downloadTransferBuffer);
+	ReleaseDownsampleTarget(context->Device, &target);
+	return true;
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	GradientPipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"GradientTexture.comp",
+		&(SDL_GPUComputePipelineCreateInfo) {
+			.num_readwrite_storage_textures = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 8,
+			.threadcount_y = 8,
+			.threadcount_z = 1
+		}
+	);
+	if (GradientPipeline == NULL)
+	{
+		SDL_Log("Failed to create gradient pipeline!");
+		return -1;
+	}
+
+	DownsamplePipeline = CreateComputePipelineFromShader(
+		context->Device,
+		"SinglePassDownsample.comp",
+		&(SDL_GPUComputePipelineCreateInfo) {
+			.num_samplers = 1,
+			.num_readwrite_storage_textures = MAX_MIP_COUNT - 1,
+			.num_readwrite_storage_buffers = 1,
+			.num_uniform_buffers = 1,
+			.threadcount_x = 256,
+			.threadcount_y = 1,
+			.threadcount_z = 1
+		}
+	);
+	if (DownsamplePipeline == NULL)
+	{
+		SDL_Log("Failed to create downsample pipeline!");
+		return -1;
+	}
+
+	// Bound in place of the levels a smaller texture doesn't have, one layer per binding
+	UnusedMipTexture = SDL_CreateGPUTexture(
+		context->Device,
+		&(SDL_GPUTextureCreateInfo){
+			.type = SDL_GPU_TEXTURETYPE_2D_ARRAY,
+			.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+			.usage = SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE,
+			.width = 1,
+			.height = 1,
+			.layer_count_or_depth = MAX_MIP_COUNT - 1,
+			.num_levels = 1
+		}
+	);
+
+	PointSampler = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+		.min_filter = SDL_GPU_FILTER_NEAREST,
+		.mag_filter = SDL_GPU_FILTER_NEAREST,
+		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+		.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+	});
+
+	if (!CreateDownsampleTarget(context->Device, TEXTURE_WIDTH, TEXTURE_HEIGHT, &Target))
+	{
+		return -1;
+	}
+
+	for (Uint32 i = 0; i < SDL_arraysize(ValidationSizes); i += 1)
+	{
+		for (int filter = 0; filter < FILTER_COUNT; filter += 1)
+		{
+			ValidateDownsample(context, ValidationSizes[i][0], ValidationSizes[i][1], filter, false);
+			ValidateDownsample(context, ValidationSizes[i][0], ValidationSizes[i][1], filter, true);
+		}
+	}
+
+	// Print the instructions
+	SDL_Log("Press Left/Right to switch between blit and single-pass compute mip generation");
+	SDL_Log("Press Up to switch the compute filter");
+	SDL_Log("Press Down to toggle sRGB-correct averaging");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	bool changed = false;
+
+	if (context->LeftPressed || context->RightPressed)
+	{
+		UseComputeDownsample = !UseComputeDownsample;
+		changed = true;
+	}
+
+	if (context->UpPressed)
+	{
+		Filter = (Filter + 1) % FILTER_COUNT;
+		changed = true;
+	}
+
+	if (context->DownPressed)
+	{
+		SRGBCorrect = !SRGBCorrect;
+		changed = true;
+	}
+
+	if (changed)
+	{
+		if (UseComputeDownsample)
+		{
+			SDL_Log("Single-pass compute, %s filter, %s averaging", FilterNames[Filter], SRGBCorrect ? "sRGB-correct" : "naive");
+		}
+		else
+		{
+			SDL_Log("SDL_GenerateMipmapsForGPUTexture blit chain");
+		}
+
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	Time += context->DeltaTime;
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	Uint64 cpuStart = SDL_GetPerformanceCounter();
+
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	if (cmdbuf == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	SDL_GPUTexture* swapchainTexture;
+	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	if (swapchainTexture != NULL)
+	{
+		// Generate this frame's texture contents
+		SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+			cmdbuf,
+			(SDL_GPUStorageTextureReadWriteBinding[]){{
+				.texture = Target.Source,
+				.cycle = true
+			}},
+			1,
+			NULL,
+			0
+		);
+		SDL_BindGPUComputePipeline(computePass, GradientPipeline);
+		SDL_PushGPUComputeUniformData(cmdbuf, 0, &Time, sizeof(float));
+		SDL_DispatchGPUCompute(computePass, (Target.Width + 7) / 8, (Target.Height + 7) / 8, 1);
+		SDL_EndGPUComputePass(computePass);
+
+		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+		SDL_CopyGPUTextureToTexture(
+			copyPass,
+			&(SDL_GPUTextureLocation){
+				.texture = Target.Source
+			},
+			&(SDL_GPUTextureLocation){
+				.texture = Target.Mips
+			},
+			Target.Width,
+			Target.Height,
+			1,
+			false
+		);
+		SDL_EndGPUCopyPass(copyPass);
+
+		// Rebuild the mip chain
+		if (UseComputeDownsample)
+		{
+			DownsampleUniforms uniforms = GetDownsampleUniforms(&Target, Filter, SRGBCorrect);
+			Downsample(cmdbuf, &Target, &uniforms);
+		}
+		else
+		{
+			SDL_GenerateMipmapsForGPUTexture(cmdbuf, Target.Mips);
+		}
+
+		// Lay every level out side by side
+		Uint32 x = 0;
+		for (Uint32 level = 0; level < Target.MipCount; level += 1)
+		{
+			Uint32 width = GetMipSize(Target.Width, level);
+			Uint32 height = GetMipSize(Target.Height, level);
+			SDL_BlitGPUTexture(
+				cmdbuf,
+				&(SDL_GPUBlitInfo){
+					.source.texture = Target.Mips,
+					.source.mip_level = level,
+					.source.w = width,
+					.source.h = height,
+					.destination.texture = swapchainTexture,
+					.destination.x = x,
+					.destination.y = 0,
+					.destination.w = width,
+					.destination.h = height,
+					.load_op = level == 0 ? SDL_GPU_LOADOP_CLEAR : SDL_GPU_LOADOP_LOAD,
+					.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f },
+					.filter = SDL_GPU_FILTER_NEAREST
+				}
+			);
+			x += width;
+		}
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	// Report averaged timings once per second
+	AccumulatedCPUTicks += SDL_GetPerformanceCounter() - cpuStart;
+	AccumulatedFrameTime += context->DeltaTime;
+	AccumulatedFrames += 1;
+	if (AccumulatedFrameTime >= 1.0f)
+	{
+		double cpuMs = (double) AccumulatedCPUTicks * 1000.0 / SDL_GetPerformanceFrequency() / AccumulatedFrames;
+		SDL_Log(
+			"%s: CPU %.3f ms/frame, frame %.3f ms",
+			UseComputeDownsample ? "Compute" : "Blit",
+			cpuMs,
+			AccumulatedFrameTime * 1000.0f / AccumulatedFrames
+		);
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUComputePipeline(context->Device, GradientPipeline);
+	SDL_ReleaseGPUComputePipeline(context->Device, DownsamplePipeline);
+	ReleaseDownsampleTarget(context->Device, &Target);
+	SDL_ReleaseGPUTexture(context->Device, UnusedMipTexture);
+	SDL_ReleaseGPUSampler(context->Device, PointSampler);
+
+	UseComputeDownsample = true;
+	Filter = FILTER_BOX;
+	SRGBCorrect = true;
+	Time = 0;
+
+	CommonQuit(context);
+}
+
+Example GenerateMipmapsCompute_Example = { "GenerateMipmapsCompute", Init, Update, Draw, Quit };
@@ -3,11 +3,58 @@
 static SDL_GPUGraphicsPipeline* Pipeline;
 static SDL_GPUBuffer* VertexBuffer;
 static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUBuffer* InstanceBuffer;
+static SDL_GPUTransferBuffer* InstanceTransferBuffer;
 
 static bool UseVertexOffset = false;
 static bool UseIndexOffset = false;
 static bool UseIndexBuffer = true;
 
+typedef struct InstanceData
+{
+	float x, y;
+	float scale;
+	Uint8 r, g, b, a;
+} InstanceData;
+
+static const Uint32 InstanceCounts[] = { 16, 1024, 65536, 1048576 };
+static Uint32 InstanceCountIndex = 0;
+static InstanceData* BaseInstances;
+
+static float t = 0;
+
+static Uint64 AccumulatedUpdateTicks = 0;
+static float AccumulatedFrameTime = 0;
+static Uint32 AccumulatedFrames = 0;
+
+static void ResetInstances(void)
+{
+	Uint32 count = InstanceCounts[InstanceCountIndex];
+	Uint32 perRow = (Uint32) SDL_ceilf(SDL_sqrtf((float) count));
+	float cellSize = 2.0f / perRow;
+
+	/* With 16 instances this is the same 4x4 grid the shader used to derive from gl_InstanceIndex */
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		Uint32 column = i % perRow;
+		Uint32 row = i / perRow;
+
+		BaseInstances[i].x = -1.0f + cellSize * (column + 0.5f);
+		BaseInstances[i].y = -1.0f + cellSize * (row + 0.5f);
+		BaseInstances[i].scale = cellSize * 0.5f;
+		BaseInstances[i].r = (Uint8) (255 - (column * 128 / perRow));
+		BaseInstances[i].g = (Uint8) (255 - (row * 128 / perRow));
+		BaseInstances[i].b = 255;
+		BaseInstances[i].a = 255;
+	}
+
+	AccumulatedUpdateTicks = 0;
+	AccumulatedFrameTime = 0;
+	AccumulatedFrames = 0;
+
+	SDL_Log("Instance count: %u", count);
+}
+
 static int Init(Context* context)
 {
 	int result = CommonInit(context, 0);
@@ -16,6 +63,9 @@ static int Init(Context* context)
 		return result;
 	}
 
+	// Don't let vsync cap the reported throughput
+	ApplyPresentPolicy(context->Device, context->Window, PRESENTPOLICY_LOWEST_LATENCY);
+
 	// Create the shaders
 	SDL_GPUShader* vertexShader = LoadShader(context->Device, "PositionColorInstanced.vert", 0, 0, 0, 0);
 	if (vertexShader == NULL)
@@ -40,15 +90,21 @@ static int Init(Context* context)
 			}},
 		},
 		// This is set up to match the vertex shader layout!
+		// Slot 0 advances per vertex, slot 1 advances once per instance.
 		.vertex_input_state = (SDL_GPUVertexInputState){
-			.num_vertex_buffers = 1,
+			.num_vertex_buffers = 2,
 			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
 				.slot = 0,
 				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
 				.instance_step_rate = 0,
 				.pitch = sizeof(PositionColorVertex)
+			}, {
+				.slot = 1,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+				.instance_step_rate = 0,
+				.pitch = sizeof(InstanceData)
 			}},
-			.num_vertex_attributes = 2,
+			.num_vertex_attributes = 5,
 			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
 				.buffer_slot = 0,
 				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
@@ -59,6 +115,21 @@ static int Init(Context* context)
 				.format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
 				.location = 1,
 				.offset = sizeof(float) * 3
+			}, {
+				.buffer_slot = 1,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+				.location = 2,
+				.offset = 0
+			}, {
+				.buffer_slot = 1,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT,
+				.location = 3,
+				.offset = sizeof(float) * 2
+			}, {
+				.buffer_slot = 1,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+				.location = 4,
+				.offset = sizeof(float) * 3
 			}}
 		},
 		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
@@ -93,6 +164,32 @@ static int Init(Context* context)
 		}
     );
 
+	// The instance buffer is created once at the largest size and cycled every frame
+	Uint32 maxInstances = InstanceCounts[SDL_arraysize(InstanceCounts) - 1];
+
+	InstanceBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = sizeof(InstanceData) * maxInstances
+		}
+	);
+
+	InstanceTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = sizeof(InstanceData) * maxInstances
+		}
+	);
+
+	BaseInstances = SDL_malloc(sizeof(InstanceData) * maxInstances);
+	if (BaseInstances == NULL)
+	{
+		SDL_Log("Failed to allocate instance data!");
+		return -1;
+	}
+
 	// Set the buffer data
 	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
 		context->Device,
@@ -164,6 +261,13 @@ static int Init(Context* context)
 	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
 	SDL_ReleaseGPUTransferBuffer(context->Device, transferBuffer);
 
+	SDL_Log("Press Left to toggle vertex offset");
+	SDL_Log("Press Right to toggle index offset");
+	SDL_Log("Press Up to toggle the index buffer");
+	SDL_Log("Press Down to cycle the instance count");
+
+	ResetInstances();
+
 	return 0;
 }
 
@@ -187,6 +291,14 @@ static int Update(Context* context)
         SDL_Log("Using index buffer: %s", UseIndexBuffer ? "true" : "false");
 	}
 
+	if (context->DownPressed)
+	{
+		InstanceCountIndex = (InstanceCountIndex + 1) % SDL_arraysize(InstanceCounts);
+		ResetInstances();
+	}
+
+	t += context->DeltaTime;
+
 	return 0;
 }
 
@@ -194,6 +306,7 @@ static int Draw(Context* context)
 {
     Uint32 vertexOffset = UseVertexOffset ? 3 : 0;
     Uint32 indexOffset = UseIndexOffset ? 3 : 0;
+    Uint32 instanceCount = InstanceCounts[InstanceCountIndex];
 
     SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
     if (cmdbuf == NULL)
@@ -210,6 +323,40 @@ static int Draw(Context* context)
 
 	if (swapchainTexture != NULL)
 	{
+		// Stream this frame's instance data through the cycled transfer buffer
+		Uint64 updateStart = SDL_GetPerformanceCounter();
+		float pulse = 0.85f + SDL_sinf(t * 2.0f) * 0.15f;
+
+		InstanceData* instanceData = SDL_MapGPUTransferBuffer(
+			context->Device,
+			InstanceTransferBuffer,
+			true
+		);
+		for (Uint32 i = 0; i < instanceCount; i += 1)
+		{
+			instanceData[i] = BaseInstances[i];
+			instanceData[i].scale *= pulse;
+		}
+		SDL_UnmapGPUTransferBuffer(context->Device, InstanceTransferBuffer);
+
+		SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+		SDL_UploadToGPUBuffer(
+			copyPass,
+			&(SDL_GPUTransferBufferLocation) {
+				.transfer_buffer = InstanceTransferBuffer,
+				.offset = 0
+			},
+			&(SDL_GPUBufferRegion) {
+				.buffer = InstanceBuffer,
+				.offset = 0,
+				.size = sizeof(InstanceData) * instanceCount
+			},
+			true
+		);
+		SDL_EndGPUCopyPass(copyPass);
+
+		AccumulatedUpdateTicks += SDL_GetPerformanceCounter() - updateStart;
+
 		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
 		colorTargetInfo.texture = swapchainTexture;
 		colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
@@ -219,14 +366,22 @@ static int Draw(Context* context)
 		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
 
 		SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
-		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ .buffer = VertexBuffer, .offset = 0 }, 1);
+		SDL_BindGPUVertexBuffers(
+			renderPass,
+			0,
+			(SDL_GPUBufferBinding[]){
+				{ .buffer = VertexBuffer, .offset = 0 },
+				{ .buffer = InstanceBuffer, .offset = 0 }
+			},
+			2
+		);
 
 		if (UseIndexBuffer)
 		{
 			SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer, .offset = 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
-			SDL_DrawGPUIndexedPrimitives(renderPass, 3, 16, indexOffset, vertexOffset, 0);
+			SDL_DrawGPUIndexedPrimitives(renderPass, 3, instanceCount, indexOffset, vertexOffset, 0);
 		} else {
-			SDL_DrawGPUPrimitives(renderPass, 3, 16, vertexOffset, 0);
+			SDL_DrawGPUPrimitives(renderPass, 3, instanceCount, vertexOffset, 0);
 		}
 
 		SDL_EndGPURenderPass(renderPass);
@@ -234,6 +389,25 @@ static int Draw(Context* context)
 
 	SDL_SubmitGPUCommandBuffer(cmdbuf);
 
+	// Report instancing throughput once per second
+	AccumulatedFrameTime += context->DeltaTime;
+	AccumulatedFrames += 1;
+	if (AccumulatedFrameTime >= 1.0f)
+	{
+		double verticesPerSecond = (double) instanceCount * 3 * AccumulatedFrames / AccumulatedFrameTime;
+		double updateMs = (double) AccumulatedUpdateTicks * 1000.0 / SDL_GetPerformanceFrequency() / AccumulatedFrames;
+		SDL_Log(
+			"%u instances: %.2f M vertices/s, frame %.3f ms, instance update %.3f ms",
+			instanceCount,
+			verticesPerSecond / 1000000.0,
+			AccumulatedFrameTime * 1000.0f / AccumulatedFrames,
+			updateMs
+		);
+		AccumulatedUpdateTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
 	return 0;
 }
 
@@ -242,10 +416,17 @@ static void Quit(Context* context)
 	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
     SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, InstanceBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, InstanceTransferBuffer);
+
+	SDL_free(BaseInstances);
+	BaseInstances = NULL;
 
     UseVertexOffset = false;
     UseIndexOffset = false;
 	UseIndexBuffer = true;
+	InstanceCountIndex = 0;
+	t = 0;
 
 	CommonQuit(context);
 }
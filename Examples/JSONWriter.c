@@ -0,0 +1,22 @@
+#include "Common.h"
+
+void WriteJSONString(SDL_IOStream* stream, const char* text)
+{
+	SDL_IOprintf(stream, "\"");
+	for (const char* c = text; *c != '\0'; c += 1)
+	{
+		if (*c == '"' || *c == '\\')
+		{
+			SDL_IOprintf(stream, "\\%c", *c);
+		}
+		else if ((unsigned char) *c < 0x20)
+		{
+			SDL_IOprintf(stream, "\\u%04x", (unsigned char) *c);
+		}
+		else
+		{
+			SDL_IOprintf(stream, "%c", *c);
+		}
+	}
+	SDL_IOprintf(stream, "\"");
+}
@@ -0,0 +1,307 @@
+#include "Common.h"
+
+/* Thousands of tiny draws, split into one chunk per thread. Each chunk is a job that
+ * records its slice into its own command buffer; they all depend on the job that clears
+ * the target, and the job that presents depends on all of them.
+ */
+#define MIN_DRAW_COUNT 1024
+#define MAX_DRAW_COUNT (1024 * 1024)
+#define MAX_CHUNK_COUNT (FRAME_JOB_GRAPH_MAX_JOBS - 2)
+
+typedef struct DrawChunk
+{
+	char Name[32];
+	Uint32 Index;
+} DrawChunk;
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static FrameJobGraph Graph;
+static GPUProfiler Profiler;
+static DrawChunk Chunks[MAX_CHUNK_COUNT];
+static Uint32 ChunkCount;
+static bool UseWorkers = true;
+static Uint32 DrawCount = 16384;
+
+/* Set by Draw before the graph runs, read by every job */
+static SDL_GPUTexture* RenderTarget;
+static Uint32 TargetWidth;
+static Uint32 TargetHeight;
+
+static void RecordClear(SDL_GPUCommandBuffer* cmdbuf, SDL_GPUTexture* swapchainTexture, void* userdata)
+{
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
+		cmdbuf,
+		&(SDL_GPUColorTargetInfo){
+			.texture = RenderTarget,
+			.clear_color = { 0.0f, 0.0f, 0.0f, 1.0f },
+			.load_op = SDL_GPU_LOADOP_CLEAR,
+			.store_op = SDL_GPU_STOREOP_STORE
+		},
+		1,
+		NULL
+	);
+	SDL_EndGPURenderPass(renderPass);
+}
+
+static void RecordChunk(SDL_GPUCommandBuffer* cmdbuf, SDL_GPUTexture* swapchainTexture, void* userdata)
+{
+	DrawChunk* chunk = userdata;
+
+	/* Lay the draws out on a square grid, and give this chunk a run of its cells */
+	Uint32 gridSize = 1;
+	while (gridSize * gridSize < DrawCount)
+	{
+		gridSize *= 2;
+	}
+	float cellWidth = (float) TargetWidth / gridSize;
+	float cellHeight = (float) TargetHeight / gridSize;
+
+	Uint32 first = (Uint32) ((Uint64) DrawCount * chunk->Index / ChunkCount);
+	Uint32 last = (Uint32) ((Uint64) DrawCount * (chunk->Index + 1) / ChunkCount);
+
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
+		cmdbuf,
+		&(SDL_GPUColorTargetInfo){
+			.texture = RenderTarget,
+			.load_op = SDL_GPU_LOADOP_LOAD,
+			.store_op = SDL_GPU_STOREOP_STORE
+		},
+		1,
+		NULL
+	);
+	SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+
+	for (Uint32 i = first; i < last; i += 1)
+	{
+		SDL_SetGPUViewport(renderPass, &(SDL_GPUViewport){
+			(i % gridSize) * cellWidth,
+			(i / gridSize) * cellHeight,
+			cellWidth,
+			cellHeight,
+			0,
+			1
+		});
+		SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+	}
+
+	SDL_EndGPURenderPass(renderPass);
+}
+
+static void RecordPresent(SDL_GPUCommandBuffer* cmdbuf, SDL_GPUTexture* swapchainTexture, void* userdata)
+{
+	if (swapchainTexture == NULL)
+	{
+		return;
+	}
+
+	SDL_BlitGPUTexture(cmdbuf, &(SDL_GPUBlitInfo){
+		.source.texture = RenderTarget,
+		.source.w = TargetWidth,
+		.source.h = TargetHeight,
+		.destination.texture = swapchainTexture,
+		.destination.w = TargetWidth,
+		.destination.h = TargetHeight,
+		.load_op = SDL_GPU_LOADOP_DONT_CARE,
+		.filter = SDL_GPU_FILTER_NEAREST
+	});
+}
+
+static bool BuildGraph(Context* context)
+{
+	Uint32 workerCount = 0;
+	if (UseWorkers)
+	{
+		int coreCount = SDL_GetNumLogicalCPUCores();
+		workerCount = coreCount > 1 ? (Uint32) coreCount - 1 : 0;
+	}
+
+	if (!FrameJobGraph_Init(&Graph, context->Device, workerCount))
+	{
+		return false;
+	}
+	Graph.Profiler = &Profiler;
+
+	/* A chunk for each worker and one for the calling thread */
+	ChunkCount = SDL_min(Graph.WorkerCount + 1, MAX_CHUNK_COUNT);
+
+	int clearJob = FrameJobGraph_AddJob(&Graph, &(FrameJobDescription){
+		.Name = "Clear",
+		.Record = RecordClear
+	});
+	if (clearJob < 0)
+	{
+		return false;
+	}
+
+	Uint32 chunkMask = 0;
+	for (Uint32 i = 0; i < ChunkCount; i += 1)
+	{
+		Chunks[i].Index = i;
+		SDL_snprintf(Chunks[i].Name, sizeof(Chunks[i].Name), "Draws %u", i);
+
+		int chunkJob = FrameJobGraph_AddJob(&Graph, &(FrameJobDescription){
+			.Name = Chunks[i].Name,
+			.Record = RecordChunk,
+			.Userdata = &Chunks[i],
+			.Dependencies = 1u << clearJob
+		});
+		if (chunkJob < 0)
+		{
+			return false;
+		}
+		chunkMask |= 1u << chunkJob;
+	}
+
+	int presentJob = FrameJobGraph_AddJob(&Graph, &(FrameJobDescription){
+		.Name = "Present",
+		.Record = RecordPresent,
+		.Dependencies = chunkMask,
+		.Window = context->Window
+	});
+	if (presentJob < 0)
+	{
+		return false;
+	}
+
+	SDL_Log(
+		"%u draws in %u chunks, recorded on %u worker threads and the main thread",
+		DrawCount,
+		ChunkCount,
+		Graph.WorkerCount
+	);
+	return true;
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	/* Don't let vsync hide the recording cost */
+	ApplyPresentPolicy(context->Device, context->Window, PRESENTPOLICY_LOWEST_LATENCY);
+
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	Pipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+	if (Pipeline == NULL)
+	{
+		SDL_Log("Failed to create pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	if (!GPUProfiler_Init(&Profiler, context->Device, NULL) || !BuildGraph(context))
+	{
+		return -1;
+	}
+
+	SDL_Log("Press Left/Right to halve/double the draw count");
+	SDL_Log("Press Up to switch between worker threads and recording on the main thread");
+	SDL_Log("Press Down to write the GPU time of each job as a Chrome trace");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	if (context->LeftPressed && DrawCount > MIN_DRAW_COUNT)
+	{
+		DrawCount /= 2;
+		SDL_Log("%u draws", DrawCount);
+	}
+
+	if (context->RightPressed && DrawCount < MAX_DRAW_COUNT)
+	{
+		DrawCount *= 2;
+		SDL_Log("%u draws", DrawCount);
+	}
+
+	if (context->UpPressed)
+	{
+		UseWorkers = !UseWorkers;
+		FrameJobGraph_Destroy(&Graph);
+		if (!BuildGraph(context))
+		{
+			return -1;
+		}
+	}
+
+	if (context->DownPressed)
+	{
+		char filename[64];
+		SDL_snprintf(filename, sizeof(filename), "%s.gpu.json", context->ExampleName);
+		GPUProfiler_WriteTrace(&Profiler, filename, context->ExampleName);
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	int w, h;
+	SDL_GetWindowSizeInPixels(context->Window, &w, &h);
+	TargetWidth = w;
+	TargetHeight = h;
+
+	GPUProfiler_BeginFrame(&Profiler);
+
+	RenderTarget = AcquireRenderTarget(context->Device, &(RenderTargetDescription){
+		.Format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+		.Width = TargetWidth,
+		.Height = TargetHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+		.Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+	});
+	if (RenderTarget == NULL)
+	{
+		return -1;
+	}
+
+	bool success = FrameJobGraph_Execute(&Graph);
+
+	ReleaseRenderTarget(RenderTarget);
+	RenderTarget = NULL;
+
+	return success ? 0 : -1;
+}
+
+static void Quit(Context* context)
+{
+	// The pipeline belongs to the state cache, which CommonQuit releases
+	FrameJobGraph_Destroy(&Graph);
+	GPUProfiler_Destroy(&Profiler);
+	ChunkCount = 0;
+	UseWorkers = true;
+	DrawCount = 16384;
+
+	CommonQuit(context);
+}
+
+Example JobGraphStress_Example = { "JobGraphStress", Init, Update, Draw, Quit };
@@ -0,0 +1,312 @@
+#include "Common.h"
+
+#define MULTI_WINDOW_REPORT_INTERVAL_NS (2 * SDL_NS_PER_SECOND)
+
+/* Blocks until it is windowIndex's turn in the submission queue */
+static void WaitTurn(MultiWindowPresenter* presenter, Uint32 windowIndex)
+{
+	SDL_LockMutex(presenter->Lock);
+	while (presenter->SubmitTurn != windowIndex)
+	{
+		SDL_WaitCondition(presenter->Changed, presenter->Lock);
+	}
+	SDL_UnlockMutex(presenter->Lock);
+}
+
+static void EndTurn(MultiWindowPresenter* presenter)
+{
+	SDL_LockMutex(presenter->Lock);
+	presenter->SubmitTurn += 1;
+	SDL_BroadcastCondition(presenter->Changed);
+	SDL_UnlockMutex(presenter->Lock);
+}
+
+static int WindowWorkerThread(void* data)
+{
+	WindowWorker* worker = data;
+	MultiWindowPresenter* presenter = worker->Presenter;
+
+	while (true)
+	{
+		SDL_WaitSemaphore(worker->Start);
+		if (worker->Quit)
+		{
+			break;
+		}
+
+		/* The command buffer is acquired, recorded and submitted on this thread, as SDL requires.
+		 * A window without a swapchain texture this frame only takes its turn in the queue.
+		 */
+		SDL_GPUCommandBuffer* commandBuffer = NULL;
+		worker->Failed = false;
+		if (worker->Target != NULL)
+		{
+			Uint64 start = SDL_GetTicksNS();
+			commandBuffer = SDL_AcquireGPUCommandBuffer(presenter->Device);
+			if (commandBuffer == NULL)
+			{
+				SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+				worker->Failed = true;
+			}
+			else
+			{
+				presenter->Record(commandBuffer, worker->Target, worker->Index, presenter->Userdata);
+			}
+			worker->Timings.RecordNS += SDL_GetTicksNS() - start;
+		}
+
+		WaitTurn(presenter, worker->Index);
+		if (commandBuffer != NULL)
+		{
+			Uint64 start = SDL_GetTicksNS();
+			if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+			{
+				SDL_Log("SubmitGPUCommandBuffer failed: %s", SDL_GetError());
+				worker->Failed = true;
+			}
+			worker->Timings.SubmitNS += SDL_GetTicksNS() - start;
+		}
+		EndTurn(presenter);
+	}
+
+	return 0;
+}
+
+bool MultiWindowPresenter_Init(MultiWindowPresenter* presenter, SDL_GPUDevice* device, RecordWindowFunction record, void* userdata)
+{
+	SDL_zerop(presenter);
+	presenter->Device = device;
+	presenter->Record = record;
+	presenter->Userdata = userdata;
+	presenter->Lock = SDL_CreateMutex();
+	presenter->Changed = SDL_CreateCondition();
+	presenter->LastReportNS = SDL_GetTicksNS();
+
+	if (presenter->Lock == NULL || presenter->Changed == NULL)
+	{
+		SDL_Log("Failed to create the submission queue: %s", SDL_GetError());
+		return false;
+	}
+
+	return true;
+}
+
+bool MultiWindowPresenter_AddWindow(MultiWindowPresenter* presenter, SDL_Window* window)
+{
+	if (presenter->WindowCount == MULTI_WINDOW_MAX_WINDOWS)
+	{
+		SDL_Log("MultiWindowPresenter: at most %d windows are supported", MULTI_WINDOW_MAX_WINDOWS);
+		return false;
+	}
+
+	WindowWorker* worker = &presenter->Workers[presenter->WindowCount];
+	SDL_zerop(worker);
+	worker->Presenter = presenter;
+	worker->Index = presenter->WindowCount;
+	worker->Window = window;
+	worker->Start = SDL_CreateSemaphore(0);
+	if (worker->Start == NULL)
+	{
+		SDL_Log("CreateSemaphore failed: %s", SDL_GetError());
+		return false;
+	}
+
+	char threadName[32];
+	SDL_snprintf(threadName, sizeof(threadName), "WindowWorker%u", worker->Index);
+	worker->Thread = SDL_CreateThread(WindowWorkerThread, threadName, worker);
+	if (worker->Thread == NULL)
+	{
+		SDL_Log("CreateThread failed: %s", SDL_GetError());
+		SDL_DestroySemaphore(worker->Start);
+		return false;
+	}
+
+	presenter->WindowCount += 1;
+	return true;
+}
+
+SDL_Window* MultiWindowPresenter_RemoveWindow(MultiWindowPresenter* presenter)
+{
+	if (presenter->WindowCount == 0)
+	{
+		return NULL;
+	}
+
+	presenter->WindowCount -= 1;
+	WindowWorker* worker = &presenter->Workers[presenter->WindowCount];
+
+	worker->Quit = true;
+	SDL_SignalSemaphore(worker->Start);
+	SDL_WaitThread(worker->Thread, NULL);
+	SDL_DestroySemaphore(worker->Start);
+
+	SDL_Window* window = worker->Window;
+	SDL_zerop(worker);
+	return window;
+}
+
+static void ReportTimings(MultiWindowPresenter* presenter)
+{
+	Uint64 recordNS = 0;
+	for (Uint32 i = 0; i < presenter->WindowCount; i += 1)
+	{
+		WindowTimings* timings = &presenter->Workers[i].Timings;
+		if (timings->FrameCount == 0)
+		{
+			continue;
+		}
+
+		SDL_Log(
+			"Window %u: acquire %.3f ms, record %.3f ms, submit %.3f ms",
+			i,
+			timings->AcquireNS / 1e6 / timings->FrameCount,
+			timings->RecordNS / 1e6 / timings->FrameCount,
+			timings->SubmitNS / 1e6 / timings->FrameCount
+		);
+		recordNS += timings->RecordNS / timings->FrameCount;
+		SDL_zerop(timings);
+	}
+
+	if (presenter->FrameCount > 0)
+	{
+		SDL_Log(
+			"%u windows: %.3f ms per frame on the main thread, %.3f ms of it submitting the blits, %.3f ms of recording spread over the workers",
+			presenter->WindowCount,
+			presenter->FrameNS / 1e6 / presenter->FrameCount,
+			presenter->PresentSubmitNS / 1e6 / presenter->FrameCount,
+			recordNS / 1e6
+		);
+	}
+
+	presenter->FrameCount = 0;
+	presenter->FrameNS = 0;
+	presenter->PresentSubmitNS = 0;
+}
+
+bool MultiWindowPresenter_Present(MultiWindowPresenter* presenter)
+{
+	Uint64 frameStart = SDL_GetTicksNS();
+
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(presenter->Device);
+	if (commandBuffer == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return false;
+	}
+
+	SDL_LockMutex(presenter->Lock);
+	presenter->SubmitTurn = 0;
+	SDL_UnlockMutex(presenter->Lock);
+
+	/* Acquire each window's swapchain texture here, on the window's thread, then let its
+	 * worker render into a pooled target of the same size and format while the next
+	 * window is acquired. Every worker is let go, so all of them take their turn.
+	 */
+	bool success = true;
+	for (Uint32 i = 0; i < presenter->WindowCount; i += 1)
+	{
+		WindowWorker* worker = &presenter->Workers[i];
+
+		Uint64 start = SDL_GetTicksNS();
+		worker->SwapchainTexture = NULL;
+		worker->Target = NULL;
+		if (!SDL_AcquireGPUSwapchainTexture(commandBuffer, worker->Window, &worker->SwapchainTexture))
+		{
+			SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+			success = false;
+		}
+		worker->Timings.AcquireNS += SDL_GetTicksNS() - start;
+
+		if (worker->SwapchainTexture != NULL)
+		{
+			int width, height;
+			SDL_GetWindowSizeInPixels(worker->Window, &width, &height);
+			worker->Width = width;
+			worker->Height = height;
+			worker->Target = AcquireRenderTarget(presenter->Device, &(RenderTargetDescription){
+				.Format = SDL_GetGPUSwapchainTextureFormat(presenter->Device, worker->Window),
+				.Width = worker->Width,
+				.Height = worker->Height,
+				.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+				.Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+			});
+			if (worker->Target == NULL)
+			{
+				success = false;
+			}
+		}
+
+		SDL_SignalSemaphore(worker->Start);
+	}
+
+	/* The blits can be recorded before the workers finish, since this command buffer is only
+	 * submitted once every worker has submitted the commands that render its target
+	 */
+	for (Uint32 i = 0; i < presenter->WindowCount; i += 1)
+	{
+		WindowWorker* worker = &presenter->Workers[i];
+		if (worker->Target == NULL)
+		{
+			continue;
+		}
+
+		SDL_BlitGPUTexture(
+			commandBuffer,
+			&(SDL_GPUBlitInfo){
+				.source.texture = worker->Target,
+				.source.w = worker->Width,
+				.source.h = worker->Height,
+				.destination.texture = worker->SwapchainTexture,
+				.destination.w = worker->Width,
+				.destination.h = worker->Height,
+				.load_op = SDL_GPU_LOADOP_DONT_CARE,
+				.filter = SDL_GPU_FILTER_NEAREST
+			}
+		);
+	}
+
+	WaitTurn(presenter, presenter->WindowCount);
+
+	Uint64 submitStart = SDL_GetTicksNS();
+	if (!SDL_SubmitGPUCommandBuffer(commandBuffer))
+	{
+		SDL_Log("SubmitGPUCommandBuffer failed: %s", SDL_GetError());
+		success = false;
+	}
+	presenter->PresentSubmitNS += SDL_GetTicksNS() - submitStart;
+
+	for (Uint32 i = 0; i < presenter->WindowCount; i += 1)
+	{
+		WindowWorker* worker = &presenter->Workers[i];
+		if (worker->Target != NULL)
+		{
+			ReleaseRenderTarget(worker->Target);
+			worker->Target = NULL;
+			worker->Timings.FrameCount += 1;
+		}
+		success = success && !worker->Failed;
+	}
+
+	Uint64 now = SDL_GetTicksNS();
+	presenter->FrameCount += 1;
+	presenter->FrameNS += now - frameStart;
+	if (now - presenter->LastReportNS >= MULTI_WINDOW_REPORT_INTERVAL_NS)
+	{
+		ReportTimings(presenter);
+		presenter->LastReportNS = now;
+	}
+
+	return success;
+}
+
+void MultiWindowPresenter_Destroy(MultiWindowPresenter* presenter)
+{
+	while (presenter->WindowCount > 0)
+	{
+		MultiWindowPresenter_RemoveWindow(presenter);
+	}
+
+	SDL_DestroyCondition(presenter->Changed);
+	SDL_DestroyMutex(presenter->Lock);
+	SDL_zerop(presenter);
+}
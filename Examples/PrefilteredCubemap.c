@@ -0,0 +1,398 @@
+#include "Common.h"
+
+/* Loads the cube0-5 faces with LoadCubemap, which decodes them in parallel and uploads the
+ * whole mip chain in one pass, box-filtering any level without an authored file. Then builds
+ * a GGX-prefiltered specular cubemap from it with a compute kernel. Each mip level can be
+ * inspected on the skybox.
+ */
+
+#define SAMPLE_COUNT 64
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static SDL_GPUBuffer* VertexBuffer;
+static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUTexture* BakedTexture;
+static SDL_GPUTexture* SpecularTexture;
+static SDL_GPUSampler* LevelSamplers[16];
+static SpecularPrefilter Prefilter;
+
+static CubemapInfo Info;
+static bool ShowPrefiltered = true;
+static int CurrentLevel = 0;
+static float CameraAngle = 0;
+
+static Vector3 CamPos = { 0, 0, 4 };
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Create the shaders
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "Skybox.vert", 0, 1, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "Skybox.frag", 1, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	// Create the pipeline
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.vertex_input_state = (SDL_GPUVertexInputState){
+			.num_vertex_buffers = 1,
+			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+				.slot = 0,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+				.instance_step_rate = 0,
+				.pitch = sizeof(PositionVertex)
+			}},
+			.num_vertex_attributes = 1,
+			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+				.location = 0,
+				.offset = 0
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	};
+
+	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	// Load the faces, with a full mip chain so the prefilter can sample wide lobes cheaply
+	const char* imageNames[] = {
+		"cube0.bmp", "cube1.bmp", "cube2.bmp",
+		"cube3.bmp", "cube4.bmp", "cube5.bmp",
+	};
+
+	BakedTexture = LoadCubemap(context->Device, imageNames, 0, 0, &Info);
+	if (BakedTexture == NULL)
+	{
+		SDL_Log("Could not load cubemap!");
+		return -1;
+	}
+
+	SDL_Log(
+		"Loaded a %ux%u cubemap with %u levels, %u authored (%u bytes staged): %.2f ms decoding, %.2f ms uploading",
+		Info.Size,
+		Info.Size,
+		Info.LevelCount,
+		Info.AuthoredLevelCount,
+		Info.StagingSize,
+		Info.DecodeMilliseconds,
+		Info.UploadMilliseconds
+	);
+
+	SpecularTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
+		.type = SDL_GPU_TEXTURETYPE_CUBE,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.width = Info.Size,
+		.height = Info.Size,
+		.layer_count_or_depth = 6,
+		.num_levels = Info.LevelCount,
+		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
+	});
+
+	if (!SpecularPrefilter_Init(&Prefilter, context->Device))
+	{
+		SDL_Log("Failed to create the specular prefilter!");
+		return -1;
+	}
+
+	// One sampler per level, since the skybox shader samples with implicit LOD
+	for (Uint32 i = 0; i < Info.LevelCount && i < SDL_arraysize(LevelSamplers); i += 1)
+	{
+		LevelSamplers[i] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+			.min_filter = SDL_GPU_FILTER_LINEAR,
+			.mag_filter = SDL_GPU_FILTER_LINEAR,
+			.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+			.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+			.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+			.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+			.min_lod = (float) i,
+			.max_lod = (float) i
+		});
+	}
+
+	// Create the GPU resources
+	VertexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = sizeof(PositionVertex) * 24
+		}
+	);
+
+	IndexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = sizeof(Uint16) * 36
+		}
+	);
+
+	// Set up buffer data
+	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = (sizeof(PositionVertex) * 24) + (sizeof(Uint16) * 36)
+		}
+	);
+
+	PositionVertex* transferData = SDL_MapGPUTransferBuffer(
+		context->Device,
+		bufferTransferBuffer,
+		false
+	);
+
+	transferData[0] = (PositionVertex) { -10, -10, -10 };
+	transferData[1] = (PositionVertex) { 10, -10, -10 };
+	transferData[2] = (PositionVertex) { 10, 10, -10 };
+	transferData[3] = (PositionVertex) { -10, 10, -10 };
+
+	transferData[4] = (PositionVertex) { -10, -10, 10 };
+	transferData[5] = (PositionVertex) { 10, -10, 10 };
+	transferData[6] = (PositionVertex) { 10, 10, 10 };
+	transferData[7] = (PositionVertex) { -10, 10, 10 };
+
+	transferData[8] = (PositionVertex) { -10, -10, -10 };
+	transferData[9] = (PositionVertex) { -10, 10, -10 };
+	transferData[10] = (PositionVertex) { -10, 10, 10 };
+	transferData[11] = (PositionVertex) { -10, -10, 10 };
+
+	transferData[12] = (PositionVertex) { 10, -10, -10 };
+	transferData[13] = (PositionVertex) { 10, 10, -10 };
+	transferData[14] = (PositionVertex) { 10, 10, 10 };
+	transferData[15] = (PositionVertex) { 10, -10, 10 };
+
+	transferData[16] = (PositionVertex) { -10, -10, -10 };
+	transferData[17] = (PositionVertex) { -10, -10, 10 };
+	transferData[18] = (PositionVertex) { 10, -10, 10 };
+	transferData[19] = (PositionVertex) { 10, -10, -10 };
+
+	transferData[20] = (PositionVertex) { -10, 10, -10 };
+	transferData[21] = (PositionVertex) { -10, 10, 10 };
+	transferData[22] = (PositionVertex) { 10, 10, 10 };
+	transferData[23] = (PositionVertex) { 10, 10, -10 };
+
+	Uint16* indexData = (Uint16*) &transferData[24];
+	Uint16 indices[] = {
+		 0,  1,  2,  0,  2,  3,
+		 6,  5,  4,  7,  6,  4,
+		 8,  9, 10,  8, 10, 11,
+		14, 13, 12, 15, 14, 12,
+		16, 17, 18, 16, 18, 19,
+		22, 21, 20, 23, 22, 20
+	};
+	SDL_memcpy(indexData, indices, sizeof(indices));
+
+	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+
+	// Upload the transfer data to the GPU buffers
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = VertexBuffer,
+			.offset = 0,
+			.size = sizeof(PositionVertex) * 24
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = sizeof(PositionVertex) * 24
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = IndexBuffer,
+			.offset = 0,
+			.size = sizeof(Uint16) * 36
+		},
+		false
+	);
+
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+
+	// Prefilter the specular mips
+	Uint64 prefilterStart = SDL_GetPerformanceCounter();
+	SpecularPrefilter_Run(&Prefilter, cmdbuf, BakedTexture, Info.Size, SpecularTexture, Info.Size, Info.LevelCount, SAMPLE_COUNT);
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
+	SDL_WaitForGPUFences(context->Device, true, &fence, 1);
+	SDL_ReleaseGPUFence(context->Device, fence);
+	Uint64 prefilterEnd = SDL_GetPerformanceCounter();
+
+	SDL_Log(
+		"Prefiltered %u specular levels with %d samples per texel in %.2f ms",
+		Info.LevelCount,
+		SAMPLE_COUNT,
+		(double) (prefilterEnd - prefilterStart) * 1000.0 / SDL_GetPerformanceFrequency()
+	);
+
+	// Print the instructions
+	SDL_Log("Press Left/Right to switch between the box-filtered and prefiltered mips");
+	SDL_Log("Press Up/Down to change the displayed mip level");
+
+	SDL_Log("Showing %s level %d", ShowPrefiltered ? "prefiltered" : "box-filtered", CurrentLevel);
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	bool changed = false;
+
+	if (context->LeftPressed || context->RightPressed)
+	{
+		ShowPrefiltered = !ShowPrefiltered;
+		changed = true;
+	}
+
+	if (context->UpPressed && CurrentLevel + 1 < (int) SDL_min(Info.LevelCount, SDL_arraysize(LevelSamplers)))
+	{
+		CurrentLevel += 1;
+		changed = true;
+	}
+
+	if (context->DownPressed && CurrentLevel > 0)
+	{
+		CurrentLevel -= 1;
+		changed = true;
+	}
+
+	if (changed)
+	{
+		SDL_Log(
+			"Showing %s level %d (roughness %.2f)",
+			ShowPrefiltered ? "prefiltered" : "box-filtered",
+			CurrentLevel,
+			Info.LevelCount > 1 ? (float) CurrentLevel / (Info.LevelCount - 1) : 0.0f
+		);
+	}
+
+	CameraAngle += context->DeltaTime * 0.5f;
+	CamPos.x = SDL_sinf(CameraAngle) * 4;
+	CamPos.z = SDL_cosf(CameraAngle) * 4;
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+    if (cmdbuf == NULL)
+    {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GPUTexture* swapchainTexture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        return -1;
+    }
+
+	if (swapchainTexture != NULL)
+	{
+		Matrix4x4 proj = Matrix4x4_CreatePerspectiveFieldOfView(
+			75.0f * SDL_PI_F / 180.0f,
+			640.0f / 480.0f,
+			0.01f,
+			100.0f
+		);
+		Matrix4x4 view = Matrix4x4_CreateLookAt(
+			CamPos,
+			(Vector3) { 0, 0, 0 },
+			(Vector3) { 0, 1, 0 }
+		);
+
+		Matrix4x4 viewproj = Matrix4x4_Multiply(view, proj);
+
+		SDL_GPUColorTargetInfo colorTargetInfo = {
+			.texture = swapchainTexture,
+			.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f },
+			.load_op = SDL_GPU_LOADOP_CLEAR,
+			.store_op = SDL_GPU_STOREOP_STORE
+		};
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+
+		SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ VertexBuffer, 0 }, 1);
+		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ IndexBuffer, 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+		SDL_BindGPUFragmentSamplers(
+			renderPass,
+			0,
+			&(SDL_GPUTextureSamplerBinding){ ShowPrefiltered ? SpecularTexture : BakedTexture, LevelSamplers[CurrentLevel] },
+			1
+		);
+		SDL_PushGPUVertexUniformData(cmdbuf, 0, &viewproj, sizeof(viewproj));
+		SDL_DrawGPUIndexedPrimitives(renderPass, 36, 1, 0, 0, 0);
+
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
+	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUTexture(context->Device, BakedTexture);
+	SDL_ReleaseGPUTexture(context->Device, SpecularTexture);
+	SpecularPrefilter_Destroy(&Prefilter, context->Device);
+
+	for (int i = 0; i < SDL_arraysize(LevelSamplers); i += 1)
+	{
+		if (LevelSamplers[i] != NULL)
+		{
+			SDL_ReleaseGPUSampler(context->Device, LevelSamplers[i]);
+			LevelSamplers[i] = NULL;
+		}
+	}
+
+	ShowPrefiltered = true;
+	CurrentLevel = 0;
+	CameraAngle = 0;
+	SDL_zero(Info);
+	CamPos = (Vector3) { 0, 0, 4 };
+
+	CommonQuit(context);
+}
+
+Example PrefilteredCubemap_Example = { "PrefilteredCubemap", Init, Update, Draw, Quit };
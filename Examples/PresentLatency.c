@@ -0,0 +1,138 @@
+#include "Common.h"
+
+/* Every key press flips the clear color, so the frame that answers it is easy to spot,
+ * and the presenter times how long that frame took to reach the GPU's finish line.
+ * Stacking up overdraw makes the GPU the bottleneck, which is where the policies differ most.
+ */
+#define MAX_LAYER_COUNT 1024
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static FramePresenter Presenter;
+static PresentPolicy Policy = PRESENTPOLICY_LOWEST_LATENCY;
+static Uint32 LayerCount = 16;
+static bool Flipped;
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	Pipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window)
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+	if (Pipeline == NULL)
+	{
+		SDL_Log("Failed to create pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	if (!FramePresenter_Init(&Presenter, context->Device, context->Window, Policy, "PresentLatency.csv"))
+	{
+		return -1;
+	}
+
+	SDL_Log("Press Left/Right to halve/double the overdraw");
+	SDL_Log("Press Up to switch present policy");
+	SDL_Log("Any of them flips the clear color, and is timed from press to present");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	if (context->InputTimestampNS != 0)
+	{
+		Flipped = !Flipped;
+	}
+
+	if (context->LeftPressed && LayerCount > 1)
+	{
+		LayerCount /= 2;
+		SDL_Log("%u layers of overdraw", LayerCount);
+	}
+
+	if (context->RightPressed && LayerCount < MAX_LAYER_COUNT)
+	{
+		LayerCount *= 2;
+		SDL_Log("%u layers of overdraw", LayerCount);
+	}
+
+	if (context->UpPressed)
+	{
+		Policy = (Policy + 1) % PRESENTPOLICY_COUNT;
+		FramePresenter_SetPolicy(&Presenter, Policy);
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	SDL_GPUTexture* swapchainTexture;
+	SDL_GPUCommandBuffer* cmdbuf = FramePresenter_Acquire(&Presenter, context->InputTimestampNS, &swapchainTexture);
+	if (cmdbuf == NULL)
+	{
+		return -1;
+	}
+
+	if (swapchainTexture != NULL)
+	{
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(
+			cmdbuf,
+			&(SDL_GPUColorTargetInfo){
+				.texture = swapchainTexture,
+				.clear_color = Flipped ? (SDL_FColor){ 0.8f, 0.3f, 0.1f, 1.0f } : (SDL_FColor){ 0.1f, 0.3f, 0.8f, 1.0f },
+				.load_op = SDL_GPU_LOADOP_CLEAR,
+				.store_op = SDL_GPU_STOREOP_STORE
+			},
+			1,
+			NULL
+		);
+		SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+		SDL_DrawGPUPrimitives(renderPass, 3, LayerCount, 0, 0);
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	return FramePresenter_Submit(&Presenter, cmdbuf) ? 0 : -1;
+}
+
+static void Quit(Context* context)
+{
+	// The pipeline belongs to the state cache, which CommonQuit releases
+	FramePresenter_Destroy(&Presenter);
+	Policy = PRESENTPOLICY_LOWEST_LATENCY;
+	LayerCount = 16;
+	Flipped = false;
+
+	CommonQuit(context);
+}
+
+Example PresentLatency_Example = { "PresentLatency", Init, Update, Draw, Quit };
@@ -0,0 +1,359 @@
+#include "Common.h"
+
+#define FRAME_PRESENTER_REPORT_INTERVAL_NS SDL_NS_PER_SECOND
+
+static const char* PresentPolicyNames[PRESENTPOLICY_COUNT] =
+{
+	"LowestLatency",
+	"LowestPower",
+	"TearFree"
+};
+
+/* In order of preference. VSYNC is always supported, so every list ends with it. */
+static const SDL_GPUPresentMode PresentPolicyModes[PRESENTPOLICY_COUNT][3] =
+{
+	{ SDL_GPU_PRESENTMODE_IMMEDIATE, SDL_GPU_PRESENTMODE_MAILBOX, SDL_GPU_PRESENTMODE_VSYNC },
+	{ SDL_GPU_PRESENTMODE_VSYNC, SDL_GPU_PRESENTMODE_VSYNC, SDL_GPU_PRESENTMODE_VSYNC },
+	{ SDL_GPU_PRESENTMODE_MAILBOX, SDL_GPU_PRESENTMODE_VSYNC, SDL_GPU_PRESENTMODE_VSYNC }
+};
+
+/* One frame in flight means the next frame's input is polled only once the GPU is done,
+ * the shortest path from input to screen. Lowest power lets VSYNC cap the frame rate and
+ * keeps two frames in flight so the CPU and GPU overlap instead of each racing to finish.
+ * Tear-free queues the most, so a slow frame doesn't miss a refresh.
+ */
+static const Uint32 PresentPolicyFramesInFlight[PRESENTPOLICY_COUNT] = { 1, 2, 3 };
+
+const char* GetPresentPolicyName(PresentPolicy policy)
+{
+	return policy < PRESENTPOLICY_COUNT ? PresentPolicyNames[policy] : "Unknown";
+}
+
+const char* GetPresentModeName(SDL_GPUPresentMode presentMode)
+{
+	switch (presentMode)
+	{
+		case SDL_GPU_PRESENTMODE_VSYNC: return "VSYNC";
+		case SDL_GPU_PRESENTMODE_IMMEDIATE: return "IMMEDIATE";
+		case SDL_GPU_PRESENTMODE_MAILBOX: return "MAILBOX";
+		default: return "Unknown";
+	}
+}
+
+SDL_GPUPresentMode ApplyPresentPolicy(SDL_GPUDevice* device, SDL_Window* window, PresentPolicy policy)
+{
+	SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
+	for (Uint32 i = 0; i < SDL_arraysize(PresentPolicyModes[policy]); i += 1)
+	{
+		if (SDL_WindowSupportsGPUPresentMode(device, window, PresentPolicyModes[policy][i]))
+		{
+			presentMode = PresentPolicyModes[policy][i];
+			break;
+		}
+	}
+
+	if (!SDL_SetGPUSwapchainParameters(device, window, SDL_GPU_SWAPCHAINCOMPOSITION_SDR, presentMode))
+	{
+		SDL_Log("SetGPUSwapchainParameters failed: %s", SDL_GetError());
+		return SDL_GPU_PRESENTMODE_VSYNC;
+	}
+
+	return presentMode;
+}
+
+static void WriteFrame(FramePresenter* presenter, const PresentedFrame* frame, Uint64 gpuNS)
+{
+	SDL_IOprintf(
+		presenter->CSV,
+		"%llu,%s,%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f,",
+		(unsigned long long) frame->Index,
+		GetPresentPolicyName(frame->Policy),
+		GetPresentModeName(frame->PresentMode),
+		frame->FramesInFlight,
+		frame->FrameNS / 1e6,
+		frame->ThrottleNS / 1e6,
+		frame->AcquireWaitNS / 1e6,
+		(frame->SubmitNS - frame->AcquireNS) / 1e6,
+		gpuNS / 1e6
+	);
+
+	/* Frames without input leave the latency column empty */
+	if (frame->InputNS != 0)
+	{
+		SDL_IOprintf(presenter->CSV, "%.3f\n", (frame->CompleteNS - frame->InputNS) / 1e6);
+	}
+	else
+	{
+		SDL_IOprintf(presenter->CSV, "\n");
+	}
+}
+
+/* Runs on the profiler's watcher thread as each frame finishes, in submission order, so the
+ * oldest frame in flight is always the one that finished
+ */
+static void OnFrameComplete(void* userdata, const GPUPassRecord* record)
+{
+	FramePresenter* presenter = userdata;
+
+	SDL_LockMutex(presenter->Lock);
+	PresentedFrame frame = presenter->InFlight[presenter->InFlightRead];
+	SDL_UnlockMutex(presenter->Lock);
+
+	/* Only this thread touches the file */
+	frame.CompleteNS = record->CompleteNS;
+	Uint64 gpuNS = record->CompleteNS - record->StartNS;
+	if (presenter->CSV != NULL)
+	{
+		WriteFrame(presenter, &frame, gpuNS);
+	}
+
+	SDL_LockMutex(presenter->Lock);
+	PresentStats* stats = &presenter->Stats;
+	stats->FrameCount += 1;
+	stats->FrameNS += frame.FrameNS;
+	stats->ThrottleNS += frame.ThrottleNS;
+	stats->AcquireWaitNS += frame.AcquireWaitNS;
+	stats->GPUNS += gpuNS;
+	if (frame.InputNS != 0)
+	{
+		Uint64 latencyNS = frame.CompleteNS - frame.InputNS;
+		stats->InputCount += 1;
+		stats->LatencyNS += latencyNS;
+		stats->MaxLatencyNS = SDL_max(stats->MaxLatencyNS, latencyNS);
+	}
+
+	presenter->InFlightRead = (presenter->InFlightRead + 1) % FRAME_PRESENTER_MAX_FRAMES_IN_FLIGHT;
+	presenter->InFlightCount -= 1;
+	SDL_BroadcastCondition(presenter->Signal);
+	SDL_UnlockMutex(presenter->Lock);
+}
+
+bool FramePresenter_Init(
+	FramePresenter* presenter,
+	SDL_GPUDevice* device,
+	SDL_Window* window,
+	PresentPolicy policy,
+	const char* csvFilename
+) {
+	SDL_zerop(presenter);
+	presenter->Device = device;
+	presenter->Window = window;
+	SDL_strlcpy(presenter->Title, SDL_GetWindowTitle(window), sizeof(presenter->Title));
+	presenter->LastReportNS = SDL_GetTicksNS();
+
+	presenter->Lock = SDL_CreateMutex();
+	presenter->Signal = SDL_CreateCondition();
+	if (presenter->Lock == NULL || presenter->Signal == NULL)
+	{
+		SDL_Log("Failed to create the frame queue: %s", SDL_GetError());
+		return false;
+	}
+
+	if (!GPUProfiler_Init(&presenter->Profiler, device, NULL))
+	{
+		return false;
+	}
+
+	if (csvFilename != NULL)
+	{
+		char path[1024];
+		char* prefPath = SDL_GetPrefPath("SDL", "SDL_gpu_examples");
+		SDL_snprintf(path, sizeof(path), "%s%s", prefPath ? prefPath : "", csvFilename);
+		SDL_free(prefPath);
+
+		presenter->CSV = SDL_IOFromFile(path, "w");
+		if (presenter->CSV == NULL)
+		{
+			SDL_Log("Couldn't open %s, frames won't be recorded: %s", path, SDL_GetError());
+		}
+		else
+		{
+			SDL_IOprintf(
+				presenter->CSV,
+				"frame,policy,present_mode,frames_in_flight,frame_ms,throttle_ms,acquire_wait_ms,record_ms,gpu_ms,input_latency_ms\n"
+			);
+			SDL_Log("Recording frames to %s", path);
+		}
+	}
+
+	FramePresenter_SetPolicy(presenter, policy);
+	return true;
+}
+
+void FramePresenter_SetPolicy(FramePresenter* presenter, PresentPolicy policy)
+{
+	presenter->Policy = policy;
+	presenter->PresentMode = ApplyPresentPolicy(presenter->Device, presenter->Window, policy);
+
+	/* Frames already in flight are left to finish; Submit waits for the new limit */
+	SDL_LockMutex(presenter->Lock);
+	presenter->FramesInFlight = PresentPolicyFramesInFlight[policy];
+	SDL_UnlockMutex(presenter->Lock);
+
+	SDL_Log(
+		"Present policy %s: %s with %u frame(s) in flight",
+		GetPresentPolicyName(policy),
+		GetPresentModeName(presenter->PresentMode),
+		presenter->FramesInFlight
+	);
+}
+
+static void ReportStats(FramePresenter* presenter)
+{
+	SDL_LockMutex(presenter->Lock);
+	PresentStats stats = presenter->Stats;
+	SDL_zero(presenter->Stats);
+	SDL_UnlockMutex(presenter->Lock);
+
+	if (stats.FrameCount == 0)
+	{
+		return;
+	}
+
+	double frameMs = stats.FrameNS / 1e6 / stats.FrameCount;
+	double throttleMs = stats.ThrottleNS / 1e6 / stats.FrameCount;
+	double acquireMs = stats.AcquireWaitNS / 1e6 / stats.FrameCount;
+	double gpuMs = stats.GPUNS / 1e6 / stats.FrameCount;
+
+	char latency[64];
+	if (stats.InputCount > 0)
+	{
+		SDL_snprintf(
+			latency,
+			sizeof(latency),
+			"%.2f ms (max %.2f ms)",
+			stats.LatencyNS / 1e6 / stats.InputCount,
+			stats.MaxLatencyNS / 1e6
+		);
+	}
+	else
+	{
+		SDL_strlcpy(latency, "no input", sizeof(latency));
+	}
+
+	SDL_Log(
+		"%s, %s, %u in flight: frame %.3f ms, frame wait %.3f ms, acquire wait %.3f ms, GPU %.3f ms, input to present %s",
+		GetPresentPolicyName(presenter->Policy),
+		GetPresentModeName(presenter->PresentMode),
+		presenter->FramesInFlight,
+		frameMs,
+		throttleMs,
+		acquireMs,
+		gpuMs,
+		latency
+	);
+
+	/* The examples have no text rendering, so the title bar is the on-screen readout */
+	char title[256];
+	SDL_snprintf(
+		title,
+		sizeof(title),
+		"%s | %s %s x%u | %.1f fps | acquire %.2f ms | input %s",
+		presenter->Title,
+		GetPresentPolicyName(presenter->Policy),
+		GetPresentModeName(presenter->PresentMode),
+		presenter->FramesInFlight,
+		frameMs > 0 ? 1000.0 / frameMs : 0.0,
+		acquireMs,
+		latency
+	);
+	SDL_SetWindowTitle(presenter->Window, title);
+}
+
+SDL_GPUCommandBuffer* FramePresenter_Acquire(FramePresenter* presenter, Uint64 inputTimestampNS, SDL_GPUTexture** pSwapchainTexture)
+{
+	*pSwapchainTexture = NULL;
+
+	Uint64 now = SDL_GetTicksNS();
+	if (now - presenter->LastReportNS >= FRAME_PRESENTER_REPORT_INTERVAL_NS)
+	{
+		ReportStats(presenter);
+		presenter->LastReportNS = now;
+	}
+
+	PresentedFrame* frame = &presenter->Current;
+	SDL_zerop(frame);
+	frame->Index = presenter->FrameIndex;
+	frame->Policy = presenter->Policy;
+	frame->PresentMode = presenter->PresentMode;
+	frame->FramesInFlight = presenter->FramesInFlight;
+	frame->InputNS = inputTimestampNS;
+	frame->FrameNS = presenter->LastAcquireNS != 0 ? now - presenter->LastAcquireNS : 0;
+	frame->ThrottleNS = presenter->LastThrottleNS;
+	presenter->LastAcquireNS = now;
+
+	SDL_GPUCommandBuffer* commandBuffer = SDL_AcquireGPUCommandBuffer(presenter->Device);
+	if (commandBuffer == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return NULL;
+	}
+
+	Uint64 acquireStart = SDL_GetTicksNS();
+	if (!SDL_AcquireGPUSwapchainTexture(commandBuffer, presenter->Window, pSwapchainTexture))
+	{
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		SDL_CancelGPUCommandBuffer(commandBuffer);
+		return NULL;
+	}
+	frame->AcquireNS = SDL_GetTicksNS();
+	frame->AcquireWaitNS = frame->AcquireNS - acquireStart;
+
+	return commandBuffer;
+}
+
+bool FramePresenter_Submit(FramePresenter* presenter, SDL_GPUCommandBuffer* commandBuffer)
+{
+	PresentedFrame* frame = &presenter->Current;
+	frame->SubmitNS = SDL_GetTicksNS();
+	SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer);
+	if (fence == NULL)
+	{
+		SDL_Log("SubmitGPUCommandBufferAndAcquireFence failed: %s", SDL_GetError());
+		return false;
+	}
+	presenter->FrameIndex += 1;
+
+	/* Queued before the fence is tracked, so it's there when OnFrameComplete runs */
+	SDL_LockMutex(presenter->Lock);
+	Uint32 write = (presenter->InFlightRead + presenter->InFlightCount) % FRAME_PRESENTER_MAX_FRAMES_IN_FLIGHT;
+	presenter->InFlight[write] = *frame;
+	presenter->InFlightCount += 1;
+	SDL_UnlockMutex(presenter->Lock);
+
+	GPUProfiler_TrackFence(&presenter->Profiler, "Frame", fence, OnFrameComplete, presenter);
+
+	SDL_LockMutex(presenter->Lock);
+
+	/* Waiting here rather than in Acquire lets the main loop poll input after the wait,
+	 * so the next frame starts from the freshest input
+	 */
+	Uint64 throttleStart = SDL_GetTicksNS();
+	while (presenter->InFlightCount >= presenter->FramesInFlight)
+	{
+		SDL_WaitCondition(presenter->Signal, presenter->Lock);
+	}
+	SDL_UnlockMutex(presenter->Lock);
+	presenter->LastThrottleNS = SDL_GetTicksNS() - throttleStart;
+
+	return true;
+}
+
+void FramePresenter_Destroy(FramePresenter* presenter)
+{
+	/* The profiler's watcher drains the frames still in flight, through OnFrameComplete, before it exits */
+	GPUProfiler_Destroy(&presenter->Profiler);
+	SDL_DestroyCondition(presenter->Signal);
+	SDL_DestroyMutex(presenter->Lock);
+
+	if (presenter->CSV != NULL)
+	{
+		SDL_CloseIO(presenter->CSV);
+	}
+	if (presenter->Window != NULL && presenter->Title[0] != '\0')
+	{
+		SDL_SetWindowTitle(presenter->Window, presenter->Title);
+	}
+
+	SDL_zerop(presenter);
+}
@@ -0,0 +1,889 @@
+#include "Common.h"
+
+static const char* PassTypeNames[] = { "render", "compute", "blit" };
+
+void RenderGraph_Reset(RenderGraph* graph)
+{
+	SDL_zerop(graph);
+}
+
+static Uint32 AddResource(RenderGraph* graph, const char* name, const RenderTargetDescription* description, bool imported)
+{
+	if (graph->ResourceCount == RENDER_GRAPH_MAX_RESOURCES)
+	{
+		SDL_Log("RenderGraph: at most %d resources are supported", RENDER_GRAPH_MAX_RESOURCES);
+		graph->Invalid = true;
+		return RENDER_GRAPH_INVALID;
+	}
+
+	RenderGraphResource* resource = &graph->Resources[graph->ResourceCount];
+	SDL_zerop(resource);
+	resource->Name = name;
+	resource->Description = *description;
+	resource->Imported = imported;
+	resource->FirstUse = RENDER_GRAPH_INVALID;
+	resource->LastUse = RENDER_GRAPH_INVALID;
+	resource->PhysicalIndex = RENDER_GRAPH_INVALID;
+
+	graph->Compiled = false;
+	graph->ResourceCount += 1;
+	return graph->ResourceCount - 1;
+}
+
+Uint32 RenderGraph_CreateTexture(RenderGraph* graph, const char* name, const RenderTargetDescription* description)
+{
+	return AddResource(graph, name, description, false);
+}
+
+Uint32 RenderGraph_ImportTexture(RenderGraph* graph, const char* name, const RenderTargetDescription* description)
+{
+	return AddResource(graph, name, description, true);
+}
+
+void RenderGraph_SetTexture(RenderGraph* graph, Uint32 resource, SDL_GPUTexture* texture)
+{
+	if (resource >= graph->ResourceCount || !graph->Resources[resource].Imported)
+	{
+		SDL_Log("RenderGraph: only imported textures can be set");
+		return;
+	}
+
+	graph->Resources[resource].Texture = texture;
+}
+
+Uint32 RenderGraph_AddPass(RenderGraph* graph, const char* name, RenderGraphPassType type, RenderGraphPassFunction function, void* userdata)
+{
+	if (graph->PassCount == RENDER_GRAPH_MAX_PASSES)
+	{
+		SDL_Log("RenderGraph: at most %d passes are supported", RENDER_GRAPH_MAX_PASSES);
+		graph->Invalid = true;
+		return RENDER_GRAPH_INVALID;
+	}
+
+	RenderGraphPass* pass = &graph->Passes[graph->PassCount];
+	SDL_zerop(pass);
+	pass->Name = name;
+	pass->Type = type;
+	pass->Function = function;
+	pass->Userdata = userdata;
+
+	graph->Compiled = false;
+	graph->PassCount += 1;
+	return graph->PassCount - 1;
+}
+
+static RenderGraphAccess* AddAccess(RenderGraph* graph, Uint32 pass, Uint32 resource)
+{
+	if (pass >= graph->PassCount || resource >= graph->ResourceCount)
+	{
+		SDL_Log("RenderGraph: access to an invalid pass or resource");
+		graph->Invalid = true;
+		return NULL;
+	}
+
+	RenderGraphPass* graphPass = &graph->Passes[pass];
+	if (graphPass->AccessCount == RENDER_GRAPH_MAX_ACCESSES)
+	{
+		SDL_Log("RenderGraph: %s has more than %d accesses", graphPass->Name, RENDER_GRAPH_MAX_ACCESSES);
+		graph->Invalid = true;
+		return NULL;
+	}
+
+	RenderGraphAccess* access = &graphPass->Accesses[graphPass->AccessCount];
+	SDL_zerop(access);
+	access->Resource = resource;
+	access->ResolveFrom = RENDER_GRAPH_INVALID;
+
+	graph->Compiled = false;
+	graphPass->AccessCount += 1;
+	return access;
+}
+
+void RenderGraph_Read(RenderGraph* graph, Uint32 pass, Uint32 resource, SDL_GPUTextureUsageFlags usage)
+{
+	RenderGraphAccess* access = AddAccess(graph, pass, resource);
+	if (access != NULL)
+	{
+		access->Usage = usage != 0 ? usage : SDL_GPU_TEXTUREUSAGE_SAMPLER;
+	}
+}
+
+void RenderGraph_Write(RenderGraph* graph, Uint32 pass, Uint32 resource)
+{
+	RenderGraphAccess* access = AddAccess(graph, pass, resource);
+	if (access != NULL)
+	{
+		access->Write = true;
+		access->Usage = graph->Passes[pass].Type == RENDERGRAPH_PASS_COMPUTE ?
+			SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE :
+			SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+	}
+}
+
+void RenderGraph_Clear(RenderGraph* graph, Uint32 pass, Uint32 resource, SDL_FColor color)
+{
+	RenderGraphAccess* access = AddAccess(graph, pass, resource);
+	if (access != NULL)
+	{
+		access->Write = true;
+		access->Clear = true;
+		access->ClearColor = color;
+		access->Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+	}
+}
+
+void RenderGraph_Resolve(RenderGraph* graph, Uint32 pass, Uint32 source, Uint32 destination)
+{
+	RenderGraphAccess* access = AddAccess(graph, pass, destination);
+	if (access != NULL)
+	{
+		access->Write = true;
+		access->ResolveFrom = source;
+		access->Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+	}
+}
+
+static bool IsColorTarget(const RenderGraphPass* pass, const RenderGraphAccess* access)
+{
+	return pass->Type == RENDERGRAPH_PASS_RENDER && access->Write && access->ResolveFrom == RENDER_GRAPH_INVALID;
+}
+
+/* A write that replaces every pixel, so whatever was there before doesn't matter */
+static bool Overwrites(const RenderGraphPass* pass, const RenderGraphAccess* access)
+{
+	return
+		access->Clear ||
+		access->ResolveFrom != RENDER_GRAPH_INVALID ||
+		(pass->Type == RENDERGRAPH_PASS_BLIT && pass->Function == NULL);
+}
+
+static Uint32 GetColorTargets(const RenderGraphPass* pass, const RenderGraphAccess** targets)
+{
+	Uint32 count = 0;
+	for (Uint32 i = 0; i < pass->AccessCount; i += 1)
+	{
+		if (IsColorTarget(pass, &pass->Accesses[i]) && count < RENDER_GRAPH_MAX_COLOR_TARGETS)
+		{
+			targets[count] = &pass->Accesses[i];
+			count += 1;
+		}
+	}
+
+	return count;
+}
+
+static bool ValidatePass(RenderGraph* graph, const RenderGraphPass* pass)
+{
+	Uint32 readCount = 0;
+	Uint32 writeCount = 0;
+	Uint32 colorTargetCount = 0;
+	const RenderTargetDescription* first = NULL;
+	const RenderTargetDescription* firstColorTarget = NULL;
+
+	for (Uint32 i = 0; i < pass->AccessCount; i += 1)
+	{
+		const RenderGraphAccess* access = &pass->Accesses[i];
+		const RenderTargetDescription* description = &graph->Resources[access->Resource].Description;
+
+		if (!access->Write)
+		{
+			readCount += 1;
+			for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+			{
+				if (pass->Accesses[j].Write && pass->Accesses[j].Resource == access->Resource)
+				{
+					SDL_Log("RenderGraph: %s reads %s while writing it", pass->Name, graph->Resources[access->Resource].Name);
+					return false;
+				}
+			}
+			continue;
+		}
+
+		writeCount += 1;
+		if (access->ResolveFrom != RENDER_GRAPH_INVALID)
+		{
+			bool found = false;
+			for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+			{
+				if (IsColorTarget(pass, &pass->Accesses[j]) && pass->Accesses[j].Resource == access->ResolveFrom)
+				{
+					found = true;
+				}
+			}
+
+			if (pass->Type != RENDERGRAPH_PASS_RENDER || !found ||
+				graph->Resources[access->ResolveFrom].Description.SampleCount == SDL_GPU_SAMPLECOUNT_1 ||
+				description->SampleCount != SDL_GPU_SAMPLECOUNT_1)
+			{
+				SDL_Log("RenderGraph: %s must resolve a multisampled color target it writes into a single sampled texture", pass->Name);
+				return false;
+			}
+		}
+
+		if (pass->Type == RENDERGRAPH_PASS_RENDER)
+		{
+			if (IsColorTarget(pass, access))
+			{
+				colorTargetCount += 1;
+				if (firstColorTarget == NULL)
+				{
+					firstColorTarget = description;
+				}
+				else if (description->SampleCount != firstColorTarget->SampleCount)
+				{
+					SDL_Log("RenderGraph: the color targets of %s differ in sample count", pass->Name);
+					return false;
+				}
+			}
+
+			if (first == NULL)
+			{
+				first = description;
+			}
+			else if (description->Width != first->Width || description->Height != first->Height)
+			{
+				SDL_Log("RenderGraph: the targets of %s differ in size", pass->Name);
+				return false;
+			}
+		}
+		else if (description->SampleCount != SDL_GPU_SAMPLECOUNT_1)
+		{
+			SDL_Log("RenderGraph: %s can't write multisampled %s", pass->Name, graph->Resources[access->Resource].Name);
+			return false;
+		}
+
+		if (access->Clear && pass->Type != RENDERGRAPH_PASS_RENDER)
+		{
+			SDL_Log("RenderGraph: only render passes can clear, not %s", pass->Name);
+			return false;
+		}
+	}
+
+	if (pass->Type == RENDERGRAPH_PASS_RENDER && (colorTargetCount == 0 || colorTargetCount > RENDER_GRAPH_MAX_COLOR_TARGETS))
+	{
+		SDL_Log("RenderGraph: %s must write between 1 and %d color targets", pass->Name, RENDER_GRAPH_MAX_COLOR_TARGETS);
+		return false;
+	}
+
+	if (pass->Type == RENDERGRAPH_PASS_BLIT && pass->Function == NULL && (readCount != 1 || writeCount != 1))
+	{
+		SDL_Log("RenderGraph: %s needs exactly one read and one write to blit without a function", pass->Name);
+		return false;
+	}
+
+	return true;
+}
+
+/* Declaration order defines the hazards: reading after a write, and writing after a read
+ * or a write. Producers only keeps the edges along which content flows.
+ */
+static void FindDependencies(RenderGraph* graph)
+{
+	Uint32 lastWriter[RENDER_GRAPH_MAX_RESOURCES];
+	Uint32 readers[RENDER_GRAPH_MAX_RESOURCES];
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		lastWriter[i] = RENDER_GRAPH_INVALID;
+		readers[i] = 0;
+	}
+
+	for (Uint32 i = 0; i < graph->PassCount; i += 1)
+	{
+		RenderGraphPass* pass = &graph->Passes[i];
+		pass->Dependencies = 0;
+		pass->Producers = 0;
+
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			Uint32 writer = lastWriter[access->Resource];
+
+			if (writer != RENDER_GRAPH_INVALID && writer != i)
+			{
+				pass->Dependencies |= 1u << writer;
+				if (!access->Write || !Overwrites(pass, access))
+				{
+					pass->Producers |= 1u << writer;
+				}
+			}
+			if (access->Write)
+			{
+				pass->Dependencies |= readers[access->Resource] & ~(1u << i);
+			}
+		}
+
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			if (access->Write)
+			{
+				lastWriter[access->Resource] = i;
+				readers[access->Resource] = 0;
+			}
+			else
+			{
+				readers[access->Resource] |= 1u << i;
+			}
+		}
+	}
+}
+
+/* Keep every pass that writes an imported texture, and whatever feeds those */
+static Uint32 CullPasses(RenderGraph* graph)
+{
+	Uint32 needed = 0;
+	for (Uint32 i = 0; i < graph->PassCount; i += 1)
+	{
+		const RenderGraphPass* pass = &graph->Passes[i];
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			if (pass->Accesses[j].Write && graph->Resources[pass->Accesses[j].Resource].Imported)
+			{
+				needed |= 1u << i;
+			}
+		}
+	}
+
+	/* Producers always come first, so one sweep backwards reaches all of them */
+	for (Uint32 i = graph->PassCount; i > 0; i -= 1)
+	{
+		if (needed & (1u << (i - 1)))
+		{
+			needed |= graph->Passes[i - 1].Producers;
+		}
+	}
+
+	for (Uint32 i = 0; i < graph->PassCount; i += 1)
+	{
+		graph->Passes[i].Culled = !(needed & (1u << i));
+	}
+
+	return needed;
+}
+
+/* b can continue the SDL render pass a began: same color targets, nothing to clear,
+ * no resolve ending a, and no sampling of what is being rendered to
+ */
+static bool CanMerge(const RenderGraph* graph, Uint32 a, Uint32 b)
+{
+	const RenderGraphPass* passA = &graph->Passes[a];
+	const RenderGraphPass* passB = &graph->Passes[b];
+	if (passA->Type != RENDERGRAPH_PASS_RENDER || passB->Type != RENDERGRAPH_PASS_RENDER)
+	{
+		return false;
+	}
+
+	const RenderGraphAccess* targetsA[RENDER_GRAPH_MAX_COLOR_TARGETS];
+	const RenderGraphAccess* targetsB[RENDER_GRAPH_MAX_COLOR_TARGETS];
+	Uint32 countA = GetColorTargets(passA, targetsA);
+	Uint32 countB = GetColorTargets(passB, targetsB);
+	if (countA != countB)
+	{
+		return false;
+	}
+
+	for (Uint32 i = 0; i < countA; i += 1)
+	{
+		if (targetsA[i]->Resource != targetsB[i]->Resource || targetsB[i]->Clear)
+		{
+			return false;
+		}
+	}
+
+	for (Uint32 i = 0; i < passA->AccessCount; i += 1)
+	{
+		if (passA->Accesses[i].ResolveFrom != RENDER_GRAPH_INVALID)
+		{
+			return false;
+		}
+	}
+
+	for (Uint32 i = 0; i < passB->AccessCount; i += 1)
+	{
+		for (Uint32 j = 0; j < countA; j += 1)
+		{
+			if (!passB->Accesses[i].Write && passB->Accesses[i].Resource == targetsA[j]->Resource)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* Any ready pass may go next. One that merges with the last pass is best, since that
+ * saves a pass break, and otherwise the earliest declared keeps the order predictable.
+ */
+static void SchedulePasses(RenderGraph* graph, Uint32 needed)
+{
+	Uint32 scheduled = 0;
+	Uint32 last = RENDER_GRAPH_INVALID;
+
+	graph->OrderCount = 0;
+	graph->SDLPassCount = 0;
+
+	while (scheduled != needed)
+	{
+		Uint32 choice = RENDER_GRAPH_INVALID;
+		bool merge = false;
+		for (Uint32 i = 0; i < graph->PassCount; i += 1)
+		{
+			Uint32 bit = 1u << i;
+			if (!(needed & bit) || (scheduled & bit) || (graph->Passes[i].Dependencies & needed & ~scheduled))
+			{
+				continue;
+			}
+
+			if (last != RENDER_GRAPH_INVALID && CanMerge(graph, last, i))
+			{
+				choice = i;
+				merge = true;
+				break;
+			}
+			if (choice == RENDER_GRAPH_INVALID)
+			{
+				choice = i;
+			}
+		}
+
+		graph->Passes[choice].MergedWithPrevious = merge;
+		if (!merge)
+		{
+			graph->SDLPassCount += 1;
+		}
+
+		graph->Order[graph->OrderCount] = choice;
+		graph->OrderCount += 1;
+		scheduled |= 1u << choice;
+		last = choice;
+	}
+}
+
+/* Whether anything scheduled after position needs what resource holds */
+static bool NeededAfter(const RenderGraph* graph, Uint32 resource, Uint32 position)
+{
+	if (graph->Resources[resource].Imported)
+	{
+		return true;
+	}
+
+	for (Uint32 i = position + 1; i < graph->OrderCount; i += 1)
+	{
+		const RenderGraphPass* pass = &graph->Passes[graph->Order[i]];
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			const RenderGraphAccess* access = &pass->Accesses[j];
+			if (access->Resource != resource)
+			{
+				continue;
+			}
+
+			if (!access->Write || !Overwrites(pass, access))
+			{
+				return true;
+			}
+
+			/* Overwritten before anyone looks */
+			return false;
+		}
+	}
+
+	return false;
+}
+
+static void ChooseLoadStoreOps(RenderGraph* graph)
+{
+	for (Uint32 i = 0; i < graph->OrderCount; i += 1)
+	{
+		RenderGraphPass* pass = &graph->Passes[graph->Order[i]];
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			RenderGraphAccess* access = &pass->Accesses[j];
+			if (!IsColorTarget(pass, access))
+			{
+				continue;
+			}
+
+			const RenderGraphResource* resource = &graph->Resources[access->Resource];
+			if (access->Clear)
+			{
+				access->LoadOp = SDL_GPU_LOADOP_CLEAR;
+			}
+			else if (resource->Imported || resource->FirstUse < i)
+			{
+				access->LoadOp = SDL_GPU_LOADOP_LOAD;
+			}
+			else
+			{
+				access->LoadOp = SDL_GPU_LOADOP_DONT_CARE;
+			}
+
+			bool store = NeededAfter(graph, access->Resource, i);
+			bool resolve = false;
+			for (Uint32 k = 0; k < pass->AccessCount; k += 1)
+			{
+				if (pass->Accesses[k].ResolveFrom == access->Resource)
+				{
+					resolve = true;
+				}
+			}
+
+			if (resolve)
+			{
+				access->StoreOp = store ? SDL_GPU_STOREOP_RESOLVE_AND_STORE : SDL_GPU_STOREOP_RESOLVE;
+			}
+			else
+			{
+				access->StoreOp = store ? SDL_GPU_STOREOP_STORE : SDL_GPU_STOREOP_DONT_CARE;
+			}
+		}
+	}
+}
+
+static void FindLifetimes(RenderGraph* graph)
+{
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		graph->Resources[i].FirstUse = RENDER_GRAPH_INVALID;
+		graph->Resources[i].LastUse = RENDER_GRAPH_INVALID;
+		graph->Resources[i].PhysicalIndex = RENDER_GRAPH_INVALID;
+	}
+
+	for (Uint32 i = 0; i < graph->OrderCount; i += 1)
+	{
+		const RenderGraphPass* pass = &graph->Passes[graph->Order[i]];
+		for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+		{
+			RenderGraphResource* resource = &graph->Resources[pass->Accesses[j].Resource];
+			if (resource->FirstUse == RENDER_GRAPH_INVALID)
+			{
+				resource->FirstUse = i;
+				if (!resource->Imported && !pass->Accesses[j].Write)
+				{
+					SDL_Log("RenderGraph: %s reads %s before anything writes it", pass->Name, resource->Name);
+				}
+			}
+			resource->LastUse = i;
+			resource->Description.Usage |= pass->Accesses[j].Usage;
+		}
+	}
+}
+
+/* Transients are handed a texture in order of first use, taking one that is free again
+ * when its description matches, so textures with disjoint lifetimes alias
+ */
+static void AssignPhysicalTextures(RenderGraph* graph)
+{
+	graph->PhysicalCount = 0;
+
+	for (Uint32 position = 0; position < graph->OrderCount; position += 1)
+	{
+		for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+		{
+			RenderGraphResource* resource = &graph->Resources[i];
+			if (resource->Imported || resource->FirstUse != position)
+			{
+				continue;
+			}
+
+			const RenderTargetDescription* description = &resource->Description;
+			RenderGraphPhysicalTexture* physical = NULL;
+			for (Uint32 j = 0; j < graph->PhysicalCount; j += 1)
+			{
+				RenderTargetDescription* candidate = &graph->Physical[j].Description;
+				if (graph->Physical[j].LastUse < position &&
+					candidate->Format == description->Format &&
+					candidate->Width == description->Width &&
+					candidate->Height == description->Height &&
+					candidate->SampleCount == description->SampleCount)
+				{
+					physical = &graph->Physical[j];
+					resource->PhysicalIndex = j;
+					break;
+				}
+			}
+
+			if (physical == NULL)
+			{
+				physical = &graph->Physical[graph->PhysicalCount];
+				SDL_zerop(physical);
+				physical->Description = *description;
+				physical->Description.Usage = 0;
+				resource->PhysicalIndex = graph->PhysicalCount;
+				graph->PhysicalCount += 1;
+			}
+
+			physical->Description.Usage |= description->Usage;
+			physical->LastUse = resource->LastUse;
+		}
+	}
+}
+
+bool RenderGraph_Compile(RenderGraph* graph)
+{
+	graph->Compiled = false;
+
+	if (graph->Invalid)
+	{
+		SDL_Log("RenderGraph: not compiling a graph that had errors while it was built");
+		return false;
+	}
+
+	for (Uint32 i = 0; i < graph->PassCount; i += 1)
+	{
+		if (!ValidatePass(graph, &graph->Passes[i]))
+		{
+			return false;
+		}
+	}
+
+	FindDependencies(graph);
+	Uint32 needed = CullPasses(graph);
+	SchedulePasses(graph, needed);
+	FindLifetimes(graph);
+	ChooseLoadStoreOps(graph);
+	AssignPhysicalTextures(graph);
+
+	graph->Compiled = true;
+	return true;
+}
+
+void RenderGraph_LogSchedule(const RenderGraph* graph)
+{
+	Uint32 transientCount = 0;
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		if (!graph->Resources[i].Imported && graph->Resources[i].FirstUse != RENDER_GRAPH_INVALID)
+		{
+			transientCount += 1;
+		}
+	}
+
+	SDL_Log(
+		"Render graph: %u of %u passes kept in %u SDL passes, %u transient textures in %u",
+		graph->OrderCount,
+		graph->PassCount,
+		graph->SDLPassCount,
+		transientCount,
+		graph->PhysicalCount
+	);
+
+	for (Uint32 i = 0; i < graph->OrderCount; i += 1)
+	{
+		const RenderGraphPass* pass = &graph->Passes[graph->Order[i]];
+		SDL_Log(
+			"  %u. %s (%s)%s",
+			i,
+			pass->Name,
+			PassTypeNames[pass->Type],
+			pass->MergedWithPrevious ? ", merged into the render pass before it" : ""
+		);
+	}
+
+	for (Uint32 i = 0; i < graph->PassCount; i += 1)
+	{
+		if (graph->Passes[i].Culled)
+		{
+			SDL_Log("  Culled: %s", graph->Passes[i].Name);
+		}
+	}
+
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		const RenderGraphResource* resource = &graph->Resources[i];
+		if (!resource->Imported && resource->FirstUse != RENDER_GRAPH_INVALID)
+		{
+			SDL_Log("  %s: texture %u, alive from %u to %u", resource->Name, resource->PhysicalIndex, resource->FirstUse, resource->LastUse);
+		}
+	}
+}
+
+SDL_GPUTexture* RenderGraph_GetTexture(const RenderGraph* graph, Uint32 resource)
+{
+	return resource < graph->ResourceCount ? graph->Resources[resource].Texture : NULL;
+}
+
+static void BeginRenderPass(RenderGraph* graph, Uint32 position, RenderGraphPassContext* context)
+{
+	/* Loads come from the first pass of the merged run, stores and resolves from the last */
+	Uint32 end = position;
+	while (end + 1 < graph->OrderCount && graph->Passes[graph->Order[end + 1]].MergedWithPrevious)
+	{
+		end += 1;
+	}
+
+	const RenderGraphPass* first = &graph->Passes[graph->Order[position]];
+	const RenderGraphPass* last = &graph->Passes[graph->Order[end]];
+	const RenderGraphAccess* firstTargets[RENDER_GRAPH_MAX_COLOR_TARGETS];
+	const RenderGraphAccess* lastTargets[RENDER_GRAPH_MAX_COLOR_TARGETS];
+	Uint32 count = GetColorTargets(first, firstTargets);
+	GetColorTargets(last, lastTargets);
+
+	SDL_GPUColorTargetInfo colorTargetInfos[RENDER_GRAPH_MAX_COLOR_TARGETS];
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		SDL_GPUColorTargetInfo* info = &colorTargetInfos[i];
+		SDL_zerop(info);
+		info->texture = graph->Resources[firstTargets[i]->Resource].Texture;
+		info->clear_color = firstTargets[i]->ClearColor;
+		info->load_op = firstTargets[i]->LoadOp;
+		info->store_op = lastTargets[i]->StoreOp;
+
+		for (Uint32 j = 0; j < last->AccessCount; j += 1)
+		{
+			if (last->Accesses[j].ResolveFrom == firstTargets[i]->Resource)
+			{
+				info->resolve_texture = graph->Resources[last->Accesses[j].Resource].Texture;
+			}
+		}
+	}
+
+	context->RenderPass = SDL_BeginGPURenderPass(context->CommandBuffer, colorTargetInfos, count, NULL);
+}
+
+static void Blit(RenderGraph* graph, const RenderGraphPass* pass, SDL_GPUCommandBuffer* commandBuffer)
+{
+	const RenderGraphResource* source = NULL;
+	const RenderGraphResource* destination = NULL;
+	for (Uint32 i = 0; i < pass->AccessCount; i += 1)
+	{
+		if (pass->Accesses[i].Write)
+		{
+			destination = &graph->Resources[pass->Accesses[i].Resource];
+		}
+		else
+		{
+			source = &graph->Resources[pass->Accesses[i].Resource];
+		}
+	}
+
+	SDL_BlitGPUTexture(commandBuffer, &(SDL_GPUBlitInfo){
+		.source.texture = source->Texture,
+		.source.w = source->Description.Width,
+		.source.h = source->Description.Height,
+		.destination.texture = destination->Texture,
+		.destination.w = destination->Description.Width,
+		.destination.h = destination->Description.Height,
+		.load_op = SDL_GPU_LOADOP_DONT_CARE,
+		.filter = SDL_GPU_FILTER_LINEAR
+	});
+}
+
+static void ReleasePhysicalTextures(RenderGraph* graph)
+{
+	for (Uint32 i = 0; i < graph->PhysicalCount; i += 1)
+	{
+		if (graph->Physical[i].Texture != NULL)
+		{
+			ReleaseRenderTarget(graph->Physical[i].Texture);
+			graph->Physical[i].Texture = NULL;
+		}
+	}
+
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		if (!graph->Resources[i].Imported)
+		{
+			graph->Resources[i].Texture = NULL;
+		}
+	}
+}
+
+bool RenderGraph_Execute(RenderGraph* graph, SDL_GPUDevice* device, SDL_GPUCommandBuffer* commandBuffer)
+{
+	if (!graph->Compiled)
+	{
+		SDL_Log("RenderGraph: compile the graph before executing it");
+		return false;
+	}
+
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		const RenderGraphResource* resource = &graph->Resources[i];
+		if (resource->Imported && resource->FirstUse != RENDER_GRAPH_INVALID && resource->Texture == NULL)
+		{
+			SDL_Log("RenderGraph: no texture was set for %s", resource->Name);
+			return false;
+		}
+	}
+
+	for (Uint32 i = 0; i < graph->PhysicalCount; i += 1)
+	{
+		graph->Physical[i].Texture = AcquireRenderTarget(device, &graph->Physical[i].Description);
+		if (graph->Physical[i].Texture == NULL)
+		{
+			ReleasePhysicalTextures(graph);
+			return false;
+		}
+	}
+
+	for (Uint32 i = 0; i < graph->ResourceCount; i += 1)
+	{
+		RenderGraphResource* resource = &graph->Resources[i];
+		if (!resource->Imported && resource->PhysicalIndex != RENDER_GRAPH_INVALID)
+		{
+			resource->Texture = graph->Physical[resource->PhysicalIndex].Texture;
+		}
+	}
+
+	RenderGraphPassContext context = { graph, commandBuffer, NULL, NULL };
+	for (Uint32 i = 0; i < graph->OrderCount; i += 1)
+	{
+		const RenderGraphPass* pass = &graph->Passes[graph->Order[i]];
+
+		if (pass->Type == RENDERGRAPH_PASS_RENDER)
+		{
+			if (!pass->MergedWithPrevious)
+			{
+				BeginRenderPass(graph, i, &context);
+			}
+
+			if (pass->Function != NULL)
+			{
+				pass->Function(&context, pass->Userdata);
+			}
+
+			if (i + 1 == graph->OrderCount || !graph->Passes[graph->Order[i + 1]].MergedWithPrevious)
+			{
+				SDL_EndGPURenderPass(context.RenderPass);
+				context.RenderPass = NULL;
+			}
+		}
+		else if (pass->Type == RENDERGRAPH_PASS_COMPUTE)
+		{
+			SDL_GPUStorageTextureReadWriteBinding bindings[RENDER_GRAPH_MAX_ACCESSES];
+			Uint32 bindingCount = 0;
+			for (Uint32 j = 0; j < pass->AccessCount; j += 1)
+			{
+				if (pass->Accesses[j].Write)
+				{
+					/* Pooled textures are never cycled */
+					bindings[bindingCount] = (SDL_GPUStorageTextureReadWriteBinding){
+						.texture = graph->Resources[pass->Accesses[j].Resource].Texture
+					};
+					bindingCount += 1;
+				}
+			}
+
+			context.ComputePass = SDL_BeginGPUComputePass(commandBuffer, bindings, bindingCount, NULL, 0);
+			if (pass->Function != NULL)
+			{
+				pass->Function(&context, pass->Userdata);
+			}
+			SDL_EndGPUComputePass(context.ComputePass);
+			context.ComputePass = NULL;
+		}
+		else if (pass->Function != NULL)
+		{
+			pass->Function(&context, pass->Userdata);
+		}
+		else
+		{
+			Blit(graph, pass, commandBuffer);
+		}
+	}
+
+	ReleasePhysicalTextures(graph);
+	return true;
+}
@@ -0,0 +1,289 @@
+#include "Common.h"
+
+/* A small post chain built on the render graph:
+ *   Scene   (render)  clears HDR and draws a triangle
+ *   Gradient (compute) fills a small texture for the inset
+ *   Overlay (render)  draws a grid of triangles over HDR, merged into Scene's render pass
+ *   Debug   (render)  draws into a texture nobody reads, so it is culled
+ *   ToSRGB  (compute) converts HDR into LDR
+ *   Present (blit)    stretches LDR over the swapchain
+ *   Inset   (blit)    copies the gradient into a corner of the swapchain
+ * The scheduling decisions themselves are checked headlessly by Tools/ExampleChecks.c.
+ */
+
+#define INSET_SIZE 128
+#define INSET_MARGIN 16
+#define OVERLAY_GRID_SIZE 8
+
+static SDL_GPUGraphicsPipeline* ScenePipeline;
+static SDL_GPUComputePipeline* GradientPipeline;
+static SDL_GPUComputePipeline* ToSRGBPipeline;
+
+static RenderGraph Graph;
+static Uint32 HDRTexture;
+static Uint32 GradientTexture;
+static Uint32 SwapchainTexture;
+static Uint32 WindowWidth;
+static Uint32 WindowHeight;
+static bool ShowInset = true;
+static float Time;
+
+// Post chain
+
+static void DrawScene(const RenderGraphPassContext* context, void* userdata)
+{
+	SDL_BindGPUGraphicsPipeline(context->RenderPass, ScenePipeline);
+	SDL_DrawGPUPrimitives(context->RenderPass, 3, 1, 0, 0);
+}
+
+static void DrawOverlay(const RenderGraphPassContext* context, void* userdata)
+{
+	float cellWidth = (float) WindowWidth / OVERLAY_GRID_SIZE;
+	float cellHeight = (float) WindowHeight / OVERLAY_GRID_SIZE;
+
+	SDL_BindGPUGraphicsPipeline(context->RenderPass, ScenePipeline);
+	for (int y = 0; y < OVERLAY_GRID_SIZE; y += 1)
+	{
+		for (int x = 0; x < OVERLAY_GRID_SIZE; x += 1)
+		{
+			/* Keep to the edges so the big triangle stays visible */
+			if (x > 0 && x < OVERLAY_GRID_SIZE - 1 && y > 0 && y < OVERLAY_GRID_SIZE - 1)
+			{
+				continue;
+			}
+
+			SDL_SetGPUViewport(context->RenderPass, &(SDL_GPUViewport){ x * cellWidth, y * cellHeight, cellWidth, cellHeight, 0, 1 });
+			SDL_DrawGPUPrimitives(context->RenderPass, 3, 1, 0, 0);
+		}
+	}
+}
+
+static void DrawGradient(const RenderGraphPassContext* context, void* userdata)
+{
+	SDL_BindGPUComputePipeline(context->ComputePass, GradientPipeline);
+	SDL_PushGPUComputeUniformData(context->CommandBuffer, 0, &Time, sizeof(Time));
+	SDL_DispatchGPUCompute(context->ComputePass, INSET_SIZE / 8, INSET_SIZE / 8, 1);
+}
+
+static void ConvertToSRGB(const RenderGraphPassContext* context, void* userdata)
+{
+	SDL_BindGPUComputePipeline(context->ComputePass, ToSRGBPipeline);
+	SDL_BindGPUComputeStorageTextures(
+		context->ComputePass,
+		0,
+		&(SDL_GPUTexture*){ RenderGraph_GetTexture(context->Graph, HDRTexture) },
+		1
+	);
+	SDL_DispatchGPUCompute(context->ComputePass, (WindowWidth + 7) / 8, (WindowHeight + 7) / 8, 1);
+}
+
+static void BlitInset(const RenderGraphPassContext* context, void* userdata)
+{
+	SDL_BlitGPUTexture(context->CommandBuffer, &(SDL_GPUBlitInfo){
+		.source.texture = RenderGraph_GetTexture(context->Graph, GradientTexture),
+		.source.w = INSET_SIZE,
+		.source.h = INSET_SIZE,
+		.destination.texture = RenderGraph_GetTexture(context->Graph, SwapchainTexture),
+		.destination.x = WindowWidth - INSET_SIZE - INSET_MARGIN,
+		.destination.y = INSET_MARGIN,
+		.destination.w = INSET_SIZE,
+		.destination.h = INSET_SIZE,
+		.load_op = SDL_GPU_LOADOP_LOAD,
+		.filter = SDL_GPU_FILTER_NEAREST
+	});
+}
+
+static bool BuildGraph(Context* context)
+{
+	const SDL_FColor black = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+	RenderGraph_Reset(&Graph);
+
+	SwapchainTexture = RenderGraph_ImportTexture(&Graph, "Swapchain", &(RenderTargetDescription){
+		.Format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+		.Width = WindowWidth,
+		.Height = WindowHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1
+	});
+	HDRTexture = RenderGraph_CreateTexture(&Graph, "HDR", &(RenderTargetDescription){
+		.Format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+		.Width = WindowWidth,
+		.Height = WindowHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1
+	});
+	Uint32 ldrTexture = RenderGraph_CreateTexture(&Graph, "LDR", &(RenderTargetDescription){
+		.Format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.Width = WindowWidth,
+		.Height = WindowHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1
+	});
+	Uint32 debugTexture = RenderGraph_CreateTexture(&Graph, "Debug", &(RenderTargetDescription){
+		.Format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+		.Width = WindowWidth,
+		.Height = WindowHeight,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1
+	});
+	GradientTexture = RenderGraph_CreateTexture(&Graph, "Gradient", &(RenderTargetDescription){
+		.Format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.Width = INSET_SIZE,
+		.Height = INSET_SIZE,
+		.SampleCount = SDL_GPU_SAMPLECOUNT_1
+	});
+
+	Uint32 pass = RenderGraph_AddPass(&Graph, "Scene", RENDERGRAPH_PASS_RENDER, DrawScene, NULL);
+	RenderGraph_Clear(&Graph, pass, HDRTexture, black);
+
+	pass = RenderGraph_AddPass(&Graph, "Gradient", RENDERGRAPH_PASS_COMPUTE, DrawGradient, NULL);
+	RenderGraph_Write(&Graph, pass, GradientTexture);
+
+	pass = RenderGraph_AddPass(&Graph, "Overlay", RENDERGRAPH_PASS_RENDER, DrawOverlay, NULL);
+	RenderGraph_Write(&Graph, pass, HDRTexture);
+
+	pass = RenderGraph_AddPass(&Graph, "Debug", RENDERGRAPH_PASS_RENDER, DrawScene, NULL);
+	RenderGraph_Clear(&Graph, pass, debugTexture, black);
+
+	pass = RenderGraph_AddPass(&Graph, "ToSRGB", RENDERGRAPH_PASS_COMPUTE, ConvertToSRGB, NULL);
+	RenderGraph_Read(&Graph, pass, HDRTexture, SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ);
+	RenderGraph_Write(&Graph, pass, ldrTexture);
+
+	pass = RenderGraph_AddPass(&Graph, "Present", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(&Graph, pass, ldrTexture, 0);
+	RenderGraph_Write(&Graph, pass, SwapchainTexture);
+
+	/* Without the inset nothing reads the gradient, and its pass is culled too */
+	if (ShowInset)
+	{
+		pass = RenderGraph_AddPass(&Graph, "Inset", RENDERGRAPH_PASS_BLIT, BlitInset, NULL);
+		RenderGraph_Read(&Graph, pass, GradientTexture, 0);
+		RenderGraph_Write(&Graph, pass, SwapchainTexture);
+	}
+
+	if (!RenderGraph_Compile(&Graph))
+	{
+		return false;
+	}
+
+	RenderGraph_LogSchedule(&Graph);
+	return true;
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	int w, h;
+	SDL_GetWindowSizeInPixels(context->Window, &w, &h);
+	WindowWidth = w;
+	WindowHeight = h;
+
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	ScenePipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	// Bindings and group size are reflected from the SPIR-V
+	GradientPipeline = GetCachedComputePipeline(context->Device, "GradientTexture.comp", &(SDL_GPUComputePipelineCreateInfo){ 0 });
+	ToSRGBPipeline = GetCachedComputePipeline(context->Device, "LinearToSRGB.comp", &(SDL_GPUComputePipelineCreateInfo){ 0 });
+	if (ScenePipeline == NULL || GradientPipeline == NULL || ToSRGBPipeline == NULL)
+	{
+		SDL_Log("Failed to create pipelines!");
+		return -1;
+	}
+
+	if (!BuildGraph(context))
+	{
+		return -1;
+	}
+
+	SDL_Log("Press Down to toggle the inset");
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	Time += context->DeltaTime;
+
+	if (context->DownPressed)
+	{
+		ShowInset = !ShowInset;
+		if (!BuildGraph(context))
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	if (cmdbuf == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	SDL_GPUTexture* swapchainTexture;
+	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture))
+	{
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	if (swapchainTexture != NULL)
+	{
+		RenderGraph_SetTexture(&Graph, SwapchainTexture, swapchainTexture);
+		if (!RenderGraph_Execute(&Graph, context->Device, cmdbuf))
+		{
+			/* A command buffer holding a swapchain texture can't be cancelled */
+			SDL_SubmitGPUCommandBuffer(cmdbuf);
+			return -1;
+		}
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	// The pipelines belong to the state cache, and the graph's textures to the render target pool
+	RenderGraph_Reset(&Graph);
+	ShowInset = true;
+	Time = 0;
+
+	CommonQuit(context);
+}
+
+Example RenderGraphPost_Example = { "RenderGraphPost", Init, Update, Draw, Quit };
@@ -0,0 +1,180 @@
+#include "Common.h"
+
+typedef struct PooledTarget
+{
+	RenderTargetDescription Description;
+	SDL_GPUTexture* Texture;
+	Uint64 Bytes;
+	bool InUse;
+	Uint32 LastUsedFrame;
+} PooledTarget;
+
+static SDL_GPUDevice* PoolDevice;
+static PooledTarget Targets[RENDER_TARGET_POOL_CAPACITY];
+static Uint32 TargetCount;
+static Uint32 Frame;
+static Uint64 FrameAcquiredBytes;
+static bool WarnedUnreleased;
+static RenderTargetPoolStats Stats;
+
+static bool DescriptionsMatch(const RenderTargetDescription* a, const RenderTargetDescription* b)
+{
+	return
+		a->Format == b->Format &&
+		a->Width == b->Width &&
+		a->Height == b->Height &&
+		a->SampleCount == b->SampleCount &&
+		a->Usage == b->Usage;
+}
+
+static void DestroyTarget(Uint32 index)
+{
+	SDL_ReleaseGPUTexture(PoolDevice, Targets[index].Texture);
+	Stats.Bytes -= Targets[index].Bytes;
+	Stats.TargetCount -= 1;
+
+	/* Order doesn't matter, so the last target fills the hole */
+	TargetCount -= 1;
+	Targets[index] = Targets[TargetCount];
+}
+
+SDL_GPUTexture* AcquireRenderTarget(SDL_GPUDevice* device, const RenderTargetDescription* description)
+{
+	if (PoolDevice != NULL && PoolDevice != device)
+	{
+		SDL_Log("AcquireRenderTarget: the pool belongs to another device, release it first");
+		return NULL;
+	}
+	PoolDevice = device;
+
+	Stats.AcquireCount += 1;
+
+	PooledTarget* target = NULL;
+	for (Uint32 i = 0; i < TargetCount; i += 1)
+	{
+		if (!Targets[i].InUse && DescriptionsMatch(&Targets[i].Description, description))
+		{
+			target = &Targets[i];
+			break;
+		}
+	}
+
+	if (target == NULL)
+	{
+		if (TargetCount == RENDER_TARGET_POOL_CAPACITY)
+		{
+			SDL_Log("AcquireRenderTarget: all %d pool slots are taken", RENDER_TARGET_POOL_CAPACITY);
+			return NULL;
+		}
+
+		SDL_GPUTexture* texture = SDL_CreateGPUTexture(device, &(SDL_GPUTextureCreateInfo){
+			.type = SDL_GPU_TEXTURETYPE_2D,
+			.format = description->Format,
+			.width = description->Width,
+			.height = description->Height,
+			.layer_count_or_depth = 1,
+			.num_levels = 1,
+			.sample_count = description->SampleCount,
+			.usage = description->Usage
+		});
+		if (texture == NULL)
+		{
+			SDL_Log("AcquireRenderTarget: CreateGPUTexture failed: %s", SDL_GetError());
+			return NULL;
+		}
+
+		target = &Targets[TargetCount];
+		TargetCount += 1;
+
+		target->Description = *description;
+		target->Texture = texture;
+		target->Bytes =
+			(Uint64) SDL_CalculateGPUTextureFormatSize(description->Format, description->Width, description->Height, 1) <<
+			description->SampleCount;
+
+		Stats.CreateCount += 1;
+		Stats.TargetCount += 1;
+		Stats.Bytes += target->Bytes;
+		Stats.PeakTargetCount = SDL_max(Stats.PeakTargetCount, Stats.TargetCount);
+		Stats.PeakBytes = SDL_max(Stats.PeakBytes, Stats.Bytes);
+	}
+
+	target->InUse = true;
+	target->LastUsedFrame = Frame;
+	FrameAcquiredBytes += target->Bytes;
+
+	return target->Texture;
+}
+
+void ReleaseRenderTarget(SDL_GPUTexture* texture)
+{
+	for (Uint32 i = 0; i < TargetCount; i += 1)
+	{
+		if (Targets[i].Texture == texture)
+		{
+			Targets[i].InUse = false;
+			return;
+		}
+	}
+}
+
+void EndRenderTargetFrame(void)
+{
+	Stats.PeakUnpooledBytes = SDL_max(Stats.PeakUnpooledBytes, FrameAcquiredBytes);
+	FrameAcquiredBytes = 0;
+
+	/* Go backwards, DestroyTarget moves the last target into the freed slot */
+	for (Uint32 i = TargetCount; i > 0; i -= 1)
+	{
+		PooledTarget* target = &Targets[i - 1];
+		if (target->InUse)
+		{
+			if (!WarnedUnreleased)
+			{
+				SDL_Log("Render targets must be released in the frame that acquired them");
+				WarnedUnreleased = true;
+			}
+			target->InUse = false;
+		}
+		else if (Frame - target->LastUsedFrame >= RENDER_TARGET_POOL_IDLE_FRAMES)
+		{
+			DestroyTarget(i - 1);
+			Stats.EvictCount += 1;
+		}
+	}
+
+	Frame += 1;
+}
+
+void GetRenderTargetPoolStats(RenderTargetPoolStats* stats)
+{
+	*stats = Stats;
+}
+
+void ReleaseRenderTargetPool(SDL_GPUDevice* device)
+{
+	if (Stats.AcquireCount > 0)
+	{
+		SDL_Log(
+			"Render target pool: peak %u targets, %.2f MB (%.2f MB with a texture per acquire); %u acquires, %u created, %u evicted",
+			Stats.PeakTargetCount,
+			Stats.PeakBytes / (1024.0 * 1024.0),
+			Stats.PeakUnpooledBytes / (1024.0 * 1024.0),
+			Stats.AcquireCount,
+			Stats.CreateCount,
+			Stats.EvictCount
+		);
+	}
+
+	for (Uint32 i = 0; i < TargetCount; i += 1)
+	{
+		SDL_ReleaseGPUTexture(device, Targets[i].Texture);
+	}
+
+	PoolDevice = NULL;
+	TargetCount = 0;
+	Frame = 0;
+	FrameAcquiredBytes = 0;
+	WarnedUnreleased = false;
+	SDL_zero(Stats);
+}
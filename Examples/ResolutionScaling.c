@@ -0,0 +1,175 @@
+#include "Common.h"
+
+#define TARGET_MILLISECONDS 8.0f
+#define MAX_LOAD 4096
+
+static SDL_GPUGraphicsPipeline* Pipeline;
+static DynamicResolution Resolution;
+static Uint32 Load;
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, SDL_WINDOW_RESIZABLE);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "RawTriangle.vert", 0, 0, 0, 0);
+	if (vertexShader == NULL)
+	{
+		SDL_Log("Failed to create vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* fragmentShader = LoadShader(context->Device, "SolidColor.frag", 0, 0, 0, 0);
+	if (fragmentShader == NULL)
+	{
+		SDL_Log("Failed to create fragment shader!");
+		return -1;
+	}
+
+	SDL_GPUTextureFormat format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window);
+
+	/* Blended, so every layer of overdraw is really shaded */
+	Pipeline = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = format,
+				.blend_state = {
+					.enable_blend = true,
+					.color_blend_op = SDL_GPU_BLENDOP_ADD,
+					.alpha_blend_op = SDL_GPU_BLENDOP_ADD,
+					.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+					.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA
+				}
+			}},
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = vertexShader,
+		.fragment_shader = fragmentShader
+	});
+	if (Pipeline == NULL)
+	{
+		SDL_Log("Failed to create pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, vertexShader);
+	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+
+	/* The scene renders in the swapchain format so the pipeline works for both */
+	if (!DynamicResolution_Init(&Resolution, context->Device, context->Window, format, TARGET_MILLISECONDS))
+	{
+		return -1;
+	}
+
+	Load = 64;
+
+	SDL_Log("Press Left/Right to halve/double the overdraw");
+	SDL_Log("Press Up to toggle the sharpening upscale");
+	SDL_Log("Press Down to toggle dynamic resolution");
+	SDL_Log("Overdraw: %u, GPU time target: %.1f ms", Load, TARGET_MILLISECONDS);
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	if (context->LeftPressed && Load > 1)
+	{
+		Load /= 2;
+		SDL_Log("Overdraw: %u", Load);
+	}
+	if (context->RightPressed && Load < MAX_LOAD)
+	{
+		Load *= 2;
+		SDL_Log("Overdraw: %u", Load);
+	}
+	if (context->UpPressed)
+	{
+		Resolution.Sharpen = !Resolution.Sharpen;
+		SDL_Log("Upscale: %s", Resolution.Sharpen ? "sharpen" : "blit");
+	}
+	if (context->DownPressed)
+	{
+		Resolution.Enabled = !Resolution.Enabled;
+		SDL_Log("Dynamic resolution: %s", Resolution.Enabled ? "on" : "off");
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	if (cmdbuf == NULL)
+	{
+		SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	SDL_GPUTexture* swapchainTexture;
+	if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+		SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+		return -1;
+	}
+
+	if (swapchainTexture != NULL)
+	{
+		/* The scene gets a command buffer of its own so its GPU time can be measured */
+		SDL_GPUCommandBuffer* sceneCmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+		if (sceneCmdbuf == NULL)
+		{
+			SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+			return -1;
+		}
+
+		Uint32 width, height;
+		SDL_GPUTexture* target = DynamicResolution_BeginFrame(&Resolution, &width, &height);
+		if (target != NULL)
+		{
+			SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+			colorTargetInfo.texture = target;
+			colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
+			colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+			colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+			SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(sceneCmdbuf, &colorTargetInfo, 1, NULL);
+			SDL_BindGPUGraphicsPipeline(renderPass, Pipeline);
+			SDL_SetGPUViewport(renderPass, &(SDL_GPUViewport){ 0, 0, (float) width, (float) height, 0, 1 });
+			SDL_DrawGPUPrimitives(renderPass, 3, Load, 0, 0);
+			SDL_EndGPURenderPass(renderPass);
+		}
+
+		if (!DynamicResolution_SubmitScene(&Resolution, sceneCmdbuf))
+		{
+			return -1;
+		}
+
+		DynamicResolution_Upscale(&Resolution, cmdbuf, swapchainTexture);
+	}
+
+	/* Times the sharpening upscale per path, and submits plainly when the upscale was a blit */
+	if (!ComputePresenter_Submit(&Resolution.Presenter, cmdbuf))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	// The pipeline belongs to the state cache, which CommonQuit releases
+	DynamicResolution_Destroy(&Resolution);
+
+	Load = 0;
+
+	CommonQuit(context);
+}
+
+Example ResolutionScaling_Example = { "ResolutionScaling", Init, Update, Draw, Quit };
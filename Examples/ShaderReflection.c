@@ -0,0 +1,550 @@
+#include "Common.h"
+
+/* Minimal SPIR-V reflection, enough to derive the resource counts SDL_gpu asks for.
+ *
+ * One pass over the module collects types, decorations and variables, then every variable
+ * with a DescriptorSet decoration is classified by its type: sampled images count as
+ * samplers, storage images as storage textures, Block structs in Uniform storage as uniform
+ * buffers and everything else backed by a struct as a storage buffer. Compute storage
+ * resources are read-write when they live in set 1, which is where SDL_gpu expects them.
+ *
+ * Results are cached by filename for the life of the process, so a shader is parsed once
+ * no matter how many pipelines or examples load it.
+ *
+ * Shader variants are named "File:id=value,id=value". SpecializeShader patches those values
+ * into the module's specialization constants before it is created, and since the whole name
+ * is used for every cache lookup, each combination of values is cached as its own shader.
+ */
+
+#define SPIRV_MAGIC 0x07230203
+
+enum
+{
+	SPIRV_OP_ENTRY_POINT = 15,
+	SPIRV_OP_EXECUTION_MODE = 16,
+	SPIRV_OP_TYPE_IMAGE = 25,
+	SPIRV_OP_TYPE_SAMPLED_IMAGE = 27,
+	SPIRV_OP_TYPE_ARRAY = 28,
+	SPIRV_OP_TYPE_RUNTIME_ARRAY = 29,
+	SPIRV_OP_TYPE_STRUCT = 30,
+	SPIRV_OP_TYPE_POINTER = 32,
+	SPIRV_OP_CONSTANT = 43,
+	SPIRV_OP_SPEC_CONSTANT_TRUE = 48,
+	SPIRV_OP_SPEC_CONSTANT_FALSE = 49,
+	SPIRV_OP_SPEC_CONSTANT = 50,
+	SPIRV_OP_VARIABLE = 59,
+	SPIRV_OP_DECORATE = 71,
+	SPIRV_OP_EXECUTION_MODE_ID = 331
+};
+
+enum
+{
+	SPIRV_EXECUTION_MODEL_VERTEX = 0,
+	SPIRV_EXECUTION_MODEL_FRAGMENT = 4,
+	SPIRV_EXECUTION_MODEL_GLCOMPUTE = 5,
+	SPIRV_EXECUTION_MODE_LOCAL_SIZE = 17,
+	SPIRV_EXECUTION_MODE_LOCAL_SIZE_ID = 38,
+	SPIRV_DECORATION_SPEC_ID = 1,
+	SPIRV_DECORATION_BLOCK = 2,
+	SPIRV_DECORATION_DESCRIPTOR_SET = 34,
+	SPIRV_STORAGE_CLASS_UNIFORM = 2,
+	SPIRV_IMAGE_SAMPLED_STORAGE = 2
+};
+
+typedef enum ResourceKind
+{
+	RESOURCEKIND_NONE,
+	RESOURCEKIND_SAMPLER,
+	RESOURCEKIND_STORAGE_TEXTURE,
+	RESOURCEKIND_UNIFORM_BUFFER,
+	RESOURCEKIND_STORAGE_BUFFER
+} ResourceKind;
+
+/* Everything the parser remembers about one result id */
+typedef struct SpirvId
+{
+	Uint16 Opcode;
+	Uint32 Operands[3];
+	Uint32 DescriptorSet;
+	bool HasDescriptorSet;
+	bool IsBlock;
+} SpirvId;
+
+typedef struct CachedReflection
+{
+	char Filename[64];
+	ShaderReflection Reflection;
+} CachedReflection;
+
+static SDL_SpinLock ReflectionLock;
+static CachedReflection* Reflections;
+static Uint32 ReflectionCount;
+
+/* Follows arrays down to the element type, multiplying out their lengths */
+static ResourceKind ClassifyType(const SpirvId* ids, Uint32 idBound, Uint32 typeId, Uint32 storageClass, Uint32* pCount)
+{
+	*pCount = 1;
+	while (typeId < idBound && (ids[typeId].Opcode == SPIRV_OP_TYPE_ARRAY || ids[typeId].Opcode == SPIRV_OP_TYPE_RUNTIME_ARRAY))
+	{
+		if (ids[typeId].Opcode == SPIRV_OP_TYPE_ARRAY)
+		{
+			Uint32 lengthId = ids[typeId].Operands[1];
+			if (lengthId < idBound && ids[lengthId].Opcode == SPIRV_OP_CONSTANT)
+			{
+				*pCount *= ids[lengthId].Operands[0];
+			}
+		}
+		typeId = ids[typeId].Operands[0];
+	}
+
+	if (typeId >= idBound)
+	{
+		return RESOURCEKIND_NONE;
+	}
+
+	switch (ids[typeId].Opcode)
+	{
+		case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+			return RESOURCEKIND_SAMPLER;
+		case SPIRV_OP_TYPE_IMAGE:
+			return ids[typeId].Operands[0] == SPIRV_IMAGE_SAMPLED_STORAGE ? RESOURCEKIND_STORAGE_TEXTURE : RESOURCEKIND_SAMPLER;
+		case SPIRV_OP_TYPE_STRUCT:
+			/* Older SPIR-V marks storage buffers as BufferBlock in Uniform storage */
+			return (storageClass == SPIRV_STORAGE_CLASS_UNIFORM && ids[typeId].IsBlock) ? RESOURCEKIND_UNIFORM_BUFFER : RESOURCEKIND_STORAGE_BUFFER;
+		default:
+			return RESOURCEKIND_NONE;
+	}
+}
+
+/* Returns the set SDL_gpu expects a resource in, see the SDL_CreateGPUShader docs */
+static Uint32 GetExpectedSet(const ShaderReflection* reflection, ResourceKind kind, Uint32 set)
+{
+	if (reflection->IsCompute)
+	{
+		if (kind == RESOURCEKIND_UNIFORM_BUFFER)
+		{
+			return 2;
+		}
+		/* Storage resources may be read-only (set 0) or read-write (set 1) */
+		return (kind != RESOURCEKIND_SAMPLER && set == 1) ? 1 : 0;
+	}
+
+	Uint32 base = reflection->Stage == SDL_GPU_SHADERSTAGE_FRAGMENT ? 2 : 0;
+	return base + (kind == RESOURCEKIND_UNIFORM_BUFFER ? 1 : 0);
+}
+
+bool ReflectShader(const char* name, const void* code, size_t codeSize, ShaderReflection* reflection)
+{
+	const Uint32* words = code;
+	size_t wordCount = codeSize / 4;
+	SDL_zerop(reflection);
+
+	if (wordCount < 5 || words[0] != SPIRV_MAGIC)
+	{
+		SDL_Log("%s is not a SPIR-V module!", name);
+		return false;
+	}
+
+	Uint32 idBound = words[3];
+	SpirvId* ids = SDL_calloc(idBound, sizeof(SpirvId));
+	if (ids == NULL)
+	{
+		return false;
+	}
+
+	Uint32 executionModel = 0xFFFFFFFF;
+	Uint32 localSizeIds[3] = { 0 };
+	bool hasLocalSizeIds = false;
+
+	/* Decorations come before the ids they decorate, so variables are only classified
+	 * once the whole module has been read.
+	 */
+	for (size_t i = 5; i < wordCount;)
+	{
+		Uint16 opcode = words[i] & 0xFFFF;
+		Uint16 length = words[i] >> 16;
+		if (length == 0 || i + length > wordCount)
+		{
+			SDL_Log("%s has a truncated SPIR-V instruction!", name);
+			SDL_free(ids);
+			return false;
+		}
+		const Uint32* operands = &words[i + 1];
+
+		switch (opcode)
+		{
+			case SPIRV_OP_ENTRY_POINT:
+				if (executionModel == 0xFFFFFFFF)
+				{
+					executionModel = operands[0];
+				}
+				break;
+
+			case SPIRV_OP_EXECUTION_MODE:
+			case SPIRV_OP_EXECUTION_MODE_ID:
+				if (length >= 6 && operands[1] == SPIRV_EXECUTION_MODE_LOCAL_SIZE)
+				{
+					SDL_memcpy(reflection->ThreadCount, &operands[2], sizeof(reflection->ThreadCount));
+				}
+				else if (length >= 6 && operands[1] == SPIRV_EXECUTION_MODE_LOCAL_SIZE_ID)
+				{
+					SDL_memcpy(localSizeIds, &operands[2], sizeof(localSizeIds));
+					hasLocalSizeIds = true;
+				}
+				break;
+
+			case SPIRV_OP_TYPE_IMAGE:
+				/* Keep only the Sampled operand: 1 for sampling, 2 for storage */
+				if (length >= 9 && operands[0] < idBound)
+				{
+					ids[operands[0]].Opcode = opcode;
+					ids[operands[0]].Operands[0] = operands[6];
+				}
+				break;
+
+			case SPIRV_OP_TYPE_SAMPLED_IMAGE:
+			case SPIRV_OP_TYPE_ARRAY:
+			case SPIRV_OP_TYPE_RUNTIME_ARRAY:
+			case SPIRV_OP_TYPE_STRUCT:
+			case SPIRV_OP_TYPE_POINTER:
+				if (length >= 2 && operands[0] < idBound)
+				{
+					ids[operands[0]].Opcode = opcode;
+					for (Uint16 j = 1; j < length - 1 && j <= 3; j += 1)
+					{
+						ids[operands[0]].Operands[j - 1] = operands[j];
+					}
+				}
+				break;
+
+			case SPIRV_OP_CONSTANT:
+			case SPIRV_OP_SPEC_CONSTANT:
+				/* Spec constants are read at their default value */
+				if (length >= 4 && operands[1] < idBound)
+				{
+					ids[operands[1]].Opcode = SPIRV_OP_CONSTANT;
+					ids[operands[1]].Operands[0] = operands[2];
+				}
+				break;
+
+			case SPIRV_OP_VARIABLE:
+				if (length >= 4 && operands[1] < idBound)
+				{
+					ids[operands[1]].Opcode = opcode;
+					ids[operands[1]].Operands[0] = operands[0];
+					ids[operands[1]].Operands[1] = operands[2];
+				}
+				break;
+
+			case SPIRV_OP_DECORATE:
+				if (length >= 3 && operands[0] < idBound)
+				{
+					if (operands[1] == SPIRV_DECORATION_BLOCK)
+					{
+						ids[operands[0]].IsBlock = true;
+					}
+					else if (operands[1] == SPIRV_DECORATION_DESCRIPTOR_SET && length >= 4)
+					{
+						ids[operands[0]].DescriptorSet = operands[2];
+						ids[operands[0]].HasDescriptorSet = true;
+					}
+				}
+				break;
+		}
+
+		i += length;
+	}
+
+	bool valid = true;
+	switch (executionModel)
+	{
+		case SPIRV_EXECUTION_MODEL_VERTEX:
+			reflection->Stage = SDL_GPU_SHADERSTAGE_VERTEX;
+			break;
+		case SPIRV_EXECUTION_MODEL_FRAGMENT:
+			reflection->Stage = SDL_GPU_SHADERSTAGE_FRAGMENT;
+			break;
+		case SPIRV_EXECUTION_MODEL_GLCOMPUTE:
+			reflection->IsCompute = true;
+			break;
+		default:
+			SDL_Log("%s has no vertex, fragment or compute entry point!", name);
+			valid = false;
+			break;
+	}
+
+	if (hasLocalSizeIds)
+	{
+		for (int j = 0; j < 3; j += 1)
+		{
+			if (localSizeIds[j] < idBound && ids[localSizeIds[j]].Opcode == SPIRV_OP_CONSTANT)
+			{
+				reflection->ThreadCount[j] = ids[localSizeIds[j]].Operands[0];
+			}
+		}
+	}
+
+	for (Uint32 id = 0; id < idBound && valid; id += 1)
+	{
+		if (ids[id].Opcode != SPIRV_OP_VARIABLE || !ids[id].HasDescriptorSet)
+		{
+			continue;
+		}
+
+		Uint32 pointerType = ids[id].Operands[0];
+		if (pointerType >= idBound || ids[pointerType].Opcode != SPIRV_OP_TYPE_POINTER)
+		{
+			continue;
+		}
+
+		Uint32 count;
+		Uint32 storageClass = ids[id].Operands[1];
+		ResourceKind kind = ClassifyType(ids, idBound, ids[pointerType].Operands[1], storageClass, &count);
+		Uint32 set = ids[id].DescriptorSet;
+		bool readWrite = reflection->IsCompute && set == 1;
+
+		if (kind == RESOURCEKIND_NONE)
+		{
+			continue;
+		}
+
+		if (set != GetExpectedSet(reflection, kind, set))
+		{
+			SDL_Log("%s binds a resource in descriptor set %u, but SDL_gpu expects it in set %u!", name, set, GetExpectedSet(reflection, kind, set));
+			valid = false;
+		}
+
+		switch (kind)
+		{
+			case RESOURCEKIND_SAMPLER:
+				reflection->SamplerCount += count;
+				break;
+			case RESOURCEKIND_STORAGE_TEXTURE:
+				if (readWrite)
+				{
+					reflection->ReadWriteStorageTextureCount += count;
+				}
+				else
+				{
+					reflection->StorageTextureCount += count;
+				}
+				break;
+			case RESOURCEKIND_UNIFORM_BUFFER:
+				reflection->UniformBufferCount += count;
+				break;
+			case RESOURCEKIND_STORAGE_BUFFER:
+				if (readWrite)
+				{
+					reflection->ReadWriteStorageBufferCount += count;
+				}
+				else
+				{
+					reflection->StorageBufferCount += count;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	SDL_free(ids);
+	reflection->CodeHash = HashBytes(STATE_CACHE_HASH_SEED, code, codeSize);
+	return valid;
+}
+
+bool GetShaderReflection(const char* shaderFilename, const void* code, size_t codeSize, ShaderReflection* reflection)
+{
+	SDL_LockSpinlock(&ReflectionLock);
+	for (Uint32 i = 0; i < ReflectionCount; i += 1)
+	{
+		if (SDL_strcmp(Reflections[i].Filename, shaderFilename) == 0)
+		{
+			*reflection = Reflections[i].Reflection;
+			SDL_UnlockSpinlock(&ReflectionLock);
+			return true;
+		}
+	}
+	SDL_UnlockSpinlock(&ReflectionLock);
+
+	if (!ReflectShader(shaderFilename, code, codeSize, reflection))
+	{
+		return false;
+	}
+
+	/* Two threads may reflect the same file at once, which is harmless */
+	SDL_LockSpinlock(&ReflectionLock);
+	CachedReflection* reflections = SDL_realloc(Reflections, sizeof(CachedReflection) * (ReflectionCount + 1));
+	if (reflections != NULL)
+	{
+		Reflections = reflections;
+		SDL_strlcpy(Reflections[ReflectionCount].Filename, shaderFilename, sizeof(Reflections[ReflectionCount].Filename));
+		Reflections[ReflectionCount].Reflection = *reflection;
+		ReflectionCount += 1;
+	}
+	SDL_UnlockSpinlock(&ReflectionLock);
+	return true;
+}
+
+/* Fills a zero count from reflection and warns when a non-zero one disagrees with it.
+ * Reflection wins either way, since it describes what the shader actually binds.
+ */
+static Uint32 CheckCount(const char* shaderFilename, const char* field, Uint32 requested, Uint32 reflected)
+{
+	if (requested != 0 && requested != reflected)
+	{
+		SDL_Log("%s: %s is %u but the shader uses %u, using %u", shaderFilename, field, requested, reflected, reflected);
+	}
+	return reflected;
+}
+
+void ApplyShaderReflection(
+	const char* shaderFilename,
+	const ShaderReflection* reflection,
+	Uint32* pSamplerCount,
+	Uint32* pUniformBufferCount,
+	Uint32* pStorageBufferCount,
+	Uint32* pStorageTextureCount
+) {
+	*pSamplerCount = CheckCount(shaderFilename, "samplerCount", *pSamplerCount, reflection->SamplerCount);
+	*pUniformBufferCount = CheckCount(shaderFilename, "uniformBufferCount", *pUniformBufferCount, reflection->UniformBufferCount);
+	*pStorageBufferCount = CheckCount(shaderFilename, "storageBufferCount", *pStorageBufferCount, reflection->StorageBufferCount);
+	*pStorageTextureCount = CheckCount(shaderFilename, "storageTextureCount", *pStorageTextureCount, reflection->StorageTextureCount);
+}
+
+void ApplyComputeShaderReflection(const char* shaderFilename, const ShaderReflection* reflection, SDL_GPUComputePipelineCreateInfo* createInfo)
+{
+	createInfo->num_samplers = CheckCount(shaderFilename, "num_samplers", createInfo->num_samplers, reflection->SamplerCount);
+	createInfo->num_readonly_storage_textures = CheckCount(shaderFilename, "num_readonly_storage_textures", createInfo->num_readonly_storage_textures, reflection->StorageTextureCount);
+	createInfo->num_readonly_storage_buffers = CheckCount(shaderFilename, "num_readonly_storage_buffers", createInfo->num_readonly_storage_buffers, reflection->StorageBufferCount);
+	createInfo->num_readwrite_storage_textures = CheckCount(shaderFilename, "num_readwrite_storage_textures", createInfo->num_readwrite_storage_textures, reflection->ReadWriteStorageTextureCount);
+	createInfo->num_readwrite_storage_buffers = CheckCount(shaderFilename, "num_readwrite_storage_buffers", createInfo->num_readwrite_storage_buffers, reflection->ReadWriteStorageBufferCount);
+	createInfo->num_uniform_buffers = CheckCount(shaderFilename, "num_uniform_buffers", createInfo->num_uniform_buffers, reflection->UniformBufferCount);
+	createInfo->threadcount_x = CheckCount(shaderFilename, "threadcount_x", createInfo->threadcount_x, reflection->ThreadCount[0]);
+	createInfo->threadcount_y = CheckCount(shaderFilename, "threadcount_y", createInfo->threadcount_y, reflection->ThreadCount[1]);
+	createInfo->threadcount_z = CheckCount(shaderFilename, "threadcount_z", createInfo->threadcount_z, reflection->ThreadCount[2]);
+}
+
+// Specialization
+
+bool ParseShaderVariantName(
+	const char* variantName,
+	char* filename,
+	size_t filenameSize,
+	SpecializationConstant* constants,
+	Uint32* pConstantCount
+) {
+	const char* separator = SDL_strchr(variantName, ':');
+	size_t nameLength = separator ? (size_t) (separator - variantName) : SDL_strlen(variantName);
+	*pConstantCount = 0;
+
+	if (nameLength >= filenameSize)
+	{
+		SDL_Log("Shader name %s is too long!", variantName);
+		return false;
+	}
+	SDL_memcpy(filename, variantName, nameLength);
+	filename[nameLength] = '\0';
+
+	/* ":id=value,id=value" follows the file name */
+	const char* cursor = separator;
+	while (cursor != NULL && *cursor != '\0')
+	{
+		char* end;
+		SpecializationConstant constant;
+		constant.ID = (Uint32) SDL_strtoul(cursor + 1, &end, 10);
+		if (*end != '=' || *pConstantCount == MAX_SPECIALIZATION_CONSTANTS)
+		{
+			SDL_Log("Malformed shader variant %s, expected File:id=value,id=value", variantName);
+			return false;
+		}
+		constant.Value = (Uint32) SDL_strtol(end + 1, &end, 10);
+		if (*end != ',' && *end != '\0')
+		{
+			SDL_Log("Malformed shader variant %s, expected File:id=value,id=value", variantName);
+			return false;
+		}
+
+		constants[*pConstantCount] = constant;
+		*pConstantCount += 1;
+		cursor = end;
+	}
+
+	return true;
+}
+
+/* SDL_gpu has no way to pass specialization info, so the defaults are rewritten instead.
+ * Drivers (and SPIRV-Cross, for the other backends) treat the new defaults as constants.
+ */
+bool SpecializeShader(const char* name, void* code, size_t codeSize, const SpecializationConstant* constants, Uint32 constantCount)
+{
+	Uint32* words = code;
+	size_t wordCount = codeSize / 4;
+	if (wordCount < 5 || words[0] != SPIRV_MAGIC)
+	{
+		SDL_Log("%s is not a SPIR-V module!", name);
+		return false;
+	}
+
+	Uint32 idBound = words[3];
+	Uint32* specIds = SDL_malloc(sizeof(Uint32) * idBound);
+	if (specIds == NULL)
+	{
+		return false;
+	}
+	SDL_memset(specIds, 0xFF, sizeof(Uint32) * idBound);
+
+	Uint32 patchedMask = 0;
+	for (size_t i = 5; i < wordCount;)
+	{
+		Uint16 opcode = words[i] & 0xFFFF;
+		Uint16 length = words[i] >> 16;
+		if (length == 0 || i + length > wordCount)
+		{
+			break;
+		}
+		Uint32* operands = &words[i + 1];
+
+		/* SpecId decorations always come before the constants they name */
+		if (opcode == SPIRV_OP_DECORATE && length >= 4 && operands[1] == SPIRV_DECORATION_SPEC_ID && operands[0] < idBound)
+		{
+			specIds[operands[0]] = operands[2];
+		}
+		else if ((opcode == SPIRV_OP_SPEC_CONSTANT_TRUE || opcode == SPIRV_OP_SPEC_CONSTANT_FALSE || opcode == SPIRV_OP_SPEC_CONSTANT) &&
+			length >= 3 && operands[1] < idBound)
+		{
+			for (Uint32 j = 0; j < constantCount; j += 1)
+			{
+				if (specIds[operands[1]] != constants[j].ID)
+				{
+					continue;
+				}
+
+				if (opcode == SPIRV_OP_SPEC_CONSTANT)
+				{
+					operands[2] = constants[j].Value;
+				}
+				else
+				{
+					opcode = constants[j].Value ? SPIRV_OP_SPEC_CONSTANT_TRUE : SPIRV_OP_SPEC_CONSTANT_FALSE;
+					words[i] = ((Uint32) length << 16) | opcode;
+				}
+				patchedMask |= 1u << j;
+			}
+		}
+
+		i += length;
+	}
+
+	SDL_free(specIds);
+
+	bool success = true;
+	for (Uint32 j = 0; j < constantCount; j += 1)
+	{
+		if ((patchedMask & (1u << j)) == 0)
+		{
+			SDL_Log("%s has no specialization constant with id %u!", name, constants[j].ID);
+			success = false;
+		}
+	}
+	return success;
+}
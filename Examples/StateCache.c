@@ -0,0 +1,970 @@
+#include "Common.h"
+
+/* Sampler and pipeline caches, plus a pipeline manifest used to prewarm them.
+ *
+ * Each create info is visited field by field (pointers are followed and padding is skipped)
+ * to build a key, and the key's hash picks a slot in an open-addressed table. Full keys are
+ * compared on lookup, so a hash collision can never return the wrong object.
+ *
+ * Graphics shaders are keyed by what LoadShader registered for them (a hash of the code,
+ * stage and resource counts) rather than by pointer, because examples release their shaders
+ * right after creating a pipeline and a later shader may reuse the same address.
+ *
+ * Every pipeline created on demand is appended to a manifest in the pref path, as one line
+ * holding the shader files, resource counts and every visited field. The same visitor that
+ * builds keys also prints and parses those lines. When an example starts, a worker thread
+ * recreates that example's manifest entries through the cache. If the example asks for a
+ * pipeline the worker is still building, the lookup blocks until it is ready instead of
+ * building it a second time.
+ */
+
+#define MANIFEST_FILENAME "PipelineManifest.txt"
+#define MAX_COLOR_TARGETS 8
+#define MAX_VERTEX_BUFFERS 16
+#define MAX_VERTEX_ATTRIBUTES 16
+
+typedef enum EntryState
+{
+	ENTRYSTATE_EMPTY,
+	ENTRYSTATE_PENDING,
+	ENTRYSTATE_READY,
+	ENTRYSTATE_FAILED /* Created NULL last time, the next lookup tries again */
+} EntryState;
+
+typedef struct CacheEntry
+{
+	EntryState State;
+	Uint64 Hash;
+	Uint8* Key;
+	Uint32 KeySize;
+	void* Object;
+} CacheEntry;
+
+typedef struct ObjectCache
+{
+	CacheEntry* Entries;
+	Uint32 Count;
+	Uint32 Capacity;
+	Uint32 Hits;
+	Uint32 Misses;
+	Uint64 CreationNS;
+} ObjectCache;
+
+typedef struct ShaderIdentity
+{
+	SDL_GPUShader* Shader;
+	Uint64 Hash;
+	char Filename[64];
+	Uint32 ResourceCounts[4];
+} ShaderIdentity;
+
+typedef enum FieldVisitMode
+{
+	FIELDVISIT_KEY,
+	FIELDVISIT_PRINT,
+	FIELDVISIT_PARSE
+} FieldVisitMode;
+
+/* Builds a key, prints a manifest line or parses one, depending on Mode */
+typedef struct FieldVisitor
+{
+	FieldVisitMode Mode;
+	Uint8 Key[1024];
+	Uint32 KeySize;
+	char Text[2048];
+	Uint32 TextSize;
+	const char* Cursor;
+	bool Failed;
+} FieldVisitor;
+
+/* A graphics pipeline create info with its arrays stored inline */
+typedef struct PipelineDescription
+{
+	SDL_GPUGraphicsPipelineCreateInfo CreateInfo;
+	SDL_GPUColorTargetDescription ColorTargets[MAX_COLOR_TARGETS];
+	SDL_GPUVertexBufferDescription VertexBuffers[MAX_VERTEX_BUFFERS];
+	SDL_GPUVertexAttribute VertexAttributes[MAX_VERTEX_ATTRIBUTES];
+} PipelineDescription;
+
+typedef void* (*CreateObjectFunction)(SDL_GPUDevice* device, const void* userdata);
+
+static SDL_Mutex* CacheMutex;
+static SDL_Condition* CacheCondition;
+static SDL_GPUDevice* CacheDevice;
+static ObjectCache SamplerCache;
+static ObjectCache PipelineCache;
+static ObjectCache ComputePipelineCache;
+static ShaderIdentity* ShaderIdentities;
+static Uint32 ShaderIdentityCount;
+static Uint32 ShaderIdentityCapacity;
+
+static const char* CurrentExample;
+static char** ManifestLines;
+static Uint32 ManifestLineCount;
+static bool ManifestLoaded;
+static SDL_Thread* PrewarmThread;
+static SDL_AtomicInt PrewarmCancelled;
+static Uint32 PrewarmedCount;
+static Uint32 WaitCount;
+static Uint64 WaitNS;
+
+Uint64 HashBytes(Uint64 hash, const void* data, size_t size)
+{
+	const Uint8* bytes = data;
+	for (size_t i = 0; i < size; i += 1)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static void LockCache()
+{
+	if (CacheMutex == NULL)
+	{
+		CacheMutex = SDL_CreateMutex();
+		CacheCondition = SDL_CreateCondition();
+	}
+	SDL_LockMutex(CacheMutex);
+}
+
+// Field Visiting
+
+static void InitVisitor(FieldVisitor* visitor, FieldVisitMode mode, const char* text)
+{
+	visitor->Mode = mode;
+	visitor->KeySize = 0;
+	visitor->TextSize = 0;
+	visitor->Text[0] = '\0';
+	visitor->Cursor = text;
+	visitor->Failed = false;
+}
+
+static void VisitText(FieldVisitor* visitor, const char* text)
+{
+	if (visitor->Mode == FIELDVISIT_PRINT)
+	{
+		int written = SDL_snprintf(&visitor->Text[visitor->TextSize], sizeof(visitor->Text) - visitor->TextSize, "%s%s", visitor->TextSize ? " " : "", text);
+		visitor->TextSize += written;
+		visitor->Failed |= visitor->TextSize >= sizeof(visitor->Text);
+	}
+}
+
+/* Fields are at most 8 bytes and stored little-endian, so they print as plain integers */
+static void VisitField(FieldVisitor* visitor, void* field, size_t size)
+{
+	Uint64 value = 0;
+	char number[24];
+	char* end;
+
+	switch (visitor->Mode)
+	{
+		case FIELDVISIT_KEY:
+			if (visitor->KeySize + size > sizeof(visitor->Key))
+			{
+				visitor->Failed = true;
+				return;
+			}
+			SDL_memcpy(&visitor->Key[visitor->KeySize], field, size);
+			visitor->KeySize += (Uint32) size;
+			break;
+
+		case FIELDVISIT_PRINT:
+			SDL_memcpy(&value, field, size);
+			SDL_snprintf(number, sizeof(number), "%" SDL_PRIu64, value);
+			VisitText(visitor, number);
+			break;
+
+		case FIELDVISIT_PARSE:
+			value = SDL_strtoull(visitor->Cursor, &end, 10);
+			if (end == visitor->Cursor)
+			{
+				visitor->Failed = true;
+				return;
+			}
+			visitor->Cursor = end;
+			SDL_memcpy(field, &value, size);
+			break;
+	}
+}
+
+#define VISIT(visitor, field) VisitField((visitor), &(field), sizeof(field))
+
+static void VisitSampler(FieldVisitor* visitor, SDL_GPUSamplerCreateInfo* createInfo)
+{
+	VISIT(visitor, createInfo->min_filter);
+	VISIT(visitor, createInfo->mag_filter);
+	VISIT(visitor, createInfo->mipmap_mode);
+	VISIT(visitor, createInfo->address_mode_u);
+	VISIT(visitor, createInfo->address_mode_v);
+	VISIT(visitor, createInfo->address_mode_w);
+	VISIT(visitor, createInfo->mip_lod_bias);
+	VISIT(visitor, createInfo->max_anisotropy);
+	VISIT(visitor, createInfo->compare_op);
+	VISIT(visitor, createInfo->min_lod);
+	VISIT(visitor, createInfo->max_lod);
+	VISIT(visitor, createInfo->enable_anisotropy);
+	VISIT(visitor, createInfo->enable_compare);
+	VISIT(visitor, createInfo->props);
+}
+
+static void VisitStencil(FieldVisitor* visitor, SDL_GPUStencilOpState* state)
+{
+	VISIT(visitor, state->fail_op);
+	VISIT(visitor, state->pass_op);
+	VISIT(visitor, state->depth_fail_op);
+	VISIT(visitor, state->compare_op);
+}
+
+/* Array counts are visited before their elements, and clamped when parsing */
+static void VisitPipeline(FieldVisitor* visitor, PipelineDescription* description)
+{
+	SDL_GPUGraphicsPipelineCreateInfo* createInfo = &description->CreateInfo;
+
+	SDL_GPUVertexInputState* vertexInput = &createInfo->vertex_input_state;
+	VISIT(visitor, vertexInput->num_vertex_buffers);
+	if (vertexInput->num_vertex_buffers > MAX_VERTEX_BUFFERS)
+	{
+		visitor->Failed = true;
+		return;
+	}
+	for (Uint32 i = 0; i < vertexInput->num_vertex_buffers; i += 1)
+	{
+		SDL_GPUVertexBufferDescription* buffer = &description->VertexBuffers[i];
+		VISIT(visitor, buffer->slot);
+		VISIT(visitor, buffer->pitch);
+		VISIT(visitor, buffer->input_rate);
+		VISIT(visitor, buffer->instance_step_rate);
+	}
+	VISIT(visitor, vertexInput->num_vertex_attributes);
+	if (vertexInput->num_vertex_attributes > MAX_VERTEX_ATTRIBUTES)
+	{
+		visitor->Failed = true;
+		return;
+	}
+	for (Uint32 i = 0; i < vertexInput->num_vertex_attributes; i += 1)
+	{
+		SDL_GPUVertexAttribute* attribute = &description->VertexAttributes[i];
+		VISIT(visitor, attribute->location);
+		VISIT(visitor, attribute->buffer_slot);
+		VISIT(visitor, attribute->format);
+		VISIT(visitor, attribute->offset);
+	}
+	vertexInput->vertex_buffer_descriptions = description->VertexBuffers;
+	vertexInput->vertex_attributes = description->VertexAttributes;
+
+	VISIT(visitor, createInfo->primitive_type);
+
+	SDL_GPURasterizerState* rasterizer = &createInfo->rasterizer_state;
+	VISIT(visitor, rasterizer->fill_mode);
+	VISIT(visitor, rasterizer->cull_mode);
+	VISIT(visitor, rasterizer->front_face);
+	VISIT(visitor, rasterizer->depth_bias_constant_factor);
+	VISIT(visitor, rasterizer->depth_bias_clamp);
+	VISIT(visitor, rasterizer->depth_bias_slope_factor);
+	VISIT(visitor, rasterizer->enable_depth_bias);
+	VISIT(visitor, rasterizer->enable_depth_clip);
+
+	SDL_GPUMultisampleState* multisample = &createInfo->multisample_state;
+	VISIT(visitor, multisample->sample_count);
+	VISIT(visitor, multisample->sample_mask);
+	VISIT(visitor, multisample->enable_mask);
+
+	SDL_GPUDepthStencilState* depthStencil = &createInfo->depth_stencil_state;
+	VISIT(visitor, depthStencil->compare_op);
+	VisitStencil(visitor, &depthStencil->back_stencil_state);
+	VisitStencil(visitor, &depthStencil->front_stencil_state);
+	VISIT(visitor, depthStencil->compare_mask);
+	VISIT(visitor, depthStencil->write_mask);
+	VISIT(visitor, depthStencil->enable_depth_test);
+	VISIT(visitor, depthStencil->enable_depth_write);
+	VISIT(visitor, depthStencil->enable_stencil_test);
+
+	SDL_GPUGraphicsPipelineTargetInfo* targets = &createInfo->target_info;
+	VISIT(visitor, targets->num_color_targets);
+	if (targets->num_color_targets > MAX_COLOR_TARGETS)
+	{
+		visitor->Failed = true;
+		return;
+	}
+	for (Uint32 i = 0; i < targets->num_color_targets; i += 1)
+	{
+		SDL_GPUColorTargetDescription* target = &description->ColorTargets[i];
+		SDL_GPUColorTargetBlendState* blend = &target->blend_state;
+		VISIT(visitor, target->format);
+		VISIT(visitor, blend->src_color_blendfactor);
+		VISIT(visitor, blend->dst_color_blendfactor);
+		VISIT(visitor, blend->color_blend_op);
+		VISIT(visitor, blend->src_alpha_blendfactor);
+		VISIT(visitor, blend->dst_alpha_blendfactor);
+		VISIT(visitor, blend->alpha_blend_op);
+		VISIT(visitor, blend->color_write_mask);
+		VISIT(visitor, blend->enable_blend);
+		VISIT(visitor, blend->enable_color_write_mask);
+	}
+	targets->color_target_descriptions = description->ColorTargets;
+	VISIT(visitor, targets->depth_stencil_format);
+	VISIT(visitor, targets->has_depth_stencil_target);
+
+	VISIT(visitor, createInfo->props);
+}
+
+static void VisitComputePipeline(FieldVisitor* visitor, SDL_GPUComputePipelineCreateInfo* createInfo)
+{
+	VISIT(visitor, createInfo->num_samplers);
+	VISIT(visitor, createInfo->num_readonly_storage_textures);
+	VISIT(visitor, createInfo->num_readonly_storage_buffers);
+	VISIT(visitor, createInfo->num_readwrite_storage_textures);
+	VISIT(visitor, createInfo->num_readwrite_storage_buffers);
+	VISIT(visitor, createInfo->num_uniform_buffers);
+	VISIT(visitor, createInfo->threadcount_x);
+	VISIT(visitor, createInfo->threadcount_y);
+	VISIT(visitor, createInfo->threadcount_z);
+	VISIT(visitor, createInfo->props);
+}
+
+static bool CopyPipelineDescription(PipelineDescription* description, const SDL_GPUGraphicsPipelineCreateInfo* createInfo)
+{
+	const SDL_GPUVertexInputState* vertexInput = &createInfo->vertex_input_state;
+	const SDL_GPUGraphicsPipelineTargetInfo* targets = &createInfo->target_info;
+	if (vertexInput->num_vertex_buffers > MAX_VERTEX_BUFFERS ||
+		vertexInput->num_vertex_attributes > MAX_VERTEX_ATTRIBUTES ||
+		targets->num_color_targets > MAX_COLOR_TARGETS)
+	{
+		return false;
+	}
+
+	SDL_zerop(description);
+	description->CreateInfo = *createInfo;
+	if (vertexInput->num_vertex_buffers > 0)
+	{
+		SDL_memcpy(description->VertexBuffers, vertexInput->vertex_buffer_descriptions, sizeof(SDL_GPUVertexBufferDescription) * vertexInput->num_vertex_buffers);
+	}
+	if (vertexInput->num_vertex_attributes > 0)
+	{
+		SDL_memcpy(description->VertexAttributes, vertexInput->vertex_attributes, sizeof(SDL_GPUVertexAttribute) * vertexInput->num_vertex_attributes);
+	}
+	if (targets->num_color_targets > 0)
+	{
+		SDL_memcpy(description->ColorTargets, targets->color_target_descriptions, sizeof(SDL_GPUColorTargetDescription) * targets->num_color_targets);
+	}
+	return true;
+}
+
+// Cache Tables
+
+static CacheEntry* FindEntry(ObjectCache* cache, Uint64 hash, const FieldVisitor* key)
+{
+	if (cache->Capacity == 0)
+	{
+		return NULL;
+	}
+
+	Uint32 mask = cache->Capacity - 1;
+	for (Uint32 slot = (Uint32) hash & mask; cache->Entries[slot].State != ENTRYSTATE_EMPTY; slot = (slot + 1) & mask)
+	{
+		CacheEntry* entry = &cache->Entries[slot];
+		if (entry->Hash == hash && entry->KeySize == key->KeySize && SDL_memcmp(entry->Key, key->Key, key->KeySize) == 0)
+		{
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static void InsertEntry(ObjectCache* cache, Uint64 hash, const FieldVisitor* key)
+{
+	/* Keep the table at most half full */
+	if ((cache->Count + 1) * 2 > cache->Capacity)
+	{
+		Uint32 newCapacity = cache->Capacity ? cache->Capacity * 2 : 64;
+		CacheEntry* newEntries = SDL_calloc(newCapacity, sizeof(CacheEntry));
+		for (Uint32 i = 0; i < cache->Capacity; i += 1)
+		{
+			if (cache->Entries[i].State != ENTRYSTATE_EMPTY)
+			{
+				Uint32 slot = (Uint32) cache->Entries[i].Hash & (newCapacity - 1);
+				while (newEntries[slot].State != ENTRYSTATE_EMPTY)
+				{
+					slot = (slot + 1) & (newCapacity - 1);
+				}
+				newEntries[slot] = cache->Entries[i];
+			}
+		}
+		SDL_free(cache->Entries);
+		cache->Entries = newEntries;
+		cache->Capacity = newCapacity;
+	}
+
+	Uint32 slot = (Uint32) hash & (cache->Capacity - 1);
+	while (cache->Entries[slot].State != ENTRYSTATE_EMPTY)
+	{
+		slot = (slot + 1) & (cache->Capacity - 1);
+	}
+
+	CacheEntry* entry = &cache->Entries[slot];
+	entry->State = ENTRYSTATE_PENDING;
+	entry->Hash = hash;
+	entry->Key = SDL_malloc(key->KeySize);
+	SDL_memcpy(entry->Key, key->Key, key->KeySize);
+	entry->KeySize = key->KeySize;
+	entry->Object = NULL;
+	cache->Count += 1;
+}
+
+/* Returns the cached object for key, creating it outside the lock on a miss.
+ * A lookup that finds the object still being created by another thread waits for it.
+ * A failed creation isn't cached: the key is marked failed and the next lookup retries it.
+ * Must be called with the cache locked, and returns with it locked.
+ */
+static void* LookupOrCreate(
+	ObjectCache* cache,
+	SDL_GPUDevice* device,
+	const FieldVisitor* key,
+	CreateObjectFunction create,
+	const void* userdata,
+	bool* pCreated
+) {
+	Uint64 hash = HashBytes(STATE_CACHE_HASH_SEED, key->Key, key->KeySize);
+	*pCreated = false;
+
+	if (CacheDevice == NULL)
+	{
+		CacheDevice = device;
+	}
+	SDL_assert(CacheDevice == device && "The state cache serves one device at a time");
+
+	CacheEntry* entry = FindEntry(cache, hash, key);
+	if (entry != NULL && entry->State == ENTRYSTATE_PENDING)
+	{
+		Uint64 waitStart = SDL_GetTicksNS();
+		while (entry->State == ENTRYSTATE_PENDING)
+		{
+			SDL_WaitCondition(CacheCondition, CacheMutex);
+			/* The table may have grown while unlocked */
+			entry = FindEntry(cache, hash, key);
+		}
+		WaitCount += 1;
+		WaitNS += SDL_GetTicksNS() - waitStart;
+	}
+
+	if (entry != NULL && entry->State == ENTRYSTATE_READY)
+	{
+		cache->Hits += 1;
+		return entry->Object;
+	}
+
+	if (entry == NULL)
+	{
+		InsertEntry(cache, hash, key);
+	}
+	else
+	{
+		entry->State = ENTRYSTATE_PENDING;
+	}
+	cache->Misses += 1;
+	SDL_UnlockMutex(CacheMutex);
+
+	Uint64 start = SDL_GetTicksNS();
+	void* object = create(device, userdata);
+	Uint64 elapsed = SDL_GetTicksNS() - start;
+	if (object == NULL)
+	{
+		SDL_Log("State cache: creation failed, the next lookup will retry it: %s", SDL_GetError());
+	}
+
+	SDL_LockMutex(CacheMutex);
+	entry = FindEntry(cache, hash, key);
+	entry->State = object != NULL ? ENTRYSTATE_READY : ENTRYSTATE_FAILED;
+	entry->Object = object;
+	cache->CreationNS += elapsed;
+	SDL_BroadcastCondition(CacheCondition);
+
+	*pCreated = object != NULL;
+	return object;
+}
+
+void RegisterShaderIdentity(
+	SDL_GPUShader* shader,
+	Uint64 hash,
+	const char* filename,
+	Uint32 samplerCount,
+	Uint32 uniformBufferCount,
+	Uint32 storageBufferCount,
+	Uint32 storageTextureCount
+) {
+	LockCache();
+
+	/* A released shader's address can come back from a later LoadShader, so overwrite */
+	ShaderIdentity* identity = NULL;
+	for (Uint32 i = 0; i < ShaderIdentityCount; i += 1)
+	{
+		if (ShaderIdentities[i].Shader == shader)
+		{
+			identity = &ShaderIdentities[i];
+		}
+	}
+
+	if (identity == NULL)
+	{
+		if (ShaderIdentityCount == ShaderIdentityCapacity)
+		{
+			ShaderIdentityCapacity = ShaderIdentityCapacity ? ShaderIdentityCapacity * 2 : 64;
+			ShaderIdentities = SDL_realloc(ShaderIdentities, sizeof(ShaderIdentity) * ShaderIdentityCapacity);
+		}
+		identity = &ShaderIdentities[ShaderIdentityCount];
+		ShaderIdentityCount += 1;
+	}
+
+	identity->Shader = shader;
+	identity->Hash = hash;
+	SDL_strlcpy(identity->Filename, filename, sizeof(identity->Filename));
+	identity->ResourceCounts[0] = samplerCount;
+	identity->ResourceCounts[1] = uniformBufferCount;
+	identity->ResourceCounts[2] = storageBufferCount;
+	identity->ResourceCounts[3] = storageTextureCount;
+
+	SDL_UnlockMutex(CacheMutex);
+}
+
+/* Must be called with the cache locked */
+static const ShaderIdentity* GetShaderIdentity(SDL_GPUShader* shader)
+{
+	for (Uint32 i = 0; i < ShaderIdentityCount; i += 1)
+	{
+		if (ShaderIdentities[i].Shader == shader)
+		{
+			return &ShaderIdentities[i];
+		}
+	}
+	return NULL;
+}
+
+// Pipeline Manifest
+
+static void GetManifestPath(char* path, size_t size)
+{
+	char* prefPath = SDL_GetPrefPath("SDL", "SDL_gpu_examples");
+	SDL_snprintf(path, size, "%s%s", prefPath ? prefPath : "", MANIFEST_FILENAME);
+	SDL_free(prefPath);
+}
+
+static void LoadManifest()
+{
+	char path[512];
+	GetManifestPath(path, sizeof(path));
+	ManifestLoaded = true;
+
+	size_t size;
+	char* text = SDL_LoadFile(path, &size);
+	if (text == NULL)
+	{
+		return;
+	}
+
+	char* state;
+	for (char* line = SDL_strtok_r(text, "\r\n", &state); line != NULL; line = SDL_strtok_r(NULL, "\r\n", &state))
+	{
+		ManifestLines = SDL_realloc(ManifestLines, sizeof(char*) * (ManifestLineCount + 1));
+		ManifestLines[ManifestLineCount] = SDL_strdup(line);
+		ManifestLineCount += 1;
+	}
+
+	SDL_free(text);
+}
+
+/* Must be called with the cache locked */
+static void RecordManifestLine(const FieldVisitor* line)
+{
+	if (line->Failed)
+	{
+		return;
+	}
+
+	for (Uint32 i = 0; i < ManifestLineCount; i += 1)
+	{
+		if (SDL_strcmp(ManifestLines[i], line->Text) == 0)
+		{
+			return;
+		}
+	}
+
+	ManifestLines = SDL_realloc(ManifestLines, sizeof(char*) * (ManifestLineCount + 1));
+	ManifestLines[ManifestLineCount] = SDL_strdup(line->Text);
+	ManifestLineCount += 1;
+
+	char path[512];
+	GetManifestPath(path, sizeof(path));
+	SDL_IOStream* stream = SDL_IOFromFile(path, "a");
+	if (stream != NULL)
+	{
+		SDL_IOprintf(stream, "%s\n", line->Text);
+		SDL_CloseIO(stream);
+	}
+}
+
+static void PrintShader(FieldVisitor* visitor, const ShaderIdentity* identity)
+{
+	VisitText(visitor, identity->Filename);
+	for (int i = 0; i < 4; i += 1)
+	{
+		VisitField(visitor, (void*) &identity->ResourceCounts[i], sizeof(Uint32));
+	}
+}
+
+/* Reads one whitespace-separated token from a manifest line */
+static bool ParseToken(FieldVisitor* visitor, char* token, size_t size)
+{
+	const char* start = visitor->Cursor;
+	while (*start == ' ')
+	{
+		start += 1;
+	}
+	const char* end = start;
+	while (*end != ' ' && *end != '\0')
+	{
+		end += 1;
+	}
+	if (end == start || (size_t) (end - start) >= size)
+	{
+		return false;
+	}
+	SDL_memcpy(token, start, end - start);
+	token[end - start] = '\0';
+	visitor->Cursor = end;
+	return true;
+}
+
+static SDL_GPUShader* ParseAndLoadShader(FieldVisitor* visitor, SDL_GPUDevice* device)
+{
+	char filename[64];
+	Uint32 counts[4];
+	if (!ParseToken(visitor, filename, sizeof(filename)))
+	{
+		return NULL;
+	}
+	for (int i = 0; i < 4; i += 1)
+	{
+		VISIT(visitor, counts[i]);
+	}
+	if (visitor->Failed)
+	{
+		return NULL;
+	}
+	return LoadShader(device, filename, counts[0], counts[1], counts[2], counts[3]);
+}
+
+static void PrewarmManifestLine(SDL_GPUDevice* device, const char* line)
+{
+	FieldVisitor visitor;
+	char kind[16];
+	char example[64];
+	InitVisitor(&visitor, FIELDVISIT_PARSE, line);
+
+	if (!ParseToken(&visitor, kind, sizeof(kind)) ||
+		!ParseToken(&visitor, example, sizeof(example)) ||
+		SDL_strcmp(example, CurrentExample) != 0)
+	{
+		return;
+	}
+
+	if (SDL_strcmp(kind, "graphics") == 0)
+	{
+		PipelineDescription description;
+		SDL_zero(description);
+		SDL_GPUShader* vertexShader = ParseAndLoadShader(&visitor, device);
+		SDL_GPUShader* fragmentShader = ParseAndLoadShader(&visitor, device);
+		VisitPipeline(&visitor, &description);
+
+		if (vertexShader != NULL && fragmentShader != NULL && !visitor.Failed)
+		{
+			description.CreateInfo.vertex_shader = vertexShader;
+			description.CreateInfo.fragment_shader = fragmentShader;
+			GetCachedGraphicsPipeline(device, &description.CreateInfo);
+			PrewarmedCount += 1;
+		}
+
+		if (vertexShader != NULL)
+		{
+			SDL_ReleaseGPUShader(device, vertexShader);
+		}
+		if (fragmentShader != NULL)
+		{
+			SDL_ReleaseGPUShader(device, fragmentShader);
+		}
+	}
+	else if (SDL_strcmp(kind, "compute") == 0)
+	{
+		char filename[64];
+		SDL_GPUComputePipelineCreateInfo createInfo;
+		SDL_zero(createInfo);
+		if (ParseToken(&visitor, filename, sizeof(filename)))
+		{
+			VisitComputePipeline(&visitor, &createInfo);
+			if (!visitor.Failed)
+			{
+				GetCachedComputePipeline(device, filename, &createInfo);
+				PrewarmedCount += 1;
+			}
+		}
+	}
+}
+
+static int PrewarmThreadFunction(void* data)
+{
+	SDL_GPUDevice* device = data;
+
+	/* The manifest only grows on the main thread while this runs, so copy the current length */
+	LockCache();
+	Uint32 lineCount = ManifestLineCount;
+	SDL_UnlockMutex(CacheMutex);
+
+	for (Uint32 i = 0; i < lineCount && SDL_GetAtomicInt(&PrewarmCancelled) == 0; i += 1)
+	{
+		LockCache();
+		char* line = SDL_strdup(ManifestLines[i]);
+		SDL_UnlockMutex(CacheMutex);
+
+		PrewarmManifestLine(device, line);
+		SDL_free(line);
+	}
+
+	return 0;
+}
+
+void InitializeStateCache(SDL_GPUDevice* device, const char* exampleName)
+{
+	LockCache();
+	if (!ManifestLoaded)
+	{
+		LoadManifest();
+	}
+	CacheDevice = device;
+	CurrentExample = exampleName;
+	PrewarmedCount = 0;
+	WaitCount = 0;
+	WaitNS = 0;
+	SDL_UnlockMutex(CacheMutex);
+
+	SDL_SetAtomicInt(&PrewarmCancelled, 0);
+	PrewarmThread = SDL_CreateThread(PrewarmThreadFunction, "PipelinePrewarm", device);
+}
+
+// Cached Objects
+
+static void* CreateSamplerObject(SDL_GPUDevice* device, const void* userdata)
+{
+	return SDL_CreateGPUSampler(device, userdata);
+}
+
+static void* CreateGraphicsPipelineObject(SDL_GPUDevice* device, const void* userdata)
+{
+	return SDL_CreateGPUGraphicsPipeline(device, userdata);
+}
+
+typedef struct ComputePipelineRequest
+{
+	const char* ShaderFilename;
+	const SDL_GPUComputePipelineCreateInfo* CreateInfo;
+} ComputePipelineRequest;
+
+static void* CreateComputePipelineObject(SDL_GPUDevice* device, const void* userdata)
+{
+	const ComputePipelineRequest* request = userdata;
+	SDL_GPUComputePipelineCreateInfo createInfo = *request->CreateInfo;
+	return CreateComputePipelineFromShader(device, request->ShaderFilename, &createInfo);
+}
+
+SDL_GPUSampler* GetCachedSampler(SDL_GPUDevice* device, const SDL_GPUSamplerCreateInfo* createInfo)
+{
+	FieldVisitor key;
+	SDL_GPUSamplerCreateInfo copy = *createInfo;
+	InitVisitor(&key, FIELDVISIT_KEY, NULL);
+	VisitSampler(&key, &copy);
+
+	bool created;
+	LockCache();
+	SDL_GPUSampler* sampler = LookupOrCreate(&SamplerCache, device, &key, CreateSamplerObject, createInfo, &created);
+	SDL_UnlockMutex(CacheMutex);
+	return sampler;
+}
+
+SDL_GPUGraphicsPipeline* GetCachedGraphicsPipeline(SDL_GPUDevice* device, const SDL_GPUGraphicsPipelineCreateInfo* createInfo)
+{
+	PipelineDescription description;
+	if (!CopyPipelineDescription(&description, createInfo))
+	{
+		SDL_Log("Pipeline create info is too large to cache!");
+		return NULL;
+	}
+
+	LockCache();
+
+	const ShaderIdentity* vertexShader = GetShaderIdentity(createInfo->vertex_shader);
+	const ShaderIdentity* fragmentShader = GetShaderIdentity(createInfo->fragment_shader);
+	if (vertexShader == NULL || fragmentShader == NULL)
+	{
+		SDL_UnlockMutex(CacheMutex);
+		SDL_Log("GetCachedGraphicsPipeline needs shaders created by LoadShader!");
+		return NULL;
+	}
+
+	Uint64 shaderHashes[2] = { vertexShader->Hash, fragmentShader->Hash };
+	FieldVisitor key;
+	InitVisitor(&key, FIELDVISIT_KEY, NULL);
+	VISIT(&key, shaderHashes);
+	VisitPipeline(&key, &description);
+
+	/* Build the manifest line now, the identities can change once the lock is dropped */
+	FieldVisitor line;
+	InitVisitor(&line, FIELDVISIT_PRINT, NULL);
+	VisitText(&line, "graphics");
+	VisitText(&line, CurrentExample ? CurrentExample : "Unknown");
+	PrintShader(&line, vertexShader);
+	PrintShader(&line, fragmentShader);
+	VisitPipeline(&line, &description);
+
+	bool created;
+	SDL_GPUGraphicsPipeline* pipeline = LookupOrCreate(&PipelineCache, device, &key, CreateGraphicsPipelineObject, createInfo, &created);
+	if (created)
+	{
+		RecordManifestLine(&line);
+	}
+
+	SDL_UnlockMutex(CacheMutex);
+	return pipeline;
+}
+
+SDL_GPUComputePipeline* GetCachedComputePipeline(
+	SDL_GPUDevice* device,
+	const char* shaderFilename,
+	const SDL_GPUComputePipelineCreateInfo* createInfo
+) {
+	SDL_GPUComputePipelineCreateInfo copy = *createInfo;
+
+	FieldVisitor key;
+	InitVisitor(&key, FIELDVISIT_KEY, NULL);
+	VisitComputePipeline(&key, &copy);
+	Uint64 nameHash = HashBytes(STATE_CACHE_HASH_SEED, shaderFilename, SDL_strlen(shaderFilename));
+	VISIT(&key, nameHash);
+
+	FieldVisitor line;
+	InitVisitor(&line, FIELDVISIT_PRINT, NULL);
+	VisitText(&line, "compute");
+
+	LockCache();
+
+	VisitText(&line, CurrentExample ? CurrentExample : "Unknown");
+	VisitText(&line, shaderFilename);
+	VisitComputePipeline(&line, &copy);
+
+	ComputePipelineRequest request = { shaderFilename, createInfo };
+	bool created;
+	SDL_GPUComputePipeline* pipeline = LookupOrCreate(&ComputePipelineCache, device, &key, CreateComputePipelineObject, &request, &created);
+	if (created)
+	{
+		RecordManifestLine(&line);
+	}
+
+	SDL_UnlockMutex(CacheMutex);
+	return pipeline;
+}
+
+void GetStateCacheStats(StateCacheStats* stats)
+{
+	LockCache();
+	stats->SamplerCount = SamplerCache.Count;
+	stats->SamplerHits = SamplerCache.Hits;
+	stats->SamplerMisses = SamplerCache.Misses;
+	stats->SamplerCreationNS = SamplerCache.CreationNS;
+	stats->PipelineCount = PipelineCache.Count + ComputePipelineCache.Count;
+	stats->PipelineHits = PipelineCache.Hits + ComputePipelineCache.Hits;
+	stats->PipelineMisses = PipelineCache.Misses + ComputePipelineCache.Misses;
+	stats->PipelineCreationNS = PipelineCache.CreationNS + ComputePipelineCache.CreationNS;
+	stats->PrewarmedCount = PrewarmedCount;
+	stats->WaitCount = WaitCount;
+	stats->WaitNS = WaitNS;
+	SDL_UnlockMutex(CacheMutex);
+}
+
+static void ClearObjectCache(ObjectCache* cache)
+{
+	for (Uint32 i = 0; i < cache->Capacity; i += 1)
+	{
+		SDL_free(cache->Entries[i].Key);
+	}
+	SDL_free(cache->Entries);
+	SDL_zerop(cache);
+}
+
+void ReleaseStateCache(SDL_GPUDevice* device)
+{
+	if (PrewarmThread != NULL)
+	{
+		SDL_SetAtomicInt(&PrewarmCancelled, 1);
+		SDL_WaitThread(PrewarmThread, NULL);
+		PrewarmThread = NULL;
+	}
+
+	StateCacheStats stats;
+	GetStateCacheStats(&stats);
+
+	Uint32 samplerLookups = stats.SamplerHits + stats.SamplerMisses;
+	Uint32 pipelineLookups = stats.PipelineHits + stats.PipelineMisses;
+	if (samplerLookups > 0 || pipelineLookups > 0)
+	{
+		SDL_Log(
+			"State cache: samplers %u/%u hits, %.2f ms creating; pipelines %u/%u hits, %.2f ms creating",
+			stats.SamplerHits,
+			samplerLookups,
+			stats.SamplerCreationNS / 1e6,
+			stats.PipelineHits,
+			pipelineLookups,
+			stats.PipelineCreationNS / 1e6
+		);
+		SDL_Log(
+			"Pipeline prewarm: %u pipelines from the manifest, %u blocking waits totalling %.2f ms",
+			stats.PrewarmedCount,
+			stats.WaitCount,
+			stats.WaitNS / 1e6
+		);
+	}
+
+	LockCache();
+
+	for (Uint32 i = 0; i < SamplerCache.Capacity; i += 1)
+	{
+		if (SamplerCache.Entries[i].Object != NULL)
+		{
+			SDL_ReleaseGPUSampler(device, SamplerCache.Entries[i].Object);
+		}
+	}
+	for (Uint32 i = 0; i < PipelineCache.Capacity; i += 1)
+	{
+		if (PipelineCache.Entries[i].Object != NULL)
+		{
+			SDL_ReleaseGPUGraphicsPipeline(device, PipelineCache.Entries[i].Object);
+		}
+	}
+	for (Uint32 i = 0; i < ComputePipelineCache.Capacity; i += 1)
+	{
+		if (ComputePipelineCache.Entries[i].Object != NULL)
+		{
+			SDL_ReleaseGPUComputePipeline(device, ComputePipelineCache.Entries[i].Object);
+		}
+	}
+
+	ClearObjectCache(&SamplerCache);
+	ClearObjectCache(&PipelineCache);
+	ClearObjectCache(&ComputePipelineCache);
+
+	SDL_free(ShaderIdentities);
+	ShaderIdentities = NULL;
+	ShaderIdentityCount = 0;
+	ShaderIdentityCapacity = 0;
+	CacheDevice = NULL;
+	CurrentExample = NULL;
+
+	SDL_UnlockMutex(CacheMutex);
+}
@@ -74,22 +74,22 @@ static int Init(Context* context)
 	SDL_ReleaseGPUShader(context->Device, fragmentShader);
 
 	// Load the images
-	SDL_Surface *imageData1 = LoadImage("ravioli.bmp", 4);
-	if (imageData1 == NULL)
+	ImageFile imageData1;
+	if (!OpenImage("ravioli.bmp", &imageData1))
 	{
 		SDL_Log("Could not load first image data!");
 		return -1;
 	}
 
-	SDL_Surface *imageData2 = LoadImage("ravioli_inverted.bmp", 4);
-	if (imageData2 == NULL)
+	ImageFile imageData2;
+	if (!OpenImage("ravioli_inverted.bmp", &imageData2))
 	{
 		SDL_Log("Could not load second image data!");
 		return -1;
 	}
 
-	SDL_assert(imageData1->w == imageData2->w);
-	SDL_assert(imageData1->h == imageData2->h);
+	SDL_assert(imageData1.Width == imageData2.Width);
+	SDL_assert(imageData1.Height == imageData2.Height);
 
 	// Create the GPU resources
 	VertexBuffer = SDL_CreateGPUBuffer(
@@ -111,8 +111,8 @@ static int Init(Context* context)
 	Texture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
 		.type = SDL_GPU_TEXTURETYPE_2D_ARRAY,
 		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
-		.width = imageData1->w,
-		.height = imageData1->h,
+		.width = imageData1.Width,
+		.height = imageData1.Height,
 		.layer_count_or_depth = 2,
 		.num_levels = 1,
 		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
@@ -158,7 +158,7 @@ static int Init(Context* context)
 	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
 
 	// Set up texture data
-	const Uint32 imageSizeInBytes = imageData1->w * imageData1->h * 4;
+	const Uint32 imageSizeInBytes = imageData1.Width * imageData1.Height * 4;
 	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
 		context->Device,
 		&(SDL_GPUTransferBufferCreateInfo) {
@@ -172,8 +172,12 @@ static int Init(Context* context)
 		textureTransferBuffer,
 		false
 	);
-	SDL_memcpy(textureTransferPtr, imageData1->pixels, imageSizeInBytes);
-	SDL_memcpy(textureTransferPtr + imageSizeInBytes, imageData2->pixels, imageSizeInBytes);
+	if (!DecodeImage(&imageData1, textureTransferPtr, imageData1.Width * 4) ||
+		!DecodeImage(&imageData2, textureTransferPtr + imageSizeInBytes, imageData2.Width * 4))
+	{
+		SDL_Log("Could not decode image data!");
+		return -1;
+	}
 	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
 
 	// Upload the transfer data to the GPU resources
@@ -216,8 +220,8 @@ static int Init(Context* context)
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
-			.w = imageData1->w,
-			.h = imageData1->h,
+			.w = imageData1.Width,
+			.h = imageData1.Height,
 			.d = 1
 		},
 		false
@@ -232,15 +236,15 @@ static int Init(Context* context)
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
 			.layer = 1,
-			.w = imageData1->w,
-			.h = imageData1->h,
+			.w = imageData1.Width,
+			.h = imageData1.Height,
 			.d = 1
 		},
 		false
 	);
 
-	SDL_DestroySurface(imageData1);
-	SDL_DestroySurface(imageData2);
+	CloseImage(&imageData1);
+	CloseImage(&imageData2);
 	SDL_EndGPUCopyPass(copyPass);
 	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
 	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
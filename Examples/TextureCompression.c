@@ -0,0 +1,912 @@
+#include "Common.h"
+
+/* Block-compressed textures: a small BC1/BC3/BC7/ASTC 4x4 encoder and a KTX2 reader/writer.
+ *
+ * The encoder favors speed over quality. Every format uses one pair of endpoints per block,
+ * fit to the block's bounding box, and picks per-texel indices by projecting onto the
+ * endpoint axis four texels at a time. That is good enough for runtime encoding and for
+ * the example content; use a dedicated encoder for shipping assets.
+ */
+
+#define KTX2_HEADER_SIZE 80
+#define KTX2_LEVEL_INDEX_SIZE 24
+
+static const Uint8 KTX2Identifier[12] = {
+	0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+
+// VkFormat values used by KTX2
+#define VK_FORMAT_R8G8B8A8_UNORM 37
+#define VK_FORMAT_R8G8B8A8_SRGB 43
+#define VK_FORMAT_BC1_RGB_UNORM_BLOCK 131
+#define VK_FORMAT_BC1_RGB_SRGB_BLOCK 132
+#define VK_FORMAT_BC1_RGBA_UNORM_BLOCK 133
+#define VK_FORMAT_BC1_RGBA_SRGB_BLOCK 134
+#define VK_FORMAT_BC3_UNORM_BLOCK 137
+#define VK_FORMAT_BC3_SRGB_BLOCK 138
+#define VK_FORMAT_BC7_UNORM_BLOCK 145
+#define VK_FORMAT_BC7_SRGB_BLOCK 146
+#define VK_FORMAT_ASTC_4x4_UNORM_BLOCK 157
+#define VK_FORMAT_ASTC_4x4_SRGB_BLOCK 158
+
+/* COMPRESSEDFORMAT_COUNT names the uncompressed fallback */
+static const char* CompressedFormatNames[] = { "BC1", "BC3", "BC7", "ASTC 4x4", "R8G8B8A8" };
+
+const char* GetCompressedFormatName(CompressedFormat format)
+{
+	return CompressedFormatNames[format];
+}
+
+SDL_GPUTextureFormat GetCompressedFormatGPUFormat(CompressedFormat format, bool srgb)
+{
+	switch (format)
+	{
+		case COMPRESSEDFORMAT_BC1:
+			return srgb ? SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC1_RGBA_UNORM;
+		case COMPRESSEDFORMAT_BC3:
+			return srgb ? SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM;
+		case COMPRESSEDFORMAT_BC7:
+			return srgb ? SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM;
+		case COMPRESSEDFORMAT_ASTC_4x4:
+			return srgb ? SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM_SRGB : SDL_GPU_TEXTUREFORMAT_ASTC_4x4_UNORM;
+		default:
+			return SDL_GPU_TEXTUREFORMAT_INVALID;
+	}
+}
+
+static Uint32 GetBlockSize(CompressedFormat format)
+{
+	return format == COMPRESSEDFORMAT_BC1 ? 8 : 16;
+}
+
+static Uint32 GetLevelSize(CompressedFormat format, Uint32 width, Uint32 height)
+{
+	return ((width + 3) / 4) * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+// Block encoding
+
+typedef struct BlockTexels
+{
+	SDL_ALIGNED(16) float Channels[4][16];
+} BlockTexels;
+
+/* Reads a 4x4 block, replicating the edge texels for blocks that hang off the image */
+static void LoadBlock(const Uint8* pixels, Uint32 width, Uint32 height, Uint32 blockX, Uint32 blockY, BlockTexels* block)
+{
+	for (Uint32 i = 0; i < 16; i += 1)
+	{
+		Uint32 x = SDL_min((blockX * 4) + (i % 4), width - 1);
+		Uint32 y = SDL_min((blockY * 4) + (i / 4), height - 1);
+		const Uint8* texel = &pixels[((y * width) + x) * 4];
+		for (Uint32 c = 0; c < 4; c += 1)
+		{
+			block->Channels[c][i] = texel[c];
+		}
+	}
+}
+
+/* Bounding box endpoints over the channels in mask, with the diagonal flipped per channel
+ * to follow the sign of its covariance with the widest channel, then inset slightly.
+ */
+static void FitEndpoints(const BlockTexels* block, const float mask[4], float e0[4], float e1[4])
+{
+	float minValues[4], maxValues[4], means[4];
+	float widestRange = -1.0f;
+	int widest = 0;
+
+	for (int c = 0; c < 4; c += 1)
+	{
+		minValues[c] = 255.0f;
+		maxValues[c] = 0.0f;
+		means[c] = 0.0f;
+		for (int i = 0; i < 16; i += 1)
+		{
+			minValues[c] = SDL_min(minValues[c], block->Channels[c][i]);
+			maxValues[c] = SDL_max(maxValues[c], block->Channels[c][i]);
+			means[c] += block->Channels[c][i] / 16.0f;
+		}
+		if (mask[c] != 0 && (maxValues[c] - minValues[c]) > widestRange)
+		{
+			widestRange = maxValues[c] - minValues[c];
+			widest = c;
+		}
+	}
+
+	for (int c = 0; c < 4; c += 1)
+	{
+		float covariance = 0.0f;
+		for (int i = 0; i < 16; i += 1)
+		{
+			covariance += (block->Channels[c][i] - means[c]) * (block->Channels[widest][i] - means[widest]);
+		}
+
+		float inset = (maxValues[c] - minValues[c]) / 16.0f;
+		float low = minValues[c] + inset;
+		float high = maxValues[c] - inset;
+
+		e0[c] = covariance < 0.0f ? high : low;
+		e1[c] = covariance < 0.0f ? low : high;
+	}
+}
+
+/* Projects every texel onto the e0->e1 axis and quantizes to levels - 1 steps.
+ * Index 0 is e0 and index levels - 1 is e1.
+ */
+static void ComputeIndices(
+	const BlockTexels* block,
+	const float mask[4],
+	const float e0[4],
+	const float e1[4],
+	int levels,
+	Uint8 indices[16]
+) {
+	float axis[4];
+	float lengthSquared = 0.0f;
+	for (int c = 0; c < 4; c += 1)
+	{
+		axis[c] = (e1[c] - e0[c]) * mask[c];
+		lengthSquared += axis[c] * axis[c];
+	}
+
+	if (lengthSquared < 1e-6f)
+	{
+		SDL_memset(indices, 0, 16);
+		return;
+	}
+
+	float scale = (levels - 1) / lengthSquared;
+	int i = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+	__m128 maxIndex = _mm_set1_ps((float) (levels - 1));
+	__m128 zero = _mm_setzero_ps();
+	for (; i < 16; i += 4)
+	{
+		__m128 t = zero;
+		for (int c = 0; c < 4; c += 1)
+		{
+			__m128 texels = _mm_load_ps(&block->Channels[c][i]);
+			__m128 offset = _mm_sub_ps(texels, _mm_set1_ps(e0[c]));
+			t = _mm_add_ps(t, _mm_mul_ps(offset, _mm_set1_ps(axis[c])));
+		}
+		t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(t, _mm_set1_ps(scale)), zero), maxIndex);
+
+		/* Default MXCSR rounding is round-to-nearest */
+		SDL_ALIGNED(16) int rounded[4];
+		_mm_store_si128((__m128i*) rounded, _mm_cvtps_epi32(t));
+		indices[i] = (Uint8) rounded[0];
+		indices[i + 1] = (Uint8) rounded[1];
+		indices[i + 2] = (Uint8) rounded[2];
+		indices[i + 3] = (Uint8) rounded[3];
+	}
+#endif
+
+	for (; i < 16; i += 1)
+	{
+		float t = 0.0f;
+		for (int c = 0; c < 4; c += 1)
+		{
+			t += (block->Channels[c][i] - e0[c]) * axis[c];
+		}
+		t = SDL_clamp(t * scale, 0.0f, (float) (levels - 1));
+		indices[i] = (Uint8) (t + 0.5f);
+	}
+}
+
+typedef struct BitWriter
+{
+	Uint8* Data;
+	Uint32 Position;
+} BitWriter;
+
+/* Appends count bits of value, least significant bit first */
+static void WriteBits(BitWriter* writer, Uint32 value, Uint32 count)
+{
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		if ((value >> i) & 1)
+		{
+			writer->Data[writer->Position / 8] |= (Uint8) (1 << (writer->Position % 8));
+		}
+		writer->Position += 1;
+	}
+}
+
+static Uint16 PackRGB565(const float color[4])
+{
+	Uint32 r = (Uint32) SDL_clamp((color[0] * 31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+	Uint32 g = (Uint32) SDL_clamp((color[1] * 63.0f / 255.0f) + 0.5f, 0.0f, 63.0f);
+	Uint32 b = (Uint32) SDL_clamp((color[2] * 31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+	return (Uint16) ((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(Uint16 packed, float color[4])
+{
+	Uint32 r = (packed >> 11) & 31;
+	Uint32 g = (packed >> 5) & 63;
+	Uint32 b = packed & 31;
+	color[0] = (float) ((r << 3) | (r >> 2));
+	color[1] = (float) ((g << 2) | (g >> 4));
+	color[2] = (float) ((b << 3) | (b >> 2));
+	color[3] = 255.0f;
+}
+
+/* Four-color BC1 block, also used as the color half of BC3 */
+static void EncodeBC1Color(const BlockTexels* block, Uint8* output)
+{
+	static const float mask[4] = { 1, 1, 1, 0 };
+	/* Linear index along c0->c1 to BC1 code: c0, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1, c1 */
+	static const Uint8 codes[4] = { 0, 2, 3, 1 };
+
+	float e0[4], e1[4];
+	FitEndpoints(block, mask, e0, e1);
+
+	Uint16 c0 = PackRGB565(e0);
+	Uint16 c1 = PackRGB565(e1);
+	if (c0 < c1)
+	{
+		Uint16 temp = c0;
+		c0 = c1;
+		c1 = temp;
+	}
+
+	Uint8 indices[16] = { 0 };
+	if (c0 != c1)
+	{
+		UnpackRGB565(c0, e0);
+		UnpackRGB565(c1, e1);
+		ComputeIndices(block, mask, e0, e1, 4, indices);
+	}
+
+	Uint32 packedIndices = 0;
+	for (int i = 0; i < 16; i += 1)
+	{
+		packedIndices |= (Uint32) codes[indices[i]] << (i * 2);
+	}
+
+	output[0] = (Uint8) c0;
+	output[1] = (Uint8) (c0 >> 8);
+	output[2] = (Uint8) c1;
+	output[3] = (Uint8) (c1 >> 8);
+	output[4] = (Uint8) packedIndices;
+	output[5] = (Uint8) (packedIndices >> 8);
+	output[6] = (Uint8) (packedIndices >> 16);
+	output[7] = (Uint8) (packedIndices >> 24);
+}
+
+/* Eight-value BC3 alpha block */
+static void EncodeBC3Alpha(const BlockTexels* block, Uint8* output)
+{
+	static const float mask[4] = { 0, 0, 0, 1 };
+	/* Linear index along a0->a1 to BC3 code: a0, 6 interpolants, a1 */
+	static const Uint8 codes[8] = { 0, 2, 3, 4, 5, 6, 7, 1 };
+
+	float minAlpha = 255.0f;
+	float maxAlpha = 0.0f;
+	for (int i = 0; i < 16; i += 1)
+	{
+		minAlpha = SDL_min(minAlpha, block->Channels[3][i]);
+		maxAlpha = SDL_max(maxAlpha, block->Channels[3][i]);
+	}
+
+	Uint8 a0 = (Uint8) maxAlpha;
+	Uint8 a1 = (Uint8) minAlpha;
+	Uint8 indices[16] = { 0 };
+	if (a0 != a1)
+	{
+		float e0[4] = { 0, 0, 0, a0 };
+		float e1[4] = { 0, 0, 0, a1 };
+		ComputeIndices(block, mask, e0, e1, 8, indices);
+	}
+
+	SDL_memset(output, 0, 8);
+	BitWriter writer = { output, 0 };
+	WriteBits(&writer, a0, 8);
+	WriteBits(&writer, a1, 8);
+	for (int i = 0; i < 16; i += 1)
+	{
+		WriteBits(&writer, codes[indices[i]], 3);
+	}
+}
+
+/* BC7 mode 6: one subset, RGBA 7.7.7.7 endpoints with a unique p-bit each, 4-bit indices */
+static void QuantizeBC7Endpoint(const float endpoint[4], Uint8 quantized[4], Uint8* pbit)
+{
+	float bestError = 0.0f;
+	for (Uint8 p = 0; p < 2; p += 1)
+	{
+		Uint8 candidate[4];
+		float error = 0.0f;
+		for (int c = 0; c < 4; c += 1)
+		{
+			float q = SDL_clamp(((endpoint[c] - p) / 2.0f) + 0.5f, 0.0f, 127.0f);
+			candidate[c] = (Uint8) q;
+			float value = (float) ((candidate[c] << 1) | p);
+			error += (value - endpoint[c]) * (value - endpoint[c]);
+		}
+		if (p == 0 || error < bestError)
+		{
+			bestError = error;
+			SDL_memcpy(quantized, candidate, 4);
+			*pbit = p;
+		}
+	}
+}
+
+static void EncodeBC7(const BlockTexels* block, Uint8* output)
+{
+	static const float mask[4] = { 1, 1, 1, 1 };
+
+	float e0[4], e1[4];
+	FitEndpoints(block, mask, e0, e1);
+
+	Uint8 q0[4], q1[4], p0, p1;
+	QuantizeBC7Endpoint(e0, q0, &p0);
+	QuantizeBC7Endpoint(e1, q1, &p1);
+
+	for (int c = 0; c < 4; c += 1)
+	{
+		e0[c] = (float) ((q0[c] << 1) | p0);
+		e1[c] = (float) ((q1[c] << 1) | p1);
+	}
+
+	Uint8 indices[16];
+	ComputeIndices(block, mask, e0, e1, 16, indices);
+
+	/* The anchor index is stored with its top bit implied zero */
+	if (indices[0] & 8)
+	{
+		Uint8 tempQ[4];
+		SDL_memcpy(tempQ, q0, 4);
+		SDL_memcpy(q0, q1, 4);
+		SDL_memcpy(q1, tempQ, 4);
+		Uint8 tempP = p0;
+		p0 = p1;
+		p1 = tempP;
+		for (int i = 0; i < 16; i += 1)
+		{
+			indices[i] = 15 - indices[i];
+		}
+	}
+
+	SDL_memset(output, 0, 16);
+	BitWriter writer = { output, 0 };
+	WriteBits(&writer, 1 << 6, 7);
+	for (int c = 0; c < 4; c += 1)
+	{
+		WriteBits(&writer, q0[c], 7);
+		WriteBits(&writer, q1[c], 7);
+	}
+	WriteBits(&writer, p0, 1);
+	WriteBits(&writer, p1, 1);
+	for (int i = 0; i < 16; i += 1)
+	{
+		WriteBits(&writer, indices[i], i == 0 ? 3 : 4);
+	}
+}
+
+/* ASTC 4x4: one partition, LDR RGBA direct endpoints (CEM 12) at 8 bits,
+ * and a 4x4 grid of 2-bit weights. Block mode 0x042 encodes that weight grid and range.
+ */
+static void EncodeASTC4x4(const BlockTexels* block, Uint8* output)
+{
+	static const float mask[4] = { 1, 1, 1, 1 };
+
+	float e0[4], e1[4];
+	FitEndpoints(block, mask, e0, e1);
+
+	Uint8 q0[4], q1[4];
+	for (int c = 0; c < 4; c += 1)
+	{
+		q0[c] = (Uint8) SDL_clamp(e0[c] + 0.5f, 0.0f, 255.0f);
+		q1[c] = (Uint8) SDL_clamp(e1[c] + 0.5f, 0.0f, 255.0f);
+		e0[c] = q0[c];
+		e1[c] = q1[c];
+	}
+
+	Uint8 weights[16];
+	ComputeIndices(block, mask, e0, e1, 4, weights);
+
+	/* With the second endpoint's RGB sum lower, the decoder applies blue contraction.
+	 * Swap the endpoints to keep the direct interpretation.
+	 */
+	if (q1[0] + q1[1] + q1[2] < q0[0] + q0[1] + q0[2])
+	{
+		Uint8 temp[4];
+		SDL_memcpy(temp, q0, 4);
+		SDL_memcpy(q0, q1, 4);
+		SDL_memcpy(q1, temp, 4);
+		for (int i = 0; i < 16; i += 1)
+		{
+			weights[i] = 3 - weights[i];
+		}
+	}
+
+	SDL_memset(output, 0, 16);
+	BitWriter writer = { output, 0 };
+	WriteBits(&writer, 0x042, 11);	// Block mode
+	WriteBits(&writer, 0, 2);		// Partition count - 1
+	WriteBits(&writer, 12, 4);		// Color endpoint mode
+	for (int c = 0; c < 4; c += 1)
+	{
+		WriteBits(&writer, q0[c], 8);
+		WriteBits(&writer, q1[c], 8);
+	}
+
+	/* Weights are stored bit-reversed from the top of the block down */
+	for (int i = 0; i < 16; i += 1)
+	{
+		for (int bit = 0; bit < 2; bit += 1)
+		{
+			if ((weights[i] >> bit) & 1)
+			{
+				Uint32 position = 127 - ((i * 2) + bit);
+				output[position / 8] |= (Uint8) (1 << (position % 8));
+			}
+		}
+	}
+}
+
+static void EncodeLevel(CompressedFormat format, const Uint8* pixels, Uint32 width, Uint32 height, Uint8* output)
+{
+	Uint32 blocksX = (width + 3) / 4;
+	Uint32 blocksY = (height + 3) / 4;
+	Uint32 blockSize = GetBlockSize(format);
+
+	for (Uint32 blockY = 0; blockY < blocksY; blockY += 1)
+	{
+		for (Uint32 blockX = 0; blockX < blocksX; blockX += 1)
+		{
+			BlockTexels block;
+			LoadBlock(pixels, width, height, blockX, blockY, &block);
+
+			Uint8* blockOutput = &output[((blockY * blocksX) + blockX) * blockSize];
+			switch (format)
+			{
+				case COMPRESSEDFORMAT_BC1:
+					EncodeBC1Color(&block, blockOutput);
+					break;
+				case COMPRESSEDFORMAT_BC3:
+					EncodeBC3Alpha(&block, blockOutput);
+					EncodeBC1Color(&block, blockOutput + 8);
+					break;
+				case COMPRESSEDFORMAT_BC7:
+					EncodeBC7(&block, blockOutput);
+					break;
+				default:
+					EncodeASTC4x4(&block, blockOutput);
+					break;
+			}
+		}
+	}
+}
+
+/* 2x2 box filter for an RGBA8 image, odd edges repeat the last texel */
+static void DownsampleRGBA8(const Uint8* src, Uint32 srcWidth, Uint32 srcHeight, Uint8* dst)
+{
+	Uint32 dstWidth = SDL_max(srcWidth / 2, 1);
+	Uint32 dstHeight = SDL_max(srcHeight / 2, 1);
+
+	for (Uint32 y = 0; y < dstHeight; y += 1)
+	{
+		Uint32 y0 = SDL_min(y * 2, srcHeight - 1);
+		Uint32 y1 = SDL_min((y * 2) + 1, srcHeight - 1);
+		for (Uint32 x = 0; x < dstWidth; x += 1)
+		{
+			Uint32 x0 = SDL_min(x * 2, srcWidth - 1);
+			Uint32 x1 = SDL_min((x * 2) + 1, srcWidth - 1);
+			for (Uint32 c = 0; c < 4; c += 1)
+			{
+				Uint32 sum =
+					src[((y0 * srcWidth) + x0) * 4 + c] +
+					src[((y0 * srcWidth) + x1) * 4 + c] +
+					src[((y1 * srcWidth) + x0) * 4 + c] +
+					src[((y1 * srcWidth) + x1) * 4 + c];
+				dst[((y * dstWidth) + x) * 4 + c] = (Uint8) ((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+bool EncodeCompressedImage(
+	const Uint8* pixels,
+	Uint32 width,
+	Uint32 height,
+	CompressedFormat format,
+	bool srgb,
+	bool generateMipmaps,
+	CompressedImage* image
+) {
+	SDL_zerop(image);
+	image->Format = GetCompressedFormatGPUFormat(format, srgb);
+	image->BlockFormat = format;
+	image->SRGB = srgb;
+	image->Width = width;
+	image->Height = height;
+	image->LevelCount = 1;
+
+	if (generateMipmaps)
+	{
+		Uint32 largest = SDL_max(width, height);
+		while ((largest >> image->LevelCount) > 0 && image->LevelCount < COMPRESSED_IMAGE_MAX_LEVELS)
+		{
+			image->LevelCount += 1;
+		}
+	}
+
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		image->LevelOffsets[level] = image->DataSize;
+		image->LevelSizes[level] = GetLevelSize(format, SDL_max(width >> level, 1), SDL_max(height >> level, 1));
+		image->DataSize += image->LevelSizes[level];
+	}
+
+	image->Data = SDL_malloc(image->DataSize);
+	Uint8* scratch[2] = {
+		SDL_malloc(width * height * 4),
+		SDL_malloc(width * height * 4)
+	};
+	if (image->Data == NULL || scratch[0] == NULL || scratch[1] == NULL)
+	{
+		SDL_Log("Failed to allocate %u bytes for compressed image!", image->DataSize);
+		SDL_free(scratch[0]);
+		SDL_free(scratch[1]);
+		FreeCompressedImage(image);
+		return false;
+	}
+
+	const Uint8* levelPixels = pixels;
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		Uint32 levelWidth = SDL_max(width >> level, 1);
+		Uint32 levelHeight = SDL_max(height >> level, 1);
+
+		if (level > 0)
+		{
+			Uint8* next = scratch[level % 2];
+			DownsampleRGBA8(levelPixels, SDL_max(width >> (level - 1), 1), SDL_max(height >> (level - 1), 1), next);
+			levelPixels = next;
+		}
+
+		EncodeLevel(format, levelPixels, levelWidth, levelHeight, &image->Data[image->LevelOffsets[level]]);
+	}
+
+	SDL_free(scratch[0]);
+	SDL_free(scratch[1]);
+	return true;
+}
+
+void FreeCompressedImage(CompressedImage* image)
+{
+	SDL_free(image->Data);
+	SDL_zerop(image);
+}
+
+// KTX2 container
+
+static Uint32 ReadU32(const Uint8* data)
+{
+	Uint32 value;
+	SDL_memcpy(&value, data, sizeof(value));
+	return SDL_Swap32LE(value);
+}
+
+static Uint64 ReadU64(const Uint8* data)
+{
+	Uint64 value;
+	SDL_memcpy(&value, data, sizeof(value));
+	return SDL_Swap64LE(value);
+}
+
+static void WriteU32(Uint8* data, Uint32 value)
+{
+	value = SDL_Swap32LE(value);
+	SDL_memcpy(data, &value, sizeof(value));
+}
+
+static void WriteU64(Uint8* data, Uint64 value)
+{
+	value = SDL_Swap64LE(value);
+	SDL_memcpy(data, &value, sizeof(value));
+}
+
+static bool GetFormatFromVkFormat(Uint32 vkFormat, CompressedFormat* format, bool* srgb)
+{
+	switch (vkFormat)
+	{
+		/* Our BC1 blocks are always four-color, so the RGB and RGBA variants decode identically */
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK: *format = COMPRESSEDFORMAT_BC1; *srgb = false; return true;
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK: *format = COMPRESSEDFORMAT_BC1; *srgb = true; return true;
+		case VK_FORMAT_BC3_UNORM_BLOCK: *format = COMPRESSEDFORMAT_BC3; *srgb = false; return true;
+		case VK_FORMAT_BC3_SRGB_BLOCK: *format = COMPRESSEDFORMAT_BC3; *srgb = true; return true;
+		case VK_FORMAT_BC7_UNORM_BLOCK: *format = COMPRESSEDFORMAT_BC7; *srgb = false; return true;
+		case VK_FORMAT_BC7_SRGB_BLOCK: *format = COMPRESSEDFORMAT_BC7; *srgb = true; return true;
+		case VK_FORMAT_ASTC_4x4_UNORM_BLOCK: *format = COMPRESSEDFORMAT_ASTC_4x4; *srgb = false; return true;
+		case VK_FORMAT_ASTC_4x4_SRGB_BLOCK: *format = COMPRESSEDFORMAT_ASTC_4x4; *srgb = true; return true;
+		default: return false;
+	}
+}
+
+static Uint32 GetVkFormat(CompressedFormat format, bool srgb)
+{
+	switch (format)
+	{
+		/* The textures are created as SDL_GPU_TEXTUREFORMAT_BC1_RGBA_*, which decodes the
+		 * c0 <= c1 punch-through mode as transparent; the RGB VkFormat would decode it as opaque */
+		case COMPRESSEDFORMAT_BC1: return srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+		case COMPRESSEDFORMAT_BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+		case COMPRESSEDFORMAT_BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+		default: return srgb ? VK_FORMAT_ASTC_4x4_SRGB_BLOCK : VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+	}
+}
+
+bool LoadKTX2(const char* path, CompressedImage* image)
+{
+	SDL_zerop(image);
+
+	size_t fileSize;
+	Uint8* file = SDL_LoadFile(path, &fileSize);
+	if (file == NULL)
+	{
+		return false;
+	}
+
+	if (fileSize < KTX2_HEADER_SIZE || SDL_memcmp(file, KTX2Identifier, sizeof(KTX2Identifier)) != 0)
+	{
+		SDL_Log("%s is not a KTX2 file!", path);
+		SDL_free(file);
+		return false;
+	}
+
+	Uint32 vkFormat = ReadU32(&file[12]);
+	Uint32 width = ReadU32(&file[20]);
+	Uint32 height = ReadU32(&file[24]);
+	Uint32 depth = ReadU32(&file[28]);
+	Uint32 layerCount = ReadU32(&file[32]);
+	Uint32 faceCount = ReadU32(&file[36]);
+	Uint32 levelCount = SDL_max(ReadU32(&file[40]), 1);
+	Uint32 supercompression = ReadU32(&file[44]);
+
+	CompressedFormat format;
+	bool srgb;
+	if (!GetFormatFromVkFormat(vkFormat, &format, &srgb))
+	{
+		SDL_Log("%s: unsupported VkFormat %u!", path, vkFormat);
+		SDL_free(file);
+		return false;
+	}
+
+	if (width == 0 || height == 0)
+	{
+		SDL_Log("%s: zero width or height!", path);
+		SDL_free(file);
+		return false;
+	}
+
+	if (depth > 1 || layerCount > 1 || faceCount != 1 || supercompression != 0 || levelCount > COMPRESSED_IMAGE_MAX_LEVELS)
+	{
+		SDL_Log("%s: only single 2D textures without supercompression are supported!", path);
+		SDL_free(file);
+		return false;
+	}
+
+	if (fileSize < KTX2_HEADER_SIZE + (KTX2_LEVEL_INDEX_SIZE * levelCount))
+	{
+		SDL_Log("%s: truncated level index!", path);
+		SDL_free(file);
+		return false;
+	}
+
+	/* Level data is used in place, the file buffer becomes the image's data */
+	image->Format = GetCompressedFormatGPUFormat(format, srgb);
+	image->BlockFormat = format;
+	image->SRGB = srgb;
+	image->Width = width;
+	image->Height = height;
+	image->LevelCount = levelCount;
+	image->Data = file;
+
+	for (Uint32 level = 0; level < levelCount; level += 1)
+	{
+		const Uint8* entry = &file[KTX2_HEADER_SIZE + (KTX2_LEVEL_INDEX_SIZE * level)];
+		Uint64 offset = ReadU64(entry);
+		Uint64 length = ReadU64(entry + 8);
+		Uint32 expected = GetLevelSize(format, SDL_max(width >> level, 1), SDL_max(height >> level, 1));
+
+		if (offset > fileSize || length > fileSize - offset || length != expected)
+		{
+			SDL_Log("%s: level %u is out of bounds or has the wrong size!", path, level);
+			FreeCompressedImage(image);
+			return false;
+		}
+
+		image->LevelOffsets[level] = (Uint32) offset;
+		image->LevelSizes[level] = (Uint32) length;
+		image->DataSize += (Uint32) length;
+	}
+
+	return true;
+}
+
+/* Basic Data Format Descriptor for the block formats we write */
+static Uint32 WriteDataFormatDescriptor(Uint8* output, CompressedFormat format, bool srgb)
+{
+	static const Uint8 colorModels[] = { 128, 130, 134, 162 };
+	Uint32 sampleCount = format == COMPRESSEDFORMAT_BC3 ? 2 : 1;
+	Uint32 blockSize = 24 + (16 * sampleCount);
+	Uint32 bytesPerBlock = GetBlockSize(format);
+
+	if (output == NULL)
+	{
+		return 4 + blockSize;
+	}
+
+	SDL_memset(output, 0, 4 + blockSize);
+	WriteU32(&output[0], 4 + blockSize);
+	WriteU32(&output[4], 0);							// Khronos vendor, basic descriptor type
+	WriteU32(&output[8], 2 | (blockSize << 16));		// Version 2, block size
+	output[12] = colorModels[format];
+	output[13] = 1;										// BT.709 primaries
+	output[14] = srgb ? 2 : 1;							// sRGB or linear transfer
+	output[15] = 0;										// Straight alpha
+	output[16] = 3;										// 4x4 texel blocks
+	output[17] = 3;
+	output[20] = (Uint8) bytesPerBlock;
+
+	Uint8* sample = &output[28];
+	for (Uint32 i = 0; i < sampleCount; i += 1)
+	{
+		/* BC3 stores alpha in the first 64 bits, everything else is one 64/128-bit sample.
+		 * BC1 is tagged as BC1A with alpha to match the RGBA VkFormat the file is written with. */
+		bool isAlpha = format == COMPRESSEDFORMAT_BC3 && i == 0;
+		Uint32 bitOffset = (format == COMPRESSEDFORMAT_BC3 && i == 1) ? 64 : 0;
+		Uint32 bitLength = format == COMPRESSEDFORMAT_BC3 ? 64 : bytesPerBlock * 8;
+		Uint32 channel = isAlpha ? 15 : (format == COMPRESSEDFORMAT_BC1 ? 1 : 0);
+
+		WriteU32(&sample[0], bitOffset | ((bitLength - 1) << 16) | (channel << 24));
+		WriteU32(&sample[4], 0);
+		WriteU32(&sample[8], 0);
+		WriteU32(&sample[12], 0xFFFFFFFF);
+		sample += 16;
+	}
+
+	return 4 + blockSize;
+}
+
+bool SaveKTX2(const char* path, const CompressedImage* image)
+{
+	Uint32 blockSize = GetBlockSize(image->BlockFormat);
+	Uint32 dfdOffset = KTX2_HEADER_SIZE + (KTX2_LEVEL_INDEX_SIZE * image->LevelCount);
+	Uint32 dfdSize = WriteDataFormatDescriptor(NULL, image->BlockFormat, image->SRGB);
+
+	/* Levels are stored smallest first, each aligned to the block size */
+	Uint32 levelOffsets[COMPRESSED_IMAGE_MAX_LEVELS];
+	Uint32 fileSize = dfdOffset + dfdSize;
+	for (Uint32 i = image->LevelCount; i > 0; i -= 1)
+	{
+		Uint32 level = i - 1;
+		fileSize = (fileSize + blockSize - 1) / blockSize * blockSize;
+		levelOffsets[level] = fileSize;
+		fileSize += image->LevelSizes[level];
+	}
+
+	Uint8* file = SDL_calloc(1, fileSize);
+	if (file == NULL)
+	{
+		SDL_Log("Failed to allocate %u bytes for %s!", fileSize, path);
+		return false;
+	}
+
+	SDL_memcpy(file, KTX2Identifier, sizeof(KTX2Identifier));
+	WriteU32(&file[12], GetVkFormat(image->BlockFormat, image->SRGB));
+	WriteU32(&file[16], 1);			// typeSize
+	WriteU32(&file[20], image->Width);
+	WriteU32(&file[24], image->Height);
+	WriteU32(&file[28], 0);			// pixelDepth
+	WriteU32(&file[32], 0);			// layerCount
+	WriteU32(&file[36], 1);			// faceCount
+	WriteU32(&file[40], image->LevelCount);
+	WriteU32(&file[44], 0);			// supercompressionScheme
+	WriteU32(&file[48], dfdOffset);
+	WriteU32(&file[52], dfdSize);
+	WriteU32(&file[56], 0);			// No key/value data
+	WriteU32(&file[60], 0);
+	WriteU64(&file[64], 0);			// No supercompression global data
+	WriteU64(&file[72], 0);
+
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		Uint8* entry = &file[KTX2_HEADER_SIZE + (KTX2_LEVEL_INDEX_SIZE * level)];
+		WriteU64(entry, levelOffsets[level]);
+		WriteU64(entry + 8, image->LevelSizes[level]);
+		WriteU64(entry + 16, image->LevelSizes[level]);
+		SDL_memcpy(&file[levelOffsets[level]], &image->Data[image->LevelOffsets[level]], image->LevelSizes[level]);
+	}
+
+	WriteDataFormatDescriptor(&file[dfdOffset], image->BlockFormat, image->SRGB);
+
+	bool result = SDL_SaveFile(path, file, fileSize);
+	if (!result)
+	{
+		SDL_Log("Failed to write %s: %s", path, SDL_GetError());
+	}
+
+	SDL_free(file);
+	return result;
+}
+
+// GPU upload
+
+SDL_GPUTexture* CreateTextureFromCompressedImage(SDL_GPUDevice* device, const CompressedImage* image)
+{
+	SDL_GPUTexture* texture = SDL_CreateGPUTexture(device, &(SDL_GPUTextureCreateInfo){
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = image->Format,
+		.width = image->Width,
+		.height = image->Height,
+		.layer_count_or_depth = 1,
+		.num_levels = image->LevelCount,
+		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
+	});
+	if (texture == NULL)
+	{
+		SDL_Log("Failed to create %s texture: %s", GetCompressedFormatName(image->BlockFormat), SDL_GetError());
+		return NULL;
+	}
+
+	Uint32 uploadSize = 0;
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		uploadSize += image->LevelSizes[level];
+	}
+
+	SDL_GPUTransferBuffer* transferBuffer = SDL_CreateGPUTransferBuffer(
+		device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = uploadSize
+		}
+	);
+
+	Uint8* transferData = SDL_MapGPUTransferBuffer(device, transferBuffer, false);
+	Uint32 offset = 0;
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		SDL_memcpy(&transferData[offset], &image->Data[image->LevelOffsets[level]], image->LevelSizes[level]);
+		offset += image->LevelSizes[level];
+	}
+	SDL_UnmapGPUTransferBuffer(device, transferBuffer);
+
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	offset = 0;
+	for (Uint32 level = 0; level < image->LevelCount; level += 1)
+	{
+		SDL_UploadToGPUTexture(
+			copyPass,
+			&(SDL_GPUTextureTransferInfo) {
+				.transfer_buffer = transferBuffer,
+				.offset = offset
+			},
+			&(SDL_GPUTextureRegion){
+				.texture = texture,
+				.mip_level = level,
+				.w = SDL_max(image->Width >> level, 1),
+				.h = SDL_max(image->Height >> level, 1),
+				.d = 1
+			},
+			false
+		);
+		offset += image->LevelSizes[level];
+	}
+
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+
+	return texture;
+}
@@ -0,0 +1,548 @@
+#include "Common.h"
+
+static SDL_GPUGraphicsPipeline* PerDrawPipeline;
+static SDL_GPUGraphicsPipeline* InstancedPipeline;
+static SDL_GPUBuffer* VertexBuffer;
+static SDL_GPUBuffer* IndexBuffer;
+static SDL_GPUBuffer* TransformBuffer;
+static SDL_GPUBuffer* ColorBuffer;
+static SDL_GPUTransferBuffer* InstanceTransferBuffer;
+static SDL_GPUTexture* Texture;
+static SDL_GPUSampler* Sampler;
+
+static TransformBatch Transforms;
+
+static const Uint32 InstanceCounts[] = { 4, 1024, 16384, 65536 };
+static Sint32 InstanceCountIndex = 0;
+static bool UseInstancing = true;
+
+static float t = 0;
+
+static Uint64 AccumulatedCPUTicks = 0;
+static float AccumulatedFrameTime = 0;
+static Uint32 AccumulatedFrames = 0;
+
+typedef struct FragMultiplyUniform
+{
+	float r, g, b, a;
+} FragMultiplyUniform;
+
+static void ResetInstances(void)
+{
+	Uint32 count = InstanceCounts[InstanceCountIndex];
+	Uint32 perRow = (Uint32) SDL_ceilf(SDL_sqrtf((float) count));
+	float cellSize = 2.0f / perRow;
+
+	/* With four instances this lands on the same quadrants as TexturedAnimatedQuad */
+	Transforms.Count = 0;
+	for (Uint32 i = 0; i < count; i += 1)
+	{
+		TransformBatch_Add(
+			&Transforms,
+			-1.0f + cellSize * ((i % perRow) + 0.5f),
+			-1.0f + cellSize * ((i / perRow) + 0.5f),
+			0,
+			0,
+			cellSize
+		);
+	}
+
+	AccumulatedCPUTicks = 0;
+	AccumulatedFrameTime = 0;
+	AccumulatedFrames = 0;
+
+	SDL_Log("%s, %u quads", UseInstancing ? "Instanced" : "Per-draw", count);
+}
+
+static FragMultiplyUniform GetMultiplyColor(Uint32 i)
+{
+	return (FragMultiplyUniform){ 1.0f, 0.5f + SDL_sinf(t + i * 0.1f) * 0.5f, 1.0f, 1.0f };
+}
+
+static int Init(Context* context)
+{
+	int result = CommonInit(context, 0);
+	if (result < 0)
+	{
+		return result;
+	}
+
+	// Create the shaders
+	SDL_GPUShader* perDrawVertexShader = LoadShader(context->Device, "TexturedQuadWithMatrix.vert", 0, 1, 0, 0);
+	if (perDrawVertexShader == NULL)
+	{
+		SDL_Log("Failed to create per-draw vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* perDrawFragmentShader = LoadShader(context->Device, "TexturedQuadWithMultiplyColor.frag", 1, 1, 0, 0);
+	if (perDrawFragmentShader == NULL)
+	{
+		SDL_Log("Failed to create per-draw fragment shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* instancedVertexShader = LoadShader(context->Device, "TexturedQuadWithMatrixInstanced.vert", 0, 0, 2, 0);
+	if (instancedVertexShader == NULL)
+	{
+		SDL_Log("Failed to create instanced vertex shader!");
+		return -1;
+	}
+
+	SDL_GPUShader* instancedFragmentShader = LoadShader(context->Device, "TexturedQuadColor.frag", 1, 0, 0, 0);
+	if (instancedFragmentShader == NULL)
+	{
+		SDL_Log("Failed to create instanced fragment shader!");
+		return -1;
+	}
+
+	// Load the image
+	SDL_Surface *imageData = LoadImage("ravioli.bmp", 4);
+	if (imageData == NULL)
+	{
+		SDL_Log("Could not load image data!");
+		return -1;
+	}
+
+	// Create the pipelines
+	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
+		.target_info = {
+			.num_color_targets = 1,
+			.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+				.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
+				.blend_state = {
+					.enable_blend = true,
+					.alpha_blend_op = SDL_GPU_BLENDOP_ADD,
+					.color_blend_op = SDL_GPU_BLENDOP_ADD,
+					.src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+					.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+					.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA
+				}
+			}},
+		},
+		.vertex_input_state = (SDL_GPUVertexInputState){
+			.num_vertex_buffers = 1,
+			.vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+				.slot = 0,
+				.input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+				.instance_step_rate = 0,
+				.pitch = sizeof(PositionTextureVertex)
+			}},
+			.num_vertex_attributes = 2,
+			.vertex_attributes = (SDL_GPUVertexAttribute[]){{
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+				.location = 0,
+				.offset = 0
+			}, {
+				.buffer_slot = 0,
+				.format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2,
+				.location = 1,
+				.offset = sizeof(float) * 3
+			}}
+		},
+		.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+		.vertex_shader = perDrawVertexShader,
+		.fragment_shader = perDrawFragmentShader,
+	};
+
+	PerDrawPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (PerDrawPipeline == NULL)
+	{
+		SDL_Log("Failed to create per-draw pipeline!");
+		return -1;
+	}
+
+	pipelineCreateInfo.vertex_shader = instancedVertexShader;
+	pipelineCreateInfo.fragment_shader = instancedFragmentShader;
+	InstancedPipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	if (InstancedPipeline == NULL)
+	{
+		SDL_Log("Failed to create instanced pipeline!");
+		return -1;
+	}
+
+	SDL_ReleaseGPUShader(context->Device, perDrawVertexShader);
+	SDL_ReleaseGPUShader(context->Device, perDrawFragmentShader);
+	SDL_ReleaseGPUShader(context->Device, instancedVertexShader);
+	SDL_ReleaseGPUShader(context->Device, instancedFragmentShader);
+
+	// Create the GPU resources
+	Uint32 maxInstances = InstanceCounts[SDL_arraysize(InstanceCounts) - 1];
+
+	VertexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+			.size = sizeof(PositionTextureVertex) * 4
+		}
+	);
+
+	IndexBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_INDEX,
+			.size = sizeof(Uint16) * 6
+		}
+	);
+
+	TransformBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			.size = sizeof(Matrix4x4) * maxInstances
+		}
+	);
+
+	ColorBuffer = SDL_CreateGPUBuffer(
+		context->Device,
+		&(SDL_GPUBufferCreateInfo) {
+			.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+			.size = sizeof(FragMultiplyUniform) * maxInstances
+		}
+	);
+
+	// Matrices first, then colors, so each frame needs a single map
+	InstanceTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = (sizeof(Matrix4x4) + sizeof(FragMultiplyUniform)) * maxInstances
+		}
+	);
+
+	if (!TransformBatch_Init(&Transforms, maxInstances))
+	{
+		return -1;
+	}
+
+	Texture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+		.width = imageData->w,
+		.height = imageData->h,
+		.layer_count_or_depth = 1,
+		.num_levels = 1,
+		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
+	});
+
+	Sampler = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+		.min_filter = SDL_GPU_FILTER_NEAREST,
+		.mag_filter = SDL_GPU_FILTER_NEAREST,
+		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+		.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+	});
+
+	// Set up buffer data
+	SDL_GPUTransferBuffer* bufferTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = (sizeof(PositionTextureVertex) * 4) + (sizeof(Uint16) * 6)
+		}
+	);
+
+	PositionTextureVertex* transferData = SDL_MapGPUTransferBuffer(
+		context->Device,
+		bufferTransferBuffer,
+		false
+	);
+
+	transferData[0] = (PositionTextureVertex){ -0.5f, -0.5f, 0, 0, 0 };
+	transferData[1] = (PositionTextureVertex){  0.5f, -0.5f, 0, 1, 0 };
+	transferData[2] = (PositionTextureVertex){  0.5f,  0.5f, 0, 1, 1 };
+	transferData[3] = (PositionTextureVertex){ -0.5f,  0.5f, 0, 0, 1 };
+
+	Uint16* indexData = (Uint16*) &transferData[4];
+	indexData[0] = 0;
+	indexData[1] = 1;
+	indexData[2] = 2;
+	indexData[3] = 0;
+	indexData[4] = 2;
+	indexData[5] = 3;
+
+	SDL_UnmapGPUTransferBuffer(context->Device, bufferTransferBuffer);
+
+	// Set up texture data
+	SDL_GPUTransferBuffer* textureTransferBuffer = SDL_CreateGPUTransferBuffer(
+		context->Device,
+		&(SDL_GPUTransferBufferCreateInfo) {
+			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+			.size = imageData->w * imageData->h * 4
+		}
+	);
+
+	Uint8* textureTransferPtr = SDL_MapGPUTransferBuffer(
+		context->Device,
+		textureTransferBuffer,
+		false
+	);
+	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
+	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
+
+	// Upload the transfer data to the GPU resources
+	SDL_GPUCommandBuffer* uploadCmdBuf = SDL_AcquireGPUCommandBuffer(context->Device);
+	SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(uploadCmdBuf);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = 0
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = VertexBuffer,
+			.offset = 0,
+			.size = sizeof(PositionTextureVertex) * 4
+		},
+		false
+	);
+
+	SDL_UploadToGPUBuffer(
+		copyPass,
+		&(SDL_GPUTransferBufferLocation) {
+			.transfer_buffer = bufferTransferBuffer,
+			.offset = sizeof(PositionTextureVertex) * 4
+		},
+		&(SDL_GPUBufferRegion) {
+			.buffer = IndexBuffer,
+			.offset = 0,
+			.size = sizeof(Uint16) * 6
+		},
+		false
+	);
+
+	SDL_UploadToGPUTexture(
+		copyPass,
+		&(SDL_GPUTextureTransferInfo) {
+			.transfer_buffer = textureTransferBuffer,
+			.offset = 0, /* Zeroes out the rest */
+		},
+		&(SDL_GPUTextureRegion){
+			.texture = Texture,
+			.w = imageData->w,
+			.h = imageData->h,
+			.d = 1
+		},
+		false
+	);
+
+	SDL_DestroySurface(imageData);
+	SDL_EndGPUCopyPass(copyPass);
+	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
+	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
+
+	// Print the instructions
+	SDL_Log("Press Left/Right to switch between instanced and per-draw rendering");
+	SDL_Log("Press Up/Down to change the quad count");
+
+	ResetInstances();
+
+	return 0;
+}
+
+static int Update(Context* context)
+{
+	bool changed = false;
+
+	if (context->LeftPressed || context->RightPressed)
+	{
+		UseInstancing = !UseInstancing;
+		changed = true;
+	}
+
+	if (context->UpPressed)
+	{
+		InstanceCountIndex = (InstanceCountIndex + 1) % SDL_arraysize(InstanceCounts);
+		changed = true;
+	}
+	else if (context->DownPressed)
+	{
+		InstanceCountIndex -= 1;
+		if (InstanceCountIndex < 0)
+		{
+			InstanceCountIndex = SDL_arraysize(InstanceCounts) - 1;
+		}
+		changed = true;
+	}
+
+	if (changed)
+	{
+		ResetInstances();
+	}
+
+	t += context->DeltaTime;
+
+	// Alternate quads spin in opposite directions, like the top-right quad in TexturedAnimatedQuad
+	for (Uint32 i = 0; i < Transforms.Count; i += 1)
+	{
+		Transforms.RotationZ[i] = (i % 2 == 0) ? t : (2.0f * SDL_PI_F) - t;
+	}
+
+	return 0;
+}
+
+static int Draw(Context* context)
+{
+	Uint64 cpuStart = SDL_GetPerformanceCounter();
+
+    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+    if (cmdbuf == NULL)
+    {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GPUTexture* swapchainTexture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        return -1;
+    }
+
+	if (swapchainTexture != NULL)
+	{
+		Uint32 count = Transforms.Count;
+
+		if (UseInstancing)
+		{
+			// Write every instance's matrix and color into one cycled transfer buffer
+			Uint8* mapped = SDL_MapGPUTransferBuffer(
+				context->Device,
+				InstanceTransferBuffer,
+				true
+			);
+
+			Matrix4x4* matrices = (Matrix4x4*) mapped;
+			FragMultiplyUniform* colors = (FragMultiplyUniform*) (mapped + sizeof(Matrix4x4) * count);
+
+			TransformBatch_Compute(&Transforms, NULL, matrices, NULL);
+			for (Uint32 i = 0; i < count; i += 1)
+			{
+				colors[i] = GetMultiplyColor(i);
+			}
+
+			SDL_UnmapGPUTransferBuffer(context->Device, InstanceTransferBuffer);
+
+			SDL_GPUCopyPass* copyPass = SDL_BeginGPUCopyPass(cmdbuf);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) {
+					.transfer_buffer = InstanceTransferBuffer,
+					.offset = 0
+				},
+				&(SDL_GPUBufferRegion) {
+					.buffer = TransformBuffer,
+					.offset = 0,
+					.size = sizeof(Matrix4x4) * count
+				},
+				true
+			);
+			SDL_UploadToGPUBuffer(
+				copyPass,
+				&(SDL_GPUTransferBufferLocation) {
+					.transfer_buffer = InstanceTransferBuffer,
+					.offset = sizeof(Matrix4x4) * count
+				},
+				&(SDL_GPUBufferRegion) {
+					.buffer = ColorBuffer,
+					.offset = 0,
+					.size = sizeof(FragMultiplyUniform) * count
+				},
+				true
+			);
+			SDL_EndGPUCopyPass(copyPass);
+		}
+
+		SDL_GPUColorTargetInfo colorTargetInfo = { 0 };
+		colorTargetInfo.texture = swapchainTexture;
+		colorTargetInfo.clear_color = (SDL_FColor){ 0.0f, 0.0f, 0.0f, 1.0f };
+		colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+		colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+		SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+
+		SDL_BindGPUVertexBuffers(renderPass, 0, &(SDL_GPUBufferBinding){ .buffer = VertexBuffer, .offset = 0 }, 1);
+		SDL_BindGPUIndexBuffer(renderPass, &(SDL_GPUBufferBinding){ .buffer = IndexBuffer, .offset = 0 }, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+
+		if (UseInstancing)
+		{
+			SDL_BindGPUGraphicsPipeline(renderPass, InstancedPipeline);
+			SDL_BindGPUVertexStorageBuffers(renderPass, 0, (SDL_GPUBuffer*[]){ TransformBuffer, ColorBuffer }, 2);
+			SDL_BindGPUFragmentSamplers(renderPass, 0, &(SDL_GPUTextureSamplerBinding){ .texture = Texture, .sampler = Sampler }, 1);
+			SDL_DrawGPUIndexedPrimitives(renderPass, 6, count, 0, 0, 0);
+		}
+		else
+		{
+			SDL_BindGPUGraphicsPipeline(renderPass, PerDrawPipeline);
+			SDL_BindGPUFragmentSamplers(renderPass, 0, &(SDL_GPUTextureSamplerBinding){ .texture = Texture, .sampler = Sampler }, 1);
+
+			for (Uint32 i = 0; i < count; i += 1)
+			{
+				Matrix4x4 matrixUniform = Matrix4x4_Multiply(
+					Matrix4x4_Multiply(
+						Matrix4x4_CreateScale(Transforms.ScaleX[i], Transforms.ScaleY[i], Transforms.ScaleZ[i]),
+						Matrix4x4_CreateRotationZ(Transforms.RotationZ[i])
+					),
+					Matrix4x4_CreateTranslation(Transforms.PositionX[i], Transforms.PositionY[i], Transforms.PositionZ[i])
+				);
+				FragMultiplyUniform colorUniform = GetMultiplyColor(i);
+
+				SDL_PushGPUVertexUniformData(cmdbuf, 0, &matrixUniform, sizeof(matrixUniform));
+				SDL_PushGPUFragmentUniformData(cmdbuf, 0, &colorUniform, sizeof(colorUniform));
+				SDL_DrawGPUIndexedPrimitives(renderPass, 6, 1, 0, 0, 0);
+			}
+		}
+
+		SDL_EndGPURenderPass(renderPass);
+	}
+
+	SDL_SubmitGPUCommandBuffer(cmdbuf);
+
+	// Report averaged timings once per second
+	AccumulatedCPUTicks += SDL_GetPerformanceCounter() - cpuStart;
+	AccumulatedFrameTime += context->DeltaTime;
+	AccumulatedFrames += 1;
+	if (AccumulatedFrameTime >= 1.0f)
+	{
+		double cpuMs = (double) AccumulatedCPUTicks * 1000.0 / SDL_GetPerformanceFrequency() / AccumulatedFrames;
+		SDL_Log(
+			"%s, %u quads: CPU %.3f ms/frame, frame %.3f ms",
+			UseInstancing ? "Instanced" : "Per-draw",
+			Transforms.Count,
+			cpuMs,
+			AccumulatedFrameTime * 1000.0f / AccumulatedFrames
+		);
+		AccumulatedCPUTicks = 0;
+		AccumulatedFrameTime = 0;
+		AccumulatedFrames = 0;
+	}
+
+	return 0;
+}
+
+static void Quit(Context* context)
+{
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, PerDrawPipeline);
+	SDL_ReleaseGPUGraphicsPipeline(context->Device, InstancedPipeline);
+	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, TransformBuffer);
+	SDL_ReleaseGPUBuffer(context->Device, ColorBuffer);
+	SDL_ReleaseGPUTransferBuffer(context->Device, InstanceTransferBuffer);
+	SDL_ReleaseGPUTexture(context->Device, Texture);
+	SDL_ReleaseGPUSampler(context->Device, Sampler);
+
+	TransformBatch_Destroy(&Transforms);
+
+	InstanceCountIndex = 0;
+	UseInstancing = true;
+	t = 0;
+
+	CommonQuit(context);
+}
+
+Example TexturedAnimatedQuadInstanced_Example = { "TexturedAnimatedQuadInstanced", Init, Update, Draw, Quit };
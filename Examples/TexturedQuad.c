@@ -41,9 +41,9 @@ static int Init(Context* context)
 		return -1;
 	}
 
-	// Load the image
-	SDL_Surface *imageData = LoadImage("ravioli.bmp", 4);
-	if (imageData == NULL)
+	// Open the image, its pixels are decoded straight into the transfer buffer below
+	ImageFile imageData;
+	if (!OpenImage("ravioli.bmp", &imageData))
 	{
 		SDL_Log("Could not load image data!");
 		return -1;
@@ -83,7 +83,7 @@ static int Init(Context* context)
 		.fragment_shader = fragmentShader
 	};
 
-	Pipeline = SDL_CreateGPUGraphicsPipeline(context->Device, &pipelineCreateInfo);
+	Pipeline = GetCachedGraphicsPipeline(context->Device, &pipelineCreateInfo);
 	if (Pipeline == NULL)
 	{
 		SDL_Log("Failed to create pipeline!");
@@ -94,7 +94,7 @@ static int Init(Context* context)
 	SDL_ReleaseGPUShader(context->Device, fragmentShader);
 
 	// PointClamp
-	Samplers[0] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[0] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_NEAREST,
 		.mag_filter = SDL_GPU_FILTER_NEAREST,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
@@ -103,7 +103,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
 	});
 	// PointWrap
-	Samplers[1] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[1] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_NEAREST,
 		.mag_filter = SDL_GPU_FILTER_NEAREST,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
@@ -112,7 +112,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
 	});
 	// LinearClamp
-	Samplers[2] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[2] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -121,7 +121,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
 	});
 	// LinearWrap
-	Samplers[3] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[3] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -130,7 +130,7 @@ static int Init(Context* context)
 		.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_REPEAT,
 	});
 	// AnisotropicClamp
-	Samplers[4] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[4] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -141,7 +141,7 @@ static int Init(Context* context)
 		.max_anisotropy = 4
 	});
 	// AnisotropicWrap
-	Samplers[5] = SDL_CreateGPUSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
+	Samplers[5] = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){
 		.min_filter = SDL_GPU_FILTER_LINEAR,
 		.mag_filter = SDL_GPU_FILTER_LINEAR,
 		.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
@@ -177,8 +177,8 @@ static int Init(Context* context)
 	Texture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
 		.type = SDL_GPU_TEXTURETYPE_2D,
 		.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
-		.width = imageData->w,
-		.height = imageData->h,
+		.width = imageData.Width,
+		.height = imageData.Height,
 		.layer_count_or_depth = 1,
 		.num_levels = 1,
 		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
@@ -224,7 +224,7 @@ static int Init(Context* context)
 		context->Device,
 		&(SDL_GPUTransferBufferCreateInfo) {
 			.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-			.size = imageData->w * imageData->h * 4
+			.size = imageData.Width * imageData.Height * 4
 		}
 	);
 
@@ -233,7 +233,11 @@ static int Init(Context* context)
 		textureTransferBuffer,
 		false
 	);
-	SDL_memcpy(textureTransferPtr, imageData->pixels, imageData->w * imageData->h * 4);
+	if (!DecodeImage(&imageData, textureTransferPtr, imageData.Width * 4))
+	{
+		SDL_Log("Could not decode image data!");
+		return -1;
+	}
 	SDL_UnmapGPUTransferBuffer(context->Device, textureTransferBuffer);
 
 	// Upload the transfer data to the GPU resources
@@ -276,8 +280,8 @@ static int Init(Context* context)
 		},
 		&(SDL_GPUTextureRegion){
 			.texture = Texture,
-			.w = imageData->w,
-			.h = imageData->h,
+			.w = imageData.Width,
+			.h = imageData.Height,
 			.d = 1
 		},
 		false
@@ -285,7 +289,7 @@ static int Init(Context* context)
 
 	SDL_EndGPUCopyPass(copyPass);
 	SDL_SubmitGPUCommandBuffer(uploadCmdBuf);
-	SDL_DestroySurface(imageData);
+	CloseImage(&imageData);
 	SDL_ReleaseGPUTransferBuffer(context->Device, bufferTransferBuffer);
 	SDL_ReleaseGPUTransferBuffer(context->Device, textureTransferBuffer);
 
@@ -358,16 +362,11 @@ static int Draw(Context* context)
 
 static void Quit(Context* context)
 {
-	SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipeline);
 	SDL_ReleaseGPUBuffer(context->Device, VertexBuffer);
 	SDL_ReleaseGPUBuffer(context->Device, IndexBuffer);
 	SDL_ReleaseGPUTexture(context->Device, Texture);
 
-	for (int i = 0; i < SDL_arraysize(Samplers); i += 1)
-	{
-		SDL_ReleaseGPUSampler(context->Device, Samplers[i]);
-	}
-
+	// The pipeline and samplers belong to the state cache, which CommonQuit releases
 	CurrentSamplerIndex = 0;
 
 	CommonQuit(context);
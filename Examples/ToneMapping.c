@@ -4,8 +4,7 @@
 #include "SDL_gpu_shadercross.h" /* SDL_ShaderCross_GetSPIRVShaderFormats() */
 
 static SDL_GPUTexture* HDRTexture;
-static SDL_GPUTexture* ToneMapTexture;
-static SDL_GPUTexture* TransferTexture;
+static ComputePresenter Presenter;
 
 static SDL_GPUSwapchainComposition swapchainCompositions[] =
 {
@@ -40,8 +39,67 @@ static SDL_GPUComputePipeline* currentTonemapOperator;
 static SDL_GPUComputePipeline* LinearToSRGBPipeline;
 static SDL_GPUComputePipeline* LinearToST2084Pipeline;
 
+/* ToneMap.frag variants, one per operator, for the current swapchain format and transfer function */
+static SDL_GPUGraphicsPipeline* tonemapDrawPipelines[sizeof(tonemapOperatorNames)/sizeof(char*)];
+
 static int w, h;
 
+/* Constant 1 of ToneMap.frag: 0 for a linear swapchain, 1 for LinearToSRGB, 2 for LinearToST2084 */
+static int GetTransferFunction(void)
+{
+	switch (currentSwapchainComposition)
+	{
+		case SDL_GPU_SWAPCHAINCOMPOSITION_SDR: return 1;
+		case SDL_GPU_SWAPCHAINCOMPOSITION_HDR10_ST2048: return 2;
+		default: return 0;
+	}
+}
+
+/* The swapchain format and transfer function follow the composition, so these are rebuilt
+ * whenever it changes. The state cache keeps the old ones, so switching back is free.
+ */
+static void BuildDrawPipelines(Context* context)
+{
+	SDL_GPUShader* vertexShader = LoadShader(context->Device, "Fullscreen.vert", 0, 0, 0, 0);
+	SDL_GPUTextureFormat format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window);
+
+	for (Sint32 i = 0; i < tonemapOperatorCount; i += 1)
+	{
+		tonemapDrawPipelines[i] = NULL;
+
+		char variantName[64];
+		SDL_snprintf(variantName, sizeof(variantName), "ToneMap.frag:0=%d,1=%d", (int) i, GetTransferFunction());
+		SDL_GPUShader* fragmentShader = LoadShader(context->Device, variantName, 0, 0, 0, 0);
+		if (vertexShader != NULL && fragmentShader != NULL)
+		{
+			tonemapDrawPipelines[i] = GetCachedGraphicsPipeline(context->Device, &(SDL_GPUGraphicsPipelineCreateInfo){
+				.target_info = {
+					.num_color_targets = 1,
+					.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+						.format = format
+					}},
+				},
+				.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST,
+				.vertex_shader = vertexShader,
+				.fragment_shader = fragmentShader
+			});
+		}
+		if (fragmentShader != NULL)
+		{
+			SDL_ReleaseGPUShader(context->Device, fragmentShader);
+		}
+		if (tonemapDrawPipelines[i] == NULL)
+		{
+			SDL_Log("Failed to create the %s fragment pipeline, it will tonemap through compute + blit", tonemapOperatorNames[i]);
+		}
+	}
+
+	if (vertexShader != NULL)
+	{
+		SDL_ReleaseGPUShader(context->Device, vertexShader);
+	}
+}
+
 static void ChangeSwapchainComposition(Context* context, Uint32 selectionIndex)
 {
 	if (SDL_WindowSupportsGPUSwapchainComposition(context->Device, context->Window, swapchainCompositions[selectionIndex]))
@@ -49,6 +107,7 @@ static void ChangeSwapchainComposition(Context* context, Uint32 selectionIndex)
 		currentSwapchainComposition = swapchainCompositions[selectionIndex];
 		SDL_Log("Changing swapchain composition to %s", swapchainCompositionNames[selectionIndex]);
 		SDL_SetGPUSwapchainParameters(context->Device, context->Window, currentSwapchainComposition, SDL_GPU_PRESENTMODE_VSYNC);
+		BuildDrawPipelines(context);
 	}
 	else
 	{
@@ -64,16 +123,11 @@ static void ChangeTonemapOperator(Context* context, Uint32 selectionIndex)
 
 static SDL_GPUComputePipeline* BuildPostProcessComputePipeline(SDL_GPUDevice *device, const char* spvFile)
 {
-	return CreateComputePipelineFromShader(
+	return GetCachedComputePipeline(
 		device,
 		spvFile,
-		&(SDL_GPUComputePipelineCreateInfo){
-			.num_readonly_storage_textures = 1,
-			.num_readwrite_storage_textures = 1,
-			.threadcount_x = 8,
-			.threadcount_y = 8,
-			.threadcount_z = 1,
-		}
+		// Bindings and group size are reflected from the SPIR-V
+		&(SDL_GPUComputePipelineCreateInfo){ 0 }
 	);
 }
 
@@ -87,6 +141,9 @@ static int Init(Context* context)
 		return -1;
 	}
 
+	/* Start building the pipelines from earlier runs while the HDR image loads */
+	InitializeStateCache(context->Device, context->ExampleName);
+
     int img_x, img_y, n;
     float *hdrImageData = LoadHDRImage("memorial.hdr", &img_x, &img_y, &n, 4);
 
@@ -135,25 +192,14 @@ static int Init(Context* context)
         .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ
     });
 
-	ToneMapTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
-		.type = SDL_GPU_TEXTURETYPE_2D,
-		.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
-		.width = img_x,
-		.height = img_y,
-		.layer_count_or_depth = 1,
-		.num_levels = 1,
-		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
-	});
-
-	TransferTexture = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
-		.type = SDL_GPU_TEXTURETYPE_2D,
-		.format = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window),
-		.width = img_x,
-		.height = img_y,
-		.layer_count_or_depth = 1,
-		.num_levels = 1,
-		.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
-	});
+
+	/* Tonemapping ends in a fragment pass on the swapchain, or in compute passes whose
+	 * output the presenter blits to it when that pipeline is unavailable
+	 */
+	if (!ComputePresenter_Init(&Presenter, context->Device, context->Window))
+	{
+		return -1;
+	}
 
     SDL_ReleaseGPUShader(context->Device, vertexShader);
     SDL_ReleaseGPUShader(context->Device, fragmentShader);
@@ -200,16 +246,21 @@ static int Init(Context* context)
 
     SDL_ReleaseGPUTransferBuffer(context->Device, imageDataTransferBuffer);
 
-	tonemapOperators[0] = BuildPostProcessComputePipeline(context->Device, "ToneMapReinhard.comp");
-	tonemapOperators[1] = BuildPostProcessComputePipeline(context->Device, "ToneMapExtendedReinhardLuminance.comp");
-	tonemapOperators[2] = BuildPostProcessComputePipeline(context->Device, "ToneMapHable.comp");
-	tonemapOperators[3] = BuildPostProcessComputePipeline(context->Device, "ToneMapACES.comp");
+	/* One source, specialized per operator. Constant 0 picks the operator, in tonemapOperatorNames order */
+	for (Sint32 i = 0; i < tonemapOperatorCount; i += 1)
+	{
+		char variantName[64];
+		SDL_snprintf(variantName, sizeof(variantName), "ToneMap.comp:0=%d", (int) i);
+		tonemapOperators[i] = BuildPostProcessComputePipeline(context->Device, variantName);
+	}
 
 	currentTonemapOperator = tonemapOperators[0];
 
 	LinearToSRGBPipeline = BuildPostProcessComputePipeline(context->Device, "LinearToSRGB.comp");
 	LinearToST2084Pipeline = BuildPostProcessComputePipeline(context->Device, "LinearToST2084.comp");
 
+	BuildDrawPipelines(context);
+
 	SDL_Log("Press Left/Right to cycle swapchain composition");
 	SDL_Log("Press Up/Down to cycle tonemap operators");
 
@@ -256,122 +307,169 @@ static int Update(Context* context)
     return 0;
 }
 
-static int Draw(Context* context)
+/* The fallback: tonemap, and transfer to the target color space if necessary, in compute
+ * passes, then blit the result to the swapchain
+ */
+static void ToneMapCompute(Context* context, SDL_GPUCommandBuffer* cmdbuf, SDL_GPUTexture* swapchainTexture)
 {
-    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
-    if (cmdbuf == NULL)
-    {
-        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
-        return -1;
-    }
+	bool needsTransfer =
+		currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_SDR ||
+		currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_HDR10_ST2048;
+
+	/* Tonemap, straight to the presenter's intermediate when no transfer function follows.
+	 * Otherwise into a pooled target that only lives until the transfer pass has read it.
+	 */
+	SDL_GPUTexture* toneMapTexture = NULL;
+	SDL_GPUStorageTextureReadWriteBinding tonemapBinding;
+	if (needsTransfer)
+	{
+		toneMapTexture = AcquireRenderTarget(context->Device, &(RenderTargetDescription){
+			.Format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT,
+			.Width = w,
+			.Height = h,
+			.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+			.Usage = SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE
+		});
+		tonemapBinding = (SDL_GPUStorageTextureReadWriteBinding){ .texture = toneMapTexture };
+	}
+	else
+	{
+		tonemapBinding = ComputePresenter_BeginCompute(&Presenter, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, w, h);
+	}
 
-    SDL_GPUTexture* swapchainTexture;
-    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
-        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
-        return -1;
-    }
+	if (tonemapBinding.texture == NULL)
+	{
+		return;
+	}
 
-    if (swapchainTexture != NULL)
-    {
-		/* Tonemap */
-		SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+	SDL_GPUComputePass* computePass = SDL_BeginGPUComputePass(
+		cmdbuf,
+		&tonemapBinding,
+		1,
+		NULL,
+		0
+	);
+
+	SDL_BindGPUComputePipeline(computePass, currentTonemapOperator);
+	SDL_BindGPUComputeStorageTextures(
+		computePass,
+		0,
+		&HDRTexture,
+		1
+	);
+	SDL_DispatchGPUCompute(computePass, w / 8, h / 8, 1);
+	SDL_EndGPUComputePass(computePass);
+
+	/* Transfer to target color space if necessary */
+	if (needsTransfer)
+	{
+		/* LinearToSRGB writes rgba8, LinearToST2084 rgb10_a2 */
+		SDL_GPUStorageTextureReadWriteBinding transferBinding = ComputePresenter_BeginCompute(
+			&Presenter,
+			currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_SDR ?
+				SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM :
+				SDL_GPU_TEXTUREFORMAT_R10G10B10A2_UNORM,
+			w,
+			h
+		);
+
+		if (transferBinding.texture == NULL)
+		{
+			ReleaseRenderTarget(toneMapTexture);
+			return;
+		}
+
+		computePass = SDL_BeginGPUComputePass(
 			cmdbuf,
-			(SDL_GPUStorageTextureReadWriteBinding[]){{
-				.texture = ToneMapTexture,
-				.cycle = true
-			}},
+			&transferBinding,
 			1,
 			NULL,
 			0
 		);
 
-		SDL_BindGPUComputePipeline(computePass, currentTonemapOperator);
+		if (currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_SDR)
+		{
+			SDL_BindGPUComputePipeline(computePass, LinearToSRGBPipeline);
+		}
+		else
+		{
+			SDL_BindGPUComputePipeline(computePass, LinearToST2084Pipeline);
+		}
+
 		SDL_BindGPUComputeStorageTextures(
 			computePass,
 			0,
-			&HDRTexture,
+			&toneMapTexture,
 			1
 		);
 		SDL_DispatchGPUCompute(computePass, w / 8, h / 8, 1);
 		SDL_EndGPUComputePass(computePass);
 
-		SDL_GPUTexture* BlitSourceTexture = ToneMapTexture;
-
-		/* Transfer to target color space if necessary */
-		if (
-			currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_SDR ||
-			currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_HDR10_ST2048
-		) {
-			computePass = SDL_BeginGPUComputePass(
-				cmdbuf,
-				(SDL_GPUStorageTextureReadWriteBinding[]){{
-					.texture = TransferTexture,
-					.cycle = true
-				}},
-				1,
-				NULL,
-				0
-			);
+		ReleaseRenderTarget(toneMapTexture);
+	}
+
+	/* Blit to swapchain */
+	ComputePresenter_End(&Presenter, cmdbuf, swapchainTexture, SDL_GPU_FILTER_NEAREST);
+}
 
-			if (currentSwapchainComposition == SDL_GPU_SWAPCHAINCOMPOSITION_SDR)
-			{
-				SDL_BindGPUComputePipeline(computePass, LinearToSRGBPipeline);
-			}
-			else
-			{
-				SDL_BindGPUComputePipeline(computePass, LinearToST2084Pipeline);
-			}
-
-			SDL_BindGPUComputeStorageTextures(
-				computePass,
+static int Draw(Context* context)
+{
+    SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+    if (cmdbuf == NULL)
+    {
+        SDL_Log("AcquireGPUCommandBuffer failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    SDL_GPUTexture* swapchainTexture;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdbuf, context->Window, &swapchainTexture)) {
+        SDL_Log("AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
+        return -1;
+    }
+
+    if (swapchainTexture != NULL)
+    {
+		SDL_GPUGraphicsPipeline* drawPipeline = tonemapDrawPipelines[tonemapOperatorSelectionIndex];
+		if (ComputePresenter_CanDraw(&Presenter, drawPipeline))
+		{
+			/* Tonemap and transfer in one pass, straight into the swapchain */
+			SDL_GPURenderPass* renderPass = ComputePresenter_BeginDraw(&Presenter, cmdbuf, swapchainTexture);
+			SDL_BindGPUGraphicsPipeline(renderPass, drawPipeline);
+			SDL_BindGPUFragmentSamplers(
+				renderPass,
 				0,
-				&ToneMapTexture,
+				&(SDL_GPUTextureSamplerBinding){
+					.texture = HDRTexture,
+					.sampler = GetCachedSampler(context->Device, &(SDL_GPUSamplerCreateInfo){ 0 })
+				},
 				1
 			);
-			SDL_DispatchGPUCompute(computePass, w / 8, h / 8, 1);
-			SDL_EndGPUComputePass(computePass);
-
-			BlitSourceTexture = TransferTexture;
+			SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+			ComputePresenter_End(&Presenter, cmdbuf, swapchainTexture, SDL_GPU_FILTER_NEAREST);
+		}
+		else
+		{
+			ToneMapCompute(context, cmdbuf, swapchainTexture);
 		}
-
-		int swapchainWidth, swapchainHeight;
-		SDL_GetWindowSizeInPixels(context->Window, &swapchainWidth, &swapchainHeight);
-
-		/* Blit to swapchain */
-		SDL_BlitGPUTexture(
-			cmdbuf,
-			&(SDL_GPUBlitInfo){
-				.source.texture = BlitSourceTexture,
-				.source.w = w,
-				.source.h = h,
-				.destination.texture = swapchainTexture,
-				.destination.w = swapchainWidth,
-				.destination.h = swapchainHeight,
-				.load_op = SDL_GPU_LOADOP_DONT_CARE,
-				.filter = SDL_GPU_FILTER_NEAREST
-			}
-		);
     }
 
-    SDL_SubmitGPUCommandBuffer(cmdbuf);
+    if (!ComputePresenter_Submit(&Presenter, cmdbuf))
+    {
+        return -1;
+    }
 
     return 0;
 }
 
 static void Quit(Context* context)
 {
-	for (Sint32 i = 0; i < tonemapOperatorCount; i += 1)
-	{
-		SDL_ReleaseGPUComputePipeline(context->Device, tonemapOperators[i]);
-	}
-
-	SDL_ReleaseGPUComputePipeline(context->Device, LinearToSRGBPipeline);
-	SDL_ReleaseGPUComputePipeline(context->Device, LinearToST2084Pipeline);
+	// The pipelines and sampler belong to the state cache, which is released below
 
     SDL_ReleaseGPUTexture(context->Device, HDRTexture);
-	SDL_ReleaseGPUTexture(context->Device, ToneMapTexture);
-	SDL_ReleaseGPUTexture(context->Device, TransferTexture);
+	ComputePresenter_Destroy(&Presenter);
 
+    ReleaseRenderTargetPool(context->Device);
+    ReleaseStateCache(context->Device);
     SDL_ReleaseWindowFromGPUDevice(context->Device, context->Window);
     SDL_DestroyWindow(context->Window);
     SDL_DestroyGPUDevice(context->Device);
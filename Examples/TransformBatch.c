@@ -0,0 +1,222 @@
+#include "Common.h"
+
+/* Structure-of-arrays transform storage.
+ * Every component lives in its own tightly packed float array so that
+ * four objects can be loaded into a single SIMD register at a time.
+ */
+
+static Uint32 RoundUpToFour(Uint32 value)
+{
+	return (value + 3) & ~3u;
+}
+
+bool TransformBatch_Init(TransformBatch* batch, Uint32 capacity)
+{
+	SDL_zerop(batch);
+
+	/* Padding the arrays to a multiple of four lets the SIMD loop read past Count safely */
+	Uint32 paddedCapacity = RoundUpToFour(capacity);
+	float** arrays[] = {
+		&batch->PositionX,
+		&batch->PositionY,
+		&batch->PositionZ,
+		&batch->RotationZ,
+		&batch->ScaleX,
+		&batch->ScaleY,
+		&batch->ScaleZ
+	};
+
+	for (Uint32 i = 0; i < SDL_arraysize(arrays); i += 1)
+	{
+		*arrays[i] = SDL_aligned_alloc(16, sizeof(float) * paddedCapacity);
+		if (*arrays[i] == NULL)
+		{
+			SDL_Log("Failed to allocate transform batch of %u objects!", capacity);
+			TransformBatch_Destroy(batch);
+			return false;
+		}
+		SDL_memset(*arrays[i], 0, sizeof(float) * paddedCapacity);
+	}
+
+	batch->Capacity = capacity;
+	batch->Count = 0;
+
+	return true;
+}
+
+void TransformBatch_Destroy(TransformBatch* batch)
+{
+	SDL_aligned_free(batch->PositionX);
+	SDL_aligned_free(batch->PositionY);
+	SDL_aligned_free(batch->PositionZ);
+	SDL_aligned_free(batch->RotationZ);
+	SDL_aligned_free(batch->ScaleX);
+	SDL_aligned_free(batch->ScaleY);
+	SDL_aligned_free(batch->ScaleZ);
+	SDL_zerop(batch);
+}
+
+Uint32 TransformBatch_Add(TransformBatch* batch, float x, float y, float z, float rotationZ, float scale)
+{
+	SDL_assert(batch->Count < batch->Capacity);
+
+	Uint32 index = batch->Count;
+	batch->PositionX[index] = x;
+	batch->PositionY[index] = y;
+	batch->PositionZ[index] = z;
+	batch->RotationZ[index] = rotationZ;
+	batch->ScaleX[index] = scale;
+	batch->ScaleY[index] = scale;
+	batch->ScaleZ[index] = scale;
+	batch->Count += 1;
+
+	return index;
+}
+
+/* Builds World = Scale * RotationZ * Translation for one object.
+ * This is the same result as chaining the Matrix4x4_Create* helpers,
+ * minus all of the multiplications against zero.
+ */
+static void ComputeWorldScalar(const TransformBatch* batch, Uint32 i, Matrix4x4* world)
+{
+	float s = SDL_sinf(batch->RotationZ[i]);
+	float c = SDL_cosf(batch->RotationZ[i]);
+
+	*world = (Matrix4x4) {
+		batch->ScaleX[i] * c, batch->ScaleX[i] * s, 0, 0,
+		batch->ScaleY[i] * -s, batch->ScaleY[i] * c, 0, 0,
+		0, 0, batch->ScaleZ[i], 0,
+		batch->PositionX[i], batch->PositionY[i], batch->PositionZ[i], 1
+	};
+}
+
+#ifdef SDL_SSE_INTRINSICS
+/* Writes one matrix row for four objects, transposing from SoA lanes to AoS matrices */
+static void StoreRows(Matrix4x4* out, Uint32 row, __m128 a, __m128 b, __m128 c, __m128 d)
+{
+	_MM_TRANSPOSE4_PS(a, b, c, d);
+	_mm_storeu_ps(&out[0].m11 + (row * 4), a);
+	_mm_storeu_ps(&out[1].m11 + (row * 4), b);
+	_mm_storeu_ps(&out[2].m11 + (row * 4), c);
+	_mm_storeu_ps(&out[3].m11 + (row * 4), d);
+}
+
+static void ComputeFourSSE(
+	const TransformBatch* batch,
+	Uint32 i,
+	const Matrix4x4* viewProjection,
+	Matrix4x4* worldOut,
+	Matrix4x4* wvpOut
+) {
+	/* There is no vector sin/cos in SSE, so the trig happens per lane */
+	SDL_ALIGNED(16) float sinValues[4];
+	SDL_ALIGNED(16) float cosValues[4];
+	for (Uint32 lane = 0; lane < 4; lane += 1)
+	{
+		sinValues[lane] = SDL_sinf(batch->RotationZ[i + lane]);
+		cosValues[lane] = SDL_cosf(batch->RotationZ[i + lane]);
+	}
+
+	__m128 s = _mm_load_ps(sinValues);
+	__m128 c = _mm_load_ps(cosValues);
+	__m128 sx = _mm_load_ps(&batch->ScaleX[i]);
+	__m128 sy = _mm_load_ps(&batch->ScaleY[i]);
+	__m128 sz = _mm_load_ps(&batch->ScaleZ[i]);
+	__m128 px = _mm_load_ps(&batch->PositionX[i]);
+	__m128 py = _mm_load_ps(&batch->PositionY[i]);
+	__m128 pz = _mm_load_ps(&batch->PositionZ[i]);
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+
+	/* Non-zero terms of the world matrix */
+	__m128 w11 = _mm_mul_ps(sx, c);
+	__m128 w12 = _mm_mul_ps(sx, s);
+	__m128 w21 = _mm_sub_ps(zero, _mm_mul_ps(sy, s));
+	__m128 w22 = _mm_mul_ps(sy, c);
+
+	if (worldOut != NULL)
+	{
+		Matrix4x4* out = &worldOut[i];
+		StoreRows(out, 0, w11, w12, zero, zero);
+		StoreRows(out, 1, w21, w22, zero, zero);
+		StoreRows(out, 2, zero, zero, sz, zero);
+		StoreRows(out, 3, px, py, pz, one);
+	}
+
+	if (wvpOut != NULL)
+	{
+		const float* vp = &viewProjection->m11;
+		Matrix4x4* out = &wvpOut[i];
+
+		/* WVP row r = sum over k of World[r][k] * VP row k, with the zero terms skipped */
+		__m128 column[4];
+		for (Uint32 col = 0; col < 4; col += 1)
+		{
+			__m128 vp0 = _mm_set1_ps(vp[0 * 4 + col]);
+			__m128 vp1 = _mm_set1_ps(vp[1 * 4 + col]);
+			column[col] = _mm_add_ps(_mm_mul_ps(w11, vp0), _mm_mul_ps(w12, vp1));
+		}
+		StoreRows(out, 0, column[0], column[1], column[2], column[3]);
+
+		for (Uint32 col = 0; col < 4; col += 1)
+		{
+			__m128 vp0 = _mm_set1_ps(vp[0 * 4 + col]);
+			__m128 vp1 = _mm_set1_ps(vp[1 * 4 + col]);
+			column[col] = _mm_add_ps(_mm_mul_ps(w21, vp0), _mm_mul_ps(w22, vp1));
+		}
+		StoreRows(out, 1, column[0], column[1], column[2], column[3]);
+
+		for (Uint32 col = 0; col < 4; col += 1)
+		{
+			column[col] = _mm_mul_ps(sz, _mm_set1_ps(vp[2 * 4 + col]));
+		}
+		StoreRows(out, 2, column[0], column[1], column[2], column[3]);
+
+		for (Uint32 col = 0; col < 4; col += 1)
+		{
+			__m128 vp0 = _mm_set1_ps(vp[0 * 4 + col]);
+			__m128 vp1 = _mm_set1_ps(vp[1 * 4 + col]);
+			__m128 vp2 = _mm_set1_ps(vp[2 * 4 + col]);
+			__m128 vp3 = _mm_set1_ps(vp[3 * 4 + col]);
+			column[col] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(px, vp0), _mm_mul_ps(py, vp1)),
+				_mm_add_ps(_mm_mul_ps(pz, vp2), vp3)
+			);
+		}
+		StoreRows(out, 3, column[0], column[1], column[2], column[3]);
+	}
+}
+#endif
+
+void TransformBatch_Compute(
+	const TransformBatch* batch,
+	const Matrix4x4* viewProjection,
+	Matrix4x4* worldOut,
+	Matrix4x4* wvpOut
+) {
+	Uint32 i = 0;
+
+#ifdef SDL_SSE_INTRINSICS
+	for (; i + 4 <= batch->Count; i += 4)
+	{
+		ComputeFourSSE(batch, i, viewProjection, worldOut, wvpOut);
+	}
+#endif
+
+	/* Scalar fallback, also used for the last few objects when Count isn't a multiple of four */
+	for (; i < batch->Count; i += 1)
+	{
+		Matrix4x4 world;
+		ComputeWorldScalar(batch, i, &world);
+
+		if (worldOut != NULL)
+		{
+			worldOut[i] = world;
+		}
+
+		if (wvpOut != NULL)
+		{
+			wvpOut[i] = Matrix4x4_Multiply(world, *viewProjection);
+		}
+	}
+}
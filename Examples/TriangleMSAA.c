@@ -1,13 +1,34 @@
 #include "Common.h"
 
+#define BENCHMARK_FRAMES 64
+/* The tonemapped path's background, well above 1.0 so a resolve in linear HDR would show */
+#define HDR_CLEAR_VALUE 4.0f
+
+typedef enum ResolvePath
+{
+	RESOLVEPATH_BLIT, /* Resolve into a render target, then blit it to the swapchain */
+	RESOLVEPATH_DIRECT, /* Resolve straight into the swapchain */
+	RESOLVEPATH_TONEMAPPED, /* Tonemap every HDR sample in the fragment shader, then resolve straight into the swapchain */
+	RESOLVEPATH_COUNT
+} ResolvePath;
+
+static const char* ResolvePathNames[RESOLVEPATH_COUNT] =
+{
+	"resolve + blit",
+	"direct resolve",
+	"per-sample tonemap + direct resolve"
+};
+
 static SDL_GPUGraphicsPipeline* Pipelines[4];
-static SDL_GPUTexture* MSAARenderTextures[4];
-static SDL_GPUTexture* ResolveTexture;
+static SDL_GPUGraphicsPipeline* ToneMappedPipelines[4];
+static SDL_GPUSampleCount SupportedSampleCounts[4];
 static int SampleCounts;
 
 static SDL_GPUTextureFormat RTFormat;
 
 static int CurrentSampleCount = 0;
+static ResolvePath CurrentPath = RESOLVEPATH_BLIT;
+static bool BenchmarkRequested;
 
 static int Init(Context* context)
 {
@@ -32,6 +53,12 @@ static int Init(Context* context)
 		return -1;
 	}
 
+	SDL_GPUShader* toneMappedFragmentShader = LoadShader(context->Device, "ToneMappedColor.frag", 0, 0, 0, 0);
+	if (toneMappedFragmentShader == NULL)
+	{
+		SDL_Log("Failed to create the tonemapping fragment shader, the tonemapped path will be skipped");
+	}
+
 	// Create the pipelines
 	RTFormat = SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window);
 	SDL_GPUGraphicsPipelineCreateInfo pipelineCreateInfo = {
@@ -64,54 +91,66 @@ static int Init(Context* context)
 			SDL_Log("Failed to create pipeline!");
 			return -1;
 		}
-		// Create the render target textures
-		SDL_GPUTextureCreateInfo textureCreateInfo = {
-			.type = SDL_GPU_TEXTURETYPE_2D,
-			.width = 640,
-			.height = 480,
-			.layer_count_or_depth = 1,
-			.num_levels = 1,
-			.format = RTFormat,
-			.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
-			.sample_count = sample_count
-		};
-		if (sample_count == SDL_GPU_SAMPLECOUNT_1)
+		// The render targets come from the pool each frame, so only the ones in use take memory
+		SupportedSampleCounts[SampleCounts] = sample_count;
+
+		// The tonemapped path writes display-referred samples, so it renders in the same format
+		ToneMappedPipelines[SampleCounts] = NULL;
+		if (toneMappedFragmentShader != NULL)
 		{
-			textureCreateInfo.usage |= SDL_GPU_TEXTUREUSAGE_SAMPLER;
-		}
-		MSAARenderTextures[SampleCounts] = SDL_CreateGPUTexture(context->Device, &textureCreateInfo);
-		if (MSAARenderTextures[SampleCounts] == NULL) {
-			SDL_Log("Failed to create MSAA render target texture!");
-			SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[SampleCounts]);
+			SDL_GPUGraphicsPipelineCreateInfo toneMappedPipelineCreateInfo = pipelineCreateInfo;
+			toneMappedPipelineCreateInfo.fragment_shader = toneMappedFragmentShader;
+			ToneMappedPipelines[SampleCounts] = SDL_CreateGPUGraphicsPipeline(context->Device, &toneMappedPipelineCreateInfo);
 		}
+
 		SampleCounts += 1;
 	}
 
-	// Create resolve texture
-	ResolveTexture = SDL_CreateGPUTexture(
-		context->Device,
-		&(SDL_GPUTextureCreateInfo) {
-			.type = SDL_GPU_TEXTURETYPE_2D,
-			.width = 640,
-			.height = 480,
-			.layer_count_or_depth = 1,
-			.num_levels = 1,
-			.format = RTFormat,
-			.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
-		}
-	);
-
 	// Clean up shader resources
 	SDL_ReleaseGPUShader(context->Device, vertexShader);
 	SDL_ReleaseGPUShader(context->Device, fragmentShader);
+	if (toneMappedFragmentShader != NULL)
+	{
+		SDL_ReleaseGPUShader(context->Device, toneMappedFragmentShader);
+	}
 
 	// Print the instructions
 	SDL_Log("Press Left/Right to cycle between sample counts");
+	SDL_Log("Press Up to cycle between resolve paths");
+	SDL_Log("Press Down to benchmark the resolve paths at the current sample count");
 	SDL_Log("Current sample count: %d", (1 << CurrentSampleCount));
+	SDL_Log("Current resolve path: %s", ResolvePathNames[CurrentPath]);
 
 	return 0;
 }
 
+static bool PathAvailable(Context* context, ResolvePath path)
+{
+	if (path == RESOLVEPATH_TONEMAPPED && ToneMappedPipelines[CurrentSampleCount] == NULL)
+	{
+		return false;
+	}
+	if (path != RESOLVEPATH_BLIT)
+	{
+		// A resolve can't convert formats, so the swapchain has to be in the one we render
+		return SDL_GetGPUSwapchainTextureFormat(context->Device, context->Window) == RTFormat;
+	}
+	return true;
+}
+
+static void LogCurrentState(Context* context)
+{
+	SDL_Log("Current sample count: %d", (1 << SupportedSampleCounts[CurrentSampleCount]));
+	if (PathAvailable(context, CurrentPath))
+	{
+		SDL_Log("Current resolve path: %s", ResolvePathNames[CurrentPath]);
+	}
+	else
+	{
+		SDL_Log("Current resolve path: %s is unavailable at this sample count, using %s", ResolvePathNames[CurrentPath], ResolvePathNames[RESOLVEPATH_BLIT]);
+	}
+}
+
 static int Update(Context* context)
 {
 	int changed = 0;
@@ -132,16 +171,197 @@ static int Update(Context* context)
 		changed = 1;
 	}
 
+	if (context->UpPressed)
+	{
+		CurrentPath = (CurrentPath + 1) % RESOLVEPATH_COUNT;
+		changed = 1;
+	}
+
+	if (context->DownPressed)
+	{
+		BenchmarkRequested = true;
+	}
+
 	if (changed)
 	{
-		SDL_Log("Current sample count: %d", (1 << CurrentSampleCount));
+		LogCurrentState(context);
 	}
 
 	return 0;
 }
 
+/* Reinhard and the 2.2 gamma encode, as in ToneMappedColor.frag */
+static float ToneMap(float value)
+{
+	return SDL_powf(value / (1.0f + value), 1.0f / 2.2f);
+}
+
+/* Renders the triangle at width x height and gets it into destination, which is either
+ * the swapchain texture or a stand-in for it with the same format and size.
+ */
+static bool RecordFrame(Context* context, SDL_GPUCommandBuffer* cmdbuf, ResolvePath path, SDL_GPUTexture* destination, Uint32 width, Uint32 height)
+{
+	SDL_GPUSampleCount sampleCount = SupportedSampleCounts[CurrentSampleCount];
+	bool multisampled = sampleCount != SDL_GPU_SAMPLECOUNT_1;
+
+	SDL_GPUTexture* renderTarget = NULL;
+	SDL_GPUTexture* resolveTarget = NULL;
+	SDL_GPUColorTargetInfo colorTargetInfo = {
+		.clear_color = (SDL_FColor){ 1.0f, 1.0f, 1.0f, 1.0f },
+		.load_op = SDL_GPU_LOADOP_CLEAR,
+		.store_op = multisampled ? SDL_GPU_STOREOP_RESOLVE : SDL_GPU_STOREOP_STORE
+	};
+	SDL_GPUGraphicsPipeline* pipeline = Pipelines[CurrentSampleCount];
+
+	if (path == RESOLVEPATH_TONEMAPPED)
+	{
+		// The background goes through the same tonemap as the triangle's samples, so the
+		// resolve averages display-referred values on both sides of the edge
+		float clearValue = ToneMap(HDR_CLEAR_VALUE);
+		colorTargetInfo.clear_color = (SDL_FColor){ clearValue, clearValue, clearValue, 1.0f };
+		pipeline = ToneMappedPipelines[CurrentSampleCount];
+	}
+
+	if (path != RESOLVEPATH_BLIT && !multisampled)
+	{
+		colorTargetInfo.texture = destination;
+	}
+	else
+	{
+		renderTarget = AcquireRenderTarget(context->Device, &(RenderTargetDescription){
+			.Format = RTFormat,
+			.Width = width,
+			.Height = height,
+			.SampleCount = sampleCount,
+			.Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | (multisampled ? 0 : SDL_GPU_TEXTUREUSAGE_SAMPLER)
+		});
+		colorTargetInfo.texture = renderTarget;
+	}
+
+	if (multisampled)
+	{
+		if (path != RESOLVEPATH_BLIT)
+		{
+			colorTargetInfo.resolve_texture = destination;
+		}
+		else
+		{
+			resolveTarget = AcquireRenderTarget(context->Device, &(RenderTargetDescription){
+				.Format = RTFormat,
+				.Width = width,
+				.Height = height,
+				.SampleCount = SDL_GPU_SAMPLECOUNT_1,
+				.Usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER
+			});
+			colorTargetInfo.resolve_texture = resolveTarget;
+		}
+	}
+
+	if (colorTargetInfo.texture == NULL || (multisampled && colorTargetInfo.resolve_texture == NULL))
+	{
+		SDL_Log("Failed to acquire render targets!");
+		return false;
+	}
+
+	SDL_GPURenderPass* renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
+	SDL_BindGPUGraphicsPipeline(renderPass, pipeline);
+	SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+	SDL_EndGPURenderPass(renderPass);
+
+	if (path == RESOLVEPATH_BLIT)
+	{
+		SDL_BlitGPUTexture(
+			cmdbuf,
+			&(SDL_GPUBlitInfo){
+				.source.texture = multisampled ? resolveTarget : renderTarget,
+				.source.w = width,
+				.source.h = height,
+				.destination.texture = destination,
+				.destination.w = width,
+				.destination.h = height,
+				.load_op = SDL_GPU_LOADOP_DONT_CARE,
+				.filter = SDL_GPU_FILTER_NEAREST
+			}
+		);
+	}
+
+	if (renderTarget != NULL)
+	{
+		ReleaseRenderTarget(renderTarget);
+	}
+	if (resolveTarget != NULL)
+	{
+		ReleaseRenderTarget(resolveTarget);
+	}
+
+	return true;
+}
+
+/* Times BENCHMARK_FRAMES frames of every available path in one command buffer each,
+ * drawn into an offscreen stand-in for the swapchain so presentation isn't measured.
+ */
+static void RunBenchmark(Context* context)
+{
+	int w, h;
+	SDL_GetWindowSizeInPixels(context->Window, &w, &h);
+
+	SDL_GPUTexture* destination = SDL_CreateGPUTexture(context->Device, &(SDL_GPUTextureCreateInfo){
+		.type = SDL_GPU_TEXTURETYPE_2D,
+		.format = RTFormat,
+		.width = w,
+		.height = h,
+		.layer_count_or_depth = 1,
+		.num_levels = 1,
+		.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET
+	});
+	if (destination == NULL)
+	{
+		SDL_Log("Failed to create the benchmark target: %s", SDL_GetError());
+		return;
+	}
+
+	SDL_Log("Benchmarking %dx MSAA at %dx%d, %d frames per path:", 1 << SupportedSampleCounts[CurrentSampleCount], w, h, BENCHMARK_FRAMES);
+
+	for (int path = 0; path < RESOLVEPATH_COUNT; path += 1)
+	{
+		if (!PathAvailable(context, path))
+		{
+			SDL_Log("  %s: unavailable", ResolvePathNames[path]);
+			continue;
+		}
+
+		// The first run creates the pooled targets, the second is the one that is timed
+		Uint64 elapsed = 0;
+		for (int run = 0; run < 2; run += 1)
+		{
+			SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
+			int frameCount = run == 0 ? 1 : BENCHMARK_FRAMES;
+			for (int i = 0; i < frameCount; i += 1)
+			{
+				RecordFrame(context, cmdbuf, path, destination, w, h);
+			}
+
+			Uint64 start = SDL_GetTicksNS();
+			SDL_GPUFence* fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
+			SDL_WaitForGPUFences(context->Device, true, &fence, 1);
+			elapsed = SDL_GetTicksNS() - start;
+			SDL_ReleaseGPUFence(context->Device, fence);
+		}
+
+		SDL_Log("  %s: %.3f ms per frame", ResolvePathNames[path], elapsed / 1e6 / BENCHMARK_FRAMES);
+	}
+
+	SDL_ReleaseGPUTexture(context->Device, destination);
+}
+
 static int Draw(Context* context)
 {
+	if (BenchmarkRequested)
+	{
+		RunBenchmark(context);
+		BenchmarkRequested = false;
+	}
+
     SDL_GPUCommandBuffer* cmdbuf = SDL_AcquireGPUCommandBuffer(context->Device);
     if (cmdbuf == NULL)
     {
@@ -160,43 +380,11 @@ static int Draw(Context* context)
 		int w, h;
 		SDL_GetWindowSizeInPixels(context->Window, &w, &h);
 
-		SDL_GPURenderPass* renderPass;
-		SDL_GPUColorTargetInfo colorTargetInfo = {
-			.texture = MSAARenderTextures[CurrentSampleCount],
-			.clear_color = (SDL_FColor){ 1.0f, 1.0f, 1.0f, 1.0f },
-			.load_op = SDL_GPU_LOADOP_CLEAR,
-		};
-
-		if (CurrentSampleCount == SDL_GPU_SAMPLECOUNT_1)
+		ResolvePath path = PathAvailable(context, CurrentPath) ? CurrentPath : RESOLVEPATH_BLIT;
+		if (!RecordFrame(context, cmdbuf, path, swapchainTexture, w, h))
 		{
-			colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
-		}
-		else
-		{
-			colorTargetInfo.store_op = SDL_GPU_STOREOP_RESOLVE;
-			colorTargetInfo.resolve_texture = ResolveTexture;
+			return -1;
 		}
-
-		renderPass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, NULL);
-		SDL_BindGPUGraphicsPipeline(renderPass, Pipelines[CurrentSampleCount]);
-		SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
-		SDL_EndGPURenderPass(renderPass);
-
-		SDL_GPUTexture* blitSourceTexture = (colorTargetInfo.resolve_texture != NULL) ? colorTargetInfo.resolve_texture : colorTargetInfo.texture;
-		SDL_BlitGPUTexture(
-			cmdbuf,
-			&(SDL_GPUBlitInfo){
-				.source.texture = blitSourceTexture,
-				.source.x = 160,
-				.source.w = 320,
-				.source.h = 240,
-				.destination.texture = swapchainTexture,
-				.destination.w = w,
-				.destination.h = h,
-				.load_op = SDL_GPU_LOADOP_DONT_CARE,
-				.filter = SDL_GPU_FILTER_LINEAR
-			}
-		);
 	}
 
 	SDL_SubmitGPUCommandBuffer(cmdbuf);
@@ -209,11 +397,15 @@ static void Quit(Context* context)
 	for (int i = 0; i < SampleCounts; i += 1)
 	{
 		SDL_ReleaseGPUGraphicsPipeline(context->Device, Pipelines[i]);
-		SDL_ReleaseGPUTexture(context->Device, MSAARenderTextures[i]);
+		if (ToneMappedPipelines[i] != NULL)
+		{
+			SDL_ReleaseGPUGraphicsPipeline(context->Device, ToneMappedPipelines[i]);
+		}
 	}
-	SDL_ReleaseGPUTexture(context->Device, ResolveTexture);
 
 	CurrentSampleCount = 0;
+	CurrentPath = RESOLVEPATH_BLIT;
+	BenchmarkRequested = false;
 
 	CommonQuit(context);
 }
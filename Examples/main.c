@@ -14,7 +14,9 @@ static Example* Examples[] =
 	&BasicStencil_Example,
 	&InstancedIndexed_Example,
 	&TexturedQuad_Example,
+	&CompressedTexturedQuad_Example,
 	&TexturedAnimatedQuad_Example,
+	&TexturedAnimatedQuadInstanced_Example,
 	&Clear3DSlice_Example,
 	&BasicCompute_Example,
 	&ComputeUniforms_Example,
@@ -28,11 +30,20 @@ static Example* Examples[] =
 	&Texture2DArray_Example,
 	&TriangleMSAA_Example,
 	&Cubemap_Example,
+	&PrefilteredCubemap_Example,
 	&WindowResize_Example,
 	&Blit2DArray_Example,
 	&BlitCube_Example,
 	&BlitMirror_Example,
 	&GenerateMipmaps_Example,
+	&GenerateMipmapsCompute_Example,
+	&BatchedTransforms_Example,
+	&ComputeDrawIndirect_Example,
+	&ResolutionScaling_Example,
+	&JobGraphStress_Example,
+	&RenderGraphPost_Example,
+	&PresentLatency_Example,
+	&GPUPassTiming_Example,
 };
 
 bool AppLifecycleWatcher(void *userdata, SDL_Event *event)
@@ -71,7 +82,11 @@ int main(int argc, char **argv)
 
 	for (int i = 1; i < argc; i += 1)
 	{
-		if (SDL_strcmp(argv[i], "-name") == 0 && argc > i + 1)
+		if (SDL_strcmp(argv[i], "-debugshaders") == 0)
+		{
+			SetShaderFlavor(SHADERFLAVOR_DEBUG);
+		}
+		else if (SDL_strcmp(argv[i], "-name") == 0 && argc > i + 1)
 		{
 			const char* exampleName = argv[i + 1];
 			int foundExample = 0;
@@ -94,6 +109,8 @@ int main(int argc, char **argv)
 		}
 	}
 
+	CPUProfiler_NameThread("Main");
+	CPU_ZONE_BEGIN(startupZone, "Startup", NULL);
 	if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
 	{
 		SDL_Log("Failed to initialize SDL: %s", SDL_GetError());
@@ -103,28 +120,40 @@ int main(int argc, char **argv)
 	InitializeAssetLoader();
 	SDL_AddEventWatch(AppLifecycleWatcher, NULL);
 	SDL_ShaderCross_Init();
+	CPU_ZONE_END(startupZone);
 
 	SDL_Log("Welcome to the SDL_GPU example suite!");
 	SDL_Log("Press A/D (or LB/RB) to move between examples!");
+	SDL_Log("Press P to write a CPU trace of recent frames!");
 
 	SDL_Gamepad* gamepad = NULL;
 	bool canDraw = true;
 
 	while (!quit)
 	{
+		CPU_ZONE_BEGIN(frameZone, "Frame", NULL);
 		context.LeftPressed = 0;
 		context.RightPressed = 0;
 		context.DownPressed = 0;
 		context.UpPressed = 0;
+		context.InputTimestampNS = 0;
 
+		CPU_ZONE_BEGIN(eventsZone, "Events", NULL);
 		SDL_Event evt;
 		while (SDL_PollEvent(&evt))
 		{
+			if ((evt.type == SDL_EVENT_KEY_DOWN || evt.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN) && context.InputTimestampNS == 0)
+			{
+				context.InputTimestampNS = evt.common.timestamp;
+			}
+
 			if (evt.type == SDL_EVENT_QUIT)
 			{
 				if (exampleIndex != -1)
 				{
+					CPU_ZONE_BEGIN(quitZone, "Quit", context.ExampleName);
 					Examples[exampleIndex]->Quit(&context);
+					CPU_ZONE_END(quitZone);
 				}
 				quit = 1;
 			}
@@ -192,6 +221,10 @@ int main(int argc, char **argv)
 				{
 					context.UpPressed = true;
 				}
+				else if (evt.key.key == SDLK_P)
+				{
+					CPUProfiler_WriteTrace("CPUTrace.json");
+				}
 			}
 			else if (evt.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN)
 			{
@@ -227,8 +260,10 @@ int main(int argc, char **argv)
 				}
 			}
 		}
+		CPU_ZONE_END(eventsZone);
 		if (quit)
 		{
+			CPU_ZONE_END(frameZone);
 			break;
 		}
 
@@ -236,14 +271,19 @@ int main(int argc, char **argv)
 		{
 			if (exampleIndex != -1)
 			{
+				CPU_ZONE_BEGIN(quitZone, "Quit", context.ExampleName);
 				Examples[exampleIndex]->Quit(&context);
+				CPU_ZONE_END(quitZone);
 				SDL_zero(context);
 			}
 
 			exampleIndex = gotoExampleIndex;
 			context.ExampleName = Examples[exampleIndex]->Name;
 			SDL_Log("STARTING EXAMPLE: %s", context.ExampleName);
-			if (Examples[exampleIndex]->Init(&context) < 0)
+			CPU_ZONE_BEGIN(initZone, "Init", context.ExampleName);
+			int initResult = Examples[exampleIndex]->Init(&context);
+			CPU_ZONE_END(initZone);
+			if (initResult < 0)
 			{
 				SDL_Log("Init failed!");
 				return 1;
@@ -256,7 +296,10 @@ int main(int argc, char **argv)
 		context.DeltaTime = newTime - lastTime;
 		lastTime = newTime;
 
-		if (Examples[exampleIndex]->Update(&context) < 0)
+		CPU_ZONE_BEGIN(updateZone, "Update", context.ExampleName);
+		int updateResult = Examples[exampleIndex]->Update(&context);
+		CPU_ZONE_END(updateZone);
+		if (updateResult < 0)
 		{
 			SDL_Log("Update failed!");
 			return 1;
@@ -264,13 +307,19 @@ int main(int argc, char **argv)
 
 		if (canDraw)
 		{
-			if (Examples[exampleIndex]->Draw(&context) < 0)
+			CPU_ZONE_BEGIN(drawZone, "Draw", context.ExampleName);
+			int drawResult = Examples[exampleIndex]->Draw(&context);
+			EndRenderTargetFrame();
+			CPU_ZONE_END(drawZone);
+			if (drawResult < 0)
 			{
 				SDL_Log("Draw failed!");
 				return 1;
 			}
 		}
+		CPU_ZONE_END(frameZone);
 	}
 
+	CPUProfiler_WriteTrace("CPUTrace.json");
 	return 0;
 }
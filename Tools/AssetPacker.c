@@ -0,0 +1,277 @@
+#include "../Examples/Common.h"
+#include <SDL3/SDL_main.h>
+
+/* Packs Content/Images and Content/Shaders/Compiled into a Content.pak archive, see Examples/AssetArchive.c.
+ *
+ * Usage: AssetPacker <ContentDirectory> <output.pak> [<Name>=<Directory> ...]
+ *
+ * Each extra argument packs the files in Directory under Name/, replacing the default
+ * directory of that name or adding a new one. The build uses this to pack shaders
+ * straight from the build tree, e.g. Shaders/Optimized=build/Shaders/Optimized.
+ */
+
+#define MAX_PACKED_DIRECTORIES 8
+
+typedef struct PackedDirectory
+{
+	const char* Name;
+	char Path[512];
+} PackedDirectory;
+
+static const char* DefaultDirectories[] = { "Images", "Shaders/Compiled" };
+static PackedDirectory PackedDirectories[MAX_PACKED_DIRECTORIES];
+static int PackedDirectoryCount;
+
+typedef struct PackedAsset
+{
+	char* Name;
+	void* Data;
+	Uint64 Size;
+	AssetType Type;
+	Uint32 Width;
+	Uint32 Height;
+} PackedAsset;
+
+static PackedAsset* Assets;
+static Uint32 AssetCount;
+
+static Uint64 AlignUp(Uint64 value, Uint64 alignment)
+{
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static int CompareNames(const void* a, const void* b)
+{
+	return SDL_strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+static bool PackFile(const char* directoryPath, const char* name, const char* fileName)
+{
+	char fullPath[512];
+	SDL_snprintf(fullPath, sizeof(fullPath), "%s/%s", directoryPath, fileName);
+
+	PackedAsset asset = { 0 };
+	const char* extension = SDL_strrchr(name, '.');
+
+	if (extension != NULL && SDL_strcasecmp(extension, ".bmp") == 0)
+	{
+		/* Decode and swizzle now so the runtime can copy rows straight into a transfer buffer */
+		SDL_Surface* surface = SDL_LoadBMP(fullPath);
+		if (surface == NULL)
+		{
+			SDL_Log("Failed to load BMP %s: %s", fullPath, SDL_GetError());
+			return false;
+		}
+
+		asset.Type = ASSETTYPE_IMAGE_RGBA8;
+		asset.Width = surface->w;
+		asset.Height = surface->h;
+		asset.Size = (Uint64) surface->w * surface->h * 4;
+		asset.Data = SDL_malloc(asset.Size);
+		bool converted = SDL_ConvertPixels(surface->w, surface->h, surface->format, surface->pixels, surface->pitch, SDL_PIXELFORMAT_ABGR8888, asset.Data, surface->w * 4);
+		SDL_DestroySurface(surface);
+		if (!converted)
+		{
+			SDL_Log("Failed to convert %s to RGBA8: %s", fullPath, SDL_GetError());
+			SDL_free(asset.Data);
+			return false;
+		}
+	}
+	else
+	{
+		size_t size;
+		asset.Type = ASSETTYPE_RAW;
+		asset.Data = SDL_LoadFile(fullPath, &size);
+		asset.Size = size;
+		if (asset.Data == NULL)
+		{
+			SDL_Log("Failed to load %s: %s", fullPath, SDL_GetError());
+			return false;
+		}
+	}
+
+	asset.Name = SDL_strdup(name);
+	Assets = SDL_realloc(Assets, sizeof(PackedAsset) * (AssetCount + 1));
+	Assets[AssetCount] = asset;
+	AssetCount += 1;
+	return true;
+}
+
+static bool WriteArchive(const char* outputPath)
+{
+	Uint32 slotCount = 1;
+	while (slotCount < AssetCount * 2)
+	{
+		slotCount *= 2;
+	}
+
+	AssetArchiveHeader header = {
+		.Magic = ASSET_ARCHIVE_MAGIC,
+		.Version = ASSET_ARCHIVE_VERSION,
+		.EntryCount = AssetCount,
+		.SlotCount = slotCount,
+		.EntriesOffset = sizeof(AssetArchiveHeader),
+	};
+	header.SlotsOffset = header.EntriesOffset + (sizeof(AssetArchiveEntry) * AssetCount);
+
+	AssetArchiveEntry* entries = SDL_calloc(SDL_max(AssetCount, 1), sizeof(AssetArchiveEntry));
+	Uint32* slots = SDL_malloc(sizeof(Uint32) * slotCount);
+	SDL_memset(slots, 0xFF, sizeof(Uint32) * slotCount);
+
+	Uint64 offset = header.SlotsOffset + (sizeof(Uint32) * slotCount);
+	Uint32 nameOffset = 0;
+	for (Uint32 i = 0; i < AssetCount; i += 1)
+	{
+		offset = AlignUp(offset, ASSET_ARCHIVE_ALIGNMENT);
+		entries[i].NameHash = HashAssetName(Assets[i].Name);
+		entries[i].NameOffset = nameOffset;
+		entries[i].Type = Assets[i].Type;
+		entries[i].Width = Assets[i].Width;
+		entries[i].Height = Assets[i].Height;
+		entries[i].DataOffset = offset;
+		entries[i].DataSize = Assets[i].Size;
+		offset += Assets[i].Size;
+		nameOffset += (Uint32) SDL_strlen(Assets[i].Name) + 1;
+
+		Uint32 slot = entries[i].NameHash & (slotCount - 1);
+		while (slots[slot] != ASSET_ARCHIVE_EMPTY_SLOT)
+		{
+			slot = (slot + 1) & (slotCount - 1);
+		}
+		slots[slot] = i;
+	}
+	header.NamesOffset = offset;
+
+	SDL_IOStream* stream = SDL_IOFromFile(outputPath, "wb");
+	if (stream == NULL)
+	{
+		SDL_Log("Failed to open %s for writing: %s", outputPath, SDL_GetError());
+		SDL_free(entries);
+		SDL_free(slots);
+		return false;
+	}
+
+	static const Uint8 padding[ASSET_ARCHIVE_ALIGNMENT] = { 0 };
+	bool written =
+		SDL_WriteIO(stream, &header, sizeof(header)) == sizeof(header) &&
+		SDL_WriteIO(stream, entries, sizeof(AssetArchiveEntry) * AssetCount) == sizeof(AssetArchiveEntry) * AssetCount &&
+		SDL_WriteIO(stream, slots, sizeof(Uint32) * slotCount) == sizeof(Uint32) * slotCount;
+
+	for (Uint32 i = 0; i < AssetCount && written; i += 1)
+	{
+		Sint64 position = SDL_TellIO(stream);
+		size_t paddingSize = (size_t) (entries[i].DataOffset - position);
+		written =
+			SDL_WriteIO(stream, padding, paddingSize) == paddingSize &&
+			SDL_WriteIO(stream, Assets[i].Data, Assets[i].Size) == Assets[i].Size;
+	}
+
+	for (Uint32 i = 0; i < AssetCount && written; i += 1)
+	{
+		size_t nameSize = SDL_strlen(Assets[i].Name) + 1;
+		written = SDL_WriteIO(stream, Assets[i].Name, nameSize) == nameSize;
+	}
+
+	/* Keep the file ending in a zero byte even when there is nothing to name */
+	if (AssetCount == 0 && written)
+	{
+		written = SDL_WriteIO(stream, padding, 1) == 1;
+	}
+
+	SDL_CloseIO(stream);
+	SDL_free(entries);
+	SDL_free(slots);
+
+	if (!written)
+	{
+		SDL_Log("Failed to write %s: %s", outputPath, SDL_GetError());
+		return false;
+	}
+
+	SDL_Log("%s: %u assets, %u hash slots, %" SDL_PRIu64 " bytes", outputPath, AssetCount, slotCount, header.NamesOffset + nameOffset);
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		SDL_Log("Usage: %s <ContentDirectory> <output.pak> [<Name>=<Directory> ...]", argv[0]);
+		return 1;
+	}
+
+	const char* contentPath = argv[1];
+	const char* outputPath = argv[2];
+	bool success = true;
+
+	for (int i = 0; i < SDL_arraysize(DefaultDirectories); i += 1)
+	{
+		PackedDirectories[i].Name = DefaultDirectories[i];
+		SDL_snprintf(PackedDirectories[i].Path, sizeof(PackedDirectories[i].Path), "%s/%s", contentPath, DefaultDirectories[i]);
+	}
+	PackedDirectoryCount = SDL_arraysize(DefaultDirectories);
+
+	for (int i = 3; i < argc; i += 1)
+	{
+		char* separator = SDL_strchr(argv[i], '=');
+		if (separator == NULL)
+		{
+			SDL_Log("Expected <Name>=<Directory>, got %s", argv[i]);
+			return 1;
+		}
+		*separator = '\0';
+
+		int index = 0;
+		while (index < PackedDirectoryCount && SDL_strcmp(PackedDirectories[index].Name, argv[i]) != 0)
+		{
+			index += 1;
+		}
+		if (index == MAX_PACKED_DIRECTORIES)
+		{
+			SDL_Log("Too many directories to pack!");
+			return 1;
+		}
+		if (index == PackedDirectoryCount)
+		{
+			PackedDirectoryCount += 1;
+		}
+
+		PackedDirectories[index].Name = argv[i];
+		SDL_strlcpy(PackedDirectories[index].Path, separator + 1, sizeof(PackedDirectories[index].Path));
+	}
+
+	for (int i = 0; i < PackedDirectoryCount && success; i += 1)
+	{
+		const char* directoryPath = PackedDirectories[i].Path;
+		int fileCount;
+		char** files = SDL_GlobDirectory(directoryPath, "*", 0, &fileCount);
+		if (files == NULL)
+		{
+			SDL_Log("Failed to list %s: %s", directoryPath, SDL_GetError());
+			return 1;
+		}
+
+		/* Sorted so the archive is byte-identical between runs */
+		SDL_qsort(files, fileCount, sizeof(char*), CompareNames);
+
+		for (int j = 0; j < fileCount && success; j += 1)
+		{
+			char name[512];
+			SDL_snprintf(name, sizeof(name), "%s/%s", PackedDirectories[i].Name, files[j]);
+			success = PackFile(directoryPath, name, files[j]);
+		}
+
+		SDL_free(files);
+	}
+
+	success = success && WriteArchive(outputPath);
+
+	for (Uint32 i = 0; i < AssetCount; i += 1)
+	{
+		SDL_free(Assets[i].Name);
+		SDL_free(Assets[i].Data);
+	}
+	SDL_free(Assets);
+
+	return success ? 0 : 1;
+}
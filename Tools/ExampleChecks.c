@@ -0,0 +1,315 @@
+#include "../Examples/Common.h"
+#include <SDL3/SDL_main.h>
+
+/* Headless checks for the parts of the examples that can run without a window or a device.
+ * Registered with CTest, so `ctest` in the build directory runs them.
+ *
+ * Usage: ExampleChecks
+ */
+
+static Uint32 CheckCount;
+static Uint32 FailedCount;
+
+static void Expect(bool condition, const char* description)
+{
+	CheckCount += 1;
+	if (!condition)
+	{
+		FailedCount += 1;
+		SDL_Log("  FAILED: %s", description);
+	}
+}
+
+// Render graph scheduling
+
+/* RenderGraph_Compile touches no GPU state, so its decisions can be checked on the CPU alone */
+static RenderGraph CheckGraph;
+
+static Uint32 PositionOf(const RenderGraph* graph, Uint32 pass)
+{
+	for (Uint32 i = 0; i < graph->OrderCount; i += 1)
+	{
+		if (graph->Order[i] == pass)
+		{
+			return i;
+		}
+	}
+
+	return RENDER_GRAPH_INVALID;
+}
+
+static void RunRenderGraphChecks(void)
+{
+	RenderGraph* graph = &CheckGraph;
+	const SDL_FColor black = { 0.0f, 0.0f, 0.0f, 1.0f };
+	const RenderTargetDescription ldr = { SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 640, 480, SDL_GPU_SAMPLECOUNT_1, 0 };
+	const RenderTargetDescription hdr = { SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, 640, 480, SDL_GPU_SAMPLECOUNT_1, 0 };
+	const RenderTargetDescription small = { SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 320, 240, SDL_GPU_SAMPLECOUNT_1, 0 };
+	const RenderTargetDescription msaa = { SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, 640, 480, SDL_GPU_SAMPLECOUNT_4, 0 };
+	Uint32 a, b, c, d, e;
+
+	// Passes that reach no imported texture are culled, and take their textures with them
+	RenderGraph_Reset(graph);
+	Uint32 out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	Uint32 unused = RenderGraph_CreateTexture(graph, "Unused", &ldr);
+	Uint32 scene = RenderGraph_CreateTexture(graph, "Scene", &ldr);
+	a = RenderGraph_AddPass(graph, "Unused", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, a, unused, black);
+	b = RenderGraph_AddPass(graph, "Scene", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, b, scene, black);
+	c = RenderGraph_AddPass(graph, "Present", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(graph, c, scene, 0);
+	RenderGraph_Write(graph, c, out);
+	Expect(RenderGraph_Compile(graph), "culling: compiles");
+	Expect(graph->Passes[a].Culled, "culling: a pass nobody reads from is culled");
+	Expect(!graph->Passes[b].Culled && !graph->Passes[c].Culled, "culling: passes feeding an imported texture are kept");
+	Expect(graph->Resources[unused].FirstUse == RENDER_GRAPH_INVALID, "culling: a culled pass's texture isn't allocated");
+	Expect(graph->PhysicalCount == 1, "culling: one texture for the one transient in use");
+
+	// A clear makes whatever was written before it dead
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	scene = RenderGraph_CreateTexture(graph, "Scene", &ldr);
+	a = RenderGraph_AddPass(graph, "Early", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Write(graph, a, scene);
+	b = RenderGraph_AddPass(graph, "Scene", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, b, scene, black);
+	c = RenderGraph_AddPass(graph, "Present", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(graph, c, scene, 0);
+	RenderGraph_Write(graph, c, out);
+	Expect(RenderGraph_Compile(graph), "overwrite: compiles");
+	Expect(graph->Passes[a].Culled, "overwrite: a pass whose output is cleared before use is culled");
+	Expect(graph->Passes[b].Accesses[0].LoadOp == SDL_GPU_LOADOP_CLEAR, "overwrite: the clear is a load op");
+	Expect(graph->Passes[b].Accesses[0].StoreOp == SDL_GPU_STOREOP_STORE, "overwrite: a target read later is stored");
+
+	// Independent passes move so render passes on the same targets merge
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	Uint32 color = RenderGraph_CreateTexture(graph, "HDR", &hdr);
+	Uint32 gradient = RenderGraph_CreateTexture(graph, "Gradient", &ldr);
+	a = RenderGraph_AddPass(graph, "Scene", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, a, color, black);
+	b = RenderGraph_AddPass(graph, "Gradient", RENDERGRAPH_PASS_COMPUTE, NULL, NULL);
+	RenderGraph_Write(graph, b, gradient);
+	c = RenderGraph_AddPass(graph, "Overlay", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Write(graph, c, color);
+	d = RenderGraph_AddPass(graph, "Post", RENDERGRAPH_PASS_COMPUTE, NULL, NULL);
+	RenderGraph_Read(graph, d, color, SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ);
+	RenderGraph_Read(graph, d, gradient, SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ);
+	RenderGraph_Write(graph, d, out);
+	Expect(RenderGraph_Compile(graph), "merging: compiles");
+	Expect(PositionOf(graph, c) == PositionOf(graph, a) + 1, "merging: Overlay moves up to follow Scene");
+	Expect(graph->Passes[c].MergedWithPrevious, "merging: Overlay continues Scene's render pass");
+	Expect(graph->SDLPassCount == 3, "merging: four passes take three SDL passes");
+	Expect(PositionOf(graph, d) == 3, "merging: Post still comes last");
+	Expect(graph->Passes[c].Accesses[0].LoadOp == SDL_GPU_LOADOP_LOAD, "merging: Overlay loads what Scene drew");
+
+	// Writing what an earlier pass reads keeps them in declared order, even at the cost of a merge
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	Uint32 out2 = RenderGraph_ImportTexture(graph, "Out2", &hdr);
+	color = RenderGraph_CreateTexture(graph, "HDR", &hdr);
+	a = RenderGraph_AddPass(graph, "Scene", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, a, color, black);
+	b = RenderGraph_AddPass(graph, "Post", RENDERGRAPH_PASS_COMPUTE, NULL, NULL);
+	RenderGraph_Read(graph, b, color, SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_READ);
+	RenderGraph_Write(graph, b, out);
+	c = RenderGraph_AddPass(graph, "Overlay", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Write(graph, c, color);
+	d = RenderGraph_AddPass(graph, "Copy", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(graph, d, color, 0);
+	RenderGraph_Write(graph, d, out2);
+	Expect(RenderGraph_Compile(graph), "hazards: compiles");
+	Expect(PositionOf(graph, c) > PositionOf(graph, b), "hazards: Overlay waits for Post to read HDR");
+	Expect(!graph->Passes[c].MergedWithPrevious, "hazards: Overlay can't merge with Scene");
+	Expect(graph->SDLPassCount == 4, "hazards: four passes take four SDL passes");
+
+	// Transients with the same description and disjoint lifetimes share a texture
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	Uint32 t1 = RenderGraph_CreateTexture(graph, "T1", &ldr);
+	Uint32 t2 = RenderGraph_CreateTexture(graph, "T2", &ldr);
+	Uint32 t3 = RenderGraph_CreateTexture(graph, "T3", &ldr);
+	Uint32 t4 = RenderGraph_CreateTexture(graph, "T4", &small);
+	a = RenderGraph_AddPass(graph, "A", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, a, t1, black);
+	b = RenderGraph_AddPass(graph, "B", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Read(graph, b, t1, 0);
+	RenderGraph_Clear(graph, b, t2, black);
+	c = RenderGraph_AddPass(graph, "C", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Read(graph, c, t2, 0);
+	RenderGraph_Clear(graph, c, t3, black);
+	d = RenderGraph_AddPass(graph, "D", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Read(graph, d, t3, 0);
+	RenderGraph_Clear(graph, d, t4, black);
+	e = RenderGraph_AddPass(graph, "Present", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(graph, e, t4, 0);
+	RenderGraph_Write(graph, e, out);
+	Expect(RenderGraph_Compile(graph), "aliasing: compiles");
+	Expect(graph->Resources[t1].PhysicalIndex == graph->Resources[t3].PhysicalIndex, "aliasing: T3 reuses T1's texture");
+	Expect(graph->Resources[t1].PhysicalIndex != graph->Resources[t2].PhysicalIndex, "aliasing: T1 and T2 overlap, so they don't share");
+	Expect(graph->Resources[t4].PhysicalIndex != graph->Resources[t2].PhysicalIndex, "aliasing: a different size doesn't share");
+	Expect(graph->PhysicalCount == 3, "aliasing: four transients take three textures");
+	Expect(
+		graph->Physical[graph->Resources[t1].PhysicalIndex].Description.Usage ==
+			(SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER),
+		"aliasing: a shared texture has the usage of every user"
+	);
+
+	// A multisampled target nobody reads is resolved and then discarded
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	Uint32 multisampled = RenderGraph_CreateTexture(graph, "MSAA", &msaa);
+	Uint32 resolved = RenderGraph_CreateTexture(graph, "Resolved", &ldr);
+	a = RenderGraph_AddPass(graph, "Scene", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Clear(graph, a, multisampled, black);
+	RenderGraph_Resolve(graph, a, multisampled, resolved);
+	b = RenderGraph_AddPass(graph, "Present", RENDERGRAPH_PASS_BLIT, NULL, NULL);
+	RenderGraph_Read(graph, b, resolved, 0);
+	RenderGraph_Write(graph, b, out);
+	Expect(RenderGraph_Compile(graph), "resolve: compiles");
+	Expect(graph->Passes[a].Accesses[0].StoreOp == SDL_GPU_STOREOP_RESOLVE, "resolve: the samples aren't stored");
+	Expect(graph->PhysicalCount == 2, "resolve: different sample counts don't share");
+
+	// Reading a texture while rendering to it is refused
+	RenderGraph_Reset(graph);
+	out = RenderGraph_ImportTexture(graph, "Out", &ldr);
+	a = RenderGraph_AddPass(graph, "Feedback", RENDERGRAPH_PASS_RENDER, NULL, NULL);
+	RenderGraph_Read(graph, a, out, 0);
+	RenderGraph_Write(graph, a, out);
+	SDL_Log("Expect an error about Feedback:");
+	Expect(!RenderGraph_Compile(graph), "validation: a feedback loop doesn't compile");
+}
+
+// GPU profiler bookkeeping
+
+/* Made-up fences hold the time they signal at, and waiting on one moves the clock there */
+static SDL_AtomicInt MockNS;
+static GPUProfiler CheckProfiler;
+
+static Uint64 MockNow(void* userdata)
+{
+	return (Uint64) SDL_GetAtomicInt(&MockNS);
+}
+
+static void MockWait(void* userdata, SDL_GPUFence* fence)
+{
+	int signalNS = (int) (intptr_t) fence;
+	if (signalNS > SDL_GetAtomicInt(&MockNS))
+	{
+		SDL_SetAtomicInt(&MockNS, signalNS);
+	}
+}
+
+static void MockRelease(void* userdata, SDL_GPUFence* fence)
+{
+}
+
+static SDL_GPUFence* MockFence(int signalNS)
+{
+	return (SDL_GPUFence*) (intptr_t) signalNS;
+}
+
+/* What the completion callback saw, in order */
+static GPUPassRecord CallbackRecords[4];
+static Uint32 CallbackCount;
+
+static void RecordCompletion(void* userdata, const GPUPassRecord* record)
+{
+	Uint32* pCount = userdata;
+	if (*pCount < SDL_arraysize(CallbackRecords))
+	{
+		CallbackRecords[*pCount] = *record;
+	}
+	*pCount += 1;
+}
+
+static GPUPassStats* FindStats(GPUProfiler* profiler, const char* name)
+{
+	for (Uint32 i = 0; i < profiler->PassCount; i += 1)
+	{
+		if (SDL_strcmp(profiler->Passes[i].Name, name) == 0)
+		{
+			return &profiler->Passes[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void RunProfilerChecks(void)
+{
+	GPUProfiler* profiler = &CheckProfiler;
+	char sameName[] = "A";
+
+	SDL_SetAtomicInt(&MockNS, 1000);
+	if (!GPUProfiler_Init(profiler, NULL, &(GPUProfilerClock){ MockNow, MockWait, MockRelease, NULL }))
+	{
+		Expect(false, "profiler: initializes with a mock clock");
+		return;
+	}
+
+	// Back-to-back passes queue behind each other, so B starts when A finishes
+	GPUProfiler_TrackFence(profiler, "A", MockFence(3000), NULL, NULL);
+	GPUProfiler_TrackFence(profiler, "B", MockFence(4500), RecordCompletion, &CallbackCount);
+	GPUProfiler_Flush(profiler);
+
+	// After an idle gap, a pass starts when it's submitted
+	SDL_SetAtomicInt(&MockNS, 10000);
+	GPUProfiler_BeginFrame(profiler);
+	GPUProfiler_TrackFence(profiler, sameName, MockFence(10500), RecordCompletion, &CallbackCount);
+	GPUProfiler_TrackFence(profiler, "C", MockFence(12000), NULL, NULL);
+	GPUProfiler_Flush(profiler);
+
+	GPUPassStats* a = FindStats(profiler, "A");
+	GPUPassStats* b = FindStats(profiler, "B");
+	GPUPassStats* c = FindStats(profiler, "C");
+	Expect(profiler->PassCount == 3, "passes with the same name share their stats");
+	Expect(a != NULL && a->Count == 2 && a->TotalNS == 2500, "A: two passes, 2000 + 500 ns");
+	Expect(a != NULL && a->MinNS == 500 && a->MaxNS == 2000, "A: min and max");
+	Expect(b != NULL && b->Count == 1 && b->TotalNS == 1500, "B: timed from the end of A");
+	Expect(c != NULL && c->Count == 1 && c->TotalNS == 1500, "C: timed from the end of A");
+
+	Expect(profiler->EventCount == 4, "every pass is kept for the trace");
+	Expect(profiler->Events[1].StartNS == 3000 && profiler->Events[1].DurationNS == 1500, "trace: B starts when A ends");
+	Expect(profiler->Events[2].StartNS == 10000, "trace: A starts at its submission after the gap");
+	Expect(profiler->Events[0].Frame == 0 && profiler->Events[3].Frame == 1, "trace: passes carry their frame");
+
+	Expect(CallbackCount == 2, "callback: only the passes tracked with one call it");
+	Expect(
+		SDL_strcmp(CallbackRecords[0].Name, "B") == 0 && CallbackRecords[0].StartNS == 3000 && CallbackRecords[0].CompleteNS == 4500,
+		"callback: B is timed from the end of A, like its stats"
+	);
+	Expect(
+		CallbackRecords[1].Name == sameName && CallbackRecords[1].StartNS == 10000 && CallbackRecords[1].CompleteNS == 10500,
+		"callback: passes arrive in submission order"
+	);
+
+	// More passes than the pending ring and the trace hold
+	int signalNS = 20000;
+	SDL_SetAtomicInt(&MockNS, signalNS);
+	for (Uint32 i = 0; i < GPU_PROFILER_MAX_EVENTS + 10; i += 1)
+	{
+		signalNS += 10;
+		GPUProfiler_TrackFence(profiler, "D", MockFence(signalNS), NULL, NULL);
+	}
+	GPUProfiler_Flush(profiler);
+
+	GPUPassStats* d = FindStats(profiler, "D");
+	Uint32 first = (profiler->EventWrite + GPU_PROFILER_MAX_EVENTS - profiler->EventCount) % GPU_PROFILER_MAX_EVENTS;
+	Expect(d != NULL && d->Count == GPU_PROFILER_MAX_EVENTS + 10, "no pass is lost when the pending ring is full");
+	Expect(d != NULL && d->MinNS == 10 && d->MaxNS == 10, "D: each 10 ns");
+	Expect(profiler->EventCount == GPU_PROFILER_MAX_EVENTS, "the trace keeps the most recent passes");
+	Expect(SDL_strcmp(profiler->Events[first].Name, "D") == 0, "the oldest passes are the ones dropped");
+
+	GPUProfiler_Destroy(profiler);
+}
+
+int main(int argc, char **argv)
+{
+	RunRenderGraphChecks();
+	RunProfilerChecks();
+
+	SDL_Log("Example checks: %u of %u passed", CheckCount - FailedCount, CheckCount);
+	return FailedCount == 0 ? 0 : 1;
+}
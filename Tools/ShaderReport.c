@@ -0,0 +1,189 @@
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+
+/* Compares the unoptimized and spirv-opt optimized flavors of every compiled shader.
+ *
+ * Usage: ShaderReport <DebugDirectory> <OptimizedDirectory> <report.csv>
+ *
+ * Writes one CSV row per shader with module sizes, total instruction counts and the
+ * instructions inside function bodies, which is the part that actually executes.
+ */
+
+#define SPIRV_MAGIC 0x07230203
+#define SPIRV_OP_FUNCTION 54
+#define SPIRV_OP_FUNCTION_END 56
+
+typedef struct ModuleStats
+{
+	Uint64 Size;
+	Uint32 InstructionCount;
+	Uint32 FunctionInstructionCount;
+} ModuleStats;
+
+static int CompareNames(const void* a, const void* b)
+{
+	return SDL_strcmp(*(const char* const*) a, *(const char* const*) b);
+}
+
+static bool MeasureModule(const char* directory, const char* name, ModuleStats* stats)
+{
+	char path[512];
+	SDL_snprintf(path, sizeof(path), "%s/%s", directory, name);
+
+	size_t size;
+	Uint32* words = SDL_LoadFile(path, &size);
+	if (words == NULL)
+	{
+		SDL_Log("Failed to load %s: %s", path, SDL_GetError());
+		return false;
+	}
+
+	SDL_zerop(stats);
+	stats->Size = size;
+
+	size_t wordCount = size / 4;
+	if (wordCount < 5 || words[0] != SPIRV_MAGIC)
+	{
+		SDL_Log("%s is not a SPIR-V module", path);
+		SDL_free(words);
+		return false;
+	}
+
+	bool inFunction = false;
+	for (size_t i = 5; i < wordCount;)
+	{
+		Uint16 opcode = words[i] & 0xFFFF;
+		Uint16 length = words[i] >> 16;
+		if (length == 0)
+		{
+			break;
+		}
+
+		stats->InstructionCount += 1;
+		if (opcode == SPIRV_OP_FUNCTION)
+		{
+			inFunction = true;
+		}
+		if (inFunction)
+		{
+			stats->FunctionInstructionCount += 1;
+		}
+		if (opcode == SPIRV_OP_FUNCTION_END)
+		{
+			inFunction = false;
+		}
+
+		i += length;
+	}
+
+	SDL_free(words);
+	return true;
+}
+
+static double PercentChange(Uint64 before, Uint64 after)
+{
+	return before ? (100.0 * ((double) after - (double) before) / (double) before) : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 4)
+	{
+		SDL_Log("Usage: %s <DebugDirectory> <OptimizedDirectory> <report.csv>", argv[0]);
+		return 1;
+	}
+
+	const char* debugPath = argv[1];
+	const char* optimizedPath = argv[2];
+	const char* reportPath = argv[3];
+
+	int fileCount;
+	char** files = SDL_GlobDirectory(debugPath, "*.spv", 0, &fileCount);
+	if (files == NULL)
+	{
+		SDL_Log("Failed to list %s: %s", debugPath, SDL_GetError());
+		return 1;
+	}
+	SDL_qsort(files, fileCount, sizeof(char*), CompareNames);
+
+	SDL_IOStream* report = SDL_IOFromFile(reportPath, "w");
+	if (report == NULL)
+	{
+		SDL_Log("Failed to open %s for writing: %s", reportPath, SDL_GetError());
+		SDL_free(files);
+		return 1;
+	}
+
+	SDL_IOprintf(report, "Shader,DebugBytes,OptimizedBytes,BytesChange%%,DebugInstructions,OptimizedInstructions,InstructionsChange%%,DebugFunctionInstructions,OptimizedFunctionInstructions,FunctionInstructionsChange%%\n");
+
+	ModuleStats debugTotal = { 0 };
+	ModuleStats optimizedTotal = { 0 };
+	bool success = true;
+
+	for (int i = 0; i < fileCount && success; i += 1)
+	{
+		ModuleStats debug, optimized;
+		success =
+			MeasureModule(debugPath, files[i], &debug) &&
+			MeasureModule(optimizedPath, files[i], &optimized);
+		if (!success)
+		{
+			break;
+		}
+
+		SDL_IOprintf(
+			report,
+			"%s,%" SDL_PRIu64 ",%" SDL_PRIu64 ",%.1f,%u,%u,%.1f,%u,%u,%.1f\n",
+			files[i],
+			debug.Size,
+			optimized.Size,
+			PercentChange(debug.Size, optimized.Size),
+			debug.InstructionCount,
+			optimized.InstructionCount,
+			PercentChange(debug.InstructionCount, optimized.InstructionCount),
+			debug.FunctionInstructionCount,
+			optimized.FunctionInstructionCount,
+			PercentChange(debug.FunctionInstructionCount, optimized.FunctionInstructionCount)
+		);
+
+		debugTotal.Size += debug.Size;
+		debugTotal.InstructionCount += debug.InstructionCount;
+		debugTotal.FunctionInstructionCount += debug.FunctionInstructionCount;
+		optimizedTotal.Size += optimized.Size;
+		optimizedTotal.InstructionCount += optimized.InstructionCount;
+		optimizedTotal.FunctionInstructionCount += optimized.FunctionInstructionCount;
+	}
+
+	if (success)
+	{
+		SDL_IOprintf(
+			report,
+			"Total,%" SDL_PRIu64 ",%" SDL_PRIu64 ",%.1f,%u,%u,%.1f,%u,%u,%.1f\n",
+			debugTotal.Size,
+			optimizedTotal.Size,
+			PercentChange(debugTotal.Size, optimizedTotal.Size),
+			debugTotal.InstructionCount,
+			optimizedTotal.InstructionCount,
+			PercentChange(debugTotal.InstructionCount, optimizedTotal.InstructionCount),
+			debugTotal.FunctionInstructionCount,
+			optimizedTotal.FunctionInstructionCount,
+			PercentChange(debugTotal.FunctionInstructionCount, optimizedTotal.FunctionInstructionCount)
+		);
+
+		SDL_Log(
+			"%d shaders: %" SDL_PRIu64 " -> %" SDL_PRIu64 " bytes (%.1f%%), %u -> %u function instructions (%.1f%%), see %s",
+			fileCount,
+			debugTotal.Size,
+			optimizedTotal.Size,
+			PercentChange(debugTotal.Size, optimizedTotal.Size),
+			debugTotal.FunctionInstructionCount,
+			optimizedTotal.FunctionInstructionCount,
+			PercentChange(debugTotal.FunctionInstructionCount, optimizedTotal.FunctionInstructionCount),
+			reportPath
+		);
+	}
+
+	SDL_CloseIO(report);
+	SDL_free(files);
+	return success ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include "../Examples/Common.h"
+#include <SDL3/SDL_main.h>
+
+/* Offline front end for the block encoder in Examples/TextureCompression.c.
+ *
+ * Usage: TextureEncoder <input.bmp> <output.ktx2> <bc1|bc3|bc7|astc> [--srgb] [--no-mips]
+ */
+
+static const char* FormatArguments[] = { "bc1", "bc3", "bc7", "astc" };
+
+int main(int argc, char **argv)
+{
+	if (argc < 4)
+	{
+		SDL_Log("Usage: %s <input.bmp> <output.ktx2> <bc1|bc3|bc7|astc> [--srgb] [--no-mips]", argv[0]);
+		return 1;
+	}
+
+	const char* inputPath = argv[1];
+	const char* outputPath = argv[2];
+	int format = -1;
+	bool srgb = false;
+	bool generateMipmaps = true;
+
+	for (int i = 0; i < SDL_arraysize(FormatArguments); i += 1)
+	{
+		if (SDL_strcasecmp(argv[3], FormatArguments[i]) == 0)
+		{
+			format = i;
+		}
+	}
+	if (format < 0)
+	{
+		SDL_Log("Unknown format '%s'!", argv[3]);
+		return 1;
+	}
+
+	for (int i = 4; i < argc; i += 1)
+	{
+		if (SDL_strcmp(argv[i], "--srgb") == 0)
+		{
+			srgb = true;
+		}
+		else if (SDL_strcmp(argv[i], "--no-mips") == 0)
+		{
+			generateMipmaps = false;
+		}
+		else
+		{
+			SDL_Log("Unknown option '%s'!", argv[i]);
+			return 1;
+		}
+	}
+
+	SDL_Surface* surface = SDL_LoadBMP(inputPath);
+	if (surface == NULL)
+	{
+		SDL_Log("Failed to load BMP: %s", SDL_GetError());
+		return 1;
+	}
+
+	if (surface->format != SDL_PIXELFORMAT_ABGR8888)
+	{
+		SDL_Surface* next = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_ABGR8888);
+		SDL_DestroySurface(surface);
+		surface = next;
+		if (surface == NULL)
+		{
+			SDL_Log("Failed to convert %s to RGBA8: %s", inputPath, SDL_GetError());
+			return 1;
+		}
+	}
+
+	/* The encoder reads tightly packed rows */
+	Uint8* pixels = SDL_malloc(surface->w * surface->h * 4);
+	if (pixels == NULL)
+	{
+		SDL_Log("Failed to allocate %dx%d RGBA8 pixels for %s!", surface->w, surface->h, inputPath);
+		SDL_DestroySurface(surface);
+		return 1;
+	}
+	for (int y = 0; y < surface->h; y += 1)
+	{
+		SDL_memcpy(&pixels[y * surface->w * 4], (Uint8*) surface->pixels + (y * surface->pitch), surface->w * 4);
+	}
+
+	CompressedImage image;
+	Uint64 start = SDL_GetPerformanceCounter();
+	bool encoded = EncodeCompressedImage(pixels, surface->w, surface->h, format, srgb, generateMipmaps, &image);
+	Uint64 end = SDL_GetPerformanceCounter();
+
+	SDL_free(pixels);
+
+	if (!encoded || !SaveKTX2(outputPath, &image))
+	{
+		SDL_DestroySurface(surface);
+		return 1;
+	}
+
+	Uint32 uncompressedSize = 0;
+	for (Uint32 level = 0; level < image.LevelCount; level += 1)
+	{
+		uncompressedSize += SDL_max(surface->w >> level, 1) * SDL_max(surface->h >> level, 1) * 4;
+	}
+
+	SDL_Log(
+		"%s: %dx%d, %u levels, %s%s, %u bytes (%.1fx smaller than RGBA8), encoded in %.2f ms",
+		outputPath,
+		surface->w,
+		surface->h,
+		image.LevelCount,
+		GetCompressedFormatName(format),
+		srgb ? " sRGB" : "",
+		image.DataSize,
+		(double) uncompressedSize / image.DataSize,
+		(double) (end - start) * 1000.0 / SDL_GetPerformanceFrequency()
+	);
+
+	FreeCompressedImage(&image);
+	SDL_DestroySurface(surface);
+
+	return 0;
+}